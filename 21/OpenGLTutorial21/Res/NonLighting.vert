@@ -1,29 +1,41 @@
-#version 410
-
-layout(location=0) in vec3 vPosition;
-layout(location=1) in vec4 vColor;
-layout(location=2) in vec2 vTexCoord;
-
-layout(location=0) out vec4 outColor;
-layout(location=1) out vec2 outTexCoord;
-
-/**
-* _VF[_.
-*/
-layout(std140) uniform VertexData
-{
-	mat4 matMVP[4];
-	mat4 matDepthMVP;
-	mat4 matModel;
-	mat3x4 matNormal;
-	vec4 color;
-	mat4 matTex;
-} vertexData;
-
-uniform int viewIndex;
-
-void main() {
-  outColor = vColor * vertexData.color;
-  outTexCoord = (vertexData.matTex * vec4(vTexCoord, 0, 1)).xy;
-  gl_Position = vertexData.matMVP[viewIndex] * vec4(vPosition, 1.0);
+#version 410
+
+layout(location=0) in vec3 vPosition;
+layout(location=1) in vec4 vColor;
+layout(location=2) in vec2 vTexCoord;
+
+layout(location=0) out vec4 outColor;
+layout(location=1) out vec2 outTexCoord;
+
+/**
+* 頂点シェーダ入力.
+*/
+layout(std140) uniform VertexData
+{
+	mat4 matModel;
+	mat3x4 matNormal;
+	vec4 color;
+	mat4 matTex;
+} vertexData;
+
+/**
+* 全エンティティで共有する座標変換データ.
+*/
+layout(std140) uniform ViewData
+{
+	mat4 matVP[4];
+	mat4 matDepthVP;
+} viewData;
+
+uniform int viewIndex;
+
+/**
+* グループ単位の平行移動. 背景のスクロールなどに使う.
+*/
+uniform vec3 groupOffset;
+
+void main() {
+  outColor = vColor * vertexData.color;
+  outTexCoord = (vertexData.matTex * vec4(vTexCoord, 0, 1)).xy;
+  gl_Position = viewData.matVP[viewIndex] * (vertexData.matModel * vec4(vPosition, 1.0) + vec4(groupOffset, 0));
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+#version 410
+
+layout(location=0) in vec4 vPositionAndSize;
+layout(location=1) in vec4 vColor;
+
+layout(location=0) out vec4 outColor;
+layout(location=1) out vec2 outTexCoord;
+
+/**
+* 全エンティティで共有する座標変換データ.
+*/
+layout(std140) uniform ViewData
+{
+	mat4 matVP[4];
+	mat4 matDepthVP;
+	vec4 cameraRight[4];
+	vec4 cameraUp[4];
+} viewData;
+
+uniform int viewIndex;
+
+/**
+* ビルボードの頂点の位置.
+*
+* GL_TRIANGLE_STRIPで描画する順に並べている.
+*/
+const vec2 corners[4] = vec2[](vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(-0.5, 0.5), vec2(0.5, 0.5));
+
+void main() {
+  vec2 corner = corners[gl_VertexID];
+  vec3 offset = viewData.cameraRight[viewIndex].xyz * corner.x + viewData.cameraUp[viewIndex].xyz * corner.y;
+  outColor = vColor;
+  outTexCoord = corner + 0.5;
+  gl_Position = viewData.matVP[viewIndex] * vec4(vPositionAndSize.xyz + offset * vPositionAndSize.w, 1.0);
+}
\ No newline at end of file
@@ -1,25 +1,37 @@
-#version 410
-
-layout(location=0) in vec3 vPosition;
-layout(location=2) in vec2 vTexCoord;
-
-layout(location=1) out vec2 outTexCoord;
-
-/**
-* _VF[_.
-*/
-layout(std140) uniform VertexData
-{
-	mat4 matMVP[4];
-	mat4 matDepthMVP;
-	mat4 matModel;
-	mat3x4 matNormal;
-	vec4 color;
-	mat4 matTex;
-} vertexData;
-
-void main()
-{
-  outTexCoord = vTexCoord;
-  gl_Position = vertexData.matDepthMVP * vec4(vPosition, 1);
+#version 410
+
+layout(location=0) in vec3 vPosition;
+layout(location=2) in vec2 vTexCoord;
+
+layout(location=1) out vec2 outTexCoord;
+
+/**
+* 頂点シェーダ入力.
+*/
+layout(std140) uniform VertexData
+{
+	mat4 matModel;
+	mat3x4 matNormal;
+	vec4 color;
+	mat4 matTex;
+} vertexData;
+
+/**
+* 全エンティティで共有する座標変換データ.
+*/
+layout(std140) uniform ViewData
+{
+	mat4 matVP[4];
+	mat4 matDepthVP;
+} viewData;
+
+/**
+* グループ単位の平行移動. 背景のスクロールなどに使う.
+*/
+uniform vec3 groupOffset;
+
+void main()
+{
+  outTexCoord = vTexCoord;
+  gl_Position = viewData.matDepthVP * (vertexData.matModel * vec4(vPosition, 1) + vec4(groupOffset, 0));
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+#version 410
+
+layout(location=0) in vec3 vPosition;
+layout(location=2) in vec2 vTexCoord;
+
+layout(location=1) out vec2 outTexCoord;
+
+/**
+* 頂点シェーダ入力(1インスタンス分).
+*/
+struct InstanceData
+{
+	mat4 matModel;
+	mat3x4 matNormal;
+	vec4 color;
+	mat4 matTex;
+};
+
+/**
+* 頂点シェーダ入力.
+*
+* 配列の長さはUniform::maxInstanceCountと一致させること.
+*/
+layout(std140) uniform VertexData
+{
+	InstanceData instance[85];
+} vertexDataList;
+
+/**
+* 全エンティティで共有する座標変換データ.
+*/
+layout(std140) uniform ViewData
+{
+	mat4 matVP[4];
+	mat4 matDepthVP;
+} viewData;
+
+/**
+* グループ単位の平行移動. 背景のスクロールなどに使う.
+*/
+uniform vec3 groupOffset;
+
+void main()
+{
+  outTexCoord = vTexCoord;
+  gl_Position = viewData.matDepthVP * (vertexDataList.instance[gl_InstanceID].matModel * vec4(vPosition, 1) + vec4(groupOffset, 0));
+}
\ No newline at end of file
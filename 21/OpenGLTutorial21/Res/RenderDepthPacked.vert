@@ -0,0 +1,40 @@
+#version 410
+
+layout(location=0) in vec3 vPosition;
+layout(location=2) in vec2 vTexCoord;
+
+layout(location=1) out vec2 outTexCoord;
+
+/**
+* インスタンスデータ(テクスチャバッファ).
+*
+* 1インスタンスあたり4テクセル. 0～2はモデル行列の各行、3は色.
+*/
+uniform samplerBuffer instanceData;
+uniform int instanceBase;
+
+/**
+* 全エンティティで共有する座標変換データ.
+*/
+layout(std140) uniform ViewData
+{
+	mat4 matVP[4];
+	mat4 matDepthVP;
+} viewData;
+
+/**
+* グループ単位の平行移動. 背景のスクロールなどに使う.
+*/
+uniform vec3 groupOffset;
+
+void main()
+{
+  int index = (instanceBase + gl_InstanceID) * 4;
+  mat4 matModel = transpose(mat4(
+    texelFetch(instanceData, index),
+    texelFetch(instanceData, index + 1),
+    texelFetch(instanceData, index + 2),
+    vec4(0, 0, 0, 1)));
+  outTexCoord = vTexCoord;
+  gl_Position = viewData.matDepthVP * (matModel * vec4(vPosition, 1) + vec4(groupOffset, 0));
+}
\ No newline at end of file
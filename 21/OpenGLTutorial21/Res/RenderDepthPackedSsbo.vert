@@ -0,0 +1,49 @@
+#version 430
+
+layout(location=0) in vec3 vPosition;
+layout(location=2) in vec2 vTexCoord;
+
+layout(location=1) out vec2 outTexCoord;
+
+/**
+* インスタンスデータ(1インスタンス分).
+*/
+struct InstanceData
+{
+	vec4 matModel[3];
+	vec4 color;
+};
+
+/**
+* インスタンスデータ(シェーダ・ストレージ・バッファ).
+*
+* バインディング・ポイントはUniform::instanceDataStorageBindingと一致させること.
+*/
+layout(std430, binding=0) readonly buffer InstanceDataList
+{
+	InstanceData instance[];
+} instanceDataList;
+
+uniform int instanceBase;
+
+/**
+* 全エンティティで共有する座標変換データ.
+*/
+layout(std140) uniform ViewData
+{
+	mat4 matVP[4];
+	mat4 matDepthVP;
+} viewData;
+
+/**
+* グループ単位の平行移動. 背景のスクロールなどに使う.
+*/
+uniform vec3 groupOffset;
+
+void main()
+{
+  InstanceData data = instanceDataList.instance[instanceBase + gl_InstanceID];
+  mat4 matModel = transpose(mat4(data.matModel[0], data.matModel[1], data.matModel[2], vec4(0, 0, 0, 1)));
+  outTexCoord = vTexCoord;
+  gl_Position = viewData.matDepthVP * (matModel * vec4(vPosition, 1) + vec4(groupOffset, 0));
+}
\ No newline at end of file
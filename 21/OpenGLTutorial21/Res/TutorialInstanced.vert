@@ -0,0 +1,65 @@
+#version 410
+
+layout(location=0) in vec3 vPosition;
+layout(location=1) in vec4 vColor;
+layout(location=2) in vec2 vTexCoord;
+layout(location=3) in vec3 vNormal;
+layout(location=4) in vec4 vTangent;
+
+layout(location=0) out vec4 outColor;
+layout(location=1) out vec2 outTexCoord;
+layout(location=2) out vec3 outWorldPosition;
+layout(location=3) out mat3 outTBN;
+layout(location=6) out vec3 outDepthCoord;
+
+/**
+* 頂点シェーダ入力(1インスタンス分).
+*/
+struct InstanceData
+{
+	mat4 matModel;
+	mat3x4 matNormal;
+	vec4 color;
+	mat4 matTex;
+};
+
+/**
+* 頂点シェーダ入力.
+*
+* 配列の長さはUniform::maxInstanceCountと一致させること.
+*/
+layout(std140) uniform VertexData
+{
+	InstanceData instance[85];
+} vertexDataList;
+
+/**
+* 全エンティティで共有する座標変換データ.
+*/
+layout(std140) uniform ViewData
+{
+	mat4 matVP[4];
+	mat4 matDepthVP;
+} viewData;
+
+uniform int viewIndex;
+
+/**
+* グループ単位の平行移動. 背景のスクロールなどに使う.
+*/
+uniform vec3 groupOffset;
+
+void main() {
+  InstanceData vertexData = vertexDataList.instance[gl_InstanceID];
+  outColor = vColor * vertexData.color;
+  outTexCoord = (vertexData.matTex * vec4(vTexCoord, 0, 1)).xy;
+  vec4 worldPosition = vertexData.matModel * vec4(vPosition, 1.0) + vec4(groupOffset, 0);
+  outWorldPosition = worldPosition.xyz;
+  mat3 matNormal = mat3(vertexData.matNormal);
+  vec3 t = matNormal * vTangent.xyz;
+  vec3 n = matNormal * vNormal;
+  vec3 b = normalize(cross(n, t)) * vTangent.w;
+  outTBN = mat3(t, b, n);
+  outDepthCoord = ((viewData.matDepthVP * worldPosition) * 0.5 + 0.5).xyz;
+  gl_Position = viewData.matVP[viewIndex] * worldPosition;
+}
\ No newline at end of file
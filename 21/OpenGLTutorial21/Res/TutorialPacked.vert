@@ -0,0 +1,62 @@
+#version 410
+
+layout(location=0) in vec3 vPosition;
+layout(location=1) in vec4 vColor;
+layout(location=2) in vec2 vTexCoord;
+layout(location=3) in vec3 vNormal;
+layout(location=4) in vec4 vTangent;
+
+layout(location=0) out vec4 outColor;
+layout(location=1) out vec2 outTexCoord;
+layout(location=2) out vec3 outWorldPosition;
+layout(location=3) out mat3 outTBN;
+layout(location=6) out vec3 outDepthCoord;
+
+/**
+* インスタンスデータ(テクスチャバッファ).
+*
+* 1インスタンスあたり4テクセル. 0～2はモデル行列の各行、3は色.
+*/
+uniform samplerBuffer instanceData;
+uniform int instanceBase;
+
+/**
+* 全エンティティで共有する座標変換データ.
+*/
+layout(std140) uniform ViewData
+{
+	mat4 matVP[4];
+	mat4 matDepthVP;
+} viewData;
+
+uniform int viewIndex;
+
+/**
+* グループ単位の平行移動. 背景のスクロールなどに使う.
+*/
+uniform vec3 groupOffset;
+
+void main() {
+  int index = (instanceBase + gl_InstanceID) * 4;
+  mat4 matModel = transpose(mat4(
+    texelFetch(instanceData, index),
+    texelFetch(instanceData, index + 1),
+    texelFetch(instanceData, index + 2),
+    vec4(0, 0, 0, 1)));
+  vec4 color = texelFetch(instanceData, index + 3);
+  outColor = vColor * color;
+  outTexCoord = vTexCoord;
+  vec4 worldPosition = matModel * vec4(vPosition, 1.0) + vec4(groupOffset, 0);
+  outWorldPosition = worldPosition.xyz;
+  // 各列を長さの2乗で割ると、回転と拡大縮小からなる行列の逆転置行列になる.
+  mat3 matNormal = mat3(matModel);
+  matNormal[0] /= dot(matNormal[0], matNormal[0]);
+  matNormal[1] /= dot(matNormal[1], matNormal[1]);
+  matNormal[2] /= dot(matNormal[2], matNormal[2]);
+  vec3 t = normalize(mat3(matModel) * vTangent.xyz);
+  vec3 n = normalize(matNormal * vNormal);
+  vec3 b = normalize(cross(n, t)) * vTangent.w;
+  outTBN = mat3(t, b, n);
+  outDepthCoord = ((viewData.matDepthVP * worldPosition) * 0.5 + 0.5).xyz;
+  gl_Position = viewData.matVP[viewIndex] * worldPosition;
+}
\ No newline at end of file
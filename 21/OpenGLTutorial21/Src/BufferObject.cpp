@@ -1,91 +1,119 @@
-/**
-* @file BufferObject.cpp
-*/
-#include "BufferObject.h"
-
-/**
-* obt@IuWFNg쐬.
-*
-* @param target obt@IuWFNg̎.
-* @param size   _f[^̃TCY.
-* @param data   _f[^ւ̃|C^.
-* @param usage  obt@IuWFNg̃ANZX^Cv.
-*/
-void BufferObject::Init(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
-{
-  Destroy();
-  glGenBuffers(1, &id);
-  glBindBuffer(target, id);
-  glBufferData(target, size, data, usage);
-  glBindBuffer(target, 0);
-}
-
-/**
-* Buffer Objectj.
-*/
-void BufferObject::Destroy()
-{
-  if (id) {
-    glDeleteBuffers(1, &id);
-    id = 0;
-  }
-}
-
-/**
-* VAO쐬.
-*
-* @param vbo  _obt@IuWFNgID.
-* @param ibo  CfbNXobt@IuWFNgID.
-*/
-void VertexArrayObject::Init(GLuint vbo, GLuint ibo)
-{
-  Destroy();
-  glGenVertexArrays(1, &id);
-  glBindVertexArray(id);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-  glBindVertexArray(0);
-}
-
-/**
-* VAOj.
-*/
-void VertexArrayObject::Destroy()
-{
-  if (id) {
-    glDeleteVertexArrays(1, &id);
-    id = 0;
-  }
-}
-
-/**
-* _Agr[gݒ肷.
-*
-* @param index      _Agr[g̃CfbNX.
-* @param size       _Agr[g̗vf.
-* @param type       _Agr[ǧ^.
-* @param normalized GL_TRUE=vf𐳋K. GL_FALSE=KȂ.
-* @param stride     ̒_f[^܂ł̃oCg.
-* @param offset     _f[^擪̃oCgItZbg.
-*/
-void VertexArrayObject::VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, size_t offset)
-{
-  glEnableVertexAttribArray(index);
-  glVertexAttribPointer(index, size, type, normalized, stride, reinterpret_cast<GLvoid*>(offset));
-}
-
-/**
-* VAOΏۂɂ.
-*/
-void VertexArrayObject::Bind() const
-{
-  glBindVertexArray(id);
-}
-
-/**
-* VAOΏۂO.
-*/
-void VertexArrayObject::Unbind() const
-{
-  glBindVertexArray(0);
-}
+/**
+* @file BufferObject.cpp
+*/
+#include "BufferObject.h"
+#include "GLState.h"
+
+/**
+* バッファオブジェクトを作成する.
+*
+* @param target バッファオブジェクトの種類.
+* @param size   頂点データのサイズ.
+* @param data   頂点データへのポインタ.
+* @param usage  バッファオブジェクトのアクセスタイプ.
+*/
+void BufferObject::Init(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+  Destroy();
+  glGenBuffers(1, &id);
+  GLState::BindBuffer(target, id);
+  glBufferData(target, size, data, usage);
+  GLState::BindBuffer(target, 0);
+}
+
+/**
+* 大きさを変更できないバッファオブジェクトを作成する.
+*
+* @param target バッファオブジェクトの種類.
+* @param size   バッファのバイト数.
+* @param flags  glBufferStorageに渡すフラグ(GL_MAP_PERSISTENT_BITなど).
+*
+* @retval true  作成成功.
+* @retval false 作成失敗. OpenGL 4.4またはGL_ARB_buffer_storageが必要.
+*/
+bool BufferObject::InitStorage(GLenum target, GLsizeiptr size, GLbitfield flags)
+{
+  Destroy();
+  if (!GLEW_VERSION_4_4 && !GLEW_ARB_buffer_storage) {
+    return false;
+  }
+  glGenBuffers(1, &id);
+  GLState::BindBuffer(target, id);
+  glBufferStorage(target, size, nullptr, flags);
+  GLState::BindBuffer(target, 0);
+  if (glGetError() != GL_NO_ERROR) {
+    Destroy();
+    return false;
+  }
+  return true;
+}
+
+/**
+* Buffer Objectを破棄する.
+*/
+void BufferObject::Destroy()
+{
+  if (id) {
+    GLState::DeleteBuffer(id);
+    id = 0;
+  }
+}
+
+/**
+* VAOを作成する.
+*
+* @param vbo  頂点バッファオブジェクトのID.
+* @param ibo  インデックスバッファオブジェクトのID.
+*/
+void VertexArrayObject::Init(GLuint vbo, GLuint ibo)
+{
+  Destroy();
+  glGenVertexArrays(1, &id);
+  GLState::BindVertexArray(id);
+  GLState::BindBuffer(GL_ARRAY_BUFFER, vbo);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+  GLState::BindVertexArray(0);
+}
+
+/**
+* VAOを破棄する.
+*/
+void VertexArrayObject::Destroy()
+{
+  if (id) {
+    GLState::DeleteVertexArray(id);
+    id = 0;
+  }
+}
+
+/**
+* 頂点アトリビュートを設定する.
+*
+* @param index      頂点アトリビュートのインデックス.
+* @param size       頂点アトリビュートの要素数.
+* @param type       頂点アトリビュートの型.
+* @param normalized GL_TRUE=要素を正規化する. GL_FALSE=正規化しない.
+* @param stride     次の頂点データまでのバイト数.
+* @param offset     頂点データ先頭からのバイトオフセット.
+*/
+void VertexArrayObject::VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, size_t offset) const
+{
+  glEnableVertexAttribArray(index);
+  glVertexAttribPointer(index, size, type, normalized, stride, reinterpret_cast<GLvoid*>(offset));
+}
+
+/**
+* VAOを処理対象にする.
+*/
+void VertexArrayObject::Bind() const
+{
+  GLState::BindVertexArray(id);
+}
+
+/**
+* VAOを処理対象から外す.
+*/
+void VertexArrayObject::Unbind() const
+{
+  GLState::BindVertexArray(0);
+}
@@ -0,0 +1,752 @@
+/**
+* @file Bullet.cpp
+*/
+#include "Bullet.h"
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#include <xmmintrin.h>
+#define BULLET_USE_SSE
+#endif
+
+namespace Entity {
+
+static const size_t simdWidth = 4; ///< 一度に処理する弾の数.
+static const size_t maxPoolCount = 0x10000; ///< 登録できる種類の数の上限.
+
+/// 空間グリッドを使わずに総当たりで衝突判定を行う組み合わせ数の上限. Buffer::Update()と同じ値.
+static const size_t maxBruteForcePairs = 256;
+
+/**
+* 弾の数をSIMD命令の処理単位に切り上げる.
+*
+* @param n 弾の数.
+*
+* @return nを4の倍数に切り上げた値.
+*/
+static size_t RoundUp(size_t n)
+{
+  return (n + simdWidth - 1) / simdWidth * simdWidth;
+}
+
+#ifdef BULLET_USE_SSE
+/**
+* 4つの角度の正弦を近似計算する.
+*
+* @param x 角度(ラジアン).
+*
+* @return xの正弦. 誤差は0.001程度.
+*
+* -π～πの範囲に変換してから放物線で近似し、さらに放物線で誤差を補正する.
+* 四捨五入はSSE2を使わないよう、2^23付近の浮動小数点数の丸めを利用して行う.
+*/
+static __m128 SinPs(__m128 x)
+{
+  const __m128 twoPi = _mm_set1_ps(glm::two_pi<float>());
+  const __m128 invTwoPi = _mm_set1_ps(1.0f / glm::two_pi<float>());
+  const __m128 roundMagic = _mm_set1_ps(12582912.0f); // 1.5 * 2^23.
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+  const __m128 n = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(x, invTwoPi), roundMagic), roundMagic);
+  x = _mm_sub_ps(x, _mm_mul_ps(n, twoPi));
+  const __m128 b = _mm_set1_ps(4.0f / glm::pi<float>());
+  const __m128 c = _mm_set1_ps(-4.0f / (glm::pi<float>() * glm::pi<float>()));
+  __m128 y = _mm_add_ps(_mm_mul_ps(b, x), _mm_mul_ps(_mm_mul_ps(c, x), _mm_andnot_ps(signMask, x)));
+  const __m128 p = _mm_set1_ps(0.225f);
+  y = _mm_add_ps(_mm_mul_ps(p, _mm_sub_ps(_mm_mul_ps(y, _mm_andnot_ps(signMask, y)), y)), y);
+  return y;
+}
+
+/**
+* 4つの角度の余弦を近似計算する.
+*
+* @param x 角度(ラジアン).
+*
+* @return xの余弦.
+*/
+static __m128 CosPs(__m128 x)
+{
+  return SinPs(_mm_add_ps(x, _mm_set1_ps(glm::half_pi<float>())));
+}
+#endif // BULLET_USE_SSE
+
+/**
+* 等速直線運動する弾を更新する.
+*
+* @param lane 更新する弾の配列.
+* @param dt   経過時間(秒).
+*/
+void BulletBuffer::UpdateLinear(Lane& lane, float dt)
+{
+  const size_t n = RoundUp(lane.count);
+  float* const posX = lane.posX.data();
+  float* const posY = lane.posY.data();
+  float* const posZ = lane.posZ.data();
+  const float* const velX = lane.velX.data();
+  const float* const velY = lane.velY.data();
+  const float* const velZ = lane.velZ.data();
+  float* const age = lane.age.data();
+#ifdef BULLET_USE_SSE
+  const __m128 vdt = _mm_set1_ps(dt);
+  for (size_t i = 0; i < n; i += simdWidth) {
+    _mm_storeu_ps(posX + i, _mm_add_ps(_mm_loadu_ps(posX + i), _mm_mul_ps(_mm_loadu_ps(velX + i), vdt)));
+    _mm_storeu_ps(posY + i, _mm_add_ps(_mm_loadu_ps(posY + i), _mm_mul_ps(_mm_loadu_ps(velY + i), vdt)));
+    _mm_storeu_ps(posZ + i, _mm_add_ps(_mm_loadu_ps(posZ + i), _mm_mul_ps(_mm_loadu_ps(velZ + i), vdt)));
+    _mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), vdt));
+  }
+#else
+  for (size_t i = 0; i < n; ++i) {
+    posX[i] += velX[i] * dt;
+    posY[i] += velY[i] * dt;
+    posZ[i] += velZ[i] * dt;
+    age[i] += dt;
+  }
+#endif
+}
+
+/**
+* 目標を追尾する弾を更新する.
+*
+* @param lane   更新する弾の配列.
+* @param dt     経過時間(秒).
+* @param target 目標の座標.
+*
+* 速度を、目標へ向かう速さparamXの速度にparamY*dtの割合だけ近づけてから移動する.
+*/
+void BulletBuffer::UpdateAimed(Lane& lane, float dt, const glm::vec3& target)
+{
+  const size_t n = RoundUp(lane.count);
+  float* const posX = lane.posX.data();
+  float* const posY = lane.posY.data();
+  float* const posZ = lane.posZ.data();
+  float* const velX = lane.velX.data();
+  float* const velY = lane.velY.data();
+  float* const velZ = lane.velZ.data();
+  float* const age = lane.age.data();
+  const float* const speed = lane.paramX.data();
+  const float* const homing = lane.paramY.data();
+#ifdef BULLET_USE_SSE
+  const __m128 vdt = _mm_set1_ps(dt);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 epsilon = _mm_set1_ps(1e-6f);
+  const __m128 tx = _mm_set1_ps(target.x);
+  const __m128 ty = _mm_set1_ps(target.y);
+  const __m128 tz = _mm_set1_ps(target.z);
+  for (size_t i = 0; i < n; i += simdWidth) {
+    __m128 px = _mm_loadu_ps(posX + i);
+    __m128 py = _mm_loadu_ps(posY + i);
+    __m128 pz = _mm_loadu_ps(posZ + i);
+    const __m128 dx = _mm_sub_ps(tx, px);
+    const __m128 dy = _mm_sub_ps(ty, py);
+    const __m128 dz = _mm_sub_ps(tz, pz);
+    const __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+    const __m128 scale = _mm_mul_ps(_mm_rsqrt_ps(_mm_max_ps(lengthSq, epsilon)), _mm_loadu_ps(speed + i));
+    const __m128 t = _mm_min_ps(_mm_mul_ps(_mm_loadu_ps(homing + i), vdt), one);
+    __m128 vx = _mm_loadu_ps(velX + i);
+    __m128 vy = _mm_loadu_ps(velY + i);
+    __m128 vz = _mm_loadu_ps(velZ + i);
+    vx = _mm_add_ps(vx, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(dx, scale), vx), t));
+    vy = _mm_add_ps(vy, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(dy, scale), vy), t));
+    vz = _mm_add_ps(vz, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(dz, scale), vz), t));
+    _mm_storeu_ps(velX + i, vx);
+    _mm_storeu_ps(velY + i, vy);
+    _mm_storeu_ps(velZ + i, vz);
+    _mm_storeu_ps(posX + i, _mm_add_ps(px, _mm_mul_ps(vx, vdt)));
+    _mm_storeu_ps(posY + i, _mm_add_ps(py, _mm_mul_ps(vy, vdt)));
+    _mm_storeu_ps(posZ + i, _mm_add_ps(pz, _mm_mul_ps(vz, vdt)));
+    _mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), vdt));
+  }
+#else
+  for (size_t i = 0; i < n; ++i) {
+    const glm::vec3 d = target - glm::vec3(posX[i], posY[i], posZ[i]);
+    const glm::vec3 desired = d * (speed[i] / std::sqrt(std::max(glm::dot(d, d), 1e-6f)));
+    const float t = std::min(homing[i] * dt, 1.0f);
+    velX[i] += (desired.x - velX[i]) * t;
+    velY[i] += (desired.y - velY[i]) * t;
+    velZ[i] += (desired.z - velZ[i]) * t;
+    posX[i] += velX[i] * dt;
+    posY[i] += velY[i] * dt;
+    posZ[i] += velZ[i] * dt;
+    age[i] += dt;
+  }
+#endif
+}
+
+/**
+* 横方向に揺れる弾を更新する.
+*
+* @param lane 更新する弾の配列.
+* @param dt   経過時間(秒).
+*
+* 座標 = 発射位置 + 速度 * 経過時間 + 横方向 * paramX * sin(paramY * 経過時間 + paramZ).
+* 横方向は、速度をXZ平面上で90度回転した向き.
+*/
+void BulletBuffer::UpdateSine(Lane& lane, float dt)
+{
+  const size_t n = RoundUp(lane.count);
+  float* const posX = lane.posX.data();
+  float* const posY = lane.posY.data();
+  float* const posZ = lane.posZ.data();
+  const float* const velX = lane.velX.data();
+  const float* const velY = lane.velY.data();
+  const float* const velZ = lane.velZ.data();
+  const float* const orgX = lane.orgX.data();
+  const float* const orgY = lane.orgY.data();
+  const float* const orgZ = lane.orgZ.data();
+  float* const age = lane.age.data();
+  const float* const amplitude = lane.paramX.data();
+  const float* const frequency = lane.paramY.data();
+  const float* const phase = lane.paramZ.data();
+#ifdef BULLET_USE_SSE
+  const __m128 vdt = _mm_set1_ps(dt);
+  const __m128 epsilon = _mm_set1_ps(1e-6f);
+  for (size_t i = 0; i < n; i += simdWidth) {
+    const __m128 t = _mm_add_ps(_mm_loadu_ps(age + i), vdt);
+    _mm_storeu_ps(age + i, t);
+    const __m128 vx = _mm_loadu_ps(velX + i);
+    const __m128 vz = _mm_loadu_ps(velZ + i);
+    const __m128 invLength = _mm_rsqrt_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vz, vz)), epsilon));
+    const __m128 angle = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(frequency + i), t), _mm_loadu_ps(phase + i));
+    const __m128 w = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(amplitude + i), SinPs(angle)), invLength);
+    _mm_storeu_ps(posX + i, _mm_add_ps(_mm_add_ps(_mm_loadu_ps(orgX + i), _mm_mul_ps(vx, t)), _mm_mul_ps(vz, w)));
+    _mm_storeu_ps(posY + i, _mm_add_ps(_mm_loadu_ps(orgY + i), _mm_mul_ps(_mm_loadu_ps(velY + i), t)));
+    _mm_storeu_ps(posZ + i, _mm_sub_ps(_mm_add_ps(_mm_loadu_ps(orgZ + i), _mm_mul_ps(vz, t)), _mm_mul_ps(vx, w)));
+  }
+#else
+  for (size_t i = 0; i < n; ++i) {
+    const float t = age[i] + dt;
+    age[i] = t;
+    const float invLength = 1.0f / std::sqrt(std::max(velX[i] * velX[i] + velZ[i] * velZ[i], 1e-6f));
+    const float w = amplitude[i] * std::sin(frequency[i] * t + phase[i]) * invLength;
+    posX[i] = orgX[i] + velX[i] * t + velZ[i] * w;
+    posY[i] = orgY[i] + velY[i] * t;
+    posZ[i] = orgZ[i] + velZ[i] * t - velX[i] * w;
+  }
+#endif
+}
+
+/**
+* 螺旋を描く弾を更新する.
+*
+* @param lane 更新する弾の配列.
+* @param dt   経過時間(秒).
+*
+* 座標 = 発射位置 + 速度 * 経過時間 + (cosθ, 0, sinθ) * paramZ * 経過時間.
+* θ = paramX + paramY * 経過時間.
+*/
+void BulletBuffer::UpdateSpiral(Lane& lane, float dt)
+{
+  const size_t n = RoundUp(lane.count);
+  float* const posX = lane.posX.data();
+  float* const posY = lane.posY.data();
+  float* const posZ = lane.posZ.data();
+  const float* const velX = lane.velX.data();
+  const float* const velY = lane.velY.data();
+  const float* const velZ = lane.velZ.data();
+  const float* const orgX = lane.orgX.data();
+  const float* const orgY = lane.orgY.data();
+  const float* const orgZ = lane.orgZ.data();
+  float* const age = lane.age.data();
+  const float* const angle = lane.paramX.data();
+  const float* const angularSpeed = lane.paramY.data();
+  const float* const radialSpeed = lane.paramZ.data();
+#ifdef BULLET_USE_SSE
+  const __m128 vdt = _mm_set1_ps(dt);
+  for (size_t i = 0; i < n; i += simdWidth) {
+    const __m128 t = _mm_add_ps(_mm_loadu_ps(age + i), vdt);
+    _mm_storeu_ps(age + i, t);
+    const __m128 theta = _mm_add_ps(_mm_loadu_ps(angle + i), _mm_mul_ps(_mm_loadu_ps(angularSpeed + i), t));
+    const __m128 r = _mm_mul_ps(_mm_loadu_ps(radialSpeed + i), t);
+    const __m128 x = _mm_add_ps(_mm_loadu_ps(orgX + i), _mm_mul_ps(_mm_loadu_ps(velX + i), t));
+    const __m128 z = _mm_add_ps(_mm_loadu_ps(orgZ + i), _mm_mul_ps(_mm_loadu_ps(velZ + i), t));
+    _mm_storeu_ps(posX + i, _mm_add_ps(x, _mm_mul_ps(CosPs(theta), r)));
+    _mm_storeu_ps(posY + i, _mm_add_ps(_mm_loadu_ps(orgY + i), _mm_mul_ps(_mm_loadu_ps(velY + i), t)));
+    _mm_storeu_ps(posZ + i, _mm_add_ps(z, _mm_mul_ps(SinPs(theta), r)));
+  }
+#else
+  for (size_t i = 0; i < n; ++i) {
+    const float t = age[i] + dt;
+    age[i] = t;
+    const float theta = angle[i] + angularSpeed[i] * t;
+    const float r = radialSpeed[i] * t;
+    posX[i] = orgX[i] + velX[i] * t + std::cos(theta) * r;
+    posY[i] = orgY[i] + velY[i] * t;
+    posZ[i] = orgZ[i] + velZ[i] * t + std::sin(theta) * r;
+  }
+#endif
+}
+
+/**
+* 寿命が尽きたか範囲外に出た弾を削除する.
+*
+* @param lane 弾の配列.
+* @param min  弾が存在できる範囲の最小座標.
+* @param max  弾が存在できる範囲の最大座標.
+*
+* @return 削除した弾の数.
+*
+* 削除するかどうかの判定は4個ずつまとめて行い、ビットマスクにする.
+* 削除する弾は末尾の弾で置き換える. 後ろから処理すれば、置き換えに使う弾は判定済みのものになる.
+*/
+size_t BulletBuffer::RemoveDeadBullets(Lane& lane, const glm::vec3& min, const glm::vec3& max)
+{
+  const size_t oldCount = lane.count;
+  float* const posX = lane.posX.data();
+  float* const posY = lane.posY.data();
+  float* const posZ = lane.posZ.data();
+  const float* const age = lane.age.data();
+  const float* const lifetime = lane.lifetime.data();
+  for (size_t block = RoundUp(lane.count); block > 0; block -= simdWidth) {
+    const size_t first = block - simdWidth;
+#ifdef BULLET_USE_SSE
+    __m128 dead = _mm_cmpge_ps(_mm_loadu_ps(age + first), _mm_loadu_ps(lifetime + first));
+    const __m128 px = _mm_loadu_ps(posX + first);
+    const __m128 py = _mm_loadu_ps(posY + first);
+    const __m128 pz = _mm_loadu_ps(posZ + first);
+    dead = _mm_or_ps(dead, _mm_or_ps(_mm_cmplt_ps(px, _mm_set1_ps(min.x)), _mm_cmpgt_ps(px, _mm_set1_ps(max.x))));
+    dead = _mm_or_ps(dead, _mm_or_ps(_mm_cmplt_ps(py, _mm_set1_ps(min.y)), _mm_cmpgt_ps(py, _mm_set1_ps(max.y))));
+    dead = _mm_or_ps(dead, _mm_or_ps(_mm_cmplt_ps(pz, _mm_set1_ps(min.z)), _mm_cmpgt_ps(pz, _mm_set1_ps(max.z))));
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(dead));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < simdWidth; ++i) {
+      const size_t n = first + i;
+      if (age[n] >= lifetime[n] || posX[n] < min.x || posX[n] > max.x ||
+        posY[n] < min.y || posY[n] > max.y || posZ[n] < min.z || posZ[n] > max.z) {
+        mask |= 1U << i;
+      }
+    }
+#endif
+    // 末尾の余った要素は対象外.
+    if (block > lane.count) {
+      mask &= (1U << (lane.count - first)) - 1;
+    }
+    for (int bit = simdWidth - 1; mask; --bit) {
+      if (!(mask & (1U << bit))) {
+        continue;
+      }
+      mask &= ~(1U << bit);
+      const size_t i = first + bit;
+      const size_t last = --lane.count;
+      lane.posX[i] = lane.posX[last];
+      lane.posY[i] = lane.posY[last];
+      lane.posZ[i] = lane.posZ[last];
+      lane.velX[i] = lane.velX[last];
+      lane.velY[i] = lane.velY[last];
+      lane.velZ[i] = lane.velZ[last];
+      lane.orgX[i] = lane.orgX[last];
+      lane.orgY[i] = lane.orgY[last];
+      lane.orgZ[i] = lane.orgZ[last];
+      lane.age[i] = lane.age[last];
+      lane.lifetime[i] = lane.lifetime[last];
+      lane.paramX[i] = lane.paramX[last];
+      lane.paramY[i] = lane.paramY[last];
+      lane.paramZ[i] = lane.paramZ[last];
+    }
+  }
+  return oldCount - lane.count;
+}
+
+/**
+* コンストラクタ.
+*/
+BulletBuffer::BulletBuffer()
+{
+  proxyStorage.PushBack(&proxy, glm::vec3(0));
+  proxy.bulletBuffer = this;
+}
+
+/**
+* 弾の種類を登録する.
+*
+* @param archetype 描画に使うリソース、グループID、衝突形状を設定したアーキタイプ.
+*                  updateFuncとbehaviorTableは使われない.
+* @param color     弾の色.
+* @param capacity  この種類の弾が同時に存在できる数.
+*
+* @return 登録した種類のID. 登録に失敗した場合は-1.
+*/
+BulletTypeId BulletBuffer::RegisterType(const Archetype& archetype, const glm::vec4& color, size_t capacity)
+{
+  if (archetype.groupId < 0 || archetype.groupId > maxGroupId || capacity == 0) {
+    std::cerr << "WARNING in Entity::BulletBuffer::RegisterType: 無効なパラメータが指定されました." << std::endl;
+    return -1;
+  }
+  if (poolList.size() >= maxPoolCount) {
+    std::cerr << "WARNING in Entity::BulletBuffer::RegisterType: これ以上登録できません." << std::endl;
+    return -1;
+  }
+  poolList.emplace_back();
+  Pool& pool = poolList.back();
+  pool.archetype.groupId = archetype.groupId;
+  pool.archetype.mesh = archetype.mesh;
+  pool.archetype.texture[0] = archetype.texture[0];
+  pool.archetype.texture[1] = archetype.texture[1];
+  pool.archetype.program = archetype.program;
+  pool.archetype.collision = archetype.collision;
+  pool.color = color;
+  pool.capacity = capacity;
+  pool.serial = nextPoolSerial++;
+  const size_t n = RoundUp(capacity);
+  for (Lane& lane : pool.lane) {
+    for (auto* p : { &lane.posX, &lane.posY, &lane.posZ, &lane.velX, &lane.velY, &lane.velZ,
+      &lane.orgX, &lane.orgY, &lane.orgZ, &lane.age, &lane.lifetime, &lane.paramX, &lane.paramY, &lane.paramZ }) {
+      p->resize(n, 0.0f);
+    }
+  }
+  return static_cast<BulletTypeId>(poolList.size() - 1);
+}
+
+/**
+* 全ての弾の種類を削除する.
+*
+* 存在する弾も全て削除される.
+*/
+void BulletBuffer::ClearTypes()
+{
+  poolList.clear();
+  killedCount = 0;
+}
+
+/**
+* 弾を発射する.
+*
+* @param id    弾の種類のID.
+* @param pos   発射する座標.
+* @param param 発射パラメータ.
+*
+* @retval true  発射成功.
+* @retval false 種類が無効か、同時に存在できる数を超えている.
+*
+* 並列更新中のエンティティの更新関数から呼び出してもよい.
+*/
+bool BulletBuffer::Fire(BulletTypeId id, const glm::vec3& pos, const BulletParam& param)
+{
+  std::lock_guard<std::mutex> lock(fireMutex);
+  if (id < 0 || static_cast<size_t>(id) >= poolList.size()) {
+    return false;
+  }
+  Pool& pool = poolList[id];
+  if (pool.count >= pool.capacity) {
+    return false;
+  }
+  const int pattern = static_cast<int>(param.pattern);
+  if (pattern < 0 || pattern >= bulletPatternCount) {
+    return false;
+  }
+  glm::vec3 velocity = param.velocity;
+  if (param.pattern == BulletPattern::Aimed) {
+    const glm::vec3 d = pool.target - pos;
+    const float lengthSq = glm::dot(d, d);
+    if (lengthSq > 0) {
+      velocity = d * (param.param.x / std::sqrt(lengthSq));
+    }
+  }
+  Lane& lane = pool.lane[pattern];
+  const size_t i = lane.count++;
+  lane.posX[i] = lane.orgX[i] = pos.x;
+  lane.posY[i] = lane.orgY[i] = pos.y;
+  lane.posZ[i] = lane.orgZ[i] = pos.z;
+  lane.velX[i] = velocity.x;
+  lane.velY[i] = velocity.y;
+  lane.velZ[i] = velocity.z;
+  lane.age[i] = 0;
+  lane.lifetime[i] = param.lifetime;
+  lane.paramX[i] = param.param.x;
+  lane.paramY[i] = param.param.y;
+  lane.paramZ[i] = param.param.z;
+  ++pool.count;
+  return true;
+}
+
+/**
+* Aimedパターンの弾の目標を設定する.
+*
+* @param id  弾の種類のID.
+* @param pos 目標の座標.
+*/
+void BulletBuffer::Target(BulletTypeId id, const glm::vec3& pos)
+{
+  if (id >= 0 && static_cast<size_t>(id) < poolList.size()) {
+    poolList[id].target = pos;
+  }
+}
+
+/**
+* 全ての弾を削除する.
+*/
+void BulletBuffer::Clear()
+{
+  for (Pool& pool : poolList) {
+    for (Lane& lane : pool.lane) {
+      lane.count = 0;
+    }
+    pool.count = 0;
+  }
+  killedCount = 0;
+}
+
+/**
+* 存在する弾の数を取得する.
+*/
+size_t BulletBuffer::Count() const
+{
+  size_t n = 0;
+  for (const Pool& pool : poolList) {
+    n += pool.count;
+  }
+  return n;
+}
+
+/**
+* 弾の状態を更新する.
+*
+* @param delta 前回の更新からの経過時間(秒).
+*
+* 運動パターンごとに移動させてから、寿命が尽きたか範囲外に出た弾をまとめて削除する.
+*/
+void BulletBuffer::Update(double delta)
+{
+  const float dt = static_cast<float>(delta);
+  size_t total = 0;
+  for (Pool& pool : poolList) {
+    if (pool.count == 0) {
+      continue;
+    }
+    UpdateLinear(pool.lane[static_cast<int>(BulletPattern::Linear)], dt);
+    UpdateAimed(pool.lane[static_cast<int>(BulletPattern::Aimed)], dt, pool.target);
+    UpdateSine(pool.lane[static_cast<int>(BulletPattern::Sine)], dt);
+    UpdateSpiral(pool.lane[static_cast<int>(BulletPattern::Spiral)], dt);
+    for (Lane& lane : pool.lane) {
+      pool.count -= RemoveDeadBullets(lane, boundsMin, boundsMax);
+    }
+    total += pool.count;
+  }
+  peakCount = std::max(peakCount, total);
+}
+
+/**
+* 衝突処理で削除された弾を取り除く.
+*
+* @retval true  取り除いた弾がある.
+* @retval false 衝突処理で削除された弾はなかった.
+*/
+bool BulletBuffer::RemoveDead()
+{
+  if (!killedCount) {
+    return false;
+  }
+  for (Pool& pool : poolList) {
+    for (Lane& lane : pool.lane) {
+      pool.count -= RemoveDeadBullets(lane, boundsMin, boundsMax);
+    }
+  }
+  killedCount = 0;
+  return true;
+}
+
+/**
+* 弾とエンティティの衝突判定を行う.
+*
+* @param groupId      判定する弾のグループID.
+* @param other        判定するエンティティのグループデータ.
+* @param isBulletLeft trueならハンドラの左辺に弾を、falseなら右辺に弾を渡す.
+* @param handler      衝突解決ハンドラ.
+*
+* 弾の衝突形状をSIMD判定用の配列に詰め込み、エンティティごとにまとめて判定する.
+* 組み合わせが多い場合は弾を空間グリッドにも登録し、重なる可能性のあるものだけを判定する.
+*/
+void BulletBuffer::Collide(int groupId, GroupStorage& other, bool isBulletLeft, const CollisionHandlerType& handler)
+{
+  refList.clear();
+  boxList.Clear();
+  float totalSize = 0;
+  for (size_t p = 0; p < poolList.size(); ++p) {
+    const Pool& pool = poolList[p];
+    if (pool.archetype.groupId != groupId || pool.count == 0) {
+      continue;
+    }
+    const CollisionData& col = pool.archetype.collision;
+    const glm::vec3 size = col.max - col.min;
+    totalSize += std::max(size.x, std::max(size.y, size.z)) * static_cast<float>(pool.count);
+    for (int l = 0; l < bulletPatternCount; ++l) {
+      const Lane& lane = pool.lane[l];
+      for (size_t i = 0; i < lane.count; ++i) {
+        if (lane.lifetime[i] < 0) {
+          continue;
+        }
+        const glm::vec3 pos(lane.posX[i], lane.posY[i], lane.posZ[i]);
+        refList.push_back({ static_cast<uint16_t>(p), static_cast<uint16_t>(l), static_cast<uint32_t>(i) });
+        boxList.Push(col.min + pos, col.max + pos);
+      }
+    }
+  }
+  if (refList.empty()) {
+    return;
+  }
+
+  size_t otherCount = 0;
+  const uint32_t groupBit = 1U << groupId;
+  for (size_t i = 0; i < other.Size(); ++i) {
+    if (other.entity[i]->isActive && (other.collisionMask[i] & groupBit)) {
+      const glm::vec3 size = other.colWorld[i].max - other.colWorld[i].min;
+      totalSize += std::max(size.x, std::max(size.y, size.z));
+      ++otherCount;
+    }
+  }
+  if (otherCount == 0) {
+    return;
+  }
+
+  const bool useGrid = otherCount * refList.size() > maxBruteForcePairs;
+  if (useGrid) {
+    // セルの大きさは、弾とエンティティの衝突形状の平均的な大きさの2倍とする.
+    grid.Clear(totalSize / static_cast<float>(refList.size() + otherCount) * 2.0f);
+    for (size_t i = 0; i < refList.size(); ++i) {
+      const BulletRef& ref = refList[i];
+      const Lane& lane = poolList[ref.pool].lane[ref.lane];
+      const CollisionData& col = poolList[ref.pool].archetype.collision;
+      const glm::vec3 pos(lane.posX[ref.index], lane.posY[ref.index], lane.posZ[ref.index]);
+      grid.Insert(static_cast<uint32_t>(i), col.min + pos, col.max + pos);
+    }
+    grid.Build();
+  }
+
+  for (size_t index = 0; index < other.Size(); ++index) {
+    Entity* entity = other.entity[index];
+    if (!entity->isActive || !(other.collisionMask[index] & groupBit)) {
+      continue;
+    }
+    const CollisionData& colE = other.colWorld[index];
+    const Collision::PackedBoxList* list = &boxList;
+    const uint32_t* idList = nullptr;
+    if (useGrid) {
+      candidateList.clear();
+      grid.Query(colE.min, colE.max, candidateList);
+      if (candidateList.empty()) {
+        continue;
+      }
+      candidateBoxList.Gather(boxList, candidateList.data(), candidateList.size());
+      list = &candidateBoxList;
+      idList = candidateList.data();
+    }
+    for (size_t first = 0; first < list->Size() && entity->isActive && (other.collisionMask[index] & groupBit); first += Collision::PackedBoxList::batchSize) {
+      const uint32_t mask = Collision::TestOverlap(colE.min, colE.max, *list, first);
+      for (uint32_t bit = 0; (mask >> bit) != 0; ++bit) {
+        if (!(mask & (1U << bit))) {
+          continue;
+        }
+        const size_t n = first + bit;
+        const BulletRef& ref = refList[idList ? idList[n] : n];
+        if (ref.pool >= poolList.size()) {
+          return; // ハンドラの中で種類が削除された.
+        }
+        Pool& pool = poolList[ref.pool];
+        Lane& lane = pool.lane[ref.lane];
+        if (ref.index >= lane.count || lane.lifetime[ref.index] < 0) {
+          continue; // 衝突処理中に削除された弾は無視する.
+        }
+
+        // 弾の状態を代理のエンティティに設定して、ハンドラを呼び出す.
+        const glm::vec3 pos(lane.posX[ref.index], lane.posY[ref.index], lane.posZ[ref.index]);
+        proxyStorage.position[0] = pos;
+        proxyStorage.velocity[0] = glm::vec3(lane.velX[ref.index], lane.velY[ref.index], lane.velZ[ref.index]);
+        proxyStorage.color[0] = pool.color;
+        proxyStorage.matModel[0] = glm::mat4(1);
+        proxyStorage.matModel[0][3] = glm::vec4(pos, 1);
+        proxyStorage.colLocal[0] = pool.archetype.collision;
+        proxyStorage.colWorld[0] = { pool.archetype.collision.min + pos, pool.archetype.collision.max + pos };
+        proxy.groupId = groupId;
+        proxy.archetype = &pool.archetype;
+        proxy.isActive = true;
+        proxyRef = ref;
+        if (isBulletLeft) {
+          handler(proxy, *entity);
+        } else {
+          handler(*entity, proxy);
+        }
+
+        // 削除されていなければ、ハンドラによる座標と速度の変更を弾に反映する.
+        // 波形と螺旋の弾は発射位置からの相対位置で動くため、発射位置も同じだけ動かす.
+        if (proxy.isActive) {
+          const glm::vec3 moved = proxyStorage.position[0] - pos;
+          lane.posX[ref.index] += moved.x;
+          lane.posY[ref.index] += moved.y;
+          lane.posZ[ref.index] += moved.z;
+          lane.orgX[ref.index] += moved.x;
+          lane.orgY[ref.index] += moved.y;
+          lane.orgZ[ref.index] += moved.z;
+          lane.velX[ref.index] = proxyStorage.velocity[0].x;
+          lane.velY[ref.index] = proxyStorage.velocity[0].y;
+          lane.velZ[ref.index] = proxyStorage.velocity[0].z;
+          proxy.isActive = false;
+        }
+        ++proxy.generation;
+        if (!entity->isActive) {
+          break; // エンティティが削除された場合は弾のループを終了する.
+        }
+        if (!(other.collisionMask[index] & groupBit)) {
+          break; // ハンドラで衝突マスクから弾のグループが外された場合も、残りの弾とは衝突させない.
+        }
+      }
+    }
+  }
+}
+
+/**
+* 描画用のインスタンスデータを書き込む.
+*
+* @param poolIndex 書き込む種類の番号.
+* @param out       書き込み先. 種類の弾の数以上の要素を持つこと.
+*
+* @return 書き込んだインスタンスデータの数.
+*
+* 弾のモデルは+Z方向を前とし、XZ平面上で速度の方向を向くように回転する.
+*/
+size_t BulletBuffer::WriteInstanceData(size_t poolIndex, Uniform::InstanceData* out) const
+{
+  const Pool& pool = poolList[poolIndex];
+  size_t n = 0;
+  for (const Lane& lane : pool.lane) {
+    for (size_t i = 0; i < lane.count; ++i) {
+      if (lane.lifetime[i] < 0) {
+        continue;
+      }
+      const float lengthSq = lane.velX[i] * lane.velX[i] + lane.velZ[i] * lane.velZ[i];
+      float c = 1;
+      float s = 0;
+      if (lengthSq > 0) {
+        const float invLength = 1.0f / std::sqrt(lengthSq);
+        c = lane.velZ[i] * invLength;
+        s = lane.velX[i] * invLength;
+      }
+      Uniform::InstanceData& data = out[n++];
+      data.matModel[0] = glm::vec4(c, 0, s, lane.posX[i]);
+      data.matModel[1] = glm::vec4(0, 1, 0, lane.posY[i]);
+      data.matModel[2] = glm::vec4(-s, 0, c, lane.posZ[i]);
+      data.color = pool.color;
+    }
+  }
+  return n;
+}
+
+/**
+* 代理のエンティティが表している弾を削除する.
+*
+* @param e 代理のエンティティ.
+*
+* 配列からはRemoveDead()で取り除かれる.
+*/
+void BulletBuffer::Kill(Entity& e)
+{
+  if (&e != &proxy || !proxy.isActive) {
+    return;
+  }
+  poolList[proxyRef.pool].lane[proxyRef.lane].lifetime[proxyRef.index] = -1;
+  ++killedCount;
+  proxy.isActive = false;
+}
+
+} // namespace Entity
\ No newline at end of file
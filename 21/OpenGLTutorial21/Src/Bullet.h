@@ -0,0 +1,137 @@
+/**
+* @file Bullet.h
+*/
+#ifndef OPENGLTUTORIAL_SRC_BULLET_H_INCLUDED
+#define OPENGLTUTORIAL_SRC_BULLET_H_INCLUDED
+#include "Entity.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <mutex>
+
+namespace Entity {
+
+typedef int BulletTypeId; ///< 弾の種類のID.
+
+/**
+* 弾の運動パターン.
+*
+* 波形と螺旋の揺れはXZ平面上で行う.
+*/
+enum class BulletPattern {
+  Linear, ///< 等速直線運動.
+  Aimed, ///< 発射時に目標の方を向き、param.yの強さで目標を追尾する. param.xは速さ.
+  Sine, ///< 速度の方向に進みながら、横方向に揺れる. param.xが振幅、param.yが角速度、param.zが初期位相.
+  Spiral, ///< 発射位置を中心に回転しながら広がる. param.xが初期角度、param.yが角速度、param.zが半径の増加速度.
+};
+static const int bulletPatternCount = 4; ///< 運動パターンの数.
+
+/**
+* 弾を発射するときのパラメータ.
+*/
+struct BulletParam
+{
+  BulletPattern pattern = BulletPattern::Linear; ///< 運動パターン.
+  glm::vec3 velocity = glm::vec3(0); ///< 速度. Aimedでは使われない.
+  float lifetime = 10; ///< 寿命(秒).
+  glm::vec3 param = glm::vec3(0); ///< 運動パターンごとのパラメータ.
+};
+
+/**
+* 弾の管理クラス.
+*
+* 弾はエンティティを使わず、種類と運動パターンごとの配列(SoA)に座標・速度・経過時間などを格納する.
+* 運動パターンごとに分けておくことで、分岐なしにSIMD命令で4個ずつ更新できる.
+* 寿命が尽きたか、Bounds()で指定した範囲の外に出た弾は更新のたびにまとめて削除される.
+*
+* 衝突判定はBuffer::CollisionHandler()で登録したハンドラをそのまま使う.
+* 相手のエンティティの衝突マスクに弾のグループが含まれていなければ判定しない.
+* ハンドラには弾の代わりに一時的なエンティティが渡される. このエンティティはハンドラの中でだけ有効で、
+* 座標・速度の変更とDestroy()による削除が弾に反映される. 弾同士の衝突判定は行わない.
+*
+* 描画は詰めて格納したインスタンスデータを使い、種類ごとに1回のインスタンス描画で行う.
+* そのため、Buffer::InstanceStore()でUniformBuffer以外を選んでいる場合だけ描画される.
+*/
+class BulletBuffer
+{
+  friend class Buffer;
+  friend class Entity;
+  friend class Snapshot;
+public:
+  BulletTypeId RegisterType(const Archetype& archetype, const glm::vec4& color, size_t capacity);
+  void ClearTypes();
+  bool Fire(BulletTypeId id, const glm::vec3& pos, const BulletParam& param);
+  void Target(BulletTypeId id, const glm::vec3& pos);
+  void Bounds(const glm::vec3& min, const glm::vec3& max) { boundsMin = min; boundsMax = max; }
+  void Clear();
+
+  size_t Count() const;
+  size_t PeakCount() const { return peakCount; }
+
+private:
+  BulletBuffer();
+  ~BulletBuffer() = default;
+  BulletBuffer(const BulletBuffer&) = delete;
+  BulletBuffer& operator=(const BulletBuffer&) = delete;
+
+  /// 運動パターンが等しい弾の配列. 長さは4の倍数に切り上げてあり、末尾の余った要素もまとめて処理する.
+  struct Lane {
+    size_t count = 0; ///< 存在する弾の数.
+    std::vector<float> posX, posY, posZ; ///< 座標.
+    std::vector<float> velX, velY, velZ; ///< 速度.
+    std::vector<float> orgX, orgY, orgZ; ///< 発射位置. 波形と螺旋で使う.
+    std::vector<float> age; ///< 発射からの経過時間.
+    std::vector<float> lifetime; ///< 寿命. 衝突で削除された弾は負数になる.
+    std::vector<float> paramX, paramY, paramZ; ///< 運動パターンごとのパラメータ.
+  };
+
+  /// 種類ごとの弾のプール.
+  struct Pool {
+    Archetype archetype; ///< 描画に使うリソース、グループID、衝突形状.
+    glm::vec4 color; ///< 色.
+    size_t capacity = 0; ///< 同時に存在できる数.
+    uint32_t serial = 0; ///< 登録ごとに異なる番号. 種類を登録し直したことを見分けるために使う.
+    size_t count = 0; ///< 存在する弾の数.
+    glm::vec3 target = glm::vec3(0); ///< Aimedの目標座標.
+    Lane lane[bulletPatternCount]; ///< 運動パターンごとの弾.
+  };
+
+  /// 衝突判定の対象となる弾.
+  struct BulletRef {
+    uint16_t pool; ///< プールの番号.
+    uint16_t lane; ///< 運動パターンの番号.
+    uint32_t index; ///< 配列内の位置.
+  };
+
+  void Update(double delta);
+  bool RemoveDead();
+  void Collide(int groupId, GroupStorage& other, bool isBulletLeft, const CollisionHandlerType& handler);
+  size_t WriteInstanceData(size_t poolIndex, Uniform::InstanceData* out) const;
+  void Kill(Entity& e);
+  static void UpdateLinear(Lane& lane, float dt);
+  static void UpdateAimed(Lane& lane, float dt, const glm::vec3& target);
+  static void UpdateSine(Lane& lane, float dt);
+  static void UpdateSpiral(Lane& lane, float dt);
+  static size_t RemoveDeadBullets(Lane& lane, const glm::vec3& min, const glm::vec3& max);
+
+  std::vector<Pool> poolList; ///< 種類ごとのプール.
+  uint32_t nextPoolSerial = 0; ///< 次に登録するプールの番号. ClearTypes()でも戻さない.
+  glm::vec3 boundsMin = glm::vec3(-1000); ///< 弾が存在できる範囲の最小座標.
+  glm::vec3 boundsMax = glm::vec3(1000); ///< 弾が存在できる範囲の最大座標.
+  std::mutex fireMutex; ///< 並列更新中の発射を保護する.
+  size_t peakCount = 0; ///< 同時に存在した弾の数の最大値.
+  size_t killedCount = 0; ///< 衝突処理で削除され、まだ配列に残っている弾の数.
+
+  Collision::SpatialGrid grid; ///< 衝突判定用の空間グリッド.
+  std::vector<BulletRef> refList; ///< 空間グリッドに登録した弾のリスト.
+  std::vector<uint32_t> candidateList; ///< 空間グリッドの検索結果.
+  Collision::PackedBoxList boxList; ///< refListの衝突形状.
+  Collision::PackedBoxList candidateBoxList; ///< candidateListの衝突形状.
+
+  GroupStorage proxyStorage; ///< ハンドラに渡すエンティティのデータ.
+  Entity proxy; ///< ハンドラに弾の代わりに渡すエンティティ.
+  BulletRef proxyRef; ///< proxyが表している弾.
+};
+
+} // namespace Entity
+
+#endif // OPENGLTUTORIAL_SRC_BULLET_H_INCLUDED
\ No newline at end of file
@@ -0,0 +1,1240 @@
+/**
+* @file Collision.cpp
+*/
+#include "Collision.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <limits>
+#include <cmath>
+#include <cfloat>
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define COLLISION_USE_SIMD
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define COLLISION_TARGET_AVX
+#else
+#define COLLISION_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+namespace Collision {
+
+static const int cellCoordBits = 21; ///< キーに格納するセル座標1軸あたりのビット数.
+static const int cellCoordBias = 1 << (cellCoordBits - 1); ///< セル座標を非負にするための補正値.
+static const int maxCellsPerElement = 64; ///< 1要素が記録されるセル数の上限. これを越える要素はlargeListに入れる.
+static const int maxCellsPerQuery = 512; ///< 1回の検索で調べるセル数の上限. これを越える場合は全要素を返す.
+
+/**
+* セル座標からキーを作成する.
+*
+* @param x セルのX座標.
+* @param y セルのY座標.
+* @param z セルのZ座標.
+*
+* @return セルを一意に識別するキー.
+*/
+uint64_t SpatialGrid::MakeKey(int x, int y, int z)
+{
+  const uint64_t mask = (1ULL << cellCoordBits) - 1;
+  return (static_cast<uint64_t>(x + cellCoordBias) & mask) |
+    ((static_cast<uint64_t>(y + cellCoordBias) & mask) << cellCoordBits) |
+    ((static_cast<uint64_t>(z + cellCoordBias) & mask) << (cellCoordBits * 2));
+}
+
+/**
+* 座標をセル座標に変換する.
+*
+* @param v 変換する座標.
+*
+* @return vを含むセルの座標.
+*/
+glm::ivec3 SpatialGrid::ToCell(const glm::vec3& v) const
+{
+  const float limit = static_cast<float>(cellCoordBias - 1);
+  glm::ivec3 cell;
+  for (int i = 0; i < 3; ++i) {
+    cell[i] = static_cast<int>(std::floor(glm::clamp(v[i] * reciprocalCellSize, -limit, limit)));
+  }
+  return cell;
+}
+
+/**
+* 全ての要素を削除し、セルの大きさを設定する.
+*
+* @param size セルの一辺の長さ.
+*/
+void SpatialGrid::Clear(float size)
+{
+  cellSize = size > 0 ? size : 1.0f;
+  reciprocalCellSize = 1.0f / cellSize;
+  cellList.clear();
+  largeList.clear();
+  idList.clear();
+}
+
+/**
+* 要素を登録する.
+*
+* @param id  要素ID. 検索結果としてこの値が返される.
+* @param min 要素を囲む直方体の最小座標.
+* @param max 要素を囲む直方体の最大座標.
+*
+* 全ての要素を登録したら、検索する前にBuild()を呼び出すこと.
+*/
+void SpatialGrid::Insert(uint32_t id, const glm::vec3& min, const glm::vec3& max)
+{
+  idList.push_back(id);
+  const glm::ivec3 cellMin = ToCell(min);
+  const glm::ivec3 cellMax = ToCell(max);
+  const glm::ivec3 cellCount = cellMax - cellMin + glm::ivec3(1);
+  if (static_cast<int64_t>(cellCount.x) * cellCount.y * cellCount.z > maxCellsPerElement) {
+    largeList.push_back(id);
+    return;
+  }
+  for (int z = cellMin.z; z <= cellMax.z; ++z) {
+    for (int y = cellMin.y; y <= cellMax.y; ++y) {
+      for (int x = cellMin.x; x <= cellMax.x; ++x) {
+        cellList.push_back({ MakeKey(x, y, z), id });
+      }
+    }
+  }
+}
+
+/**
+* 登録された要素を検索可能な状態にする.
+*/
+void SpatialGrid::Build()
+{
+  std::sort(cellList.begin(), cellList.end());
+}
+
+/**
+* 指定された範囲と重なる可能性のある要素を検索する.
+*
+* @param min    検索範囲の最小座標.
+* @param max    検索範囲の最大座標.
+* @param result 検索結果を格納する配列.
+*               要素IDが昇順かつ重複なしの状態で末尾に追加される.
+*
+* 結果には実際には重なっていない要素も含まれうるため、呼び出し側で詳細な判定を行うこと.
+*/
+void SpatialGrid::Query(const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& result) const
+{
+  const size_t first = result.size();
+  const glm::ivec3 cellMin = ToCell(min);
+  const glm::ivec3 cellMax = ToCell(max);
+  const glm::ivec3 cellCount = cellMax - cellMin + glm::ivec3(1);
+  if (static_cast<int64_t>(cellCount.x) * cellCount.y * cellCount.z > maxCellsPerQuery) {
+    result.insert(result.end(), idList.begin(), idList.end());
+  } else {
+    for (int z = cellMin.z; z <= cellMax.z; ++z) {
+      for (int y = cellMin.y; y <= cellMax.y; ++y) {
+        for (int x = cellMin.x; x <= cellMax.x; ++x) {
+          const uint64_t key = MakeKey(x, y, z);
+          auto itr = std::lower_bound(cellList.begin(), cellList.end(), Cell{ key, 0 });
+          for (; itr != cellList.end() && itr->key == key; ++itr) {
+            result.push_back(itr->id);
+          }
+        }
+      }
+    }
+    result.insert(result.end(), largeList.begin(), largeList.end());
+  }
+  std::sort(result.begin() + first, result.end());
+  result.erase(std::unique(result.begin() + first, result.end()), result.end());
+}
+
+/**
+* 総当たりと空間ハッシュで、2つのグループ間の衝突判定にかかる時間を計測する.
+*
+* @param minCount 最初に計測する要素数(2グループの合計).
+* @param maxCount 最後に計測する要素数(2グループの合計).
+*
+* 要素数を10倍ずつ増やしながら計測し、結果を標準出力に出力する.
+* 弾の撃ち合いを想定し、1辺1～2の直方体をXZ平面上にばらまく. 要素の密度が一定になるよう、
+* ばらまく範囲の面積は要素数に比例させる.
+* 両方の方法で見つかった衝突の数が一致しなければ、エラーとして標準エラーに出力する.
+*/
+void BenchmarkBroadphase(size_t minCount, size_t maxCount)
+{
+  typedef std::chrono::steady_clock Clock;
+  static const double minSeconds = 0.2; ///< 1つの計測にかける最小時間.
+
+  struct Box {
+    glm::vec3 min;
+    glm::vec3 max;
+  };
+  const auto hasCollision = [](const Box& lhs, const Box& rhs) {
+    return lhs.min.x <= rhs.max.x && lhs.max.x >= rhs.min.x &&
+      lhs.min.y <= rhs.max.y && lhs.max.y >= rhs.min.y &&
+      lhs.min.z <= rhs.max.z && lhs.max.z >= rhs.min.z;
+  };
+
+  // 時間がminSecondsを越えるまでfuncを繰り返し、1回あたりの時間を返す.
+  const auto measure = [](const auto& func) {
+    int count = 0;
+    const Clock::time_point start = Clock::now();
+    double seconds = 0;
+    do {
+      func();
+      ++count;
+      seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (seconds < minSeconds);
+    return seconds / count;
+  };
+
+  std::mt19937 rand(0);
+  std::vector<Box> listL;
+  std::vector<Box> listR;
+  SpatialGrid grid;
+  std::vector<uint32_t> candidateList;
+  for (size_t n = minCount; n <= maxCount; n *= 10) {
+    const float range = std::sqrt(static_cast<float>(n)) * 4.0f;
+    std::uniform_real_distribution<float> rndPos(-range * 0.5f, range * 0.5f);
+    std::uniform_real_distribution<float> rndSize(1.0f, 2.0f);
+    const auto randomBox = [&]() {
+      const glm::vec3 pos(rndPos(rand), 0, rndPos(rand));
+      const glm::vec3 size(rndSize(rand), rndSize(rand), rndSize(rand));
+      return Box{ pos - size * 0.5f, pos + size * 0.5f };
+    };
+    listL.clear();
+    listR.clear();
+    for (size_t i = 0; i < n / 2; ++i) {
+      listL.push_back(randomBox());
+      listR.push_back(randomBox());
+    }
+
+    size_t bruteForceHitCount = 0;
+    const double bruteForceSeconds = measure([&]() {
+      bruteForceHitCount = 0;
+      for (const Box& l : listL) {
+        for (const Box& r : listR) {
+          bruteForceHitCount += hasCollision(l, r);
+        }
+      }
+    });
+
+    // Entity::Buffer::Updateと同じく、両辺の衝突形状の平均的な大きさの2倍をセルの大きさにする.
+    size_t gridHitCount = 0;
+    const double gridSeconds = measure([&]() {
+      float totalSize = 0;
+      for (const std::vector<Box>* list : { &listL, &listR }) {
+        for (const Box& e : *list) {
+          const glm::vec3 size = e.max - e.min;
+          totalSize += std::max(size.x, std::max(size.y, size.z));
+        }
+      }
+      grid.Clear(totalSize / static_cast<float>(listL.size() + listR.size()) * 2.0f);
+      for (size_t i = 0; i < listR.size(); ++i) {
+        grid.Insert(static_cast<uint32_t>(i), listR[i].min, listR[i].max);
+      }
+      grid.Build();
+      gridHitCount = 0;
+      for (const Box& l : listL) {
+        candidateList.clear();
+        grid.Query(l.min, l.max, candidateList);
+        for (uint32_t id : candidateList) {
+          gridHitCount += hasCollision(l, listR[id]);
+        }
+      }
+    });
+
+    if (gridHitCount != bruteForceHitCount) {
+      std::cerr << "ERROR in Collision::BenchmarkBroadphase: 衝突の数が一致しません(総当たり=" <<
+        bruteForceHitCount << " 空間ハッシュ=" << gridHitCount << ")." << std::endl;
+    }
+    std::cout << "BenchmarkBroadphase: entities=" << n << " hits=" << gridHitCount <<
+      " bruteForce=" << bruteForceSeconds * 1000.0 << "ms grid=" << gridSeconds * 1000.0 << "ms" << std::endl;
+  }
+}
+
+/**
+* 要素数を変更する.
+*
+* @param n 新しい要素数.
+*
+* 配列はbatchSizeの倍数に切り上げた大きさ以上を確保し、最後のバッチの余りは何とも重ならない直方体で埋める.
+* 余りの座標はNaNにする. NaNとの比較は常に偽になるので、全空間を覆う直方体とも重ならない.
+* 配列が足りなければ現在の2倍以上に拡張する. 縮小はしない.
+*/
+void PackedBoxList::Resize(size_t n)
+{
+  count = n;
+  const size_t paddedSize = PaddedSize();
+  if (paddedSize > minX.size()) {
+    const size_t capacity = std::max(paddedSize, minX.size() * 2);
+    minX.resize(capacity);
+    minY.resize(capacity);
+    minZ.resize(capacity);
+    maxX.resize(capacity);
+    maxY.resize(capacity);
+    maxZ.resize(capacity);
+  }
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  for (size_t i = n; i < paddedSize; ++i) {
+    minX[i] = minY[i] = minZ[i] = nan;
+    maxX[i] = maxY[i] = maxZ[i] = nan;
+  }
+}
+
+/**
+* 全ての直方体を削除する.
+*/
+void PackedBoxList::Clear()
+{
+  Resize(0);
+}
+
+/**
+* 直方体を追加する.
+*
+* @param min 直方体の最小座標.
+* @param max 直方体の最大座標.
+*/
+void PackedBoxList::Push(const glm::vec3& min, const glm::vec3& max)
+{
+  const size_t i = count;
+  if (i % batchSize == 0) {
+    // 新しいバッチに入るときだけ、配列の確保と余りの埋め直しを行う.
+    Resize(i + 1);
+  } else {
+    ++count;
+  }
+  minX[i] = min.x;
+  minY[i] = min.y;
+  minZ[i] = min.z;
+  maxX[i] = max.x;
+  maxY[i] = max.y;
+  maxZ[i] = max.z;
+}
+
+/**
+* 他のリストから指定された直方体を集めて、このリストの内容とする.
+*
+* @param src     直方体を取り出すリスト.
+* @param indices 取り出す直方体のsrc内での位置の配列.
+* @param n       indicesの要素数.
+*/
+void PackedBoxList::Gather(const PackedBoxList& src, const uint32_t* indices, size_t n)
+{
+  Resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    const uint32_t j = indices[i];
+    minX[i] = src.minX[j];
+    minY[i] = src.minY[j];
+    minZ[i] = src.minZ[j];
+    maxX[i] = src.maxX[j];
+    maxY[i] = src.maxY[j];
+    maxZ[i] = src.maxZ[j];
+  }
+}
+
+/**
+* 直方体とリストの直方体の重なりを判定する(スカラー版).
+*
+* @param min   判定する直方体の最小座標.
+* @param max   判定する直方体の最大座標.
+* @param list  判定対象の直方体のリスト.
+* @param first 判定を開始するリスト内の位置. batchSizeの倍数であること.
+*
+* @return firstから始まるbatchSize個の直方体のうち、重なっているものに対応するビットを1にした値.
+*         ビット0がfirst番目の直方体に対応する.
+*/
+uint32_t TestOverlapScalar(const glm::vec3& min, const glm::vec3& max, const PackedBoxList& list, size_t first)
+{
+  uint32_t mask = 0;
+  for (size_t i = 0; i < PackedBoxList::batchSize; ++i) {
+    const size_t n = first + i;
+    if (list.minX[n] <= max.x && list.maxX[n] >= min.x &&
+      list.minY[n] <= max.y && list.maxY[n] >= min.y &&
+      list.minZ[n] <= max.z && list.maxZ[n] >= min.z) {
+      mask |= 1U << i;
+    }
+  }
+  return mask;
+}
+
+#ifdef COLLISION_USE_SIMD
+/**
+* 直方体と4個の直方体の重なりを判定する(SSE2版).
+*
+* @param box  判定する直方体の座標(最小XYZ, 最大XYZの順).
+* @param minX 判定対象の最小座標X成分の配列.
+* @param minY 判定対象の最小座標Y成分の配列.
+* @param minZ 判定対象の最小座標Z成分の配列.
+* @param maxX 判定対象の最大座標X成分の配列.
+* @param maxY 判定対象の最大座標Y成分の配列.
+* @param maxZ 判定対象の最大座標Z成分の配列.
+*
+* @return 重なっている直方体に対応するビットを1にした値.
+*/
+static uint32_t TestOverlap4Sse2(const __m128* box, const float* minX, const float* minY, const float* minZ, const float* maxX, const float* maxY, const float* maxZ)
+{
+  __m128 hit = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minX), box[3]), _mm_cmpge_ps(_mm_loadu_ps(maxX), box[0]));
+  hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minY), box[4]), _mm_cmpge_ps(_mm_loadu_ps(maxY), box[1])));
+  hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minZ), box[5]), _mm_cmpge_ps(_mm_loadu_ps(maxZ), box[2])));
+  return static_cast<uint32_t>(_mm_movemask_ps(hit));
+}
+
+/**
+* 直方体とリストの直方体の重なりを判定する(SSE2版).
+*
+* 引数と戻り値はTestOverlapScalar()と同じ.
+*/
+static uint32_t TestOverlapSse2(const glm::vec3& min, const glm::vec3& max, const float* const* v, size_t first)
+{
+  const __m128 box[6] = {
+    _mm_set1_ps(min.x), _mm_set1_ps(min.y), _mm_set1_ps(min.z),
+    _mm_set1_ps(max.x), _mm_set1_ps(max.y), _mm_set1_ps(max.z),
+  };
+  uint32_t mask = 0;
+  for (size_t i = 0; i < PackedBoxList::batchSize; i += 4) {
+    const size_t n = first + i;
+    mask |= TestOverlap4Sse2(box, v[0] + n, v[1] + n, v[2] + n, v[3] + n, v[4] + n, v[5] + n) << i;
+  }
+  return mask;
+}
+
+/**
+* 直方体とリストの直方体の重なりを判定する(AVX版).
+*
+* 引数と戻り値はTestOverlapScalar()と同じ.
+*/
+COLLISION_TARGET_AVX
+static uint32_t TestOverlapAvx(const glm::vec3& min, const glm::vec3& max, const float* const* v, size_t first)
+{
+  __m256 hit = _mm256_and_ps(
+    _mm256_cmp_ps(_mm256_loadu_ps(v[0] + first), _mm256_set1_ps(max.x), _CMP_LE_OQ),
+    _mm256_cmp_ps(_mm256_loadu_ps(v[3] + first), _mm256_set1_ps(min.x), _CMP_GE_OQ));
+  hit = _mm256_and_ps(hit, _mm256_and_ps(
+    _mm256_cmp_ps(_mm256_loadu_ps(v[1] + first), _mm256_set1_ps(max.y), _CMP_LE_OQ),
+    _mm256_cmp_ps(_mm256_loadu_ps(v[4] + first), _mm256_set1_ps(min.y), _CMP_GE_OQ)));
+  hit = _mm256_and_ps(hit, _mm256_and_ps(
+    _mm256_cmp_ps(_mm256_loadu_ps(v[2] + first), _mm256_set1_ps(max.z), _CMP_LE_OQ),
+    _mm256_cmp_ps(_mm256_loadu_ps(v[5] + first), _mm256_set1_ps(min.z), _CMP_GE_OQ)));
+  return static_cast<uint32_t>(_mm256_movemask_ps(hit));
+}
+
+/**
+* AVX命令が使用可能か調べる.
+*
+* @retval true  CPUとOSの両方がAVXに対応している.
+* @retval false AVXは使用できない.
+*/
+static bool IsAvxSupported()
+{
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 1);
+  const bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+  const bool hasAvx = (info[2] & (1 << 28)) != 0;
+  if (!hasOsxsave || !hasAvx) {
+    return false;
+  }
+  // OSがYMMレジスタを保存するか確認する.
+  return (_xgetbv(0) & 6) == 6;
+#else
+  return __builtin_cpu_supports("avx") != 0;
+#endif
+}
+#endif // COLLISION_USE_SIMD
+
+/// SIMD版判定関数の型.
+typedef uint32_t(*OverlapKernel)(const glm::vec3&, const glm::vec3&, const float* const*, size_t);
+
+/**
+* 実行中のCPUで使用可能な最速の判定関数を選択する.
+*
+* @return 判定関数へのポインタ. SIMD命令を使用できない場合はnullptr.
+*/
+static OverlapKernel SelectOverlapKernel()
+{
+#ifdef COLLISION_USE_SIMD
+  if (IsAvxSupported()) {
+    return TestOverlapAvx;
+  }
+  return TestOverlapSse2;
+#else
+  return nullptr;
+#endif
+}
+
+static const OverlapKernel overlapKernel = SelectOverlapKernel(); ///< TestOverlap()が使用する判定関数.
+
+/**
+* 直方体とリストの直方体の重なりを判定する.
+*
+* 引数と戻り値はTestOverlapScalar()と同じ.
+* 実行中のCPUに応じて、AVX版・SSE2版・スカラー版のいずれかを使用する.
+* 重なりの判定は境界を含む(接しているだけの場合も重なっているとみなす).
+*/
+uint32_t TestOverlap(const glm::vec3& min, const glm::vec3& max, const PackedBoxList& list, size_t first)
+{
+  if (!overlapKernel) {
+    return TestOverlapScalar(min, max, list, first);
+  }
+  const float* const v[6] = {
+    list.minX.data(), list.minY.data(), list.minZ.data(),
+    list.maxX.data(), list.maxY.data(), list.maxZ.data(),
+  };
+  return overlapKernel(min, max, v, first);
+}
+
+/**
+* TestOverlap()が使用している判定関数の名前を取得する.
+*
+* @return 判定関数の名前.
+*/
+const char* OverlapKernelName()
+{
+#ifdef COLLISION_USE_SIMD
+  if (overlapKernel == TestOverlapAvx) {
+    return "AVX";
+  } else if (overlapKernel == TestOverlapSse2) {
+    return "SSE2";
+  }
+#endif
+  return "Scalar";
+}
+
+/**
+* 実行中のCPUで使用可能な全てのSIMD版判定関数を取得する.
+*
+* @param nameList   判定関数の名前を格納する配列. 2要素以上であること.
+* @param kernelList 判定関数を格納する配列. 2要素以上であること.
+*
+* @return 格納した判定関数の数.
+*/
+static size_t AvailableOverlapKernels(const char** nameList, OverlapKernel* kernelList)
+{
+  size_t n = 0;
+#ifdef COLLISION_USE_SIMD
+  nameList[n] = "SSE2";
+  kernelList[n++] = TestOverlapSse2;
+  if (IsAvxSupported()) {
+    nameList[n] = "AVX";
+    kernelList[n++] = TestOverlapAvx;
+  }
+#endif
+  return n;
+}
+
+/**
+* SIMD版の判定関数の結果が、スカラー版とビット単位で一致するか検証する.
+*
+* @param seed       直方体を作る乱数の種.
+* @param iterations ランダムなリストで検証する回数.
+*
+* @retval true  全ての判定関数が全てのケースで一致した.
+* @retval false 一致しないケースがあった. 最初のいくつかを標準エラーに出力する.
+*
+* 座標を整数の格子に乗せたランダムな直方体に加えて、面で接する直方体、大きさのない直方体、
+* 全空間を覆う直方体、最小と最大が逆転した直方体、-0と+0で接する直方体を使う.
+* リストの長さはbatchSizeの倍数に限らず、firstもbatchSizeの倍数に限らず確保範囲内の全ての位置を試す.
+* 末尾の余りに対応するビットが、どの判定関数でも立たないことも確かめる.
+*/
+bool TestOverlapKernels(uint32_t seed, int iterations)
+{
+  const char* nameList[2];
+  OverlapKernel kernelList[2];
+  const size_t kernelCount = AvailableOverlapKernels(nameList, kernelList);
+
+  PackedBoxList list;
+  size_t caseCount = 0;
+  size_t errorCount = 0;
+  const auto report = [&errorCount](const char* name, const glm::vec3& min, const glm::vec3& max, size_t first, uint32_t expected, uint32_t actual) {
+    if (errorCount < 8) {
+      std::cerr << "ERROR in Collision::TestOverlapKernels: " << name << " first=" << first <<
+        " box=(" << min.x << "," << min.y << "," << min.z << ")-(" << max.x << "," << max.y << "," << max.z << ")" <<
+        " expected=0x" << std::hex << expected << " actual=0x" << actual << std::dec << std::endl;
+    }
+    ++errorCount;
+  };
+  const auto check = [&](const glm::vec3& min, const glm::vec3& max) {
+    const float* const v[6] = {
+      list.minX.data(), list.minY.data(), list.minZ.data(),
+      list.maxX.data(), list.maxY.data(), list.maxZ.data(),
+    };
+    const size_t capacity = list.PaddedSize();
+    for (size_t first = 0; first + PackedBoxList::batchSize <= capacity; ++first) {
+      const uint32_t expected = TestOverlapScalar(min, max, list, first);
+      uint32_t paddingMask = 0;
+      if (first + PackedBoxList::batchSize > list.Size()) {
+        const size_t valid = list.Size() > first ? list.Size() - first : 0;
+        paddingMask = (0xffU << valid) & 0xffU;
+      }
+      if (expected & paddingMask) {
+        report("Scalar(padding)", min, max, first, expected & ~paddingMask, expected);
+      }
+      for (size_t k = 0; k < kernelCount; ++k) {
+        const uint32_t actual = kernelList[k](min, max, v, first);
+        ++caseCount;
+        if (actual != expected) {
+          report(nameList[k], min, max, first, expected, actual);
+        }
+      }
+    }
+  };
+
+  std::mt19937 rand(seed);
+  std::uniform_int_distribution<int> rndCoord(-8, 8);
+  std::uniform_int_distribution<int> rndSize(0, 4);
+  std::uniform_int_distribution<size_t> rndCount(1, PackedBoxList::batchSize * 5 + 1);
+  const auto randomBox = [&](glm::vec3& min, glm::vec3& max) {
+    for (int i = 0; i < 3; ++i) {
+      min[i] = static_cast<float>(rndCoord(rand));
+      max[i] = min[i] + static_cast<float>(rndSize(rand));
+    }
+  };
+  for (int n = 0; n < iterations; ++n) {
+    list.Clear();
+    const size_t count = rndCount(rand);
+    for (size_t i = 0; i < count; ++i) {
+      glm::vec3 min, max;
+      randomBox(min, max);
+      if (i == 0 && n % 2) {
+        min.x = max.x = -0.0f; // +0と-0で接するケースを作る.
+      }
+      list.Push(min, max);
+    }
+
+    // ランダムな直方体.
+    for (int i = 0; i < 16; ++i) {
+      glm::vec3 min, max;
+      randomBox(min, max);
+      check(min, max);
+    }
+
+    // リスト内の直方体自身と、その各面に外側から接する直方体.
+    const size_t target = rand() % count;
+    const glm::vec3 boxMin(list.minX[target], list.minY[target], list.minZ[target]);
+    const glm::vec3 boxMax(list.maxX[target], list.maxY[target], list.maxZ[target]);
+    check(boxMin, boxMax);
+    for (int axis = 0; axis < 3; ++axis) {
+      glm::vec3 min = boxMin;
+      glm::vec3 max = boxMax;
+      min[axis] = boxMax[axis];
+      max[axis] = boxMax[axis] + 1;
+      check(min, max);
+      min = boxMin;
+      max = boxMax;
+      max[axis] = boxMin[axis];
+      min[axis] = boxMin[axis] - 1;
+      check(min, max);
+    }
+
+    // 特殊な直方体.
+    check(glm::vec3(-FLT_MAX), glm::vec3(FLT_MAX));
+    check(glm::vec3(0), glm::vec3(0));
+    check(glm::vec3(0.0f), glm::vec3(-0.0f));
+    check(glm::vec3(2), glm::vec3(-2));
+  }
+
+  std::cout << "TestOverlapKernels: kernels=" << kernelCount << " cases=" << caseCount << " errors=" << errorCount << std::endl;
+  return errorCount == 0;
+}
+
+/**
+* 判定関数ごとに、直方体とリストの重なりの判定にかかる時間を計測する.
+*
+* @param boxCount   リストの直方体の数.
+* @param iterations リスト全体を判定する回数.
+*
+* 結果は直方体1個あたりの時間として標準出力に出力する.
+*/
+void BenchmarkOverlapKernels(size_t boxCount, int iterations)
+{
+  typedef std::chrono::steady_clock Clock;
+  static const size_t queryCount = 64;
+
+  std::mt19937 rand(0);
+  std::uniform_real_distribution<float> rndPos(-100, 100);
+  std::uniform_real_distribution<float> rndSize(1, 4);
+  const auto randomBox = [&](glm::vec3& min, glm::vec3& max) {
+    for (int i = 0; i < 3; ++i) {
+      min[i] = rndPos(rand);
+      max[i] = min[i] + rndSize(rand);
+    }
+  };
+  PackedBoxList list;
+  for (size_t i = 0; i < boxCount; ++i) {
+    glm::vec3 min, max;
+    randomBox(min, max);
+    list.Push(min, max);
+  }
+  glm::vec3 queryMin[queryCount];
+  glm::vec3 queryMax[queryCount];
+  for (size_t i = 0; i < queryCount; ++i) {
+    randomBox(queryMin[i], queryMax[i]);
+    queryMax[i] += glm::vec3(20);
+  }
+
+  const double testCount = static_cast<double>(list.PaddedSize()) * static_cast<double>(iterations) * queryCount;
+  uint32_t hitCount = 0;
+  const auto measure = [&](const char* name, const OverlapKernel kernel) {
+    const float* const v[6] = {
+      list.minX.data(), list.minY.data(), list.minZ.data(),
+      list.maxX.data(), list.maxY.data(), list.maxZ.data(),
+    };
+    const Clock::time_point start = Clock::now();
+    for (int n = 0; n < iterations; ++n) {
+      for (size_t q = 0; q < queryCount; ++q) {
+        for (size_t first = 0; first < list.Size(); first += PackedBoxList::batchSize) {
+          const uint32_t mask = kernel ? kernel(queryMin[q], queryMax[q], v, first) : TestOverlapScalar(queryMin[q], queryMax[q], list, first);
+          hitCount += mask != 0;
+        }
+      }
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << " " << name << "=" << seconds * 1e9 / testCount << "ns";
+  };
+
+  const char* nameList[2];
+  OverlapKernel kernelList[2];
+  const size_t kernelCount = AvailableOverlapKernels(nameList, kernelList);
+  std::cout << "BenchmarkOverlapKernels: boxes=" << boxCount << " per box:";
+  measure("Scalar", nullptr);
+  for (size_t k = 0; k < kernelCount; ++k) {
+    measure(nameList[k], kernelList[k]);
+  }
+  std::cout << " selected=" << OverlapKernelName() << " (hits=" << hitCount << ")" << std::endl;
+}
+
+static const size_t treeStackSize = 256; ///< AabbTreeの検索に使う作業用スタックの、固定長の部分の大きさ.
+
+/**
+* AabbTreeの検索に使う作業用スタック.
+*
+* 通常は固定長の配列に積み、溢れた分だけvectorに積む. 溢れても部分木を取りこぼすことはない.
+* 検索ごとに作るので、複数のスレッドから同時に検索しても競合しない.
+*/
+class TreeStack
+{
+public:
+  TreeStack() = default;
+  TreeStack(const TreeStack&) = delete;
+  TreeStack& operator=(const TreeStack&) = delete;
+
+  bool Empty() const { return top == 0; }
+  void Push(int32_t index) {
+    if (top < treeStackSize) {
+      buffer[top] = index;
+    } else {
+      overflow.push_back(index);
+    }
+    ++top;
+  }
+  int32_t Pop() {
+    --top;
+    if (top < treeStackSize) {
+      return buffer[top];
+    }
+    const int32_t index = overflow.back();
+    overflow.pop_back();
+    return index;
+  }
+
+private:
+  int32_t buffer[treeStackSize]; ///< 固定長の部分.
+  std::vector<int32_t> overflow; ///< 固定長の部分から溢れた分.
+  size_t top = 0; ///< 積んでいる要素の数.
+};
+
+/**
+* 直方体の表面積を計算する.
+*
+* @param min 直方体の最小座標.
+* @param max 直方体の最大座標.
+*
+* @return 表面積.
+*/
+static float SurfaceArea(const glm::vec3& min, const glm::vec3& max)
+{
+  const glm::vec3 d = max - min;
+  return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+/**
+* 点と直方体の距離の2乗を計算する.
+*
+* @param p   点の座標.
+* @param min 直方体の最小座標.
+* @param max 直方体の最大座標.
+*
+* @return 距離の2乗. 点が直方体の内部にあれば0.
+*/
+float DistanceSquared(const glm::vec3& p, const glm::vec3& min, const glm::vec3& max)
+{
+  const glm::vec3 d = glm::max(glm::max(min - p, glm::vec3(0)), p - max);
+  return glm::dot(d, d);
+}
+
+/**
+* 半直線と直方体の交差を判定する.
+*
+* @param origin      半直線の始点.
+* @param invDir      半直線の方向の各成分の逆数.
+* @param maxDistance 判定する最大距離.
+* @param min         直方体の最小座標.
+* @param max         直方体の最大座標.
+* @param distance    交差する場合、始点から直方体に入るまでの距離を格納する変数.
+*
+* @retval true  交差している.
+* @retval false 交差していない.
+*/
+bool TestRay(const glm::vec3& origin, const glm::vec3& invDir, float maxDistance, const glm::vec3& min, const glm::vec3& max, float& distance)
+{
+  const glm::vec3 t0 = (min - origin) * invDir;
+  const glm::vec3 t1 = (max - origin) * invDir;
+  const glm::vec3 tMin = glm::min(t0, t1);
+  const glm::vec3 tMax = glm::max(t0, t1);
+  const float enter = std::max(0.0f, std::max(tMin.x, std::max(tMin.y, tMin.z)));
+  const float exit = std::min(maxDistance, std::min(tMax.x, std::min(tMax.y, tMax.z)));
+  distance = enter;
+  return enter <= exit;
+}
+
+/**
+* 要素を追加する.
+*
+* @param min      要素を囲む直方体の最小座標.
+* @param max      要素を囲む直方体の最大座標.
+* @param userData 要素を指すポインタ. 検索結果としてこの値が渡される.
+* @param category 要素のカテゴリ. 検索時のマスクと論理積が0でなければ検索対象になる.
+*
+* @return 要素を格納した葉の番号. Move()やRemove()に渡す.
+*/
+int32_t AabbTree::Insert(const glm::vec3& min, const glm::vec3& max, void* userData, uint32_t category)
+{
+  const int32_t leaf = AllocateNode();
+  Node& n = nodeList[leaf];
+  n.min = min - glm::vec3(margin);
+  n.max = max + glm::vec3(margin);
+  n.userData = userData;
+  n.category = category;
+  InsertLeaf(leaf);
+  ++leafCount;
+  return leaf;
+}
+
+/**
+* 要素を削除する.
+*
+* @param proxy Insert()が返した葉の番号.
+*/
+void AabbTree::Remove(int32_t proxy)
+{
+  RemoveLeaf(proxy);
+  FreeNode(proxy);
+  --leafCount;
+}
+
+/**
+* 要素の直方体を更新する.
+*
+* @param proxy Insert()が返した葉の番号.
+* @param min   要素を囲む直方体の新しい最小座標.
+* @param max   要素を囲む直方体の新しい最大座標.
+*
+* @retval true  拡張した直方体からはみ出したので、挿入し直した.
+* @retval false 拡張した直方体の内部にあるので、木は変更していない.
+*/
+bool AabbTree::Move(int32_t proxy, const glm::vec3& min, const glm::vec3& max)
+{
+  Node& n = nodeList[proxy];
+  if (glm::all(glm::lessThanEqual(n.min, min)) && glm::all(glm::lessThanEqual(max, n.max))) {
+    return false;
+  }
+  RemoveLeaf(proxy);
+  n.min = min - glm::vec3(margin);
+  n.max = max + glm::vec3(margin);
+  InsertLeaf(proxy);
+  return true;
+}
+
+/**
+* 全ての要素を削除する.
+*/
+void AabbTree::Clear()
+{
+  nodeList.clear();
+  root = nullNode;
+  freeNode = nullNode;
+  leafCount = 0;
+}
+
+/**
+* ノードを確保する.
+*
+* @return 確保したノードの番号.
+*
+* ノードの配列が拡張されることがあるため、呼び出し前に取得したノードへの参照は無効になる.
+*/
+int32_t AabbTree::AllocateNode()
+{
+  int32_t index = freeNode;
+  if (index == nullNode) {
+    index = static_cast<int32_t>(nodeList.size());
+    nodeList.push_back(Node());
+  } else {
+    freeNode = nodeList[index].parent;
+  }
+  Node& n = nodeList[index];
+  n.parent = nullNode;
+  n.child[0] = n.child[1] = nullNode;
+  n.height = 0;
+  n.userData = nullptr;
+  n.category = 0;
+  return index;
+}
+
+/**
+* ノードを未使用ノードのリストに戻す.
+*
+* @param index 戻すノードの番号.
+*/
+void AabbTree::FreeNode(int32_t index)
+{
+  Node& n = nodeList[index];
+  n.parent = freeNode;
+  n.height = -1;
+  freeNode = index;
+}
+
+/**
+* 葉を木に挿入する.
+*
+* @param leaf 挿入する葉の番号.
+*
+* 葉と兄弟にしたときに増える表面積が最小になるノードを探し、そのノードと葉の親となるノードを追加する.
+*/
+void AabbTree::InsertLeaf(int32_t leaf)
+{
+  if (root == nullNode) {
+    root = leaf;
+    nodeList[leaf].parent = nullNode;
+    return;
+  }
+
+  const glm::vec3 leafMin = nodeList[leaf].min;
+  const glm::vec3 leafMax = nodeList[leaf].max;
+  int32_t index = root;
+  while (!IsLeaf(index)) {
+    const Node& n = nodeList[index];
+    const float area = SurfaceArea(n.min, n.max);
+    const float combinedArea = SurfaceArea(glm::min(n.min, leafMin), glm::max(n.max, leafMax));
+    // このノードを兄弟にする場合のコストと、子孫に下りる場合にこのノードが大きくなる分のコスト.
+    const float cost = 2.0f * combinedArea;
+    const float inheritanceCost = 2.0f * (combinedArea - area);
+    float childCost[2];
+    for (int i = 0; i < 2; ++i) {
+      const Node& c = nodeList[n.child[i]];
+      const float a = SurfaceArea(glm::min(c.min, leafMin), glm::max(c.max, leafMax));
+      childCost[i] = (IsLeaf(n.child[i]) ? a : a - SurfaceArea(c.min, c.max)) + inheritanceCost;
+    }
+    if (cost < childCost[0] && cost < childCost[1]) {
+      break;
+    }
+    index = childCost[0] < childCost[1] ? n.child[0] : n.child[1];
+  }
+
+  const int32_t sibling = index;
+  const int32_t oldParent = nodeList[sibling].parent;
+  const int32_t newParent = AllocateNode();
+  Node& p = nodeList[newParent];
+  p.parent = oldParent;
+  p.child[0] = sibling;
+  p.child[1] = leaf;
+  if (oldParent != nullNode) {
+    Node& op = nodeList[oldParent];
+    op.child[op.child[0] == sibling ? 0 : 1] = newParent;
+  } else {
+    root = newParent;
+  }
+  nodeList[sibling].parent = newParent;
+  nodeList[leaf].parent = newParent;
+
+  // 親をたどって直方体と高さを更新する.
+  for (int32_t i = newParent; i != nullNode; i = nodeList[i].parent) {
+    Refit(i);
+    i = Balance(i);
+  }
+}
+
+/**
+* 葉を木から取り外す.
+*
+* @param leaf 取り外す葉の番号.
+*
+* 葉の親ノードは削除され、兄弟ノードが親の位置に移動する.
+*/
+void AabbTree::RemoveLeaf(int32_t leaf)
+{
+  if (leaf == root) {
+    root = nullNode;
+    return;
+  }
+  const int32_t parent = nodeList[leaf].parent;
+  const int32_t grandParent = nodeList[parent].parent;
+  const int32_t sibling = nodeList[parent].child[nodeList[parent].child[0] == leaf ? 1 : 0];
+  nodeList[leaf].parent = nullNode;
+  FreeNode(parent);
+  if (grandParent == nullNode) {
+    root = sibling;
+    nodeList[sibling].parent = nullNode;
+    return;
+  }
+  Node& g = nodeList[grandParent];
+  g.child[g.child[0] == parent ? 0 : 1] = sibling;
+  nodeList[sibling].parent = grandParent;
+  for (int32_t i = grandParent; i != nullNode; i = nodeList[i].parent) {
+    Refit(i);
+    i = Balance(i);
+  }
+}
+
+/**
+* 子の高さの差が1より大きければ、高い方の子を持ち上げる.
+*
+* @param index 調べるノードの番号.
+*
+* @return 回転後にindexの位置にあるノードの番号.
+*/
+int32_t AabbTree::Balance(int32_t index)
+{
+  Node& a = nodeList[index];
+  if (IsLeaf(index) || a.height < 2) {
+    return index;
+  }
+  const int32_t diff = nodeList[a.child[1]].height - nodeList[a.child[0]].height;
+  if (diff >= -1 && diff <= 1) {
+    return index;
+  }
+
+  // 高い方の子Cを親の位置に移動し、Aを子にする.
+  const int side = diff > 1 ? 1 : 0;
+  const int32_t iC = a.child[side];
+  Node& c = nodeList[iC];
+  const int32_t iF = c.child[0];
+  const int32_t iG = c.child[1];
+  c.child[0] = index;
+  c.parent = a.parent;
+  a.parent = iC;
+  if (c.parent != nullNode) {
+    Node& p = nodeList[c.parent];
+    p.child[p.child[0] == index ? 0 : 1] = iC;
+  } else {
+    root = iC;
+  }
+
+  // Cの子のうち、高い方をCに残し、低い方をAに移す.
+  if (nodeList[iF].height > nodeList[iG].height) {
+    c.child[1] = iF;
+    a.child[side] = iG;
+    nodeList[iG].parent = index;
+  } else {
+    c.child[1] = iG;
+    a.child[side] = iF;
+    nodeList[iF].parent = index;
+  }
+  Refit(index);
+  Refit(iC);
+  return iC;
+}
+
+/**
+* 子ノードから直方体・高さ・カテゴリを計算し直す.
+*
+* @param index 計算するノードの番号.
+*/
+void AabbTree::Refit(int32_t index)
+{
+  Node& n = nodeList[index];
+  const Node& c0 = nodeList[n.child[0]];
+  const Node& c1 = nodeList[n.child[1]];
+  n.min = glm::min(c0.min, c1.min);
+  n.max = glm::max(c0.max, c1.max);
+  n.height = 1 + std::max(c0.height, c1.height);
+  n.category = c0.category | c1.category;
+}
+
+/**
+* 指定された範囲と重なる可能性のある要素を検索する.
+*
+* @param min          検索範囲の最小座標.
+* @param max          検索範囲の最大座標.
+* @param categoryMask 検索するカテゴリのマスク.
+* @param visitor      見つかった要素を受け取る関数.
+*
+* @return 調べたノードの数.
+*
+* 拡張した直方体で判定するため、実際には重なっていない要素も渡されうる.
+*/
+size_t AabbTree::Query(const glm::vec3& min, const glm::vec3& max, uint32_t categoryMask, const QueryVisitorType& visitor) const
+{
+  if (root == nullNode) {
+    return 0;
+  }
+  TreeStack stack;
+  size_t visited = 0;
+  stack.Push(root);
+  while (!stack.Empty()) {
+    const int32_t index = stack.Pop();
+    const Node& n = nodeList[index];
+    ++visited;
+    if (!(n.category & categoryMask) ||
+      glm::any(glm::greaterThan(n.min, max)) || glm::any(glm::lessThan(n.max, min))) {
+      continue;
+    }
+    if (IsLeaf(index)) {
+      if (!visitor(n.userData)) {
+        break;
+      }
+      continue;
+    }
+    stack.Push(n.child[0]);
+    stack.Push(n.child[1]);
+  }
+  return visited;
+}
+
+/**
+* 指定された点から一定の距離にある要素を、近いノードから順に検索する.
+*
+* @param center       検索の中心座標.
+* @param maxDistance  検索する最大距離.
+* @param categoryMask 検索するカテゴリのマスク.
+* @param visitor      見つかった要素を受け取る関数. 戻り値が新しい最大距離になる.
+*
+* @return 調べたノードの数.
+*
+* 拡張した直方体で判定するため、実際には最大距離より遠い要素も渡されうる.
+* 近いk個の要素を探す場合は、k個見つかった時点でk番目の距離を返せば、それより遠いノードは調べずに済む.
+*/
+size_t AabbTree::QueryNearest(const glm::vec3& center, float maxDistance, uint32_t categoryMask, const DistanceVisitorType& visitor) const
+{
+  if (root == nullNode) {
+    return 0;
+  }
+  TreeStack stack;
+  size_t visited = 0;
+  stack.Push(root);
+  while (!stack.Empty()) {
+    const int32_t index = stack.Pop();
+    const Node& n = nodeList[index];
+    ++visited;
+    if (!(n.category & categoryMask) || DistanceSquared(center, n.min, n.max) > maxDistance * maxDistance) {
+      continue;
+    }
+    if (IsLeaf(index)) {
+      maxDistance = std::min(maxDistance, visitor(n.userData, maxDistance));
+      continue;
+    }
+    // 近い方の子を先に調べるため、遠い方から積む.
+    const Node& c0 = nodeList[n.child[0]];
+    const Node& c1 = nodeList[n.child[1]];
+    const bool isNearFirst = DistanceSquared(center, c0.min, c0.max) <= DistanceSquared(center, c1.min, c1.max);
+    stack.Push(n.child[isNearFirst ? 1 : 0]);
+    stack.Push(n.child[isNearFirst ? 0 : 1]);
+  }
+  return visited;
+}
+
+/**
+* 半直線と交差する可能性のある要素を、始点に近いノードから順に検索する.
+*
+* @param origin       半直線の始点.
+* @param direction    半直線の方向. 単位ベクトルであること.
+* @param maxDistance  検索する最大距離.
+* @param categoryMask 検索するカテゴリのマスク.
+* @param visitor      見つかった要素を受け取る関数. 交差していれば交点までの距離、していなければ最大距離を返す.
+*
+* @return 調べたノードの数.
+*/
+size_t AabbTree::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, uint32_t categoryMask, const DistanceVisitorType& visitor) const
+{
+  if (root == nullNode) {
+    return 0;
+  }
+  const glm::vec3 invDir = 1.0f / direction;
+  TreeStack stack;
+  size_t visited = 0;
+  stack.Push(root);
+  while (!stack.Empty()) {
+    const int32_t index = stack.Pop();
+    const Node& n = nodeList[index];
+    ++visited;
+    float distance;
+    if (!(n.category & categoryMask) || !TestRay(origin, invDir, maxDistance, n.min, n.max, distance)) {
+      continue;
+    }
+    if (IsLeaf(index)) {
+      maxDistance = std::min(maxDistance, visitor(n.userData, maxDistance));
+      continue;
+    }
+    // 始点に近い方の子を先に調べるため、遠い方から積む.
+    const Node& c0 = nodeList[n.child[0]];
+    const Node& c1 = nodeList[n.child[1]];
+    float d0 = FLT_MAX;
+    float d1 = FLT_MAX;
+    TestRay(origin, invDir, maxDistance, c0.min, c0.max, d0);
+    TestRay(origin, invDir, maxDistance, c1.min, c1.max, d1);
+    const bool isNearFirst = d0 <= d1;
+    stack.Push(n.child[isNearFirst ? 1 : 0]);
+    stack.Push(n.child[isNearFirst ? 0 : 1]);
+  }
+  return visited;
+}
+
+/**
+* ビュー・プロジェクション行列から視錐台を作成する.
+*
+* @param matVP ビュー・プロジェクション行列.
+*
+* @return ワールド座標系の視錐台.
+*/
+Frustum CreateFrustum(const glm::mat4& matVP)
+{
+  const glm::vec4 row[4] = {
+    glm::vec4(matVP[0][0], matVP[1][0], matVP[2][0], matVP[3][0]),
+    glm::vec4(matVP[0][1], matVP[1][1], matVP[2][1], matVP[3][1]),
+    glm::vec4(matVP[0][2], matVP[1][2], matVP[2][2], matVP[3][2]),
+    glm::vec4(matVP[0][3], matVP[1][3], matVP[2][3], matVP[3][3]),
+  };
+  Frustum f;
+  f.plane[0] = row[3] + row[0];
+  f.plane[1] = row[3] - row[0];
+  f.plane[2] = row[3] + row[1];
+  f.plane[3] = row[3] - row[1];
+  f.plane[4] = row[3] + row[2];
+  f.plane[5] = row[3] - row[2];
+  for (glm::vec4& e : f.plane) {
+    e /= glm::length(glm::vec3(e));
+  }
+  return f;
+}
+
+/**
+* 球が視錐台と重なっているか調べる.
+*
+* @param frustum 視錐台.
+* @param center  球の中心.
+* @param radius  球の半径.
+*
+* @retval true  重なっている(または判定できないほど近い).
+* @retval false 完全に視錐台の外側にある.
+*/
+bool TestSphere(const Frustum& frustum, const glm::vec3& center, float radius)
+{
+  for (const glm::vec4& e : frustum.plane) {
+    if (glm::dot(glm::vec3(e), center) + e.w < -radius) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace Collision
\ No newline at end of file
@@ -0,0 +1,173 @@
+/**
+* @file Collision.h
+*/
+#ifndef COLLISION_H_INCLUDED
+#define COLLISION_H_INCLUDED
+#include "InlineFunction.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+/**
+* 衝突判定の補助機能を格納する名前空間.
+*/
+namespace Collision {
+
+/**
+* 一様グリッドによる空間ハッシュ.
+*
+* 登録された直方体を、それと重なる全てのセルに記録する.
+* 検索時は、指定範囲と重なるセルに記録された要素だけを列挙する.
+* 総当たりでO(N*M)かかる判定を、おおむねO(N+M)に減らすために使う.
+*/
+class SpatialGrid
+{
+public:
+  void Clear(float cellSize);
+  void Insert(uint32_t id, const glm::vec3& min, const glm::vec3& max);
+  void Build();
+  void Query(const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& result) const;
+  float CellSize() const { return cellSize; }
+
+private:
+  /// セルと要素の組.
+  struct Cell {
+    uint64_t key; ///< セル座標から作成したキー.
+    uint32_t id; ///< 要素ID.
+    bool operator<(const Cell& rhs) const { return key < rhs.key || (key == rhs.key && id < rhs.id); }
+  };
+  static uint64_t MakeKey(int x, int y, int z);
+  glm::ivec3 ToCell(const glm::vec3& v) const;
+
+  float cellSize = 1.0f; ///< セルの一辺の長さ.
+  float reciprocalCellSize = 1.0f; ///< セルの一辺の長さの逆数.
+  std::vector<Cell> cellList; ///< セルと要素の組のリスト. Build()によってキー順に整列される.
+  std::vector<uint32_t> largeList; ///< 多数のセルにまたがるため、常に検索結果に含める要素のリスト.
+  std::vector<uint32_t> idList; ///< 登録された全要素のリスト.
+};
+
+void BenchmarkBroadphase(size_t minCount, size_t maxCount);
+
+/**
+* SIMD命令でまとめて判定できるよう、軸ごとの配列に詰め込んだ直方体のリスト.
+*
+* 配列はbatchSizeの倍数に切り上げて確保され、最後のバッチの余りには何とも重ならない直方体(座標がNaN)が入る.
+* 追加を繰り返しても再確保の回数が増えないよう、配列は倍々に拡張する.
+*/
+class PackedBoxList
+{
+public:
+  static const size_t batchSize = 8; ///< TestOverlap()が一度に判定する直方体の数.
+
+  void Clear();
+  void Push(const glm::vec3& min, const glm::vec3& max);
+  void Gather(const PackedBoxList& src, const uint32_t* indices, size_t n);
+  size_t Size() const { return count; }
+
+private:
+  friend uint32_t TestOverlap(const glm::vec3&, const glm::vec3&, const PackedBoxList&, size_t);
+  friend uint32_t TestOverlapScalar(const glm::vec3&, const glm::vec3&, const PackedBoxList&, size_t);
+  friend bool TestOverlapKernels(uint32_t, int);
+  friend void BenchmarkOverlapKernels(size_t, int);
+  void Resize(size_t n);
+  size_t PaddedSize() const { return (count + batchSize - 1) / batchSize * batchSize; }
+
+  size_t count = 0; ///< 格納されている直方体の数.
+  std::vector<float> minX; ///< 最小座標のX成分.
+  std::vector<float> minY; ///< 最小座標のY成分.
+  std::vector<float> minZ; ///< 最小座標のZ成分.
+  std::vector<float> maxX; ///< 最大座標のX成分.
+  std::vector<float> maxY; ///< 最大座標のY成分.
+  std::vector<float> maxZ; ///< 最大座標のZ成分.
+};
+
+uint32_t TestOverlap(const glm::vec3& min, const glm::vec3& max, const PackedBoxList& list, size_t first);
+uint32_t TestOverlapScalar(const glm::vec3& min, const glm::vec3& max, const PackedBoxList& list, size_t first);
+const char* OverlapKernelName();
+bool TestOverlapKernels(uint32_t seed, int iterations);
+void BenchmarkOverlapKernels(size_t boxCount, int iterations);
+
+/**
+* 動的AABBツリー.
+*
+* 要素を囲む直方体を少し拡張して葉に格納し、内部ノードは子を囲む直方体を持つ二分木.
+* 要素が拡張した直方体の中で動いている間は木を変更せず、はみ出したときだけ葉を取り外して挿入し直す.
+* 挿入時は表面積が最小になる位置を選び、回転によって高さの偏りを抑える.
+*
+* 葉には要素を指すポインタと、検索の絞り込みに使うカテゴリ(ビットマスク)を格納する.
+* 内部ノードは子孫のカテゴリの論理和を持つので、対象外のカテゴリしか含まない部分木は調べずに済む.
+* 検索は木を変更せず、作業領域も検索ごとに用意するため、複数のスレッドから同時に呼び出せる.
+*/
+class AabbTree
+{
+public:
+  /// 検索範囲と重なる要素を受け取る関数. falseを返すと検索を打ち切る.
+  typedef InlineFunction<bool(void*), 64> QueryVisitorType;
+
+  /**
+  * 距離で絞り込む検索で要素を受け取る関数.
+  *
+  * 引数は要素を指すポインタと現在の最大距離. 戻り値は新しい最大距離で、これより遠いノードは調べなくなる.
+  */
+  typedef InlineFunction<float(void*, float), 64> DistanceVisitorType;
+
+  static const int32_t nullNode = -1; ///< ノードが存在しないことを示す番号.
+
+  explicit AabbTree(float margin = 1.0f) : margin(margin) {}
+
+  int32_t Insert(const glm::vec3& min, const glm::vec3& max, void* userData, uint32_t category);
+  void Remove(int32_t proxy);
+  bool Move(int32_t proxy, const glm::vec3& min, const glm::vec3& max);
+  void Clear();
+  size_t Size() const { return leafCount; }
+  int Height() const { return root == nullNode ? 0 : nodeList[root].height; }
+
+  size_t Query(const glm::vec3& min, const glm::vec3& max, uint32_t categoryMask, const QueryVisitorType& visitor) const;
+  size_t QueryNearest(const glm::vec3& center, float maxDistance, uint32_t categoryMask, const DistanceVisitorType& visitor) const;
+  size_t Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, uint32_t categoryMask, const DistanceVisitorType& visitor) const;
+
+private:
+  /// 木のノード.
+  struct Node {
+    glm::vec3 min; ///< 葉なら拡張した要素の直方体、内部ノードなら子を囲む直方体の最小座標.
+    glm::vec3 max; ///< 同じく最大座標.
+    int32_t parent; ///< 親ノード. 未使用のノードでは次の未使用ノード.
+    int32_t child[2]; ///< 子ノード. 葉ならnullNode.
+    int32_t height; ///< 葉からの高さ. 葉は0、未使用のノードは-1.
+    void* userData; ///< 葉に格納した要素を指すポインタ.
+    uint32_t category; ///< 葉なら要素のカテゴリ、内部ノードなら子孫のカテゴリの論理和.
+  };
+
+  int32_t AllocateNode();
+  void FreeNode(int32_t index);
+  void InsertLeaf(int32_t leaf);
+  void RemoveLeaf(int32_t leaf);
+  int32_t Balance(int32_t index);
+  void Refit(int32_t index);
+  bool IsLeaf(int32_t index) const { return nodeList[index].child[0] == nullNode; }
+
+  std::vector<Node> nodeList; ///< ノードの配列.
+  int32_t root = nullNode; ///< 根ノード.
+  int32_t freeNode = nullNode; ///< 未使用ノードのリストの先頭.
+  size_t leafCount = 0; ///< 格納している要素の数.
+  float margin; ///< 葉に格納するときに直方体を拡張する幅.
+};
+
+/**
+* 視錐台.
+*
+* 各平面はxyzが内向きの単位法線、wが原点からの距離を表す.
+*/
+struct Frustum
+{
+  glm::vec4 plane[6]; ///< 左・右・下・上・手前・奥の平面.
+};
+
+Frustum CreateFrustum(const glm::mat4& matVP);
+bool TestSphere(const Frustum& frustum, const glm::vec3& center, float radius);
+float DistanceSquared(const glm::vec3& p, const glm::vec3& min, const glm::vec3& max);
+bool TestRay(const glm::vec3& origin, const glm::vec3& invDir, float maxDistance, const glm::vec3& min, const glm::vec3& max, float& distance);
+
+} // namespace Collision
+
+#endif // COLLISION_H_INCLUDED
\ No newline at end of file
@@ -1,414 +1,2643 @@
-/**
-* @file Entity.cpp
-*/
-#include "Entity.h"
-#include "Uniform.h"
-#include <glm/gtc/matrix_transform.hpp>
-#include <iostream>
-#include <algorithm>
-
-namespace Entity {
-
-/**
-* VertexDataUBOɓ].
-*
-* @param entity
-* @param ubo
-* @param matViewProjection
-*/
-void UpdateUniformVertexData(Entity& entity, void* ubo, const glm::mat4* matViewProjection, const glm::mat4& matDepthVP, glm::u32 viewFlags)
-{
-  Uniform::VertexData data;
-  data.matModel = entity.TRSMatrix();
-  data.matNormal = glm::mat4_cast(entity.Rotation());
-  for (int i = 0; i < Uniform::maxViewCount; ++i) {
-    if (viewFlags & (1 << i)) {
-      data.matMVP[i] = matViewProjection[i] * data.matModel;
-    }
-  }
-  data.matDepthMVP = matDepthVP * data.matModel;
-  data.color = entity.Color();
-  memcpy(ubo, &data, sizeof(data));
-}
-
-/**
-* NIuWFNg̎Oɒǉ.
-*
-* @param p@ǉ郊NIuWFNgւ̃|C^.
-*
-* p̃NXg؂藣A̎Oɒǉ.
-*/
-void Buffer::Link::Insert(Link* p)
-{
-  p->Remove();
-  p->prev = prev;
-  p->next = this;
-  prev->next = p;
-  prev = p;
-}
-
-/**
-* gNXg؂藣.
-*
-* ͂ǂɂڑĂȂԂɂȂ.
-*/
-void Buffer::Link::Remove()
-{
-  next->prev = prev;
-  prev->next = next;
-  prev = this;
-  next = this;
-}
-
-/**
-* gkE]Eړs擾.
-*
-* @return TRSs.
-*/
-glm::mat4 Entity::TRSMatrix() const
-{
-#if 1
-  return glm::scale(glm::translate(glm::mat4(), position) * glm::mat4_cast(rotation), scale);
-#else
-  const glm::mat4 s = glm::scale(glm::mat4(), scale);
-  const glm::mat4 r = glm::mat4_cast(rotation);
-  const glm::mat4 t = glm::translate(glm::mat4(), position);
-  return t * r * s;
-#endif
-}
-
-/**
-* GeBeBj.
-*
-* ̊֐ĂяoƂ́AGeBeB𑀍삵Ă͂ȂȂ.
-*/
-void Entity::Destroy()
-{
-  if (pBuffer) {
-    pBuffer->RemoveEntity(this);
-  }
-}
-
-/**
-* GeBeBobt@쐬.
-*
-* @param maxEntityCount   GeBeB̍ő吔.
-* @param ubSizePerEntity  GeBeBƂUniform Buffer̃oCg.
-* @param bindingPoint     GeBeBpUBÕoCfBO|Cg.
-* @param ubName           GeBeBpUniform Buffer̖O.
-*
-* @return 쐬GeBeBobt@ւ̃|C^.
-*/
-BufferPtr Buffer::Create(size_t maxEntityCount, GLsizeiptr ubSizePerEntity, int bindingPoint, const char* ubName)
-{
-  struct Impl : Buffer { Impl() {} ~Impl() {} };
-  BufferPtr p = std::make_shared<Impl>();
-  if (!p) {
-    std::cerr << "WARNING in Entity::Buffer::Create: obt@̍쐬Ɏs." << std::endl;
-    return {};
-  }
-
-  // ubNTCYfoCX̃ACgɍ킹.
-  GLint ubAlignment;
-  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &ubAlignment);
-  ubSizePerEntity = ((ubSizePerEntity + ubAlignment - 1) / ubAlignment) * ubAlignment;
-
-  p->ubo = UniformBuffer::Create(maxEntityCount * ubSizePerEntity, bindingPoint, ubName);
-  p->buffer.reset(new LinkEntity[maxEntityCount]);
-  if (!p->ubo || !p->buffer) {
-    std::cerr << "WARNING in Entity::Buffer::Create: obt@̍쐬Ɏs." << std::endl;
-    return {};
-  }
-  p->bufferSize = maxEntityCount;
-  p->ubSizePerEntity = ubSizePerEntity;
-  GLintptr offset = 0;
-  const LinkEntity* const end = &p->buffer[maxEntityCount];
-  for (LinkEntity* itr = &p->buffer[0]; itr != end; ++itr) {
-    itr->uboOffset = offset;
-    itr->pBuffer = p.get();
-    p->freeList.Insert(itr);
-    offset += ubSizePerEntity;
-  }
-  p->collisionHandlerList.reserve(maxGroupId);
-  for (auto& e : p->visibilityFlags) {
-    e = 1;
-  }
-  return p;
-}
-
-/**
-* GeBeBǉ.
-*
-* @param groupId  GeBeB̃O[vID.
-* @param position GeBeB̍W.
-* @param mesh     GeBeB̕\Ɏgp郁bV.
-* @param texture  GeBeB̕\ɎgeNX`.
-* @param program  GeBeB̕\ɎgpVF[_vO.
-* @param func     GeBeB̏ԂXV֐(܂͊֐IuWFNg).
-*
-* @return ǉGeBeBւ̃|C^.
-*         ȏGeBeBǉłȂꍇnullptrԂ.
-*         ]g嗦͂̃|C^oRŐݒ肷.
-*         ȂÃ|C^AvP[VŕێKv͂Ȃ.
-*/
-Entity* Buffer::AddEntity(int groupId, const glm::vec3& position, const Mesh::MeshPtr& mesh, const TexturePtr t[2], const Shader::ProgramPtr& program, const Entity::UpdateFuncType& func)
-{
-  if (freeList.prev == freeList.next) {
-    std::cerr << "WARNING in Entity::Buffer::AddEntity: 󂫃GeBeB܂." << std::endl;
-    return nullptr;
-  }
-  if (groupId < 0 || groupId > maxGroupId) {
-    std::cerr << "ERROR in Entity::Buffer::AddEntity: ͈͊ÕO[vID(" << groupId << ")n܂.\nO[vID0`" << maxGroupId << "łȂ΂Ȃ܂." << std::endl;
-    return nullptr;
-  }
-  LinkEntity* entity = static_cast<LinkEntity*>(freeList.prev);
-  activeList[groupId].Insert(entity);
-  entity->groupId = groupId;
-  entity->position = position;
-  entity->rotation = glm::quat();
-  entity->scale = glm::vec3(1, 1, 1);
-  entity->velocity = glm::vec3();
-  entity->color = glm::vec4(1, 1, 1, 1);
-  entity->mesh = mesh;
-  entity->texture[0] = t[0];
-  entity->texture[1] = t[1];
-  entity->program = program;
-  entity->updateFunc = func;
-  entity->isActive = true;
-  return entity;
-}
-
-/**
-*@GeBeB폜.
-*
-* @param 폜GeBeB̃|C^.
-*/
-void Buffer::RemoveEntity(Entity* entity)
-{
-  if (!entity || !entity->isActive) {
-    std::cerr << "WARNING in Entity::Buffer::RemoveEntity: ANeBuȃGeBeB폜悤Ƃ܂." << std::endl;
-    return;
-  }
-  LinkEntity* p = static_cast<LinkEntity*>(entity);
-  if (p < &buffer[0] || p >= &buffer[bufferSize]) {
-    std::cerr << "WARNING in Entity::Buffer::RemoveEntity: قȂobt@擾GeBeB폜悤Ƃ܂." << std::endl;
-    return;
-  }
-  if (p == itrUpdate) {
-    itrUpdate = p->prev;
-  }
-  if (p == itrUpdateRhs) {
-    itrUpdateRhs = p->prev;
-  }
-  freeList.Insert(p);
-  p->mesh.reset();
-  for (auto& e : p->texture) {
-    e.reset();
-  }
-  p->program.reset();
-  p->updateFunc = nullptr;
-  p->isActive = false;
-}
-
-/**
-* SẴGeBeB폜.
-*/
-void Buffer::RemoveAllEntity()
-{
-  for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
-    while (activeList[groupId].next != &activeList[groupId]) {
-      RemoveEntity(static_cast<LinkEntity*>(activeList[groupId].next));
-    }
-  }
-}
-
-/**
-* `m̏Փ˔.
-*/
-bool HasCollision(const CollisionData& lhs, const CollisionData& rhs)
-{
-  if (lhs.max.x < rhs.min.x || lhs.min.x > rhs.max.x) return false;
-  if (lhs.max.y < rhs.min.y || lhs.min.y > rhs.max.y) return false;
-  if (lhs.max.z < rhs.min.z || lhs.min.z > rhs.max.z) return false;
-  return true;
-}
-
-#pragma optimize( "ts", off)
-/**
-* ANeBuȃGeBeB̏ԂXV.
-*
-* @param delta   O̍XV̌oߎ.
-* @param matView Views.
-* @param matProj Projections.
-*/
-void Buffer::Update(double delta, const glm::mat4* matView, const glm::mat4& matProj, const glm::mat4& matDepthVP)
-{
-  // Wƃ[hWn̏Փˌ`XV.
-  // eGeBeB̏ԂXV.
-  for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
-    for (itrUpdate = activeList[groupId].next; itrUpdate != &activeList[groupId]; itrUpdate = itrUpdate->next) {
-      LinkEntity& e = *static_cast<LinkEntity*>(itrUpdate);
-      e.position += e.velocity * static_cast<float>(delta);
-      if (e.updateFunc) {
-        e.updateFunc(e, delta);
-      }
-      e.colWorld.min = e.colLocal.min + e.position;
-      e.colWorld.max = e.colLocal.max + e.position;
-    }
-  }
-
-  // Փ˔s.
-  for (const auto& e : collisionHandlerList) {
-    if (!e.handler) {
-      continue;
-    }
-    Link* listL = &activeList[e.groupId[0]];
-    Link* listR = &activeList[e.groupId[1]];
-    for (itrUpdate = listL->next; itrUpdate != listL; itrUpdate = itrUpdate->next) {
-      LinkEntity* entityL = static_cast<LinkEntity*>(itrUpdate);
-      for (itrUpdateRhs = listR->next; itrUpdateRhs != listR; itrUpdateRhs = itrUpdateRhs->next) {
-        LinkEntity* entityR = static_cast<LinkEntity*>(itrUpdateRhs);
-        if (!HasCollision(entityL->colWorld, entityR->colWorld)) {
-          continue;
-        }
-        e.handler(*entityL, *entityR);
-        if (entityL != itrUpdate) {
-          break; // ӂ폜ꂽꍇ͉Eӂ̃[vI.
-        }
-      }
-    }
-  }
-  itrUpdate = nullptr;
-  itrUpdateRhs = nullptr;
-
-  uint8_t* p = static_cast<uint8_t*>(ubo->MapBuffer());
-  std::vector<glm::mat4> matVP;
-  matVP.resize(Uniform::maxViewCount);
-  for (int i = 0; i < Uniform::maxViewCount; ++i) {
-    matVP[i] = matProj * matView[i];
-  }
-  for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
-    for (Link* itr = activeList[groupId].next; itr != &activeList[groupId]; itr = itr->next) {
-      LinkEntity& e = *static_cast<LinkEntity*>(itr);
-      UpdateUniformVertexData(e, p + e.uboOffset, matVP.data(), matDepthVP, visibilityFlags[groupId]);
-    }
-  }
-  ubo->UnmapBuffer();
-}
-
-/**
-* ANeBuȃGeBeB`悷.
-*
-* @param viewIndex  \r[CfbNX.
-* @param meshBuffer `Ɏgp郁bVobt@ւ̃|C^.
-*
-* viewIndexɑΉtOtruẽGeBeBO[v`悳.
-*/
-void Buffer::Draw(int viewIndex, const Mesh::BufferPtr& meshBuffer) const
-{
-  meshBuffer->BindVAO();
-  for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
-    if (!(visibilityFlags[groupId] & (1 << viewIndex))) {
-      continue;
-    }
-    for (const Link* itr = activeList[groupId].next; itr != &activeList[groupId]; itr = itr->next) {
-      const LinkEntity& e = *static_cast<const LinkEntity*>(itr);
-      if (e.mesh && e.texture && e.program) {
-        e.program->UseProgram();
-        for (size_t i = 0; i < sizeof(e.texture) / sizeof(e.texture[0]); ++i) {
-          e.program->BindTexture(GL_TEXTURE0 + i, GL_TEXTURE_2D, e.texture[i]->Id());
-        }
-        e.program->SetViewIndex(viewIndex);
-        ubo->BindBufferRange(e.uboOffset, ubSizePerEntity);
-        e.mesh->Draw(meshBuffer);
-      }
-    }
-  }
-}
-
-/**
-* ANeBuȃGeBeB`悷.
-*
-* @param viewIndex  \r[CfbNX.
-* @param meshBuffer `Ɏgp郁bVobt@ւ̃|C^.
-*/
-void Buffer::DrawDepth(int viewIndex, const Mesh::BufferPtr& meshBuffer) const
-{
-  meshBuffer->BindVAO();
-  for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
-    if (!(visibilityFlags[groupId] & (1 << viewIndex))) {
-      continue;
-    }
-    for (const Link* itr = activeList[groupId].next; itr != &activeList[groupId]; itr = itr->next) {
-      const LinkEntity& e = *static_cast<const LinkEntity*>(itr);
-      if (e.mesh && e.texture && e.program) {
-        for (size_t i = 0; i < sizeof(e.texture) / sizeof(e.texture[0]); ++i) {
-          e.program->BindTexture(GL_TEXTURE0 + i, GL_TEXTURE_2D, e.texture[i]->Id());
-        }
-        ubo->BindBufferRange(e.uboOffset, ubSizePerEntity);
-        e.mesh->Draw(meshBuffer);
-      }
-    }
-  }
-}
-
-/**
-* Փˉnhݒ肷.
-*
-* @param gid0    ՓˑΏۂ̃O[vID.
-* @param gid1    ՓˑΏۂ̃O[vID.
-* @param handler Փˉnh.
-*
-* Փ˂ՓˉnhĂтƂA菬O[vIDGeBeBɓn.
-* Ŏw肵O[vID̏Ƃ͖֌Wł邱Ƃɒӂ邱.
-* ex)
-*   CollisionHandler(10, 1, Func)
-*   ƂR[hŃnho^Ƃ. Փ˂ƁA
-*   Func(O[vID=1̃GeBeBAO[vID=10̃GeBeB)
-*   ̂悤ɌĂяo.
-*/
-void Buffer::CollisionHandler(int gid0, int gid1, const CollisionHandlerType& handler)
-{
-  if (gid0 > gid1) {
-    std::swap(gid0, gid1);
-  }
-  auto itr = std::find_if(collisionHandlerList.begin(), collisionHandlerList.end(),
-    [&](const CollisionHandlerElement& e) { return e.groupId[0] == gid0 && e.groupId[1] == gid1; });
-  if (itr == collisionHandlerList.end()) {
-    collisionHandlerList.push_back({ { gid0, gid1 }, handler });
-  } else {
-    itr->handler = handler;
-  }
-}
-
-/**
-* Փˉnh擾.
-*
-* @param gid0 ՓˑΏۂ̃O[vID.
-* @param gid1 ՓˑΏۂ̃O[vID.
-*
-* @return Փˉnh.
-*/
-const CollisionHandlerType& Buffer::CollisionHandler(int gid0, int gid1) const
-{
-  if (gid0 > gid1) {
-    std::swap(gid0, gid1);
-  }
-  auto itr = std::find_if(collisionHandlerList.begin(), collisionHandlerList.end(),
-    [&](const CollisionHandlerElement& e) { return e.groupId[0] == gid0 && e.groupId[1] == gid1; });
-  if (itr == collisionHandlerList.end()) {
-    static const CollisionHandlerType dummy;
-    return dummy;
-  }
-  return itr->handler;
-}
-
-/**
-* SĂ̏Փˉnh폜.
-*/
-void Buffer::ClearCollisionHandlerList()
-{
-  collisionHandlerList.clear();
-}
-
-} // namespace Entity
+/**
+* @file Entity.cpp
+*/
+#include "Entity.h"
+#include "Bullet.h"
+#include "Uniform.h"
+#include "GLState.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+#include <algorithm>
+#include <tuple>
+#include <chrono>
+
+namespace Entity {
+
+thread_local Buffer::CommandBuffer* Buffer::currentCommandBuffer = nullptr;
+
+/// 並列更新で1チャンクが受け持つエンティティ数の最小値.
+static const size_t minEntitiesPerChunk = 64;
+
+static const size_t maxPageCount = 256; ///< ページ数の上限.
+static const double pageReclaimSeconds = 10; ///< 未使用のページを解放するまでの時間(秒).
+
+/**
+* VertexDataをUBOに転送する.
+*
+* @param s                 エンティティのグループデータ.
+* @param index             転送するエンティティのグループデータ内の位置.
+* @param ubo               転送先のUBO領域.
+*
+* モデル行列はキャッシュされたものを使う.
+* ビュー・プロジェクション行列はViewDataで共有されるため、ここでは扱わない.
+* 親を持つエンティティの法線の回転には、親の回転を含めたモデル行列の各軸を使う.
+*/
+void UpdateUniformVertexData(const GroupStorage& s, size_t index, void* ubo)
+{
+  Uniform::VertexData data;
+  data.matModel = s.matModel[index];
+  if (s.depth[index]) {
+    const glm::mat3 m(s.matModel[index]);
+    data.matNormal = glm::mat4(glm::mat3(glm::normalize(m[0]), glm::normalize(m[1]), glm::normalize(m[2])));
+  } else {
+    data.matNormal = glm::mat4_cast(s.rotation[index]);
+  }
+  data.color = s.color[index];
+  memcpy(ubo, &data, sizeof(data));
+}
+
+/**
+* 詰めて格納するインスタンスデータを作成する.
+*
+* @param s     エンティティのグループデータ.
+* @param index エンティティのグループデータ内の位置.
+*
+* @return モデル行列の上3行と色.
+*/
+Uniform::InstanceData MakeInstanceData(const GroupStorage& s, size_t index)
+{
+  const glm::mat4 m = glm::transpose(s.matModel[index]);
+  return { { m[0], m[1], m[2] }, s.color[index] };
+}
+
+/**
+* ワールド座標系の境界球を更新する.
+*
+* @param s     エンティティのグループデータ.
+* @param index 更新するエンティティのグループデータ内の位置.
+* @param mesh  エンティティのメッシュ.
+*
+* メッシュの境界球をモデル行列で変換する. 半径はモデル行列の最も長い軸の長さで拡大する.
+* メッシュがない場合は半径0の球とする.
+*/
+void UpdateBounds(GroupStorage& s, size_t index, const Mesh::MeshPtr& mesh)
+{
+  const glm::mat4& m = s.matModel[index];
+  if (!mesh) {
+    s.bounds[index] = glm::vec4(glm::vec3(m[3]), 0);
+    return;
+  }
+  const Mesh::Bounds& b = mesh->GetBounds();
+  const float scaleSq = std::max(glm::dot(m[0], m[0]), std::max(glm::dot(m[1], m[1]), glm::dot(m[2], m[2])));
+  const glm::vec3 center = glm::vec3(m * glm::vec4(b.center, 1));
+  s.bounds[index] = glm::vec4(center, b.radius * std::sqrt(scaleSq));
+}
+
+/**
+* 全ての配列の容量を予約する.
+*
+* @param n 予約する要素数.
+*/
+void GroupStorage::Reserve(size_t n)
+{
+  entity.reserve(n);
+  position.reserve(n);
+  velocity.reserve(n);
+  rotation.reserve(n);
+  scale.reserve(n);
+  color.reserve(n);
+  matModel.reserve(n);
+  isDirty.reserve(n);
+  colLocal.reserve(n);
+  colWorld.reserve(n);
+  collisionMask.reserve(n);
+  bounds.reserve(n);
+  depth.reserve(n);
+  transformStamp.reserve(n);
+  isStatic.reserve(n);
+  elapsed.reserve(n);
+  pageIndex.reserve(n);
+  uboOffset.reserve(n);
+}
+
+/**
+* 末尾に要素を追加する.
+*
+* @param e   追加するエンティティ.
+* @param pos エンティティの座標.
+*
+* @return 追加した要素の位置.
+*/
+uint32_t GroupStorage::PushBack(Entity* e, const glm::vec3& pos)
+{
+  const uint32_t index = static_cast<uint32_t>(entity.size());
+  entity.push_back(e);
+  position.push_back(pos);
+  velocity.push_back(glm::vec3());
+  rotation.push_back(glm::quat());
+  scale.push_back(glm::vec3(1, 1, 1));
+  color.push_back(glm::vec4(1, 1, 1, 1));
+  matModel.push_back(glm::mat4());
+  isDirty.push_back(true);
+  colLocal.push_back(CollisionData());
+  colWorld.push_back(CollisionData());
+  collisionMask.push_back(allGroupMask);
+  bounds.push_back(glm::vec4(pos, 0));
+  depth.push_back(0);
+  transformStamp.push_back(0);
+  isStatic.push_back(0);
+  elapsed.push_back(0);
+  pageIndex.push_back(e->pageIndex);
+  uboOffset.push_back(e->uboOffset);
+  e->storage = this;
+  e->index = index;
+  return index;
+}
+
+/**
+* 要素を削除する.
+*
+* @param index 削除する要素の位置.
+*
+* 末尾の要素をindexの位置に移動することで、配列に隙間ができないようにする.
+*/
+void GroupStorage::SwapRemove(uint32_t index)
+{
+  const size_t last = entity.size() - 1;
+  staticCount -= isStatic[index];
+  if (index != last) {
+    entity[index] = entity[last];
+    position[index] = position[last];
+    velocity[index] = velocity[last];
+    rotation[index] = rotation[last];
+    scale[index] = scale[last];
+    color[index] = color[last];
+    matModel[index] = matModel[last];
+    isDirty[index] = isDirty[last];
+    colLocal[index] = colLocal[last];
+    colWorld[index] = colWorld[last];
+    collisionMask[index] = collisionMask[last];
+    bounds[index] = bounds[last];
+    depth[index] = depth[last];
+    transformStamp[index] = transformStamp[last];
+    isStatic[index] = isStatic[last];
+    elapsed[index] = elapsed[last];
+    pageIndex[index] = pageIndex[last];
+    uboOffset[index] = uboOffset[last];
+    entity[index]->index = index;
+  }
+  entity.pop_back();
+  position.pop_back();
+  velocity.pop_back();
+  rotation.pop_back();
+  scale.pop_back();
+  color.pop_back();
+  matModel.pop_back();
+  isDirty.pop_back();
+  colLocal.pop_back();
+  colWorld.pop_back();
+  collisionMask.pop_back();
+  bounds.pop_back();
+  depth.pop_back();
+  transformStamp.pop_back();
+  isStatic.pop_back();
+  elapsed.pop_back();
+  pageIndex.pop_back();
+  uboOffset.pop_back();
+}
+
+/**
+* 全ての要素を削除する.
+*/
+void GroupStorage::Clear()
+{
+  entity.clear();
+  position.clear();
+  velocity.clear();
+  rotation.clear();
+  scale.clear();
+  color.clear();
+  matModel.clear();
+  isDirty.clear();
+  colLocal.clear();
+  colWorld.clear();
+  collisionMask.clear();
+  bounds.clear();
+  depth.clear();
+  transformStamp.clear();
+  isStatic.clear();
+  staticCount = 0;
+  elapsed.clear();
+  pageIndex.clear();
+  uboOffset.clear();
+}
+
+/**
+* 要素が静的かどうかを設定する.
+*
+* @param index    設定する要素の位置.
+* @param isStatic 静的にするならtrue、しないならfalse.
+*/
+void GroupStorage::SetStatic(uint32_t index, bool isStatic)
+{
+  const uint8_t value = isStatic ? 1 : 0;
+  if (this->isStatic[index] != value) {
+    this->isStatic[index] = value;
+    if (value) {
+      ++staticCount;
+    } else {
+      --staticCount;
+    }
+  }
+}
+
+/**
+* 拡縮・回転・移動行列を取得する.
+*
+* @return TRS行列.
+*/
+glm::mat4 Entity::TRSMatrix() const
+{
+#if 1
+  return glm::scale(glm::translate(glm::mat4(), Position()) * glm::mat4_cast(Rotation()), Scale());
+#else
+  const glm::mat4 s = glm::scale(glm::mat4(), Scale());
+  const glm::mat4 r = glm::mat4_cast(Rotation());
+  const glm::mat4 t = glm::translate(glm::mat4(), Position());
+  return t * r * s;
+#endif
+}
+
+/**
+* 親エンティティを設定する.
+*
+* @param p 親にするエンティティ. nullptrなら親子関係を解除する.
+*
+* @retval true  設定成功.
+* @retval false 設定失敗.
+*
+* 座標・回転・大きさは変更されないため、親の座標系における値として解釈し直される.
+*/
+bool Entity::Parent(Entity* p)
+{
+  return pBuffer && pBuffer->SetParent(this, p);
+}
+
+/**
+* 静的なエンティティにするかどうかを設定する.
+*
+* @param isStatic 静的にするならtrue、しないならfalse.
+*
+* @retval true  設定成功.
+* @retval false 設定失敗.
+*
+* 詳しくはBuffer::SetStatic()を参照.
+*/
+bool Entity::Static(bool isStatic)
+{
+  return pBuffer ? pBuffer->SetStatic(this, isStatic) : false;
+}
+
+/**
+* エンティティを破棄する.
+*
+* この関数を呼び出したあとは、エンティティを操作してはならない.
+* 弾の代わりに衝突解決ハンドラへ渡されたエンティティなら、その弾を削除する.
+*/
+void Entity::Destroy()
+{
+  if (bulletBuffer) {
+    bulletBuffer->Kill(*this);
+  } else if (pBuffer) {
+    pBuffer->RemoveEntity(this);
+  }
+}
+
+/**
+* エンティティバッファを作成する.
+*
+* @param initialEntityCount 最初に確保するエンティティの数.
+*                           エンティティが足りなくなると自動的に追加で確保される.
+* @param ubSizePerEntity    エンティティごとのUniform Bufferのバイト数.
+* @param bindingPoint       エンティティ用UBOのバインディングポイント.
+* @param ubName             エンティティ用Uniform Bufferの名前.
+*
+* @return 作成したエンティティバッファへのポインタ.
+*/
+BufferPtr Buffer::Create(size_t initialEntityCount, GLsizeiptr ubSizePerEntity, int bindingPoint, const char* ubName)
+{
+  struct Impl : Buffer { Impl() {} ~Impl() {} };
+  BufferPtr p = std::make_shared<Impl>();
+  if (!p) {
+    std::cerr << "WARNING in Entity::Buffer::Create: バッファの作成に失敗." << std::endl;
+    return {};
+  }
+
+  // ブロックサイズをデバイスのアラインメントに合わせる.
+  GLint ubAlignment;
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &ubAlignment);
+  p->instanceStride = ubSizePerEntity;
+  ubSizePerEntity = ((ubSizePerEntity + ubAlignment - 1) / ubAlignment) * ubAlignment;
+
+  p->ubAlignment = ubAlignment;
+  p->ubSizePerEntity = ubSizePerEntity;
+  p->bindingPoint = bindingPoint;
+  p->ubName = ubName;
+  const size_t pageCount = std::max<size_t>(1, (initialEntityCount + entitiesPerPage - 1) / entitiesPerPage);
+  for (size_t i = 0; i < pageCount; ++i) {
+    if (!p->AddPage() || !p->CreatePageUbo(i)) {
+      std::cerr << "WARNING in Entity::Buffer::Create: バッファの作成に失敗." << std::endl;
+      return {};
+    }
+  }
+  p->initialPageCount = pageCount;
+  p->removedList.reserve(p->capacity);
+  // 更新関数が乱数・音声・ユーザー変数などの共有データに触れると競合するため、並列更新は明示的に許可されたグループだけで行う.
+  for (auto& e : p->parallelUpdateFlags) {
+    e = false;
+  }
+  const unsigned int threadCount = std::thread::hardware_concurrency();
+  p->threadPool.Start(threadCount > 1 ? threadCount - 1 : 0);
+  for (auto& e : p->visibilityFlags) {
+    e = 1;
+  }
+  for (int i = 0; i <= maxGroupId; ++i) {
+    p->groupOffset[i] = glm::vec3(0);
+    p->groupVelocity[i] = glm::vec3(0);
+    p->updateDivisor[i] = 1;
+    p->updateSlice[i] = 0;
+    p->groupUpdateTime[i] = 0;
+  }
+  p->bulletBuffer.reset(new BulletBuffer);
+  return p;
+}
+
+/**
+* 弾の管理クラスを削除する.
+*/
+void Buffer::BulletBufferDeleter::operator()(BulletBuffer* p)
+{
+  delete p;
+}
+
+/**
+* デストラクタ.
+*/
+Buffer::~Buffer()
+{
+  if (instanceTexture) {
+    GLState::DeleteTexture(instanceTexture);
+  }
+}
+
+/**
+* ページを追加する.
+*
+* @retval true  追加成功.
+* @retval false ページ数が上限に達している.
+*
+* OpenGLの関数は呼ばないため、並列更新中でも呼び出すことができる.
+* UBOはPrepareDraw()の中でCreatePageUbo()によって作成される.
+*/
+bool Buffer::AddPage()
+{
+  size_t n = 0;
+  for (; n < pageList.size(); ++n) {
+    if (!pageList[n]) {
+      break;
+    }
+  }
+  if (n >= maxPageCount) {
+    return false;
+  }
+  std::unique_ptr<Page> page(new Page);
+  page->entityList.reset(new Entity[entitiesPerPage]);
+  // 空きリストは末尾から取り出すため、先頭のエンティティが最初に使われるように逆順に積む.
+  for (size_t i = entitiesPerPage; i > 0; --i) {
+    Entity* e = &page->entityList[i - 1];
+    e->pBuffer = this;
+    e->pageIndex = static_cast<uint32_t>(n);
+    e->uboOffset = static_cast<GLintptr>((i - 1) * ubSizePerEntity);
+    freeList.push_back(e);
+  }
+  if (n < pageList.size()) {
+    pageList[n] = std::move(page);
+  } else {
+    pageList.push_back(std::move(page));
+  }
+  capacity += entitiesPerPage;
+
+  // 配列の再確保によってアクセサの参照が無効にならないよう、各グループの容量を予約しておく.
+  // 並列更新中は他のスレッドが配列を読んでいるため予約しない.
+  if (!currentCommandBuffer) {
+    for (auto& e : groups) {
+      e.Reserve(capacity);
+    }
+  }
+  return true;
+}
+
+/**
+* ページのUBOを作成する.
+*
+* @param n ページ番号.
+*
+* @retval true  作成成功.
+* @retval false 作成失敗.
+*/
+bool Buffer::CreatePageUbo(size_t n)
+{
+  Page& page = *pageList[n];
+  page.ubo = UniformBuffer::Create(entitiesPerPage * ubSizePerEntity, bindingPoint, ubName.c_str());
+  if (!page.ubo) {
+    return false;
+  }
+  page.uboData.resize(entitiesPerPage * ubSizePerEntity);
+  page.dirtySlotList.assign(entitiesPerPage, 0);
+  return true;
+}
+
+/**
+* 未使用のエンティティを取得する.
+*
+* @return 取得したエンティティへのポインタ.
+*         ページ数が上限に達していて取得できない場合はnullptr.
+*/
+Entity* Buffer::AllocateEntity()
+{
+  if (freeList.empty() && !AddPage()) {
+    std::cerr << "WARNING in Entity::Buffer::AddEntity: 空きエンティティがありません." << std::endl;
+    return nullptr;
+  }
+  Entity* entity = freeList.back();
+  freeList.pop_back();
+  ++pageList[entity->pageIndex]->activeCount;
+  ++activeEntityCount;
+  peakEntityCount = std::max(peakEntityCount, activeEntityCount);
+  return entity;
+}
+
+/**
+* 未使用のエンティティを取得し、グループに追加する.
+*
+* @param groupId  エンティティのグループID.
+* @param position エンティティの座標.
+*
+* @return 追加したエンティティへのポインタ.
+*         これ以上エンティティを追加できない場合はnullptrが返される.
+*/
+Entity* Buffer::NewEntity(int groupId, const glm::vec3& position)
+{
+  if (groupId < 0 || groupId > maxGroupId) {
+    std::cerr << "ERROR in Entity::Buffer::AddEntity: 範囲外のグループID(" << groupId << ")が渡されました.\nグループIDは0～" << maxGroupId << "でなければなりません." << std::endl;
+    return nullptr;
+  }
+  Entity* entity;
+  if (currentCommandBuffer) {
+    // 並列更新中はステージング領域に追加し、更新後にグループへ移動する.
+    {
+      std::lock_guard<std::mutex> lock(freeListMutex);
+      entity = AllocateEntity();
+    }
+    if (!entity) {
+      return nullptr;
+    }
+    currentCommandBuffer->staging.PushBack(entity, position);
+  } else {
+    entity = AllocateEntity();
+    if (!entity) {
+      return nullptr;
+    }
+    groups[groupId].PushBack(entity, position);
+  }
+  entity->groupId = groupId;
+  entity->isActive = true;
+  return entity;
+}
+
+/**
+* エンティティを追加する.
+*
+* @param groupId  エンティティのグループID.
+* @param position エンティティの座標.
+* @param mesh     エンティティの表示に使用するメッシュ.
+* @param texture  エンティティの表示に使うテクスチャ.
+* @param program  エンティティの表示に使用するシェーダプログラム.
+* @param func     エンティティの状態を更新する関数(または関数オブジェクト).
+*
+* @return 追加したエンティティへのポインタ.
+*         これ以上エンティティを追加できない場合はnullptrが返される.
+*         回転や拡大率はこのポインタ経由で設定する.
+*         なお、このポインタをアプリケーション側で保持する必要はない.
+*/
+Entity* Buffer::AddEntity(int groupId, const glm::vec3& position, const Mesh::MeshPtr& mesh, const TexturePtr t[2], const Shader::ProgramPtr& program, Entity::UpdateFuncType func)
+{
+  Entity* entity = NewEntity(groupId, position);
+  if (!entity) {
+    return nullptr;
+  }
+  entity->mesh = mesh;
+  entity->texture[0] = t[0];
+  entity->texture[1] = t[1];
+  entity->program = program;
+  entity->updateFunc = std::move(func);
+  return entity;
+}
+
+/**
+* アーキタイプからエンティティを追加する.
+*
+* @param id       アーキタイプID.
+* @param position エンティティの座標.
+*
+* @return 追加したエンティティへのポインタ.
+*         これ以上エンティティを追加できない場合はnullptrが返される.
+*/
+Entity* Buffer::AddEntity(ArchetypeId id, const glm::vec3& position)
+{
+  const Archetype* archetype = GetArchetype(id);
+  if (!archetype) {
+    std::cerr << "ERROR in Entity::Buffer::AddEntity: 無効なアーキタイプID(" << id << ")が渡されました." << std::endl;
+    return nullptr;
+  }
+  Entity* entity = NewEntity(archetype->groupId, position);
+  if (!entity) {
+    return nullptr;
+  }
+  entity->archetype = archetype;
+  SetupBehavior(entity, *archetype);
+  entity->storage->colLocal[entity->index] = archetype->collision;
+  return entity;
+}
+
+/**
+* アーキタイプから複数のエンティティを追加する.
+*
+* @param id         アーキタイプID.
+* @param posList    エンティティの座標の配列.
+* @param count      追加するエンティティの数.
+* @param entityList 追加したエンティティへのポインタを格納する配列. 不要ならnullptr.
+*
+* @return 追加できたエンティティの数.
+*/
+size_t Buffer::AddEntities(ArchetypeId id, const glm::vec3* posList, size_t count, Entity** entityList)
+{
+  const Archetype* archetype = GetArchetype(id);
+  if (!archetype) {
+    std::cerr << "ERROR in Entity::Buffer::AddEntities: 無効なアーキタイプID(" << id << ")が渡されました." << std::endl;
+    return 0;
+  }
+  size_t n = 0;
+  for (; n < count; ++n) {
+    Entity* entity = NewEntity(archetype->groupId, posList[n]);
+    if (!entity) {
+      break;
+    }
+    entity->archetype = archetype;
+    SetupBehavior(entity, *archetype);
+    entity->storage->colLocal[entity->index] = archetype->collision;
+    if (entityList) {
+      entityList[n] = entity;
+    }
+  }
+  return n;
+}
+
+/**
+* アーキタイプの振る舞いをエンティティに設定する.
+*
+* @param entity    設定するエンティティ.
+* @param archetype エンティティの生成に使うアーキタイプ.
+*
+* 振る舞いテーブルがあればエンティティをテーブルに追加し、なければ状態更新関数を複製する.
+*/
+void Buffer::SetupBehavior(Entity* entity, const Archetype& archetype)
+{
+  if (archetype.behaviorTable) {
+    archetype.behaviorTable->Add(entity);
+  } else {
+    entity->updateFunc = archetype.updateFunc.Clone();
+  }
+}
+
+/**
+* アーキタイプを登録する.
+*
+* @param archetype 登録するアーキタイプ.
+*
+* @return 登録したアーキタイプのID.
+*
+* 状態更新関数はエンティティを生成するたびに複製されるため、コピーできる関数オブジェクトでなければならない.
+*/
+ArchetypeId Buffer::RegisterArchetype(Archetype archetype)
+{
+  if (archetype.groupId < 0 || archetype.groupId > maxGroupId) {
+    std::cerr << "ERROR in Entity::Buffer::RegisterArchetype: 範囲外のグループID(" << archetype.groupId << ")が渡されました." << std::endl;
+    return -1;
+  }
+  if (!archetype.updateFunc.IsCopyable()) {
+    std::cerr << "WARNING in Entity::Buffer::RegisterArchetype: コピーできない状態更新関数は複製されません." << std::endl;
+  }
+  if (archetype.behaviorTable &&
+    std::find(behaviorTableList.begin(), behaviorTableList.end(), archetype.behaviorTable) == behaviorTableList.end()) {
+    behaviorTableList.push_back(archetype.behaviorTable);
+  }
+  archetypeList.push_back(std::unique_ptr<Archetype>(new Archetype(std::move(archetype))));
+  return static_cast<ArchetypeId>(archetypeList.size() - 1);
+}
+
+/**
+* アーキタイプを取得する.
+*
+* @param id アーキタイプID.
+*
+* @return IDに対応するアーキタイプへのポインタ. 無効なIDの場合はnullptr.
+*/
+const Archetype* Buffer::GetArchetype(ArchetypeId id) const
+{
+  if (id < 0 || static_cast<size_t>(id) >= archetypeList.size()) {
+    return nullptr;
+  }
+  return archetypeList[id].get();
+}
+
+/**
+* 全てのアーキタイプを削除する.
+*
+* アーキタイプから生成されたエンティティが残っている場合、
+* そのエンティティはアーキタイプのリソースを個別に保持するように変更される.
+* 振る舞いテーブルは、所属するエンティティが残っていなければ削除される.
+*/
+void Buffer::ClearArchetypeList()
+{
+  for (auto& group : groups) {
+    for (Entity* e : group.entity) {
+      if (!e->archetype) {
+        continue;
+      }
+      e->mesh = e->ResolvedMesh();
+      e->program = e->ResolvedProgram();
+      for (size_t i = 0; i < sizeof(e->texture) / sizeof(e->texture[0]); ++i) {
+        e->texture[i] = e->Texture(i);
+      }
+      e->archetype = nullptr;
+    }
+  }
+  archetypeList.clear();
+  behaviorTableList.erase(std::remove_if(behaviorTableList.begin(), behaviorTableList.end(),
+    [](const BehaviorTablePtr& p) { return p->Size() == 0; }), behaviorTableList.end());
+}
+
+/**
+*　エンティティを削除する.
+*
+* @param 削除するエンティティのポインタ.
+*/
+void Buffer::RemoveEntity(Entity* entity)
+{
+  if (entity && entity->bulletBuffer) {
+    entity->Destroy();
+    return;
+  }
+  if (!entity || !entity->isActive) {
+    std::cerr << "WARNING in Entity::Buffer::RemoveEntity: 非アクティブなエンティティを削除しようとしました." << std::endl;
+    return;
+  }
+  if (entity->pBuffer != this) {
+    std::cerr << "WARNING in Entity::Buffer::RemoveEntity: 異なるバッファから取得したエンティティを削除しようとしました." << std::endl;
+    return;
+  }
+  if (currentCommandBuffer) {
+    // 並列更新中は要求を記録するだけにとどめる.
+    currentCommandBuffer->removeList.push_back(entity);
+    return;
+  }
+
+  // 子孫も合わせて削除する.
+  // 解放すると親の子リストが変化するため、先に削除するエンティティを幅優先で集めておく.
+  hierarchyWork.clear();
+  hierarchyWork.push_back(entity);
+  for (size_t i = 0; i < hierarchyWork.size(); ++i) {
+    for (Entity* child : hierarchyWork[i]->childList) {
+      if (child->isActive) {
+        hierarchyWork.push_back(child);
+      }
+    }
+  }
+  for (Entity* e : hierarchyWork) {
+    e->isActive = false;
+    ++e->generation;
+    if (isUpdating) {
+      // 更新中は配列の要素を移動できないため、Update()の終わりにまとめて削除する.
+      removedList.push_back(e);
+    }
+  }
+  if (!isUpdating) {
+    for (Entity* e : hierarchyWork) {
+      ReleaseEntity(e);
+    }
+  }
+}
+
+/**
+* 親エンティティを設定する.
+*
+* @param child  子にするエンティティ.
+* @param parent 親にするエンティティ. nullptrなら親子関係を解除する.
+*
+* @retval true  設定成功.
+* @retval false 設定失敗.
+*
+* 子孫の深さを更新し、次のUpdate()で子のモデル行列が計算し直されるようにする.
+* 親子関係が循環する場合は設定できない. また、並列更新中は設定できない.
+*/
+bool Buffer::SetParent(Entity* child, Entity* parent)
+{
+  if (!child || !child->isActive || child->pBuffer != this || (parent && (!parent->isActive || parent->pBuffer != this))) {
+    std::cerr << "WARNING in Entity::Buffer::SetParent: 無効なエンティティが渡されました." << std::endl;
+    return false;
+  }
+  if (currentCommandBuffer) {
+    std::cerr << "WARNING in Entity::Buffer::SetParent: 並列更新中は親を設定できません." << std::endl;
+    return false;
+  }
+  for (const Entity* p = parent; p; p = p->parent) {
+    if (p == child) {
+      std::cerr << "WARNING in Entity::Buffer::SetParent: 親子関係が循環します." << std::endl;
+      return false;
+    }
+  }
+  if (child->parent == parent) {
+    return true;
+  }
+  if (child->parent) {
+    std::vector<Entity*>& siblings = child->parent->childList;
+    siblings.erase(std::find(siblings.begin(), siblings.end(), child));
+  }
+  child->parent = parent;
+  child->storage->depth[child->index] = parent ? parent->storage->depth[parent->index] + 1 : 0;
+  if (parent) {
+    parent->childList.push_back(child);
+  }
+
+  // 子孫の深さを更新する.
+  hierarchyWork.clear();
+  hierarchyWork.push_back(child);
+  for (size_t i = 0; i < hierarchyWork.size(); ++i) {
+    const Entity* e = hierarchyWork[i];
+    const uint16_t childDepth = e->storage->depth[e->index] + 1;
+    for (Entity* c : e->childList) {
+      c->storage->depth[c->index] = childDepth;
+      hierarchyWork.push_back(c);
+    }
+  }
+  child->storage->isDirty[child->index] = true;
+  isHierarchyDirty = true;
+  return true;
+}
+
+/**
+* 静的なエンティティにするかどうかを設定する.
+*
+* @param entity   設定するエンティティ.
+* @param isStatic 静的にするならtrue、しないならfalse.
+*
+* @retval true  設定成功.
+* @retval false 設定失敗.
+*
+* 静的なエンティティは更新関数や振る舞いテーブルが呼ばれず、速度による移動も行われない.
+* 座標などを直接変更した場合は、通常のエンティティと同様に行列とUBOが更新される.
+* グループごと動かしたい場合はGroupVelocity()を使う. グループ内の全エンティティが静的なら、そのグループの更新処理は省略される.
+* 並列更新中は、同じチャンクで追加したエンティティにしか設定できない.
+*/
+bool Buffer::SetStatic(Entity* entity, bool isStatic)
+{
+  if (!entity || !entity->isActive || entity->pBuffer != this) {
+    std::cerr << "WARNING in Entity::Buffer::SetStatic: 無効なエンティティが渡されました." << std::endl;
+    return false;
+  }
+  if (currentCommandBuffer && entity->storage != &currentCommandBuffer->staging) {
+    std::cerr << "WARNING in Entity::Buffer::SetStatic: 並列更新中は設定できません." << std::endl;
+    return false;
+  }
+  entity->storage->SetStatic(entity->index, isStatic);
+  return true;
+}
+
+/**
+* グループの更新の分割数を設定する.
+*
+* @param groupId 設定するグループのID.
+* @param divisor 分割数. 1以上の値を指定する.
+*
+* @retval true  設定成功.
+* @retval false 設定失敗.
+*
+* 分割数をNにすると、グループのエンティティをN個の範囲に分け、毎回そのうちの1つだけを更新する.
+* 更新されたエンティティには、前回更新されてからの経過時間がdeltaとして渡される.
+* このグループが関わる衝突判定も同じ範囲だけで行われる. 弾との衝突判定と振る舞いテーブルは分割されない.
+* 毎回更新しなくても見た目や遊び心地が変わらないグループの負荷を下げるために使う.
+*
+* 範囲はエンティティ自身ではなく、グループの配列の位置で決まる. エンティティを削除すると配列の末尾の
+* エンティティが空いた位置に移動するため、移動したエンティティは1巡の間に更新されなかったり、2回更新されたりする.
+* その場合も経過時間は更新されるまで貯められるので、移動量や更新関数に渡される時間の合計は変わらない.
+* 変わるのは更新の間隔だけなので、更新の回数そのものに意味がある処理(毎回1ずつ数えるなど)には使わないこと.
+* 分割数を決める目安にはGroupUpdateTime()を使う.
+*/
+bool Buffer::GroupUpdateDivisor(int groupId, int divisor)
+{
+  if (groupId < 0 || groupId > maxGroupId || divisor < 1) {
+    std::cerr << "WARNING in Entity::Buffer::GroupUpdateDivisor: 無効な値が渡されました(groupId=" << groupId << " divisor=" << divisor << ")." << std::endl;
+    return false;
+  }
+  if (isUpdating) {
+    std::cerr << "WARNING in Entity::Buffer::GroupUpdateDivisor: 更新中は設定できません." << std::endl;
+    return false;
+  }
+  updateDivisor[groupId] = divisor;
+  updateSlice[groupId] = 0;
+  if (divisor == 1) {
+    // 分割しないグループでは経過時間を使わないので、貯まっていた時間を捨てる.
+    for (float& e : groups[groupId].elapsed) {
+      e = 0;
+    }
+  }
+  return true;
+}
+
+/**
+* エンティティをグループデータから取り除き、空きリストに戻す.
+*
+* @param entity 取り除くエンティティのポインタ.
+*/
+void Buffer::ReleaseEntity(Entity* entity)
+{
+  // 親子関係を解除する. 子は親と一緒に削除されるため、親への参照だけを外せばよい.
+  if (entity->parent) {
+    std::vector<Entity*>& siblings = entity->parent->childList;
+    siblings.erase(std::find(siblings.begin(), siblings.end(), entity));
+    entity->parent = nullptr;
+    isHierarchyDirty = true;
+  }
+  if (!entity->childList.empty()) {
+    for (Entity* child : entity->childList) {
+      child->parent = nullptr;
+    }
+    entity->childList.clear();
+    isHierarchyDirty = true;
+  }
+  // 末尾の要素が移動するため、親子関係のある要素なら要素の位置を記録し直す.
+  const Entity* moved = entity->storage->entity.back();
+  if (moved->parent || !moved->childList.empty()) {
+    isHierarchyDirty = true;
+  }
+  if (entity->treeProxy != Collision::AabbTree::nullNode) {
+    spatialTree.Remove(entity->treeProxy);
+    entity->treeProxy = Collision::AabbTree::nullNode;
+  }
+  entity->storage->SwapRemove(entity->index);
+  entity->storage = nullptr;
+  entity->index = 0;
+  entity->mesh.reset();
+  for (auto& e : entity->texture) {
+    e.reset();
+  }
+  entity->program.reset();
+  entity->archetype = nullptr;
+  entity->updateFunc = nullptr;
+  if (entity->behaviorTable) {
+    entity->behaviorTable->Remove(entity);
+  }
+  freeList.push_back(entity);
+  --pageList[entity->pageIndex]->activeCount;
+  --activeEntityCount;
+}
+
+/**
+* 一定時間使われていないページを解放する.
+*
+* @param delta 前回の更新からの経過時間.
+*
+* 初期ページは解放しない.
+*/
+void Buffer::ReclaimPages(double delta)
+{
+  for (size_t n = initialPageCount; n < pageList.size(); ++n) {
+    Page* page = pageList[n].get();
+    if (!page) {
+      continue;
+    }
+    if (page->activeCount) {
+      page->emptySeconds = 0;
+      continue;
+    }
+    page->emptySeconds += delta;
+    if (page->emptySeconds < pageReclaimSeconds) {
+      continue;
+    }
+    const Entity* const first = &page->entityList[0];
+    const Entity* const last = first + entitiesPerPage;
+    freeList.erase(std::remove_if(freeList.begin(), freeList.end(),
+      [first, last](const Entity* e) { return e >= first && e < last; }), freeList.end());
+    pageList[n].reset();
+    capacity -= entitiesPerPage;
+  }
+  while (pageList.size() > initialPageCount && !pageList.back()) {
+    pageList.pop_back();
+  }
+}
+
+/**
+* 削除が保留されているエンティティを全て取り除く.
+*/
+void Buffer::FlushRemovedEntity()
+{
+  for (Entity* e : removedList) {
+    ReleaseEntity(e);
+  }
+  removedList.clear();
+}
+
+/**
+* 全てのエンティティと弾を削除する.
+*/
+void Buffer::RemoveAllEntity()
+{
+  bulletBuffer->Clear();
+  for (auto& group : groups) {
+    for (size_t i = group.Size(); i > 0; --i) {
+      if (group.entity[i - 1]->isActive) {
+        RemoveEntity(group.entity[i - 1]);
+      }
+    }
+  }
+}
+
+/// 空間グリッドを使わずに総当たりで衝突判定を行う組み合わせ数の上限.
+static const size_t maxBruteForcePairs = 256;
+
+/// グループごとのCPU時間の計測に使う時計.
+typedef std::chrono::steady_clock Clock;
+
+/// グループごとのCPU時間の移動平均で、最新の値が占める割合.
+static const double updateTimeSmoothing = 0.05;
+
+/**
+* エンティティの状態を更新する.
+*
+* @param s               エンティティのグループデータ.
+* @param i               更新するエンティティのグループデータ内の位置.
+* @param integratedCount 座標の更新が済んでいるエンティティの数.
+* @param delta           前回の更新からの経過時間.
+*
+* 更新を分割しているグループでは、deltaの代わりに前回更新されてから貯めた経過時間を使う.
+*/
+void Buffer::UpdateEntity(GroupStorage& s, size_t i, size_t integratedCount, double delta)
+{
+  if (i < integratedCount && s.elapsed[i] > 0) {
+    delta = s.elapsed[i];
+    s.elapsed[i] = 0;
+  }
+  Entity& e = *s.entity[i];
+  if (!e.isActive || s.isStatic[i]) {
+    return;
+  }
+  if (i >= integratedCount) {
+    s.position[i] += s.velocity[i] * static_cast<float>(delta);
+  }
+  if (e.updateFunc) {
+    e.updateFunc(e, delta);
+  }
+}
+
+/**
+* グループ内のエンティティをチャンクに分け、スレッドプールで並列に更新する.
+*
+* @param groupId         更新するグループのID.
+* @param begin           更新する範囲の先頭の位置.
+* @param end             更新する範囲の終端の位置.
+* @param integratedCount 座標の更新が済んでいるエンティティの数.
+* @param delta           前回の更新からの経過時間.
+*
+* 更新関数の中で行われたエンティティの追加・削除はチャンクごとのコマンドバッファに記録され、
+* 全チャンクの更新が終わったあとで、チャンクの順番どおりに反映される.
+*/
+void Buffer::UpdateGroupInParallel(int groupId, size_t begin, size_t end, size_t integratedCount, double delta)
+{
+  GroupStorage& s = groups[groupId];
+  const size_t count = end - begin;
+  const size_t threadCount = threadPool.ThreadCount();
+  const size_t chunkSize = std::max(minEntitiesPerChunk, (count + threadCount * 4 - 1) / (threadCount * 4));
+  const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+  if (commandBufferList.size() < chunkCount) {
+    commandBufferList.resize(chunkCount);
+  }
+  threadPool.ParallelFor(chunkCount, [&](size_t chunk) {
+    currentCommandBuffer = &commandBufferList[chunk];
+    const size_t chunkEnd = begin + std::min(count, (chunk + 1) * chunkSize);
+    for (size_t i = begin + chunk * chunkSize; i < chunkEnd; ++i) {
+      UpdateEntity(s, i, integratedCount, delta);
+    }
+    currentCommandBuffer = nullptr;
+  });
+  ApplyCommandBuffers(chunkCount);
+}
+
+/**
+* コマンドバッファに記録されたエンティティの追加・削除を反映する.
+*
+* @param count 反映するコマンドバッファの数.
+*/
+void Buffer::ApplyCommandBuffers(size_t count)
+{
+  for (size_t n = 0; n < count; ++n) {
+    CommandBuffer& cb = commandBufferList[n];
+    GroupStorage& staging = cb.staging;
+    for (uint32_t i = 0; i < staging.Size(); ++i) {
+      Entity* e = staging.entity[i];
+      GroupStorage& s = groups[e->groupId];
+      const uint32_t index = s.PushBack(e, staging.position[i]);
+      s.velocity[index] = staging.velocity[i];
+      s.rotation[index] = staging.rotation[i];
+      s.scale[index] = staging.scale[i];
+      s.color[index] = staging.color[i];
+      s.isDirty[index] = true;
+      s.colLocal[index] = staging.colLocal[i];
+      s.colWorld[index] = staging.colWorld[i];
+      s.collisionMask[index] = staging.collisionMask[i];
+      s.SetStatic(index, staging.isStatic[i] != 0);
+    }
+    staging.Clear();
+    for (Entity* e : cb.removeList) {
+      if (e->isActive) {
+        RemoveEntity(e);
+      }
+    }
+    cb.removeList.clear();
+  }
+}
+
+/**
+* グループのエンティティと、ハンドラが登録されている相手のグループとの衝突判定を行い、衝突した組をcollisionPairListに追加する.
+*
+* @param groupIdL 左辺のグループID.
+*
+* 右辺となるのは、左辺と同じかより大きいIDを持つ相手のグループ.
+* 全ての右辺のグループの衝突形状を1つのSIMD判定用の配列に詰め込み、左辺の各エンティティとまとめて判定する.
+* 組み合わせが多い場合は右辺を空間グリッドにも登録し、重なる可能性のあるものだけを判定する.
+* エンティティの衝突マスクに相手のグループが含まれない組は判定しない.
+* 更新を分割しているグループとの組み合わせは、分割数の大きい側の今回更新した分割だけを判定する.
+*
+* 左辺はチャンクに分けてスレッドプールで判定し、チャンクごとの作業領域に組を記録する.
+* チャンクは左辺の連続した範囲なので、チャンクの順番に連結すれば1スレッドで判定した場合と同じ順番になる.
+* 判定中はエンティティを変更しないため、ハンドラの呼び出しは全ての判定が終わってから行う.
+*/
+void Buffer::CollectCollisionPairs(int groupIdL)
+{
+  const uint32_t partnerMask = collisionGroupMask[groupIdL] & ~((1U << groupIdL) - 1);
+  GroupStorage& groupL = groups[groupIdL];
+  if (!partnerMask || groupL.Size() == 0) {
+    return;
+  }
+
+  // 右辺のグループのエンティティを集める.
+  // 左辺の方が分割数が大きい相手は、左辺の今回の分割とだけ判定する.
+  uint32_t slicedPartnerMask = 0;
+  float totalSize = 0;
+  size_t sizeCount = 0;
+  collisionTargetList.clear();
+  collisionTargetBoxList.Clear();
+  for (int groupIdR = groupIdL; groupIdR <= maxGroupId; ++groupIdR) {
+    if (!(partnerMask & (1U << groupIdR))) {
+      continue;
+    }
+    GroupStorage& groupR = groups[groupIdR];
+    size_t beginR = 0, endR = groupR.Size();
+    if (updateDivisor[groupIdL] >= updateDivisor[groupIdR]) {
+      if (updateDivisor[groupIdL] > 1) {
+        slicedPartnerMask |= 1U << groupIdR;
+      }
+    } else {
+      UpdateSliceRange(groupIdR, groupR.Size(), beginR, endR);
+    }
+    for (size_t i = beginR; i < endR; ++i) {
+      Entity* entity = groupR.entity[i];
+      if (!entity->isActive || !(groupR.collisionMask[i] & (1U << groupIdL))) {
+        continue;
+      }
+      collisionTargetList.push_back({ entity, entity->generation });
+      collisionTargetBoxList.Push(groupR.colWorld[i].min, groupR.colWorld[i].max);
+      const glm::vec3 size = groupR.colWorld[i].max - groupR.colWorld[i].min;
+      totalSize += std::max(size.x, std::max(size.y, size.z));
+      ++sizeCount;
+    }
+  }
+  if (collisionTargetList.empty()) {
+    return;
+  }
+
+  // 分割しない相手がいなければ、左辺は今回の分割だけを判定すればよい.
+  size_t sliceBegin, sliceEnd;
+  UpdateSliceRange(groupIdL, groupL.Size(), sliceBegin, sliceEnd);
+  const bool needsAll = (partnerMask & ~slicedPartnerMask) != 0;
+  const size_t beginL = needsAll ? 0 : sliceBegin;
+  const size_t endL = needsAll ? groupL.Size() : sliceEnd;
+  if (beginL >= endL) {
+    return;
+  }
+
+  const size_t countL = endL - beginL;
+  const bool useGrid = countL * collisionTargetList.size() > maxBruteForcePairs;
+  if (useGrid) {
+    // セルの大きさは、両辺の衝突形状の平均的な大きさの2倍とする.
+    for (size_t i = beginL; i < endL; ++i) {
+      if (!groupL.entity[i]->isActive) {
+        continue;
+      }
+      const glm::vec3 size = groupL.colWorld[i].max - groupL.colWorld[i].min;
+      totalSize += std::max(size.x, std::max(size.y, size.z));
+      ++sizeCount;
+    }
+    collisionGrid.Clear(totalSize / static_cast<float>(sizeCount) * 2.0f);
+    for (size_t i = 0; i < collisionTargetList.size(); ++i) {
+      const Entity* entity = collisionTargetList[i].entity;
+      const CollisionData& col = entity->storage->colWorld[entity->index];
+      collisionGrid.Insert(static_cast<uint32_t>(i), col.min, col.max);
+    }
+    collisionGrid.Build();
+  }
+
+  const size_t threadCount = threadPool.ThreadCount();
+  const size_t chunkSize = std::max(minEntitiesPerChunk, (countL + threadCount * 4 - 1) / (threadCount * 4));
+  const size_t chunkCount = (countL + chunkSize - 1) / chunkSize;
+  if (collisionWorkerList.size() < chunkCount) {
+    collisionWorkerList.resize(chunkCount);
+  }
+  threadPool.ParallelFor(chunkCount, [&](size_t chunk) {
+    CollisionWorker& worker = collisionWorkerList[chunk];
+    worker.pairList.clear();
+    const size_t chunkEnd = beginL + std::min(countL, (chunk + 1) * chunkSize);
+    for (size_t indexL = beginL + chunk * chunkSize; indexL < chunkEnd; ++indexL) {
+      Entity* entityL = groupL.entity[indexL];
+      uint32_t maskL = groupL.collisionMask[indexL] & partnerMask;
+      if (indexL < sliceBegin || indexL >= sliceEnd) {
+        maskL &= ~slicedPartnerMask;
+      }
+      if (!entityL->isActive || !maskL) {
+        continue;
+      }
+      const CollisionData& colL = groupL.colWorld[indexL];
+      const Collision::PackedBoxList* boxList = &collisionTargetBoxList;
+      const uint32_t* idList = nullptr;
+      if (useGrid) {
+        worker.candidateList.clear();
+        collisionGrid.Query(colL.min, colL.max, worker.candidateList);
+        if (worker.candidateList.empty()) {
+          continue;
+        }
+        worker.candidateBoxList.Gather(collisionTargetBoxList, worker.candidateList.data(), worker.candidateList.size());
+        boxList = &worker.candidateBoxList;
+        idList = worker.candidateList.data();
+      }
+      for (size_t first = 0; first < boxList->Size(); first += Collision::PackedBoxList::batchSize) {
+        const uint32_t mask = Collision::TestOverlap(colL.min, colL.max, *boxList, first);
+        for (uint32_t bit = 0; (mask >> bit) != 0; ++bit) {
+          if (!(mask & (1U << bit))) {
+            continue;
+          }
+          const size_t n = first + bit;
+          const CollisionTarget& target = collisionTargetList[idList ? idList[n] : n];
+          const int groupIdR = target.entity->groupId;
+          if (!(maskL & (1U << groupIdR))) {
+            continue;
+          }
+          worker.pairList.push_back({
+            { entityL, target.entity }, { entityL->generation, target.generation },
+            static_cast<uint32_t>(groupIdL * (maxGroupId + 1) + groupIdR)
+          });
+        }
+      }
+    }
+  });
+  for (size_t i = 0; i < chunkCount; ++i) {
+    const std::vector<CollisionPair>& pairList = collisionWorkerList[i].pairList;
+    collisionPairList.insert(collisionPairList.end(), pairList.begin(), pairList.end());
+  }
+}
+
+/**
+* 今回更新するエンティティの範囲を求める.
+*
+* @param groupId グループのID.
+* @param count   グループのエンティティの数.
+* @param begin   範囲の先頭の位置を格納する変数.
+* @param end     範囲の終端の位置を格納する変数.
+*
+* 更新を分割していなければ全てのエンティティが範囲になる.
+* 範囲は配列の位置なので、削除によって移動したエンティティは範囲をまたぐことがある(GroupUpdateDivisor()を参照).
+*/
+void Buffer::UpdateSliceRange(int groupId, size_t count, size_t& begin, size_t& end) const
+{
+  const size_t divisor = static_cast<size_t>(updateDivisor[groupId]);
+  const size_t slice = static_cast<size_t>(updateSlice[groupId]);
+  begin = count * slice / divisor;
+  end = count * (slice + 1) / divisor;
+}
+
+/**
+* アクティブなエンティティの状態を更新する.
+*
+* @param delta 前回の更新からの経過時間.
+*
+* 描画の準備は行わない. 描画するフレームでは、この後にPrepareDraw()を呼び出すこと.
+* ロールバックの再シミュレーションのように、1回の描画の間に何度呼び出してもよい.
+*/
+void Buffer::Update(double delta)
+{
+  isUpdating = true;
+
+  // グループ単位の平行移動量を更新する.
+  const float deltaF = static_cast<float>(delta);
+  for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
+    groupOffset[groupId] += groupVelocity[groupId] * deltaF;
+  }
+
+  // 座標を更新する. 静的なエンティティは動かさない.
+  // 更新を分割しているグループは全エンティティの経過時間を貯めておき、今回の分割のエンティティだけを貯めた時間で動かす.
+  double updateTime[maxGroupId + 1] = {};
+  size_t integratedCount[maxGroupId + 1];
+  size_t sliceBegin[maxGroupId + 1];
+  size_t sliceEnd[maxGroupId + 1];
+  for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
+    GroupStorage& s = groups[groupId];
+    const size_t count = s.Size();
+    integratedCount[groupId] = count;
+    UpdateSliceRange(groupId, count, sliceBegin[groupId], sliceEnd[groupId]);
+    if (s.staticCount == count) {
+      continue;
+    }
+    const Clock::time_point start = Clock::now();
+    const bool isSliced = updateDivisor[groupId] > 1;
+    glm::vec3* position = s.position.data();
+    const glm::vec3* velocity = s.velocity.data();
+    const uint8_t* isStatic = s.isStatic.data();
+    uint8_t* isDirty = s.isDirty.data();
+    float* elapsed = s.elapsed.data();
+    if (isSliced) {
+      for (size_t i = 0; i < count; ++i) {
+        elapsed[i] += deltaF;
+      }
+    }
+    for (size_t i = sliceBegin[groupId]; i < sliceEnd[groupId]; ++i) {
+      if (isStatic[i]) {
+        continue;
+      }
+      position[i] += velocity[i] * (isSliced ? elapsed[i] : deltaF);
+      isDirty[i] |= (velocity[i] != glm::vec3(0));
+    }
+    updateTime[groupId] += std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  // 各エンティティの状態を更新する.
+  // 並列更新が許可されたグループは、エンティティが十分に多ければスレッドプールで更新する.
+  // 更新中に追加されたエンティティは、座標の更新がまだなのでここで行う.
+  // 全てのエンティティが静的なグループは更新しない.
+  for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
+    GroupStorage& s = groups[groupId];
+    if (s.staticCount == s.Size()) {
+      continue;
+    }
+    const Clock::time_point start = Clock::now();
+    const size_t begin = sliceBegin[groupId];
+    const size_t end = sliceEnd[groupId];
+    if (parallelUpdateFlags[groupId] && end - begin > minEntitiesPerChunk) {
+      UpdateGroupInParallel(groupId, begin, end, integratedCount[groupId], delta);
+    } else {
+      for (size_t i = begin; i < end; ++i) {
+        UpdateEntity(s, i, integratedCount[groupId], delta);
+      }
+    }
+    for (size_t i = integratedCount[groupId]; i < s.Size(); ++i) {
+      UpdateEntity(s, i, integratedCount[groupId], delta);
+    }
+    updateTime[groupId] += std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  // 振る舞いテーブルに所属するエンティティを、テーブルごとにまとめて更新する.
+  for (const BehaviorTablePtr& table : behaviorTableList) {
+    table->Update(delta);
+  }
+
+  // 弾を移動させ、寿命が尽きたものと範囲外に出たものを削除する.
+  bulletBuffer->Update(delta);
+
+  // 衝突判定で子のワールド座標を使うため、ここでモデル行列を更新しておく.
+  // ロールバックの再シミュレーションでも呼ばれるため、ここではUBOを作成しない.
+  PreparePages(false);
+  UpdateTransforms();
+
+  // ワールド座標系の衝突形状を更新する.
+  // 親を持つエンティティの座標は親の座標系の値なので、モデル行列から取り出す.
+  // グループ単位の平行移動量もここで加える. 衝突ハンドラに登録されておらず、空間検索も行わないグループは省略する.
+  for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
+    if (!collisionGroupMask[groupId] && !spatialQueryFlags[groupId]) {
+      continue;
+    }
+    GroupStorage& s = groups[groupId];
+    const glm::vec3 offset = groupOffset[groupId];
+    const size_t count = s.Size();
+    const glm::vec3* position = s.position.data();
+    const glm::mat4* matModel = s.matModel.data();
+    const uint16_t* depth = s.depth.data();
+    const CollisionData* colLocal = s.colLocal.data();
+    CollisionData* colWorld = s.colWorld.data();
+    for (size_t i = 0; i < count; ++i) {
+      const glm::vec3 pos = (depth[i] ? glm::vec3(matModel[i][3]) : position[i]) + offset;
+      colWorld[i].min = colLocal[i].min + pos;
+      colWorld[i].max = colLocal[i].max + pos;
+    }
+  }
+  UpdateSpatialTree();
+
+  // 衝突判定を実行する.
+  // まずグループごとに、ハンドラが登録されている全ての相手との衝突判定を行い、衝突したエンティティの組を集める.
+  // 集めた組をグループの組の順に並べ替え、グループの組ごとに弾の衝突判定とハンドラの呼び出しを行う.
+  // 先に呼ばれたハンドラで削除されたエンティティの組は無視する.
+  // 判定にかかった時間は左辺のグループの時間として記録する.
+  collisionPairList.clear();
+  for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
+    if (!(collisionGroupMask[groupId] >> groupId)) {
+      continue;
+    }
+    const Clock::time_point start = Clock::now();
+    CollectCollisionPairs(groupId);
+    updateTime[groupId] += std::chrono::duration<double>(Clock::now() - start).count();
+  }
+  std::stable_sort(collisionPairList.begin(), collisionPairList.end(),
+    [](const CollisionPair& lhs, const CollisionPair& rhs) { return lhs.groupPair < rhs.groupPair; });
+  size_t pairIndex = 0;
+  for (int groupIdL = 0; groupIdL <= maxGroupId; ++groupIdL) {
+    for (int groupIdR = groupIdL; groupIdR <= maxGroupId; ++groupIdR) {
+      if (!(collisionGroupMask[groupIdL] & (1U << groupIdR))) {
+        continue;
+      }
+      const Clock::time_point start = Clock::now();
+      const CollisionHandlerType& handler = collisionHandlerTable[groupIdL][groupIdR];
+      // 同じグループ同士の組では2回目の判定は1回目と同じ弾とエンティティの組になるので、1回だけ行う.
+      bulletBuffer->Collide(groupIdL, groups[groupIdR], true, handler);
+      if (groupIdL != groupIdR) {
+        bulletBuffer->Collide(groupIdR, groups[groupIdL], false, handler);
+      }
+      const uint32_t groupPair = static_cast<uint32_t>(groupIdL * (maxGroupId + 1) + groupIdR);
+      for (; pairIndex < collisionPairList.size() && collisionPairList[pairIndex].groupPair <= groupPair; ++pairIndex) {
+        const CollisionPair& pair = collisionPairList[pairIndex];
+        if (pair.groupPair != groupPair || !handler) {
+          continue; // ハンドラの中でハンドラが変更された.
+        }
+        if (pair.entity[0]->generation != pair.generation[0] || pair.entity[1]->generation != pair.generation[1]) {
+          continue;
+        }
+        // 先に呼ばれたハンドラが衝突マスクを変更していれば、その変更に従う.
+        // これにより、同じフレームで複数の相手と重なっていても、マスクを0にしたエンティティのハンドラは一度しか呼ばれない.
+        if (!(pair.entity[0]->CollisionMask() & (1U << pair.entity[1]->GroupId())) ||
+          !(pair.entity[1]->CollisionMask() & (1U << pair.entity[0]->GroupId()))) {
+          continue;
+        }
+        handler(*pair.entity[0], *pair.entity[1]);
+      }
+      updateTime[groupIdL] += std::chrono::duration<double>(Clock::now() - start).count();
+    }
+  }
+
+  // グループごとの時間を平均し、更新を分割しているグループは次の分割に進める.
+  for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
+    groupUpdateTime[groupId] += (updateTime[groupId] - groupUpdateTime[groupId]) * updateTimeSmoothing;
+    if (updateDivisor[groupId] > 1) {
+      updateSlice[groupId] = (updateSlice[groupId] + 1) % updateDivisor[groupId];
+    }
+  }
+
+  // 削除されたエンティティと弾を取り除いて配列を詰める.
+  isUpdating = false;
+  FlushRemovedEntity();
+  bulletBuffer->RemoveDead();
+
+  ReclaimPages(delta);
+}
+
+/**
+* 描画の準備をする.
+*
+* @param matView    View行列.
+* @param matProj    Projection行列.
+* @param matDepthVP 影用のビュー・プロジェクション行列.
+*
+* 変更されたエンティティのデータをUBOに転送し、インスタンス描画の単位を作成する.
+* 行列は描画時の視錐台カリングに使われる. シェーダへはGameEngineがViewDataとして転送する.
+*/
+void Buffer::PrepareDraw(const glm::mat4* matView, const glm::mat4& matProj, const glm::mat4& matDepthVP)
+{
+  // 視錐台カリングと深度の計算に使う行列を記録する.
+  for (int i = 0; i < Uniform::maxViewCount; ++i) {
+    lastMatVP[i] = matProj * matView[i];
+  }
+  lastMatDepthVP = matDepthVP;
+
+  instanceDataBytes = 0;
+  UpdateUniformBuffer();
+
+  renderQueue.ResetStats();
+  submittedEntityCount = 0;
+  visibleEntityCount = 0;
+  if (isInstancedDraw) {
+    BuildInstanceRuns();
+  }
+}
+
+/**
+* 変更されたエンティティのデータをUBOに転送する.
+*
+* 座標・回転・大きさ・色が変更されたエンティティだけを転送する.
+* ビュー・プロジェクション行列はViewDataで共有されるため、視点や可視フラグが変わっても転送は発生しない.
+* ストリーミングバッファが設定されていれば、書き換えたデータをそこへ書き込み、GPU上でUBOへコピーする.
+* そうでなければUBOをGL_MAP_FLUSH_EXPLICIT_BITでマップし、書き換えた範囲だけをフラッシュする.
+* 詰めて格納したインスタンスデータだけで描画されるエンティティは、描画時に転送されるのでUBOには書き込まない.
+*/
+void Buffer::UpdateUniformBuffer()
+{
+  // 衝突判定以降に変更されたエンティティのモデル行列を更新する.
+  // UBOのないページがあればここで作成し、Update()で転送できなかったエンティティも転送する.
+  PreparePages(true);
+  UpdateTransforms();
+
+  // 書き換えたスロットを、連続するスロットごとに転送する.
+  // ストリーミングバッファ経由ならGPUがUBOを使い終わるのを待たずに済む.
+  // 空きが足りなければ、書き換えたスロットを含む範囲をマップして直接書き込む.
+  copyList.clear();
+  for (Page* page : pageDataList) {
+    if (!page) {
+      continue;
+    }
+    const auto first = std::find(page->dirtySlotList.begin(), page->dirtySlotList.end(), 1);
+    if (first == page->dirtySlotList.end()) {
+      continue;
+    }
+    const size_t begin = first - page->dirtySlotList.begin();
+    size_t end = page->dirtySlotList.size();
+    while (!page->dirtySlotList[end - 1]) {
+      --end;
+    }
+    StreamBuffer::Allocation a;
+    if (streamBuffer) {
+      const size_t dirtyCount = std::count(page->dirtySlotList.begin() + begin, page->dirtySlotList.begin() + end, 1);
+      a = streamBuffer->Allocate(dirtyCount * ubSizePerEntity, 16);
+    }
+    const GLintptr mapOffset = begin * ubSizePerEntity;
+    uint8_t* p = nullptr;
+    if (!a) {
+      p = static_cast<uint8_t*>(page->ubo->MapBufferRange(mapOffset, (end - begin) * ubSizePerEntity, GL_MAP_WRITE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT));
+      if (!p) {
+        continue;
+      }
+    }
+    GLintptr streamOffset = 0;
+    for (size_t slot = begin; slot < end;) {
+      if (!page->dirtySlotList[slot]) {
+        ++slot;
+        continue;
+      }
+      size_t slotEnd = slot;
+      for (; slotEnd < end && page->dirtySlotList[slotEnd]; ++slotEnd) {
+        page->dirtySlotList[slotEnd] = 0;
+      }
+      const GLintptr offset = slot * ubSizePerEntity;
+      const GLsizeiptr size = (slotEnd - slot) * ubSizePerEntity;
+      if (a) {
+        memcpy(static_cast<uint8_t*>(a.pointer) + streamOffset, page->uboData.data() + offset, size);
+        copyList.push_back({ page->ubo->Id(), a.offset + streamOffset, offset, size });
+        streamOffset += size;
+      } else {
+        memcpy(p + offset - mapOffset, page->uboData.data() + offset, size);
+        page->ubo->FlushMappedBufferRange(offset - mapOffset, size);
+      }
+      instanceDataBytes += size;
+      slot = slotEnd;
+    }
+    if (!a) {
+      page->ubo->UnmapBuffer();
+    }
+  }
+
+  if (!copyList.empty()) {
+    streamBuffer->Commit();
+    GLState::BindBuffer(GL_COPY_READ_BUFFER, streamBuffer->Id());
+    for (const BufferCopy& e : copyList) {
+      GLState::BindBuffer(GL_COPY_WRITE_BUFFER, e.buffer);
+      glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, e.readOffset, e.writeOffset, e.size);
+    }
+    GLState::BindBuffer(GL_COPY_READ_BUFFER, 0);
+    GLState::BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  }
+}
+
+/**
+* インスタンス描画の有効・無効を設定する.
+*
+* @param enable trueならインスタンス描画を行う.
+*
+* 詰めて格納したインスタンスデータはインスタンス描画でしか使われないため、切り替えたときは全エンティティのUBOを更新し直す.
+*/
+void Buffer::InstancedDraw(bool enable)
+{
+  if (isInstancedDraw != enable) {
+    isInstancedDraw = enable;
+    MarkAllDirty();
+  }
+}
+
+/**
+* UBOを転送できるページのリストを作成する.
+*
+* @param createUbo trueならUBOのないページのUBOを作成する.
+*                  falseならUBOのないページはリストに含めない.
+*
+* Update()中に追加されたページのUBOは、PrepareDraw()から呼ばれたときに作成する.
+* リストに含まれないページのエンティティは変更フラグが残り、UBOの作成後に転送される.
+* ページは解放されることがあるため、pageDataListを使う前に毎回呼び出すこと.
+*/
+void Buffer::PreparePages(bool createUbo)
+{
+  pageDataList.assign(pageList.size(), nullptr);
+  for (size_t n = 0; n < pageList.size(); ++n) {
+    if (pageList[n]) {
+      if (!pageList[n]->ubo) {
+        if (!createUbo) {
+          continue;
+        }
+        if (!CreatePageUbo(n)) {
+          std::cerr << "WARNING in Entity::Buffer::PrepareDraw: UBOの作成に失敗." << std::endl;
+          continue;
+        }
+      }
+      pageDataList[n] = pageList[n].get();
+    }
+  }
+}
+
+/**
+* 変更されたエンティティのモデル行列を計算する.
+*
+* 親を持たないエンティティはグループデータの配列順に計算する.
+* 親を持つエンティティは深さの順に並べたtransformNodeListの順に計算するため、親の行列は必ず先に求まっている.
+* 子は、自身が変更されたか、親の行列がこの呼び出しで計算し直された場合だけ計算される.
+*/
+void Buffer::UpdateTransforms()
+{
+  ++transformStamp;
+  for (GroupStorage& s : groups) {
+    const size_t count = s.Size();
+    for (size_t i = 0; i < count; ++i) {
+      if (!s.isDirty[i] || s.depth[i]) {
+        continue;
+      }
+      s.matModel[i] = glm::scale(glm::translate(glm::mat4(), s.position[i]) * glm::mat4_cast(s.rotation[i]), s.scale[i]);
+      CommitTransform(s, i);
+    }
+  }
+
+  if (isHierarchyDirty) {
+    RebuildTransformNodes();
+  }
+  for (const TransformNode& node : transformNodeList) {
+    GroupStorage& s = *node.storage;
+    const uint32_t i = node.index;
+    if (!s.isDirty[i] && node.parentStorage->transformStamp[node.parentIndex] != transformStamp) {
+      continue;
+    }
+    const glm::mat4 matLocal = glm::scale(glm::translate(glm::mat4(), s.position[i]) * glm::mat4_cast(s.rotation[i]), s.scale[i]);
+    s.matModel[i] = node.parentStorage->matModel[node.parentIndex] * matLocal;
+    CommitTransform(s, i);
+  }
+}
+
+/**
+* 計算し直したモデル行列を境界球とUBOのデータに反映する.
+*
+* @param s エンティティのグループデータ.
+* @param i 反映するエンティティのグループデータ内の位置.
+*
+* UBOを作成できていないページのエンティティは、変更フラグを残して次回に再試行する.
+*/
+void Buffer::CommitTransform(GroupStorage& s, size_t i)
+{
+  UpdateBounds(s, i, s.entity[i]->ResolvedMesh());
+  s.transformStamp[i] = transformStamp;
+  if (ResolvedPackedProgram(*s.entity[i])) {
+    s.isDirty[i] = false;
+    return;
+  }
+  Page* page = pageDataList[s.pageIndex[i]];
+  if (!page) {
+    return;
+  }
+  s.isDirty[i] = false;
+  UpdateUniformVertexData(s, i, page->uboData.data() + s.uboOffset[i]);
+  page->dirtySlotList[s.uboOffset[i] / ubSizePerEntity] = 1;
+}
+
+/**
+* 親を持つエンティティのリストを作り直す.
+*
+* 深さが等しい要素の順序は問わないため、深さだけで並べ替える.
+*/
+void Buffer::RebuildTransformNodes()
+{
+  transformNodeList.clear();
+  for (GroupStorage& s : groups) {
+    for (size_t i = 0; i < s.Size(); ++i) {
+      if (!s.depth[i]) {
+        continue;
+      }
+      const Entity* parent = s.entity[i]->parent;
+      transformNodeList.push_back({ &s, static_cast<uint32_t>(i), parent->storage, parent->index, s.depth[i] });
+    }
+  }
+  std::sort(transformNodeList.begin(), transformNodeList.end(),
+    [](const TransformNode& lhs, const TransformNode& rhs) { return lhs.depth < rhs.depth; });
+  isHierarchyDirty = false;
+}
+
+/**
+* インスタンス描画用のシェーダを登録する.
+*
+* @param program          通常のシェーダ.
+* @param instancedProgram programの代わりにインスタンス描画で使うシェーダ.
+*                         VertexDataをUniform::maxInstanceCount要素の配列として受け取り、gl_InstanceIDで参照すること.
+*/
+void Buffer::InstancedProgram(const Shader::ProgramPtr& program, const Shader::ProgramPtr& instancedProgram)
+{
+  for (auto& e : instancedProgramList) {
+    if (e.first == program.get()) {
+      e.second = instancedProgram;
+      return;
+    }
+  }
+  instancedProgramList.push_back(std::make_pair(program.get(), instancedProgram));
+}
+
+/**
+* 詰めて格納したインスタンスデータを使うシェーダを登録する.
+*
+* @param program       通常のシェーダ.
+* @param packedProgram InstanceStore()でUniformBuffer以外を選んだとき、programの代わりに使うシェーダ.
+*                      Uniform::InstanceDataをinstanceBase+gl_InstanceID番目の要素として参照すること.
+*/
+void Buffer::PackedProgram(const Shader::ProgramPtr& program, const Shader::ProgramPtr& packedProgram)
+{
+  MarkAllDirty();
+  for (auto& e : packedProgramList) {
+    if (e.first == program.get()) {
+      e.second = packedProgram;
+      return;
+    }
+  }
+  packedProgramList.push_back(std::make_pair(program.get(), packedProgram));
+}
+
+/**
+* 影描画用のシェーダを登録する.
+*
+* @param program          個別に描画するときに使うシェーダ.
+* @param instancedProgram インスタンス描画で使うシェーダ. 空の場合、影の描画ではインスタンス描画を行わない.
+* @param packedProgram    詰めて格納したインスタンスデータを使うシェーダ.
+*                         空の場合、影を描画するエンティティは詰めて格納したインスタンスデータを使わない.
+*/
+void Buffer::DepthProgram(const Shader::ProgramPtr& program, const Shader::ProgramPtr& instancedProgram, const Shader::ProgramPtr& packedProgram)
+{
+  depthProgram = program;
+  depthInstancedProgram = instancedProgram;
+  depthPackedProgram = packedProgram;
+  MarkAllDirty();
+}
+
+/**
+* インスタンス描画でエンティティごとのデータを格納する場所を選ぶ.
+*
+* @param type 格納場所.
+*
+* @retval true  設定成功.
+* @retval false ストリーミングバッファが設定されていない.
+*
+* UniformBuffer以外では、視錐台と交差したエンティティのUniform::InstanceDataだけを毎回の描画でストリーミングバッファに詰めて書き込む.
+* エンティティごとにUBOの範囲を割り当て直す必要がなく、インスタンス描画1回あたりのインスタンス数にも上限がない.
+* PackedProgram()で対応するシェーダが登録されていないエンティティは、これまでどおりUBOを使う.
+*/
+bool Buffer::InstanceStore(InstanceStoreType type)
+{
+  if (type != InstanceStoreType::UniformBuffer) {
+    if (!streamBuffer) {
+      std::cerr << "WARNING in Entity::Buffer::InstanceStore: ストリーミングバッファが設定されていない." << std::endl;
+      return false;
+    }
+    if (type == InstanceStoreType::TextureBuffer && !instanceTexture) {
+      glGenTextures(1, &instanceTexture);
+    }
+  }
+  if (instanceStore != type) {
+    instanceStore = type;
+    MarkAllDirty();
+  }
+  return true;
+}
+
+/**
+* 全エンティティを変更されたものとして扱う.
+*
+* UBOへ転送するかどうかの条件が変わったときに呼び出す.
+*/
+void Buffer::MarkAllDirty()
+{
+  for (GroupStorage& s : groups) {
+    std::fill(s.isDirty.begin(), s.isDirty.end(), 1);
+  }
+}
+
+/**
+* インスタンス描画用のシェーダを検索する.
+*
+* @param program 通常のシェーダ.
+*
+* @return programに対応するインスタンス描画用シェーダ. 登録されていなければ空のポインタ.
+*/
+const Shader::ProgramPtr& Buffer::FindInstancedProgram(const Shader::Program* program) const
+{
+  static const Shader::ProgramPtr notFound;
+  for (const auto& e : instancedProgramList) {
+    if (e.first == program) {
+      return e.second;
+    }
+  }
+  return notFound;
+}
+
+/**
+* 詰めて格納したインスタンスデータを使うシェーダを検索する.
+*
+* @param program 通常のシェーダ.
+*
+* @return programに対応するシェーダ. 登録されていなければ空のポインタ.
+*/
+const Shader::ProgramPtr& Buffer::FindPackedProgram(const Shader::Program* program) const
+{
+  static const Shader::ProgramPtr notFound;
+  for (const auto& e : packedProgramList) {
+    if (e.first == program) {
+      return e.second;
+    }
+  }
+  return notFound;
+}
+
+/**
+* エンティティの描画に使う、詰めて格納したインスタンスデータ用のシェーダを取得する.
+*
+* @param e エンティティ.
+*
+* @return 詰めて格納したインスタンスデータだけで描画できる場合はそのシェーダ. できなければnullptr.
+*
+* インスタンス描画が有効で、格納場所がUniformBuffer以外で、影を描画するなら影描画用のシェーダも登録されている必要がある.
+*/
+Shader::Program* Buffer::ResolvedPackedProgram(const Entity& e) const
+{
+  if (!isInstancedDraw || instanceStore == InstanceStoreType::UniformBuffer || (depthProgram && !depthPackedProgram)) {
+    return nullptr;
+  }
+  return FindPackedProgram(e.ResolvedProgram().get()).get();
+}
+
+/**
+* インスタンス描画の単位を作成する.
+*
+* グループごとにエンティティをシェーダ・メッシュ・テクスチャで並べ替え、等しいものが連続する範囲を1つの単位にまとめる.
+* 視点ごとに見えるエンティティが異なるため、UBOへのコピーは描画時にPushInstances()で行う.
+* インスタンス描画用シェーダが登録されていないエンティティと、奥から順に描画する必要のある半透明のエンティティは
+* nonInstancedListに追加する.
+* 詰めて格納したインスタンスデータを使えるエンティティは、インスタンス描画用シェーダの代わりにそのシェーダを使う.
+*/
+void Buffer::BuildInstanceRuns()
+{
+  instanceRunList.clear();
+  instanceItemList.clear();
+  nonInstancedList.clear();
+  for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
+    const GroupStorage& s = groups[groupId];
+    const size_t firstItem = instanceItemList.size();
+    for (size_t i = 0; i < s.Size(); ++i) {
+      const Entity& e = *s.entity[i];
+      const Page* page = pageList[s.pageIndex[i]].get();
+      const Mesh::MeshPtr& mesh = e.ResolvedMesh();
+      const Shader::ProgramPtr& program = e.ResolvedProgram();
+      if (!mesh || !program || !page || !page->ubo) {
+        continue;
+      }
+      Shader::Program* packedProgram = ResolvedPackedProgram(e);
+      Shader::Program* instancedProgram = packedProgram ? packedProgram : FindInstancedProgram(program.get()).get();
+      if (!instancedProgram || s.color[i].w < 1) {
+        nonInstancedList.push_back({ groupId, static_cast<uint32_t>(i), packedProgram });
+        continue;
+      }
+      instanceItemList.push_back({ instancedProgram, mesh.get(), { e.Texture(0)->Id(), e.Texture(1)->Id() }, packedProgram != nullptr, static_cast<uint32_t>(i) });
+    }
+    const auto itrBegin = instanceItemList.begin() + firstItem;
+    std::sort(itrBegin, instanceItemList.end(), [](const InstanceItem& lhs, const InstanceItem& rhs) {
+      return std::tie(lhs.program, lhs.isPacked, lhs.mesh, lhs.texture[0], lhs.texture[1]) < std::tie(rhs.program, rhs.isPacked, rhs.mesh, rhs.texture[0], rhs.texture[1]);
+    });
+
+    // 描画状態が等しく連続する要素をまとめる.
+    for (size_t i = firstItem; i < instanceItemList.size();) {
+      const InstanceItem& item = instanceItemList[i];
+      size_t end = i + 1;
+      for (; end < instanceItemList.size(); ++end) {
+        const InstanceItem& e = instanceItemList[end];
+        if (e.program != item.program || e.isPacked != item.isPacked || e.mesh != item.mesh || e.texture[0] != item.texture[0] || e.texture[1] != item.texture[1]) {
+          break;
+        }
+      }
+      InstanceRun run;
+      run.groupId = groupId;
+      run.mesh = item.mesh;
+      run.texture[0] = item.texture[0];
+      run.texture[1] = item.texture[1];
+      run.program = item.program;
+      run.isPacked = item.isPacked;
+      run.firstItem = static_cast<uint32_t>(i);
+      run.count = static_cast<uint32_t>(end - i);
+      instanceRunList.push_back(run);
+      i = end;
+    }
+  }
+}
+
+/**
+* エンティティが視錐台と交差するか調べる.
+*
+* @param s       エンティティのグループデータ.
+* @param index   調べるエンティティのグループデータ内の位置.
+* @param frustum 視錐台.
+*
+* @retval true  交差している. 描画する必要がある.
+* @retval false 交差していない. 描画する必要はない.
+*
+* 調べたエンティティの数と交差したエンティティの数を記録する.
+* 境界球はグループ単位の平行移動量だけずらして調べる.
+*/
+bool Buffer::IsVisible(const GroupStorage& s, size_t index, const Collision::Frustum& frustum) const
+{
+  ++submittedEntityCount;
+  const glm::vec4& bounds = s.bounds[index];
+  if (!Collision::TestSphere(frustum, glm::vec3(bounds) + GroupOffsetOf(s), bounds.w)) {
+    return false;
+  }
+  ++visibleEntityCount;
+  return true;
+}
+
+/**
+* 視錐台と交差するエンティティをインスタンス描画用に描画キューに追加する.
+*
+* @param pass    描画パス(視点インデックス).
+* @param frustum 視錐台.
+* @param program 描画に使うシェーダ. nullptrなら単位ごとのインスタンス描画用シェーダを使う.
+*
+* 交差したエンティティのVertexDataだけをinstanceDataに詰め、最大maxInstanceCount個ずつの描画命令にする.
+* 詰めて格納したインスタンスデータを使う単位は、PushPackedInstances()が扱うので無視する.
+* 詰めたデータはストリーミングバッファから確保した領域へ転送する.
+* ストリーミングバッファがないか空きが足りない場合は、instanceUboをGL_MAP_INVALIDATE_BUFFER_BITでマップして転送する.
+*/
+void Buffer::PushInstances(int pass, const Collision::Frustum& frustum, Shader::Program* program) const
+{
+  instanceData.clear();
+  instancePacketList.clear();
+  for (const InstanceRun& run : instanceRunList) {
+    if (run.isPacked || !(visibilityFlags[run.groupId] & (1 << pass))) {
+      continue;
+    }
+    const GroupStorage& s = groups[run.groupId];
+    GLsizei count = 0;
+    for (uint32_t i = 0; i < run.count; ++i) {
+      const uint32_t index = instanceItemList[run.firstItem + i].index;
+      if (!IsVisible(s, index, frustum)) {
+        continue;
+      }
+      if (count == 0) {
+        const size_t offset = ((instanceData.size() + ubAlignment - 1) / ubAlignment) * ubAlignment;
+        instanceData.resize(offset);
+        const RenderQueue::Packet packet = {
+          program ? program : run.program, { run.texture[0], run.texture[1] }, run.mesh,
+          0, static_cast<GLintptr>(offset), 0, 0, 0, groupOffset[run.groupId]
+        };
+        instancePacketList.push_back(packet);
+      }
+      const uint8_t* src = pageList[s.pageIndex[index]]->uboData.data() + s.uboOffset[index];
+      instanceData.insert(instanceData.end(), src, src + instanceStride);
+      RenderQueue::Packet& packet = instancePacketList.back();
+      packet.uboSize += instanceStride;
+      ++packet.instanceCount;
+      if (++count >= Uniform::maxInstanceCount) {
+        count = 0;
+      }
+    }
+  }
+  if (instanceData.empty()) {
+    return;
+  }
+
+  const GLsizeiptr totalSize = static_cast<GLsizeiptr>(instanceData.size());
+  instanceDataBytes += totalSize;
+  if (streamBuffer) {
+    const StreamBuffer::Allocation a = streamBuffer->Allocate(totalSize, ubAlignment);
+    if (a) {
+      memcpy(a.pointer, instanceData.data(), totalSize);
+      streamBuffer->Commit();
+      for (RenderQueue::Packet& packet : instancePacketList) {
+        packet.ubo = streamBuffer->Id();
+        packet.uboOffset += a.offset;
+        renderQueue.Push(packet, pass, false, 0);
+      }
+      return;
+    }
+  }
+  if (!instanceUbo || instanceUbo->Size() < totalSize) {
+    instanceUbo = UniformBuffer::Create(totalSize + totalSize / 2, bindingPoint, ubName.c_str());
+    if (!instanceUbo) {
+      std::cerr << "WARNING in Entity::Buffer::Draw: インスタンス描画用UBOの作成に失敗." << std::endl;
+      return;
+    }
+  }
+  void* p = instanceUbo->MapBufferRange(0, totalSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+  if (!p) {
+    return;
+  }
+  memcpy(p, instanceData.data(), totalSize);
+  instanceUbo->UnmapBuffer();
+  for (RenderQueue::Packet& packet : instancePacketList) {
+    packet.ubo = instanceUbo->Id();
+    renderQueue.Push(packet, pass, false, 0);
+  }
+}
+
+/**
+* 視錐台と交差するエンティティを、詰めて格納したインスタンスデータを使って描画キューに追加する.
+*
+* @param pass    描画パス(視点インデックス).
+* @param frustum 視錐台.
+* @param program 描画に使うシェーダ. nullptrなら単位やエンティティごとのシェーダを使う.
+* @param matVP   半透明のエンティティの深度の計算に使うビュー・プロジェクション行列.
+* @param isDepth 影を描画する場合はtrue. 半透明でも不透明として扱う.
+*
+* 交差したエンティティのUniform::InstanceDataを、ストリーミングバッファから1回で確保した領域に隙間なく書き込む.
+* インスタンス描画の単位は視錐台と交差した数だけのインスタンスを1回で描画し、
+* 半透明のエンティティは奥から順に描画されるよう1つずつ描画命令にする.
+*/
+void Buffer::PushPackedInstances(int pass, const Collision::Frustum& frustum, Shader::Program* program, const glm::mat4& matVP, bool isDepth) const
+{
+  if (instanceStore == InstanceStoreType::UniformBuffer) {
+    return;
+  }
+  packedData.clear();
+  packedPacketList.clear();
+  for (const InstanceRun& run : instanceRunList) {
+    if (!run.isPacked || !(visibilityFlags[run.groupId] & (1 << pass))) {
+      continue;
+    }
+    const GroupStorage& s = groups[run.groupId];
+    const size_t first = packedData.size();
+    for (uint32_t i = 0; i < run.count; ++i) {
+      const uint32_t index = instanceItemList[run.firstItem + i].index;
+      if (IsVisible(s, index, frustum)) {
+        packedData.push_back(MakeInstanceData(s, index));
+      }
+    }
+    if (packedData.size() == first) {
+      continue;
+    }
+    const PackedPacket e = {
+      {
+        program ? program : run.program, { run.texture[0], run.texture[1] }, run.mesh,
+        0, 0, 0, static_cast<GLsizei>(packedData.size() - first), static_cast<GLint>(first), groupOffset[run.groupId]
+      },
+      false, 0
+    };
+    packedPacketList.push_back(e);
+  }
+  for (const DrawItem& item : nonInstancedList) {
+    if (!item.packedProgram || !(visibilityFlags[item.groupId] & (1 << pass))) {
+      continue;
+    }
+    const GroupStorage& s = groups[item.groupId];
+    if (!IsVisible(s, item.index, frustum)) {
+      continue;
+    }
+    const Entity& entity = *s.entity[item.index];
+    // クリップ座標のz+wは、透視投影・平行投影のどちらでも視点から離れるほど大きくなる.
+    const glm::vec4 clip = matVP * (s.matModel[item.index][3] + glm::vec4(groupOffset[item.groupId], 0));
+    const PackedPacket e = {
+      {
+        program ? program : item.packedProgram, { entity.Texture(0)->Id(), entity.Texture(1)->Id() }, entity.ResolvedMesh().get(),
+        0, 0, 0, 1, static_cast<GLint>(packedData.size()), groupOffset[item.groupId]
+      },
+      !isDepth && s.color[item.index].w < 1, clip.z + clip.w
+    };
+    packedPacketList.push_back(e);
+    packedData.push_back(MakeInstanceData(s, item.index));
+  }
+  if (packedData.empty()) {
+    return;
+  }
+
+  // 要素の大きさでアラインメントすれば、オフセットを要素番号に変換できる.
+  // 空きが足りない場合、ストリーミングバッファは次のフレームで拡張されるので、このフレームは描画しない.
+  const GLsizeiptr totalSize = static_cast<GLsizeiptr>(packedData.size() * sizeof(Uniform::InstanceData));
+  const StreamBuffer::Allocation a = streamBuffer->Allocate(totalSize, sizeof(Uniform::InstanceData));
+  if (!a) {
+    return;
+  }
+  memcpy(a.pointer, packedData.data(), totalSize);
+  streamBuffer->Commit();
+  instanceDataBytes += totalSize;
+  BindInstanceStore();
+  const GLint base = static_cast<GLint>(a.offset / sizeof(Uniform::InstanceData));
+  for (PackedPacket& e : packedPacketList) {
+    e.packet.instanceBase += base;
+    renderQueue.Push(e.packet, pass, e.isTransparent, e.depth);
+  }
+}
+
+/**
+* ストリーミングバッファを、詰めて格納したインスタンスデータとしてシェーダから参照できるようにする.
+*
+* テクスチャバッファはUniform::instanceDataTextureUnitに、
+* シェーダ・ストレージ・バッファはUniform::instanceDataStorageBindingに割り当てる.
+*/
+void Buffer::BindInstanceStore() const
+{
+  if (instanceStore == InstanceStoreType::StorageBuffer) {
+    GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, Uniform::instanceDataStorageBinding, streamBuffer->Id());
+    return;
+  }
+  // ストリーミングバッファは拡張されると作り直されるため、関連付けもやり直す.
+  if (instanceTextureBuffer != streamBuffer->Id() || instanceTextureSize != streamBuffer->SegmentSize()) {
+    GLState::EditTexture(GL_TEXTURE_BUFFER, instanceTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, streamBuffer->Id());
+    instanceTextureBuffer = streamBuffer->Id();
+    instanceTextureSize = streamBuffer->SegmentSize();
+  }
+  GLState::BindTexture(GL_TEXTURE0 + Uniform::instanceDataTextureUnit, GL_TEXTURE_BUFFER, instanceTexture);
+}
+
+/**
+* エンティティを1つ描画キューに追加する.
+*
+* @param s       エンティティのグループデータ.
+* @param index   追加するエンティティのグループデータ内の位置.
+* @param pass    描画パス(視点インデックス).
+* @param program 描画に使うシェーダ. nullptrならエンティティのシェーダを使う.
+* @param matVP   深度の計算に使うビュー・プロジェクション行列.
+* @param isDepth 影を描画する場合はtrue. 半透明でも不透明として扱う.
+*/
+void Buffer::PushEntity(const GroupStorage& s, size_t index, int pass, Shader::Program* program, const glm::mat4& matVP, bool isDepth) const
+{
+  const Entity& e = *s.entity[index];
+  const UniformBufferPtr& ubo = pageList[s.pageIndex[index]]->ubo;
+  const Mesh::MeshPtr& mesh = e.ResolvedMesh();
+  const Shader::ProgramPtr& entityProgram = e.ResolvedProgram();
+  if (!mesh || !entityProgram || !ubo) {
+    return;
+  }
+  RenderQueue::Packet packet;
+  packet.program = program ? program : entityProgram.get();
+  packet.texture[0] = e.Texture(0)->Id();
+  packet.texture[1] = e.Texture(1)->Id();
+  packet.mesh = mesh.get();
+  packet.ubo = ubo->Id();
+  packet.uboOffset = s.uboOffset[index];
+  packet.uboSize = ubSizePerEntity;
+  packet.instanceCount = 0;
+  packet.instanceBase = 0;
+  packet.groupOffset = GroupOffsetOf(s);
+  // クリップ座標のz+wは、透視投影・平行投影のどちらでも視点から離れるほど大きくなる.
+  const glm::vec4 clip = matVP * (s.matModel[index][3] + glm::vec4(packet.groupOffset, 0));
+  renderQueue.Push(packet, pass, !isDepth && s.color[index].w < 1, clip.z + clip.w);
+}
+
+/**
+* 弾を描画キューに追加する.
+*
+* @param pass    描画パス(視点インデックス).
+* @param program 描画に使うシェーダ. nullptrなら種類ごとのシェーダに対応する、詰めて格納したインスタンスデータを使うシェーダを使う.
+* @param isDepth 影を描画する場合はtrue. 半透明でも不透明として扱う.
+*
+* 全ての種類のインスタンスデータを1回でストリーミングバッファに書き込み、種類ごとに1つのインスタンス描画命令を作る.
+* 弾は範囲外に出ると削除されるため、視錐台カリングは行わない.
+* 弾の座標は常にワールド座標なので、グループ単位の平行移動量は適用しない.
+*/
+void Buffer::PushBullets(int pass, Shader::Program* program, bool isDepth) const
+{
+  if (instanceStore == InstanceStoreType::UniformBuffer) {
+    return;
+  }
+  const BulletBuffer& bullets = *bulletBuffer;
+  size_t total = 0;
+  for (const BulletBuffer::Pool& pool : bullets.poolList) {
+    if (visibilityFlags[pool.archetype.groupId] & (1 << pass)) {
+      total += pool.count;
+    }
+  }
+  if (total == 0) {
+    return;
+  }
+
+  // 空きが足りない場合、ストリーミングバッファは次のフレームで拡張されるので、このフレームは描画しない.
+  const GLsizeiptr totalSize = static_cast<GLsizeiptr>(total * sizeof(Uniform::InstanceData));
+  const StreamBuffer::Allocation a = streamBuffer->Allocate(totalSize, sizeof(Uniform::InstanceData));
+  if (!a) {
+    return;
+  }
+  Uniform::InstanceData* out = static_cast<Uniform::InstanceData*>(a.pointer);
+  GLint base = static_cast<GLint>(a.offset / sizeof(Uniform::InstanceData));
+  for (size_t i = 0; i < bullets.poolList.size(); ++i) {
+    const BulletBuffer::Pool& pool = bullets.poolList[i];
+    if (pool.count == 0 || !(visibilityFlags[pool.archetype.groupId] & (1 << pass)) || !pool.archetype.mesh) {
+      continue;
+    }
+    Shader::Program* p = program ? program : FindPackedProgram(pool.archetype.program.get()).get();
+    if (!p) {
+      continue;
+    }
+    const GLsizei n = static_cast<GLsizei>(bullets.WriteInstanceData(i, out));
+    if (n == 0) {
+      continue;
+    }
+    const TexturePtr* t = pool.archetype.texture;
+    const RenderQueue::Packet packet = {
+      p, { t[0] ? t[0]->Id() : 0, t[1] ? t[1]->Id() : 0 }, pool.archetype.mesh.get(),
+      0, 0, 0, n, base, glm::vec3(0)
+    };
+    renderQueue.Push(packet, pass, !isDepth && pool.color.w < 1, 0);
+    out += n;
+    base += n;
+  }
+  streamBuffer->Commit();
+  instanceDataBytes += totalSize;
+  BindInstanceStore();
+}
+
+/**
+* アクティブなエンティティを描画する.
+*
+* @param viewIndex  表示するビューインデックス.
+* @param meshBuffer 描画に使用するメッシュバッファへのポインタ.
+*
+* viewIndexに対応する可視フラグがtrueのエンティティグループだけが描画される.
+* さらに、境界球が視錐台の外にあるエンティティはGLの命令を作る前に除外される.
+* インスタンス描画が有効な場合、描画状態の等しいエンティティはまとめて描画される.
+* さらにInstanceStore()でUniformBuffer以外を選んでいれば、詰めて格納したインスタンスデータが使われる.
+* 描画命令はRenderQueueで状態ごとに並べ替えられ、不透明なものは手前から、半透明なものは奥から描画される.
+*/
+void Buffer::Draw(int viewIndex, const Mesh::BufferPtr& meshBuffer) const
+{
+  renderQueue.Clear();
+  const glm::mat4& matVP = lastMatVP[viewIndex];
+  const Collision::Frustum frustum = Collision::CreateFrustum(matVP);
+  if (!isInstancedDraw) {
+    for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
+      if (!(visibilityFlags[groupId] & (1 << viewIndex))) {
+        continue;
+      }
+      const GroupStorage& s = groups[groupId];
+      for (size_t index = 0; index < s.Size(); ++index) {
+        if (IsVisible(s, index, frustum)) {
+          PushEntity(s, index, viewIndex, nullptr, matVP, false);
+        }
+      }
+    }
+  } else {
+    PushPackedInstances(viewIndex, frustum, nullptr, matVP, false);
+    PushInstances(viewIndex, frustum, nullptr);
+    for (const DrawItem& e : nonInstancedList) {
+      const GroupStorage& s = groups[e.groupId];
+      if (!e.packedProgram && (visibilityFlags[e.groupId] & (1 << viewIndex)) && IsVisible(s, e.index, frustum)) {
+        PushEntity(s, e.index, viewIndex, nullptr, matVP, false);
+      }
+    }
+  }
+  PushBullets(viewIndex, nullptr, false);
+  renderQueue.Execute(meshBuffer, bindingPoint);
+}
+
+/**
+* アクティブなエンティティの影を描画する.
+*
+* @param viewIndex  表示するビューインデックス.
+* @param meshBuffer 描画に使用するメッシュバッファへのポインタ.
+*
+* DepthProgram()で登録したシェーダを使って描画する. 登録されていなければなにもしない.
+* 影用のビュー・プロジェクション行列から作った視錐台の外にあるエンティティは描画しない.
+* インスタンス描画用の影描画シェーダも登録されていれば、インスタンス描画の単位ごとにまとめて描画する.
+*/
+void Buffer::DrawDepth(int viewIndex, const Mesh::BufferPtr& meshBuffer) const
+{
+  if (!depthProgram) {
+    return;
+  }
+  renderQueue.Clear();
+  const Collision::Frustum frustum = Collision::CreateFrustum(lastMatDepthVP);
+  if (!isInstancedDraw) {
+    for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
+      if (!(visibilityFlags[groupId] & (1 << viewIndex))) {
+        continue;
+      }
+      const GroupStorage& s = groups[groupId];
+      for (size_t index = 0; index < s.Size(); ++index) {
+        if (IsVisible(s, index, frustum)) {
+          PushEntity(s, index, viewIndex, depthProgram.get(), lastMatDepthVP, true);
+        }
+      }
+    }
+  } else {
+    if (depthPackedProgram) {
+      PushPackedInstances(viewIndex, frustum, depthPackedProgram.get(), lastMatDepthVP, true);
+    }
+    if (depthInstancedProgram) {
+      PushInstances(viewIndex, frustum, depthInstancedProgram.get());
+    } else {
+      for (const InstanceRun& run : instanceRunList) {
+        if (run.isPacked || !(visibilityFlags[run.groupId] & (1 << viewIndex))) {
+          continue;
+        }
+        const GroupStorage& s = groups[run.groupId];
+        for (uint32_t i = 0; i < run.count; ++i) {
+          const uint32_t index = instanceItemList[run.firstItem + i].index;
+          if (IsVisible(s, index, frustum)) {
+            PushEntity(s, index, viewIndex, depthProgram.get(), lastMatDepthVP, true);
+          }
+        }
+      }
+    }
+    for (const DrawItem& e : nonInstancedList) {
+      const GroupStorage& s = groups[e.groupId];
+      if (!e.packedProgram && (visibilityFlags[e.groupId] & (1 << viewIndex)) && IsVisible(s, e.index, frustum)) {
+        PushEntity(s, e.index, viewIndex, depthProgram.get(), lastMatDepthVP, true);
+      }
+    }
+  }
+  if (depthPackedProgram) {
+    PushBullets(viewIndex, depthPackedProgram.get(), true);
+  }
+  renderQueue.Execute(meshBuffer, bindingPoint);
+}
+
+/**
+* 衝突解決ハンドラを設定する.
+*
+* @param gid0    衝突対象のグループID.
+* @param gid1    衝突対象のグループID.
+* @param handler 衝突解決ハンドラ.
+*
+* 衝突が発生し衝突解決ハンドラが呼びされるとき、より小さいグループIDを持つエンティティから先に渡される.
+* ここで指定したグループIDの順序とは無関係であることに注意すること.
+* ex)
+*   CollisionHandler(10, 1, Func)
+*   というコードでハンドラを登録したとする. 衝突が発生すると、
+*   Func(グループID=1のエンティティ、グループID=10のエンティティ)
+*   のように呼び出される.
+*
+* ハンドラは全ての衝突判定が終わったあとで、グループIDの小さい組から順に1スレッドで呼び出される.
+* ハンドラの中で削除されたエンティティは、以降のハンドラには渡されない.
+* ハンドラの中で追加したエンティティは次のUpdateから判定される.
+* handlerにnullptrを指定すると、そのグループの組の衝突判定は行われなくなる.
+*/
+void Buffer::CollisionHandler(int gid0, int gid1, CollisionHandlerType handler)
+{
+  if (gid0 < 0 || gid0 > maxGroupId || gid1 < 0 || gid1 > maxGroupId) {
+    std::cerr << "WARNING in Entity::Buffer::CollisionHandler: 無効なグループIDが渡されました(" << gid0 << ", " << gid1 << ")." << std::endl;
+    return;
+  }
+  if (gid0 > gid1) {
+    std::swap(gid0, gid1);
+  }
+  collisionHandlerTable[gid0][gid1] = std::move(handler);
+  if (collisionHandlerTable[gid0][gid1]) {
+    collisionGroupMask[gid0] |= 1U << gid1;
+    collisionGroupMask[gid1] |= 1U << gid0;
+  } else {
+    collisionGroupMask[gid0] &= ~(1U << gid1);
+    collisionGroupMask[gid1] &= ~(1U << gid0);
+  }
+}
+
+/**
+* 衝突解決ハンドラを取得する.
+*
+* @param gid0 衝突対象のグループID.
+* @param gid1 衝突対象のグループID.
+*
+* @return 衝突解決ハンドラ.
+*/
+const CollisionHandlerType& Buffer::CollisionHandler(int gid0, int gid1) const
+{
+  if (gid0 > gid1) {
+    std::swap(gid0, gid1);
+  }
+  if (gid0 < 0 || gid1 > maxGroupId) {
+    static const CollisionHandlerType dummy;
+    return dummy;
+  }
+  return collisionHandlerTable[gid0][gid1];
+}
+
+/**
+* 全ての衝突解決ハンドラを削除する.
+*/
+void Buffer::ClearCollisionHandlerList()
+{
+  for (int i = 0; i <= maxGroupId; ++i) {
+    for (auto& e : collisionHandlerTable[i]) {
+      e = nullptr;
+    }
+    collisionGroupMask[i] = 0;
+  }
+}
+
+/**
+* グループの空間検索の可否を設定する.
+*
+* @param groupId   設定するグループID.
+* @param isEnabled 検索できるようにするならtrue、しないならfalse.
+*
+* @retval true  設定成功.
+* @retval false 無効なグループIDが渡されたか、更新中に呼び出された.
+*
+* 有効にしたグループのエンティティは、次のUpdate()から検索対象になる.
+* 無効にすると、そのグループのエンティティはただちに木から取り除かれる.
+* GroupVelocity()で動かしているグループは、多くのエンティティが毎回木に挿入し直されることに注意.
+*/
+bool Buffer::GroupSpatialQuery(int groupId, bool isEnabled)
+{
+  if (groupId < 0 || groupId > maxGroupId) {
+    std::cerr << "WARNING in Entity::Buffer::GroupSpatialQuery: 無効なグループIDが渡されました(" << groupId << ")." << std::endl;
+    return false;
+  }
+  if (isUpdating) {
+    std::cerr << "WARNING in Entity::Buffer::GroupSpatialQuery: 更新中は設定できません." << std::endl;
+    return false;
+  }
+  spatialQueryFlags[groupId] = isEnabled;
+  if (!isEnabled) {
+    for (Entity* e : groups[groupId].entity) {
+      if (e->treeProxy != Collision::AabbTree::nullNode) {
+        spatialTree.Remove(e->treeProxy);
+        e->treeProxy = Collision::AabbTree::nullNode;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+* 空間検索用の木を更新する.
+*
+* 空間検索が有効なグループのエンティティのうち、未登録のものを木に追加し、登録済みのものは衝突形状に合わせて移動する.
+* 削除が保留されているエンティティは、ReleaseEntity()で木から取り除かれる.
+*/
+void Buffer::UpdateSpatialTree()
+{
+  for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
+    if (!spatialQueryFlags[groupId]) {
+      continue;
+    }
+    const GroupStorage& s = groups[groupId];
+    const uint32_t category = 1U << groupId;
+    for (size_t i = 0; i < s.Size(); ++i) {
+      Entity* e = s.entity[i];
+      const CollisionData& col = s.colWorld[i];
+      if (e->treeProxy == Collision::AabbTree::nullNode) {
+        e->treeProxy = spatialTree.Insert(col.min, col.max, e, category);
+      } else {
+        spatialTree.Move(e->treeProxy, col.min, col.max);
+      }
+    }
+  }
+}
+
+/**
+* 空間検索の統計に1回分の結果を加える.
+*
+* @param nanoseconds      検索にかかった時間(ナノ秒).
+* @param visitedNodeCount 調べた木のノードの数.
+* @param resultCount      見つかったエンティティの数.
+*/
+void Buffer::RecordSpatialQuery(int64_t nanoseconds, size_t visitedNodeCount, size_t resultCount) const
+{
+  spatialQueryCount.fetch_add(1, std::memory_order_relaxed);
+  spatialQueryNodeCount.fetch_add(visitedNodeCount, std::memory_order_relaxed);
+  spatialQueryResultCount.fetch_add(resultCount, std::memory_order_relaxed);
+  spatialQueryNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+/**
+* 開始時刻からの経過時間を取得する.
+*
+* @param start 開始時刻.
+*
+* @return 経過時間(ナノ秒).
+*/
+static int64_t ElapsedNanoseconds(Clock::time_point start)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+/**
+* 直方体と重なるエンティティを検索する.
+*
+* @param min       検索範囲の最小座標.
+* @param max       検索範囲の最大座標.
+* @param groupMask 検索するグループのビットマスク.
+* @param out       見つかったエンティティを格納する配列.
+* @param capacity  outに格納できる要素数.
+*
+* @return outに格納したエンティティの数. capacity個見つかった時点で検索を打ち切る.
+*
+* 判定にはワールド座標系の衝突形状を使う. 見つかる順番は不定.
+*/
+size_t Buffer::QueryBox(const glm::vec3& min, const glm::vec3& max, uint32_t groupMask, Entity** out, size_t capacity) const
+{
+  if (!capacity) {
+    return 0;
+  }
+  const Clock::time_point start = Clock::now();
+  size_t count = 0;
+  const size_t visited = spatialTree.Query(min, max, groupMask, [&](void* p) {
+    Entity* e = static_cast<Entity*>(p);
+    if (!e->isActive) {
+      return true;
+    }
+    const CollisionData& col = e->storage->colWorld[e->index];
+    if (glm::any(glm::greaterThan(col.min, max)) || glm::any(glm::lessThan(col.max, min))) {
+      return true;
+    }
+    out[count++] = e;
+    return count < capacity;
+  });
+  RecordSpatialQuery(ElapsedNanoseconds(start), visited, count);
+  return count;
+}
+
+/**
+* 球と重なるエンティティを検索する.
+*
+* @param center    球の中心座標.
+* @param radius    球の半径.
+* @param groupMask 検索するグループのビットマスク.
+* @param out       見つかったエンティティを格納する配列.
+* @param capacity  outに格納できる要素数.
+*
+* @return outに格納したエンティティの数. capacity個見つかった時点で検索を打ち切る.
+*
+* 判定にはワールド座標系の衝突形状を使う. 見つかる順番は不定.
+*/
+size_t Buffer::QueryRadius(const glm::vec3& center, float radius, uint32_t groupMask, Entity** out, size_t capacity) const
+{
+  if (!capacity) {
+    return 0;
+  }
+  const Clock::time_point start = Clock::now();
+  const float radiusSq = radius * radius;
+  size_t count = 0;
+  const size_t visited = spatialTree.Query(center - glm::vec3(radius), center + glm::vec3(radius), groupMask, [&](void* p) {
+    Entity* e = static_cast<Entity*>(p);
+    if (!e->isActive) {
+      return true;
+    }
+    const CollisionData& col = e->storage->colWorld[e->index];
+    if (Collision::DistanceSquared(center, col.min, col.max) > radiusSq) {
+      return true;
+    }
+    out[count++] = e;
+    return count < capacity;
+  });
+  RecordSpatialQuery(ElapsedNanoseconds(start), visited, count);
+  return count;
+}
+
+/**
+* 半直線と最初に交差するエンティティを検索する.
+*
+* @param origin      半直線の始点.
+* @param direction   半直線の方向.
+* @param maxDistance 検索する最大距離.
+* @param groupMask   検索するグループのビットマスク.
+* @param distance    交差するエンティティが見つかった場合、始点から衝突形状までの距離を格納する変数.
+*                    不要ならnullptr.
+*
+* @return 最初に交差するエンティティ. 見つからなければnullptr.
+*
+* 始点が衝突形状の内部にある場合、そのエンティティの距離は0になる.
+*/
+Entity* Buffer::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, uint32_t groupMask, float* distance) const
+{
+  const float length = glm::length(direction);
+  if (length <= 0) {
+    return nullptr;
+  }
+  const Clock::time_point start = Clock::now();
+  const glm::vec3 dir = direction / length;
+  const glm::vec3 invDir = 1.0f / dir;
+  Entity* hit = nullptr;
+  float hitDistance = maxDistance;
+  const size_t visited = spatialTree.Raycast(origin, dir, maxDistance, groupMask, [&](void* p, float currentMax) {
+    Entity* e = static_cast<Entity*>(p);
+    if (!e->isActive) {
+      return currentMax;
+    }
+    const CollisionData& col = e->storage->colWorld[e->index];
+    float d;
+    if (!Collision::TestRay(origin, invDir, currentMax, col.min, col.max, d) || d >= hitDistance) {
+      return currentMax;
+    }
+    hit = e;
+    hitDistance = d;
+    return d;
+  });
+  RecordSpatialQuery(ElapsedNanoseconds(start), visited, hit ? 1 : 0);
+  if (hit && distance) {
+    *distance = hitDistance;
+  }
+  return hit;
+}
+
+/**
+* 指定した座標に近いエンティティを検索する.
+*
+* @param center      検索の中心座標.
+* @param k           検索するエンティティの数.
+* @param groupMask   検索するグループのビットマスク.
+* @param out         見つかったエンティティと距離を格納する配列. k個以上の要素を格納できること.
+* @param maxDistance 検索する最大距離.
+*
+* @return outに格納したエンティティの数. 距離の近い順に格納される.
+*
+* 距離は中心座標からワールド座標系の衝突形状までの距離で、中心座標が衝突形状の内部にあれば0になる.
+*/
+size_t Buffer::Nearest(const glm::vec3& center, size_t k, uint32_t groupMask, SpatialQueryResult* out, float maxDistance) const
+{
+  if (!k) {
+    return 0;
+  }
+  const Clock::time_point start = Clock::now();
+  size_t count = 0;
+  const size_t visited = spatialTree.QueryNearest(center, maxDistance, groupMask, [&](void* p, float currentMax) {
+    Entity* e = static_cast<Entity*>(p);
+    if (!e->isActive) {
+      return currentMax;
+    }
+    const CollisionData& col = e->storage->colWorld[e->index];
+    const float d = std::sqrt(Collision::DistanceSquared(center, col.min, col.max));
+    if (d > currentMax) {
+      return currentMax;
+    }
+    // 距離の昇順を保つように挿入する. k個見つかっていれば最も遠いものを押し出す.
+    if (count < k) {
+      ++count;
+    } else if (d >= out[k - 1].distance) {
+      return currentMax;
+    }
+    size_t i = count - 1;
+    for (; i > 0 && out[i - 1].distance > d; --i) {
+      out[i] = out[i - 1];
+    }
+    out[i].entity = e;
+    out[i].distance = d;
+    return count < k ? currentMax : out[k - 1].distance;
+  });
+  RecordSpatialQuery(ElapsedNanoseconds(start), visited, count);
+  return count;
+}
+
+/**
+* 空間検索の統計を取得する.
+*
+* @return ResetSpatialQueryStats()を呼んでからの統計.
+*/
+SpatialQueryStatistics Buffer::SpatialQueryStats() const
+{
+  SpatialQueryStatistics stats;
+  stats.queryCount = spatialQueryCount.load(std::memory_order_relaxed);
+  stats.visitedNodeCount = spatialQueryNodeCount.load(std::memory_order_relaxed);
+  stats.resultCount = spatialQueryResultCount.load(std::memory_order_relaxed);
+  stats.seconds = static_cast<double>(spatialQueryNanoseconds.load(std::memory_order_relaxed)) * 1e-9;
+  return stats;
+}
+
+/**
+* 空間検索の統計をリセットする.
+*/
+void Buffer::ResetSpatialQueryStats()
+{
+  spatialQueryCount = 0;
+  spatialQueryNodeCount = 0;
+  spatialQueryResultCount = 0;
+  spatialQueryNanoseconds = 0;
+}
+
+} // namespace Entity
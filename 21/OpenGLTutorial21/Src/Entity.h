@@ -1,202 +1,822 @@
-/**
-* @file Entity.h
-*/
-#ifndef OPENGLTUTORIAL_SRC_ENTITY_H_INCLUDED
-#define OPENGLTUTORIAL_SRC_ENTITY_H_INCLUDED
-#include <GL/glew.h>
-#include "Mesh.h"
-#include "Texture.h"
-#include "Shader.h"
-#include "UniformBuffer.h"
-#include <glm/glm.hpp>
-#include <glm/gtx/quaternion.hpp>
-#include <memory>
-#include <functional>
-#include <vector>
-
-namespace Entity {
-
-class Entity;
-class Buffer;
-typedef std::shared_ptr<Buffer> BufferPtr; ///< GeBeBobt@|C^^.
-typedef std::function<void(Entity&, Entity&)> CollisionHandlerType; ///< Փˉnh^.
-
-static const int maxGroupId = 15; ///< O[vID̍ől.
-
-/**
-* Փ˔.
-*/
-struct CollisionData
-{
-  glm::vec3 min;
-  glm::vec3 max;
-};
-
-/**
-* GeBeB.
-*/
-class Entity
-{
-  friend class Buffer;
-
-public:
-  typedef std::function<void(Entity&, double)> UpdateFuncType;
-
-  void Position(const glm::vec3& pos) { position = pos; }
-  const glm::vec3& Position() const { return position; }
-  void Rotation(const glm::quat& rot) { rotation = rot; }
-  const glm::quat& Rotation() const { return rotation; }
-  void Scale(const glm::vec3& s) { scale = s; }
-  const glm::vec3& Scale() const { return scale; }
-  void Velocity(const glm::vec3& v) { velocity = v; }
-  const glm::vec3& Velocity() const { return velocity; }
-  void Color(const glm::vec4& c) { color = c; }
-  const glm::vec4& Color() const { return color; }
-  void UpdateFunc(const UpdateFuncType& func) { updateFunc = func; }
-  UpdateFuncType& UpdateFunc() { return updateFunc; }
-  const UpdateFuncType& UpdateFunc() const { return updateFunc; }
-  void Collision(const CollisionData& c) { colLocal = c; }
-  const CollisionData& Collision() const { return colLocal; }
-  void Texture(size_t n, const TexturePtr& p) { texture[n] = p; }
-  const TexturePtr& Texture(size_t n) const { return texture[n]; }
-
-  glm::mat4 TRSMatrix() const;
-  int GroupId() const { return groupId; }
-
-  void Destroy();
-
-private:
-  Entity() = default;
-  ~Entity() = default;
-  Entity(const Entity&) = default;
-  Entity& operator=(const Entity&) = default;
-
-private:
-  int groupId = -1;
-  Buffer* pBuffer = nullptr; ///< BufferNXւ̃|C^.
-  glm::vec3 position; ///< W.
-  glm::quat rotation; ///< ].
-  glm::vec3 scale = glm::vec3(1, 1, 1); ///< 傫.
-  glm::vec3 velocity; ///< x.
-  glm::vec4 color = glm::vec4(1, 1, 1, 1); ///< F.
-  Mesh::MeshPtr mesh; ///< GeBeB`悷ƂɎg郁bVf[^.
-  TexturePtr texture[2]; ///< GeBeB`悷ƂɎgeNX`.
-  Shader::ProgramPtr program; ///< GeBeB`悷ƂɎgVF[_.
-  GLintptr uboOffset; ///< UBÕGeBeBp̈ւ̃oCgItZbg.
-  UpdateFuncType updateFunc; ///< ԍXV֐.
-  CollisionData colLocal;
-  CollisionData colWorld;
-  bool isActive = false;
-};
-
-/**
-* GeBeBobt@.
-*/
-class Buffer
-{
-  struct Link;
-  struct LinkEntity;
-public:
-  /// Ce[^E萔Ce[^ʂ̃NXev[g.
-  template<typename T>
-  class IteratorBase : public std::iterator<std::bidirectional_iterator_tag, Entity>
-  {
-  public:
-    IteratorBase() = default;
-    explicit IteratorBase(T* p) : link(p) {}
-
-    explicit operator bool() const { return link; }
-    bool operator!() const { return !link; }
-    bool operator==(const IteratorBase& rhs) const { return link == rhs.link; }
-    bool operator!=(const IteratorBase& rhs) const { return link != rhs.link; }
-    friend void swap(IteratorBase& lhs, IteratorBase& rhs) {
-      T tmp = lhs.link;
-      lhs.link = rhs.link;
-      rhs.link = tmp;
-    }
-
-    IteratorBase& operator++() { link = link->next; return *this; }
-    IteratorBase operator++(int) { IteratorBase tmp = *this;  link = link->next; return tmp; }
-    IteratorBase& operator--() { link = link->prev; return *this; }
-    IteratorBase operator--(int) { IteratorBase tmp = *this;  link = link->prev; return tmp; }
-
-    Entity* operator->() { return static_cast<LinkEntity*>(link); }
-    const Entity* operator->() const { return static_cast<LinkEntity*>(link); }
-    Entity& operator*() { return *static_cast<LinkEntity*>(link); }
-    const Entity& operator*() const { return *static_cast<LinkEntity*>(link); }
-  private:
-    T* link;
-  };
-  typedef IteratorBase<Link> Iterator; ///< Ce[^.
-  typedef IteratorBase<const Link> ConstIterator; ///< 萔Ce[^.
-
-  static BufferPtr Create(size_t maxEntityCount, GLsizeiptr ubSizePerEntity, int bindingPoint, const char* ubName);
-
-  Entity* AddEntity(int groupId, const glm::vec3& pos, const Mesh::MeshPtr& m, const TexturePtr t[2], const Shader::ProgramPtr& p, const Entity::UpdateFuncType& func);
-  void RemoveEntity(Entity* entity);
-  void RemoveAllEntity();
-  void GroupVisibility(int groupId, int cameraIndex, bool isVisible) {
-    if (isVisible) {
-      visibilityFlags[groupId] |= (1U << cameraIndex);
-    } else {
-      visibilityFlags[groupId] &= ~(1U << cameraIndex);
-    }
-  }
-  bool GroupVisibility(int groupId, int cameraIndex) const { return visibilityFlags[groupId] & (1U << cameraIndex); }
-  void Update(double delta, const glm::mat4* matView, const glm::mat4& matProj, const glm::mat4& matDepthVP);
-  void Draw(int viewIndex, const Mesh::BufferPtr& meshBuffer) const;
-  void DrawDepth(int viewIndex, const Mesh::BufferPtr& meshBuffer) const;
-
-  void CollisionHandler(int gid0, int gid1, const CollisionHandlerType& handler);
-  const CollisionHandlerType& CollisionHandler(int gid0, int gid1) const;
-  void ClearCollisionHandlerList();
-
-  Iterator Begin() { return Iterator(activeList[0].next); }
-  Iterator End() { return Iterator(&activeList[0]); }
-  ConstIterator Begin() const { return ConstIterator(activeList[0].next); }
-  ConstIterator End() const { return ConstIterator(&activeList[0]); }
-
-private:
-  Buffer() = default;
-  ~Buffer() = default;
-  Buffer(const Buffer&) = delete;
-  Buffer& operator=(const Buffer&) = delete;
-
-private:
-  /// GeBeBpNXg.
-  struct Link {
-    void Insert(Link* e);
-    void Remove();
-    Link* prev = this;
-    Link* next = this;
-  };
-  /// NGeBeB.
-  struct LinkEntity : public Link, public Entity {};
-  /// NtGeBeBz̍폜֐.
-  struct EntityArrayDeleter { void operator()(LinkEntity* p) { delete[] p; } };
-
-  std::unique_ptr<LinkEntity[], EntityArrayDeleter> buffer;
-  size_t bufferSize;
-  GLsizeiptr ubSizePerEntity;
-  Link freeList;
-  Link activeList[maxGroupId + 1];
-  glm::u32 visibilityFlags[maxGroupId + 1] = { 0 };
-  UniformBufferPtr ubo;
-  Link* itrUpdate = nullptr;
-  Link* itrUpdateRhs = nullptr;
-
-  struct CollisionHandlerElement {
-    int groupId[2];
-    CollisionHandlerType handler;
-  };
-  std::vector<CollisionHandlerElement> collisionHandlerList;
-};
-
-inline Buffer::Iterator begin(Buffer& buffer) { return buffer.Begin(); }
-inline Buffer::Iterator end(Buffer& buffer) { return buffer.End(); }
-inline Buffer::ConstIterator begin(const Buffer& buffer) { return buffer.Begin(); }
-inline Buffer::ConstIterator end(const Buffer& buffer) { return buffer.End(); }
-
-} // namespace Entity
-
-#endif // OPENGLTUTORIAL_SRC_ENTITY_H_INCLUDED
\ No newline at end of file
+/**
+* @file Entity.h
+*/
+#ifndef OPENGLTUTORIAL_SRC_ENTITY_H_INCLUDED
+#define OPENGLTUTORIAL_SRC_ENTITY_H_INCLUDED
+#include <GL/glew.h>
+#include "Mesh.h"
+#include "Texture.h"
+#include "Shader.h"
+#include "UniformBuffer.h"
+#include "Uniform.h"
+#include "Collision.h"
+#include "ThreadPool.h"
+#include "RenderQueue.h"
+#include "StreamBuffer.h"
+#include "InlineFunction.h"
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+#include <memory>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <cfloat>
+#include <algorithm>
+
+namespace Entity {
+
+class Entity;
+class Buffer;
+class BehaviorTable;
+class BulletBuffer;
+class Snapshot;
+struct Archetype;
+typedef std::shared_ptr<Buffer> BufferPtr; ///< エンティティバッファポインタ型.
+typedef std::shared_ptr<BehaviorTable> BehaviorTablePtr; ///< 振る舞いテーブルポインタ型.
+typedef InlineFunction<void(Entity&, Entity&)> CollisionHandlerType; ///< 衝突解決ハンドラ型.
+typedef int ArchetypeId; ///< アーキタイプID型.
+
+static const int maxGroupId = 15; ///< グループIDの最大値.
+static const uint32_t allGroupMask = ~0U; ///< 全てのグループを表すビットマスク.
+
+/**
+* インスタンス描画でエンティティごとのデータを格納する場所.
+*/
+enum class InstanceStoreType {
+  UniformBuffer, ///< ページごとのUBO. 1エンティティにつきUBOのアラインメント単位の領域を使う.
+  TextureBuffer, ///< テクスチャバッファ. Uniform::InstanceDataを詰めて格納する. OpenGL 4.1以降.
+  StorageBuffer, ///< シェーダ・ストレージ・バッファ. Uniform::InstanceDataを詰めて格納する. OpenGL 4.3以降.
+};
+
+/**
+* 衝突判定.
+*/
+struct CollisionData
+{
+  glm::vec3 min;
+  glm::vec3 max;
+};
+
+/**
+* グループ単位のエンティティデータ.
+*
+* 毎フレーム全エンティティを走査する必要のあるデータを、要素ごとの配列(SoA)として保持する.
+* エンティティが削除されると、末尾の要素を空いた位置に移動して配列を詰める.
+*/
+struct GroupStorage
+{
+  size_t Size() const { return entity.size(); }
+  void Reserve(size_t n);
+  uint32_t PushBack(Entity* e, const glm::vec3& pos);
+  void SwapRemove(uint32_t index);
+  void Clear();
+  void SetStatic(uint32_t index, bool isStatic);
+
+  std::vector<Entity*> entity; ///< 要素を所有するエンティティ.
+  std::vector<glm::vec3> position; ///< 座標.
+  std::vector<glm::vec3> velocity; ///< 速度.
+  std::vector<glm::quat> rotation; ///< 回転.
+  std::vector<glm::vec3> scale; ///< 大きさ.
+  std::vector<glm::vec4> color; ///< 色.
+  std::vector<glm::mat4> matModel; ///< モデル行列のキャッシュ.
+  std::vector<uint8_t> isDirty; ///< 座標・回転・大きさ・色のいずれかが変更されていれば1. 並列更新で競合しないようbool配列は使わない.
+  std::vector<CollisionData> colLocal; ///< ローカル座標系の衝突形状.
+  std::vector<CollisionData> colWorld; ///< ワールド座標系の衝突形状.
+  std::vector<uint32_t> collisionMask; ///< 衝突判定を行う相手のグループのビットマスク.
+  std::vector<glm::vec4> bounds; ///< ワールド座標系の境界球. xyzが中心、wが半径.
+  std::vector<uint16_t> depth; ///< 親子関係の深さ. 親がなければ0.
+  std::vector<uint32_t> transformStamp; ///< モデル行列を最後に計算したときのBuffer::transformStampの値.
+  std::vector<uint8_t> isStatic; ///< 静的なエンティティなら1. 更新関数の呼び出しと速度による移動を行わない.
+  size_t staticCount = 0; ///< 静的なエンティティの数.
+  std::vector<float> elapsed; ///< 分割更新で、前回更新されてからの経過時間. 分割しないグループでは常に0.
+  std::vector<uint32_t> pageIndex; ///< エンティティが所属するページの番号.
+  std::vector<GLintptr> uboOffset; ///< ページのUBO内でのエンティティ用領域のバイトオフセット.
+};
+
+/**
+* エンティティ.
+*
+* 親を設定したエンティティの座標・回転・大きさは、親の座標系における値として扱われる.
+* ワールド座標系の行列は、Buffer::Update()で親から順に計算される.
+* グループの平行移動(Buffer::GroupOffset())は描画と衝突判定の時点で加えられ、WorldMatrix()には含まれない.
+* CollisionMask()で衝突判定を行う相手のグループを制限できる. 0にすると、どのグループとも判定されなくなる.
+*/
+class Entity
+{
+  friend class Buffer;
+  friend struct GroupStorage;
+  friend class BehaviorTable;
+  friend class BulletBuffer;
+  friend class Snapshot;
+
+public:
+  typedef InlineFunction<void(Entity&, double)> UpdateFuncType; ///< 状態更新関数型.
+
+  void Position(const glm::vec3& pos) { storage->position[index] = pos; storage->isDirty[index] = true; }
+  const glm::vec3& Position() const { return storage->position[index]; }
+  void Rotation(const glm::quat& rot) { storage->rotation[index] = rot; storage->isDirty[index] = true; }
+  const glm::quat& Rotation() const { return storage->rotation[index]; }
+  void Scale(const glm::vec3& s) { storage->scale[index] = s; storage->isDirty[index] = true; }
+  const glm::vec3& Scale() const { return storage->scale[index]; }
+  void Velocity(const glm::vec3& v) { storage->velocity[index] = v; }
+  const glm::vec3& Velocity() const { return storage->velocity[index]; }
+  void Color(const glm::vec4& c) { storage->color[index] = c; storage->isDirty[index] = true; }
+  const glm::vec4& Color() const { return storage->color[index]; }
+  void UpdateFunc(UpdateFuncType func) { updateFunc = std::move(func); }
+  UpdateFuncType& UpdateFunc() { return updateFunc; }
+  const UpdateFuncType& UpdateFunc() const { return updateFunc; }
+  void Collision(const CollisionData& c) { storage->colLocal[index] = c; }
+  const CollisionData& Collision() const { return storage->colLocal[index]; }
+  void CollisionMask(uint32_t mask) { storage->collisionMask[index] = mask; }
+  uint32_t CollisionMask() const { return storage->collisionMask[index]; }
+  void Texture(size_t n, const TexturePtr& p) { texture[n] = p; }
+  const TexturePtr& Texture(size_t n) const;
+
+  glm::mat4 TRSMatrix() const;
+  int GroupId() const { return groupId; }
+
+  bool Static(bool isStatic);
+  bool Static() const { return storage->isStatic[index] != 0; }
+
+  bool Parent(Entity* p);
+  Entity* Parent() const { return parent; }
+  const std::vector<Entity*>& Children() const { return childList; }
+  const glm::mat4& WorldMatrix() const { return storage->matModel[index]; }
+  glm::vec3 WorldPosition() const { return glm::vec3(storage->matModel[index][3]); }
+
+  void Destroy();
+
+private:
+  Entity() = default;
+  ~Entity() = default;
+  Entity(const Entity&) = default;
+  Entity& operator=(const Entity&) = default;
+
+  const Mesh::MeshPtr& ResolvedMesh() const;
+  const Shader::ProgramPtr& ResolvedProgram() const;
+
+private:
+  int groupId = -1;
+  Buffer* pBuffer = nullptr; ///< 生成元のBufferクラスへのポインタ.
+  GroupStorage* storage = nullptr; ///< 座標などを格納しているグループデータ.
+  uint32_t index = 0; ///< グループデータ内の位置.
+  uint32_t pageIndex = 0; ///< 所属するページの番号.
+  GLintptr uboOffset = 0; ///< ページのUBO内でのエンティティ用領域のバイトオフセット.
+  Mesh::MeshPtr mesh; ///< エンティティを描画するときに使われるメッシュデータ.
+  TexturePtr texture[2]; ///< エンティティを描画するときに使われるテクスチャ.
+  Shader::ProgramPtr program; ///< エンティティを描画するときに使われるシェーダ.
+  const Archetype* archetype = nullptr; ///< 生成に使われたアーキタイプ. 個別に設定されていないリソースはここから取得する.
+  UpdateFuncType updateFunc; ///< 状態更新関数.
+  BehaviorTable* behaviorTable = nullptr; ///< 所属する振る舞いテーブル. 所属していなければnullptr.
+  Entity* parent = nullptr; ///< 親エンティティ.
+  std::vector<Entity*> childList; ///< 子エンティティのリスト.
+  uint32_t behaviorIndex = 0; ///< 振る舞いテーブル内の位置.
+  BulletBuffer* bulletBuffer = nullptr; ///< 弾の代わりに衝突解決ハンドラへ渡される場合、弾を管理するバッファ.
+  int32_t treeProxy = Collision::AabbTree::nullNode; ///< 空間検索用の木に登録した葉の番号.
+  bool isActive = false;
+  uint32_t generation = 0; ///< 削除されるたびに増加する世代番号.
+};
+
+/**
+* エンティティの雛形.
+*
+* 同じ見た目と振る舞いを持つエンティティを大量に生成するときに使う.
+* 生成されたエンティティはリソースをコピーせずに参照するため、名前の検索や参照カウントの操作が発生しない.
+*/
+struct Archetype
+{
+  int groupId = 0; ///< エンティティのグループID.
+  Mesh::MeshPtr mesh; ///< エンティティを描画するときに使われるメッシュデータ.
+  TexturePtr texture[2]; ///< エンティティを描画するときに使われるテクスチャ.
+  Shader::ProgramPtr program; ///< エンティティを描画するときに使われるシェーダ.
+  CollisionData collision; ///< 衝突形状.
+  Entity::UpdateFuncType updateFunc; ///< 状態更新関数. エンティティごとにClone()で複製される.
+  BehaviorTablePtr behaviorTable; ///< 振る舞いテーブル. 設定されていればupdateFuncの代わりに使われる.
+};
+
+/**
+* 同じ型の関数オブジェクトで更新するエンティティの表.
+*
+* 関数オブジェクトの状態を連続した配列に格納し、エンティティごとの間接呼び出しを行わずに1つのループで更新する.
+* 同じ振る舞いを持つエンティティを大量に生成する場合、updateFuncを使うより生成も更新も速い.
+* テーブルはCreateBehaviorTable()で作成し、Archetype::behaviorTableに設定して使う.
+*
+* 更新はグループごとのupdateFuncの呼び出しがすべて終わってから、登録されたテーブルの順に行われる.
+* 更新中に追加されたエンティティは、そのテーブルの更新が終わってから表に加えられる.
+*/
+class BehaviorTable
+{
+public:
+  /// Snapshotに保存するテーブルの状態.
+  struct State {
+    std::vector<Entity*> entityList; ///< エンティティのリスト.
+    std::shared_ptr<void> stateList; ///< 関数オブジェクトの配列. 要素の型は保存したテーブルの関数オブジェクトの型.
+  };
+
+  BehaviorTable() = default;
+  virtual ~BehaviorTable() = default;
+  BehaviorTable(const BehaviorTable&) = delete;
+  BehaviorTable& operator=(const BehaviorTable&) = delete;
+
+  virtual void Add(Entity* e) = 0;
+  virtual void Remove(Entity* e) = 0;
+  virtual void Update(double delta) = 0;
+  virtual size_t Size() const = 0;
+  virtual void SaveState(State& state) const = 0;
+  virtual void RestoreState(const State& state) = 0;
+
+protected:
+  static void Attach(Entity* e, BehaviorTable* table, size_t index) {
+    e->behaviorTable = table;
+    e->behaviorIndex = static_cast<uint32_t>(index);
+  }
+  static uint32_t Index(const Entity& e) { return e.behaviorIndex; }
+  static bool IsActive(const Entity& e) { return e.isActive; }
+  static bool IsUpdatable(const Entity& e) { return e.isActive && !e.storage->isStatic[e.index]; }
+};
+
+/**
+* 関数オブジェクトの型ごとの振る舞いテーブル.
+*
+* @tparam F 関数オブジェクトの型. void(Entity&, double)として呼び出せ、コピー可能であること.
+*/
+template<typename F>
+class BehaviorTableImpl : public BehaviorTable
+{
+public:
+  explicit BehaviorTableImpl(F f) : prototype(std::move(f)) {}
+  ~BehaviorTableImpl() override = default;
+
+  /**
+  * エンティティを追加する.
+  *
+  * @param e 追加するエンティティ.
+  *
+  * 関数オブジェクトの状態は、テーブル作成時に渡された関数オブジェクトのコピーで初期化される.
+  * 並列更新中に呼び出されてもよい.
+  */
+  void Add(Entity* e) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    Attach(e, this, 0);
+    if (isUpdating) {
+      pendingList.push_back(e);
+      return;
+    }
+    AddImpl(e);
+  }
+
+  /**
+  * エンティティを取り除く.
+  *
+  * @param e 取り除くエンティティ.
+  *
+  * 末尾の要素を空いた位置に移動して配列を詰める.
+  */
+  void Remove(Entity* e) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    const size_t index = Index(*e);
+    if (index < entityList.size() && entityList[index] == e) {
+      if (index != entityList.size() - 1) {
+        entityList[index] = entityList.back();
+        stateList[index] = std::move(stateList.back());
+        Attach(entityList[index], this, index);
+      }
+      entityList.pop_back();
+      stateList.pop_back();
+    } else {
+      pendingList.erase(std::remove(pendingList.begin(), pendingList.end(), e), pendingList.end());
+    }
+    Attach(e, nullptr, 0);
+  }
+
+  /**
+  * 全エンティティを更新する.
+  *
+  * @param delta 前回の更新からの経過時間.
+  */
+  void Update(double delta) override {
+    isUpdating = true;
+    const size_t count = entityList.size();
+    Entity* const* entity = entityList.data();
+    F* state = stateList.data();
+    for (size_t i = 0; i < count; ++i) {
+      if (IsUpdatable(*entity[i])) {
+        state[i](*entity[i], delta);
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    isUpdating = false;
+    for (Entity* e : pendingList) {
+      AddImpl(e);
+    }
+    pendingList.clear();
+  }
+
+  size_t Size() const override { return entityList.size(); }
+
+  /**
+  * テーブルの状態を保存する.
+  *
+  * @param state 保存先. 以前にこのテーブルの状態を保存したものであれば、配列の領域を再利用する.
+  */
+  void SaveState(State& state) const override {
+    state.entityList = entityList;
+    if (!state.stateList) {
+      state.stateList = std::make_shared<std::vector<F>>();
+    }
+    *static_cast<std::vector<F>*>(state.stateList.get()) = stateList;
+  }
+
+  /**
+  * テーブルの状態を復元する.
+  *
+  * @param state SaveState()でこのテーブルの状態を保存したもの.
+  *
+  * エンティティの所属(Attach)はエンティティ側の状態として別に復元される.
+  */
+  void RestoreState(const State& state) override {
+    entityList = state.entityList;
+    stateList = *static_cast<const std::vector<F>*>(state.stateList.get());
+    pendingList.clear();
+  }
+
+private:
+  void AddImpl(Entity* e) {
+    Attach(e, this, entityList.size());
+    entityList.push_back(e);
+    stateList.push_back(prototype);
+  }
+
+  F prototype; ///< 追加したエンティティの状態の初期値.
+  std::vector<Entity*> entityList; ///< エンティティのリスト.
+  std::vector<F> stateList; ///< エンティティごとの関数オブジェクト. entityListと同じ順に並ぶ.
+  std::vector<Entity*> pendingList; ///< 更新中に追加されたエンティティのリスト.
+  std::mutex mutex; ///< 並列更新中の追加を保護する.
+  bool isUpdating = false; ///< Update実行中はtrue.
+};
+
+/**
+* 振る舞いテーブルを作成する.
+*
+* @param f 状態更新関数オブジェクト. 追加されるエンティティごとにコピーされる.
+*
+* @return 作成した振る舞いテーブル.
+*/
+template<typename F>
+BehaviorTablePtr CreateBehaviorTable(F f)
+{
+  return std::make_shared<BehaviorTableImpl<F>>(std::move(f));
+}
+
+/**
+* テクスチャを取得する.
+*
+* @param n テクスチャ番号.
+*
+* @return n番目のテクスチャ. 個別に設定されていなければアーキタイプのテクスチャを返す.
+*/
+inline const TexturePtr& Entity::Texture(size_t n) const
+{
+  return (texture[n] || !archetype) ? texture[n] : archetype->texture[n];
+}
+
+/**
+* 描画に使うメッシュを取得する.
+*/
+inline const Mesh::MeshPtr& Entity::ResolvedMesh() const
+{
+  return (mesh || !archetype) ? mesh : archetype->mesh;
+}
+
+/**
+* 描画に使うシェーダを取得する.
+*/
+inline const Shader::ProgramPtr& Entity::ResolvedProgram() const
+{
+  return (program || !archetype) ? program : archetype->program;
+}
+
+/**
+* 距離を伴う空間検索の結果.
+*/
+struct SpatialQueryResult
+{
+  Entity* entity; ///< 見つかったエンティティ.
+  float distance; ///< 検索の中心から衝突形状までの距離.
+};
+
+/**
+* 空間検索の統計.
+*/
+struct SpatialQueryStatistics
+{
+  uint64_t queryCount = 0; ///< 検索の回数.
+  uint64_t visitedNodeCount = 0; ///< 調べた木のノードの数.
+  uint64_t resultCount = 0; ///< 見つかったエンティティの数.
+  double seconds = 0; ///< 検索にかかった時間の合計(秒).
+};
+
+/**
+* スナップショットの保存と復元の統計.
+*/
+struct SnapshotStatistics
+{
+  size_t saveCount = 0; ///< 保存した回数.
+  double saveSeconds = 0; ///< 保存にかかった時間の合計(秒).
+  double maxSaveSeconds = 0; ///< 保存にかかった時間の最大値(秒).
+  size_t restoreCount = 0; ///< 復元した回数.
+  double restoreSeconds = 0; ///< 復元にかかった時間の合計(秒).
+  double maxRestoreSeconds = 0; ///< 復元にかかった時間の最大値(秒).
+  size_t entityCount = 0; ///< 最後に保存したエンティティの数.
+};
+
+/**
+* エンティティバッファ.
+*
+* GroupSpatialQuery()で有効にしたグループのエンティティは、衝突形状が動的AABBツリーに登録され、
+* QueryBox()などで範囲内のエンティティを検索できる. 木はUpdate()の衝突形状の更新の直後に更新されるため、
+* 更新関数から検索した場合は前回のUpdate()時点の位置が使われる.
+* 検索は木を変更しないので、並列更新中の更新関数からも呼び出せる.
+*/
+class Buffer
+{
+  friend class Snapshot;
+public:
+  /// イテレータ・定数イテレータ共通のクラステンプレート.
+  template<typename B, typename E>
+  class IteratorBase : public std::iterator<std::bidirectional_iterator_tag, Entity>
+  {
+  public:
+    IteratorBase() = default;
+    IteratorBase(B* b, int g, size_t i) : buffer(b), groupId(g), index(i) { SkipForward(); }
+
+    explicit operator bool() const { return buffer && groupId <= maxGroupId; }
+    bool operator!() const { return !static_cast<bool>(*this); }
+    bool operator==(const IteratorBase& rhs) const { return buffer == rhs.buffer && groupId == rhs.groupId && index == rhs.index; }
+    bool operator!=(const IteratorBase& rhs) const { return !(*this == rhs); }
+
+    IteratorBase& operator++() { ++index; SkipForward(); return *this; }
+    IteratorBase operator++(int) { IteratorBase tmp = *this; ++*this; return tmp; }
+    IteratorBase& operator--() { SkipBackward(); return *this; }
+    IteratorBase operator--(int) { IteratorBase tmp = *this; --*this; return tmp; }
+
+    E* operator->() const { return buffer->groups[groupId].entity[index]; }
+    E& operator*() const { return *buffer->groups[groupId].entity[index]; }
+
+  private:
+    /// 現在位置が有効なエンティティを指すまで前方へ進める.
+    void SkipForward() {
+      for (; groupId <= maxGroupId; ++groupId, index = 0) {
+        const GroupStorage& s = buffer->groups[groupId];
+        for (; index < s.Size(); ++index) {
+          if (s.entity[index]->isActive) {
+            return;
+          }
+        }
+      }
+      index = 0;
+    }
+    /// 直前の有効なエンティティまで後方へ戻す.
+    void SkipBackward() {
+      for (;;) {
+        while (index == 0) {
+          if (groupId == 0) {
+            return;
+          }
+          --groupId;
+          index = buffer->groups[groupId].Size();
+        }
+        --index;
+        if (buffer->groups[groupId].entity[index]->isActive) {
+          return;
+        }
+      }
+    }
+
+    B* buffer = nullptr;
+    int groupId = 0;
+    size_t index = 0;
+  };
+  typedef IteratorBase<Buffer, Entity> Iterator; ///< イテレータ.
+  typedef IteratorBase<const Buffer, const Entity> ConstIterator; ///< 定数イテレータ.
+
+  static BufferPtr Create(size_t initialEntityCount, GLsizeiptr ubSizePerEntity, int bindingPoint, const char* ubName);
+
+  Entity* AddEntity(int groupId, const glm::vec3& pos, const Mesh::MeshPtr& m, const TexturePtr t[2], const Shader::ProgramPtr& p, Entity::UpdateFuncType func);
+  Entity* AddEntity(ArchetypeId id, const glm::vec3& pos);
+  size_t AddEntities(ArchetypeId id, const glm::vec3* posList, size_t count, Entity** entityList = nullptr);
+  void RemoveEntity(Entity* entity);
+  void RemoveAllEntity();
+  bool SetParent(Entity* child, Entity* parent);
+  bool SetStatic(Entity* entity, bool isStatic);
+
+  ArchetypeId RegisterArchetype(Archetype archetype);
+  const Archetype* GetArchetype(ArchetypeId id) const;
+  void ClearArchetypeList();
+  void GroupVisibility(int groupId, int cameraIndex, bool isVisible) {
+    if (isVisible) {
+      visibilityFlags[groupId] |= (1U << cameraIndex);
+    } else {
+      visibilityFlags[groupId] &= ~(1U << cameraIndex);
+    }
+  }
+  bool GroupVisibility(int groupId, int cameraIndex) const { return visibilityFlags[groupId] & (1U << cameraIndex); }
+  void GroupParallelUpdate(int groupId, bool isParallel) { parallelUpdateFlags[groupId] = isParallel; }
+  bool GroupParallelUpdate(int groupId) const { return parallelUpdateFlags[groupId]; }
+  bool GroupUpdateDivisor(int groupId, int divisor);
+  int GroupUpdateDivisor(int groupId) const { return updateDivisor[groupId]; }
+  double GroupUpdateTime(int groupId) const { return groupUpdateTime[groupId]; }
+  void GroupOffset(int groupId, const glm::vec3& offset) { groupOffset[groupId] = offset; }
+  const glm::vec3& GroupOffset(int groupId) const { return groupOffset[groupId]; }
+  void GroupVelocity(int groupId, const glm::vec3& v) { groupVelocity[groupId] = v; }
+  const glm::vec3& GroupVelocity(int groupId) const { return groupVelocity[groupId]; }
+  void Update(double delta);
+  void PrepareDraw(const glm::mat4* matView, const glm::mat4& matProj, const glm::mat4& matDepthVP);
+  void Draw(int viewIndex, const Mesh::BufferPtr& meshBuffer) const;
+  void DrawDepth(int viewIndex, const Mesh::BufferPtr& meshBuffer) const;
+
+  void InstancedDraw(bool enable);
+  bool InstancedDraw() const { return isInstancedDraw; }
+  void InstancedProgram(const Shader::ProgramPtr& program, const Shader::ProgramPtr& instancedProgram);
+  void PackedProgram(const Shader::ProgramPtr& program, const Shader::ProgramPtr& packedProgram);
+  void DepthProgram(const Shader::ProgramPtr& program, const Shader::ProgramPtr& instancedProgram, const Shader::ProgramPtr& packedProgram = {});
+  bool InstanceStore(InstanceStoreType type);
+  InstanceStoreType InstanceStore() const { return instanceStore; }
+  size_t DrawCallCount() const { return renderQueue.Stats().drawCallCount; }
+  size_t DrawCallCountWithoutInstancing() const { return renderQueue.Stats().drawCallCountWithoutInstancing; }
+  const RenderQueue::Statistics& RenderStats() const { return renderQueue.Stats(); }
+  size_t SubmittedEntityCount() const { return submittedEntityCount; }
+  size_t VisibleEntityCount() const { return visibleEntityCount; }
+  size_t InstanceDataBytes() const { return instanceDataBytes; }
+  void StreamingBuffer(const StreamBufferPtr& p) { streamBuffer = p; }
+
+  void CollisionHandler(int gid0, int gid1, CollisionHandlerType handler);
+  const CollisionHandlerType& CollisionHandler(int gid0, int gid1) const;
+  void ClearCollisionHandlerList();
+
+  bool GroupSpatialQuery(int groupId, bool isEnabled);
+  bool GroupSpatialQuery(int groupId) const { return spatialQueryFlags[groupId]; }
+  size_t QueryBox(const glm::vec3& min, const glm::vec3& max, uint32_t groupMask, Entity** out, size_t capacity) const;
+  size_t QueryRadius(const glm::vec3& center, float radius, uint32_t groupMask, Entity** out, size_t capacity) const;
+  Entity* Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, uint32_t groupMask, float* distance = nullptr) const;
+  size_t Nearest(const glm::vec3& center, size_t k, uint32_t groupMask, SpatialQueryResult* out, float maxDistance = FLT_MAX) const;
+  SpatialQueryStatistics SpatialQueryStats() const;
+  void ResetSpatialQueryStats();
+
+  const SnapshotStatistics& SnapshotStats() const { return snapshotStats; }
+  void ResetSnapshotStats() { snapshotStats = SnapshotStatistics(); }
+
+  size_t Capacity() const { return capacity; }
+  size_t ActiveEntityCount() const { return activeEntityCount; }
+  size_t PeakEntityCount() const { return peakEntityCount; }
+  void ResetPeakEntityCount() { peakEntityCount = activeEntityCount; }
+
+  BulletBuffer& Bullets() { return *bulletBuffer; }
+  const BulletBuffer& Bullets() const { return *bulletBuffer; }
+
+  Iterator Begin() { return Iterator(this, 0, 0); }
+  Iterator End() { return Iterator(this, maxGroupId + 1, 0); }
+  ConstIterator Begin() const { return ConstIterator(this, 0, 0); }
+  ConstIterator End() const { return ConstIterator(this, maxGroupId + 1, 0); }
+
+private:
+  Buffer() = default;
+  ~Buffer();
+  Buffer(const Buffer&) = delete;
+  Buffer& operator=(const Buffer&) = delete;
+
+  Entity* AllocateEntity();
+  Entity* NewEntity(int groupId, const glm::vec3& pos);
+  bool AddPage();
+  bool CreatePageUbo(size_t n);
+  void PreparePages(bool createUbo);
+  void ReclaimPages(double delta);
+  void ReleaseEntity(Entity* entity);
+  void SetupBehavior(Entity* entity, const Archetype& archetype);
+  void FlushRemovedEntity();
+  static void UpdateEntity(GroupStorage& s, size_t i, size_t integratedCount, double delta);
+  void UpdateUniformBuffer();
+  void UpdateTransforms();
+  void CommitTransform(GroupStorage& s, size_t i);
+  void RebuildTransformNodes();
+  void UpdateGroupInParallel(int groupId, size_t begin, size_t end, size_t integratedCount, double delta);
+  void UpdateSliceRange(int groupId, size_t count, size_t& begin, size_t& end) const;
+  void CollectCollisionPairs(int groupIdL);
+  void UpdateSpatialTree();
+  void RecordSpatialQuery(int64_t nanoseconds, size_t visitedNodeCount, size_t resultCount) const;
+  void ApplyCommandBuffers(size_t count);
+  void BuildInstanceRuns();
+  bool IsVisible(const GroupStorage& s, size_t index, const Collision::Frustum& frustum) const;
+  const glm::vec3& GroupOffsetOf(const GroupStorage& s) const { return groupOffset[&s - groups]; }
+  void PushInstances(int pass, const Collision::Frustum& frustum, Shader::Program* program) const;
+  void PushPackedInstances(int pass, const Collision::Frustum& frustum, Shader::Program* program, const glm::mat4& matVP, bool isDepth) const;
+  void BindInstanceStore() const;
+  Shader::Program* ResolvedPackedProgram(const Entity& e) const;
+  void MarkAllDirty();
+  void PushEntity(const GroupStorage& s, size_t index, int pass, Shader::Program* program, const glm::mat4& matVP, bool isDepth) const;
+  void PushBullets(int pass, Shader::Program* program, bool isDepth) const;
+  const Shader::ProgramPtr& FindInstancedProgram(const Shader::Program* program) const;
+  const Shader::ProgramPtr& FindPackedProgram(const Shader::Program* program) const;
+
+private:
+  /// エンティティ配列の削除関数.
+  struct EntityArrayDeleter { void operator()(Entity* p) { delete[] p; } };
+  /// 弾の管理クラスの削除関数.
+  struct BulletBufferDeleter { void operator()(BulletBuffer* p); };
+
+  static const size_t entitiesPerPage = 256; ///< 1ページあたりのエンティティ数.
+
+  /**
+  * エンティティとUBOを確保する単位.
+  *
+  * エンティティが足りなくなるとページを追加する. ページは移動しないため、エンティティへのポインタは常に有効.
+  * 初期ページ以外のページは、一定時間使われなければ解放される.
+  */
+  struct Page {
+    std::unique_ptr<Entity[], EntityArrayDeleter> entityList; ///< エンティティの配列.
+    UniformBufferPtr ubo; ///< エンティティ用UBO.
+    std::vector<uint8_t> uboData; ///< UBOへ転送するデータ.
+    size_t activeCount = 0; ///< 使用中のエンティティの数.
+    double emptySeconds = 0; ///< 使用中のエンティティがない状態が続いている時間.
+    std::vector<uint8_t> dirtySlotList; ///< UBOへの転送が必要なスロットなら1.
+  };
+  std::vector<std::unique_ptr<Page>> pageList; ///< ページのリスト. 解放されたページはnullptrになる.
+  size_t initialPageCount = 0; ///< 解放しないページの数. スナップショットを保存すると、その時点のページ数まで増える.
+  size_t capacity = 0; ///< 確保済みのエンティティの数.
+  size_t activeEntityCount = 0; ///< 使用中のエンティティの数.
+  size_t peakEntityCount = 0; ///< 使用中のエンティティの数の最大値.
+  GLsizeiptr ubSizePerEntity;
+  int bindingPoint; ///< エンティティ用UBOのバインディングポイント.
+  std::string ubName; ///< エンティティ用Uniform Bufferの名前.
+  std::vector<Entity*> freeList; ///< 未使用のエンティティのリスト.
+  std::vector<std::unique_ptr<Archetype>> archetypeList; ///< 登録されたアーキタイプのリスト.
+  std::vector<BehaviorTablePtr> behaviorTableList; ///< アーキタイプが使う振る舞いテーブルのリスト.
+  GroupStorage groups[maxGroupId + 1]; ///< グループごとのエンティティデータ.
+  glm::u32 visibilityFlags[maxGroupId + 1] = { 0 };
+  glm::vec3 groupOffset[maxGroupId + 1]; ///< グループごとの平行移動. 描画時にシェーダで加えられる.
+  glm::vec3 groupVelocity[maxGroupId + 1]; ///< グループごとの平行移動の速度.
+  glm::mat4 lastMatVP[Uniform::maxViewCount]; ///< 最後のPrepareDrawで渡されたビュー・プロジェクション行列. カリングに使う.
+  glm::mat4 lastMatDepthVP; ///< 最後のPrepareDrawで渡された影用ビュー・プロジェクション行列. カリングに使う.
+  std::vector<Page*> pageDataList; ///< UBOを転送できるページのリスト. 毎回のUpdateで再利用する.
+
+  /**
+  * 親を持つエンティティのモデル行列を計算するための要素.
+  *
+  * 深さの順に並べて先頭から計算すれば、親の行列は常に子より先に求まる.
+  * 要素の位置はエンティティの追加・削除で変わるため、親子関係のあるエンティティが移動したときに作り直す.
+  */
+  struct TransformNode {
+    GroupStorage* storage; ///< 子のグループデータ.
+    uint32_t index; ///< 子のグループデータ内の位置.
+    const GroupStorage* parentStorage; ///< 親のグループデータ.
+    uint32_t parentIndex; ///< 親のグループデータ内の位置.
+    uint16_t depth; ///< 子の深さ.
+  };
+  std::vector<TransformNode> transformNodeList; ///< 深さの順に並べた、親を持つエンティティのリスト.
+  bool isHierarchyDirty = false; ///< trueならtransformNodeListを作り直す.
+  uint32_t transformStamp = 0; ///< UpdateTransforms()を呼ぶたびに増加する番号.
+  std::vector<Entity*> hierarchyWork; ///< 親子関係をたどるための作業領域.
+
+  /// ストリーミングバッファからUBOへのコピー.
+  struct BufferCopy {
+    GLuint buffer; ///< コピー先のUBO.
+    GLintptr readOffset; ///< ストリーミングバッファ内のコピー元のバイトオフセット.
+    GLintptr writeOffset; ///< UBO内のコピー先のバイトオフセット.
+    GLsizeiptr size; ///< コピーするバイト数.
+  };
+  StreamBufferPtr streamBuffer; ///< 毎フレーム転送するデータを書き込むバッファ. 空ならUBOに直接書き込む.
+  std::vector<BufferCopy> copyList; ///< Update中に発行するコピーのリスト.
+
+  bool isUpdating = false; ///< Update実行中はtrue. この間の削除はFlushRemovedEntityまで保留される.
+  std::vector<Entity*> removedList; ///< 削除が保留されているエンティティのリスト.
+
+  /**
+  * 並列更新中に行われたエンティティの追加・削除の記録.
+  *
+  * 並列更新中はグループの配列を変更できないため、追加されたエンティティはstagingに置き、
+  * 削除要求はremoveListに記録しておく. これらは全チャンクの更新後にApplyCommandBuffers()で反映される.
+  */
+  struct CommandBuffer {
+    GroupStorage staging; ///< 追加されたエンティティのデータ.
+    std::vector<Entity*> removeList; ///< 削除を要求されたエンティティのリスト.
+  };
+  ThreadPool threadPool; ///< 並列更新に使うスレッドプール.
+  std::vector<CommandBuffer> commandBufferList; ///< チャンクごとのコマンドバッファ.
+  static thread_local CommandBuffer* currentCommandBuffer; ///< このスレッドが処理中のチャンクのコマンドバッファ.
+  std::mutex freeListMutex; ///< 並列更新中にfreeListとページを保護する.
+  bool parallelUpdateFlags[maxGroupId + 1]; ///< グループごとの並列更新の可否. 既定では全て不可.
+  int updateDivisor[maxGroupId + 1]; ///< グループごとの更新の分割数. 1なら毎回全エンティティを更新する.
+  int updateSlice[maxGroupId + 1]; ///< グループごとの、今回更新する分割の番号.
+  double groupUpdateTime[maxGroupId + 1]; ///< グループごとの更新と衝突判定にかかった処理時間(秒)の移動平均.
+
+  /// 衝突判定の対象となるエンティティ.
+  struct CollisionTarget {
+    Entity* entity; ///< エンティティへのポインタ.
+    uint32_t generation; ///< 登録時の世代番号. 異なる場合は判定中に削除されている.
+  };
+  Collision::SpatialGrid collisionGrid; ///< 衝突判定用の空間グリッド.
+  std::vector<CollisionTarget> collisionTargetList; ///< 空間グリッドに登録したエンティティのリスト.
+  Collision::PackedBoxList collisionTargetBoxList; ///< collisionTargetListの衝突形状.
+
+  /// 衝突したエンティティの組.
+  struct CollisionPair {
+    Entity* entity[2]; ///< 左辺と右辺のエンティティ.
+    uint32_t generation[2]; ///< 判定時の世代番号. 異なる場合はハンドラの呼び出し中に削除されている.
+    uint32_t groupPair; ///< 左辺と右辺のグループIDから作ったキー. ハンドラの選択と並べ替えに使う.
+  };
+
+  /**
+  * 衝突判定を並列に行うための、チャンクごとの作業領域.
+  */
+  struct CollisionWorker {
+    std::vector<uint32_t> candidateList; ///< 空間グリッドの検索結果.
+    Collision::PackedBoxList candidateBoxList; ///< candidateListの衝突形状.
+    std::vector<CollisionPair> pairList; ///< 衝突した組のリスト.
+  };
+  std::vector<CollisionWorker> collisionWorkerList; ///< チャンクごとの作業領域.
+  std::vector<CollisionPair> collisionPairList; ///< 衝突した組のリスト. groupPair、左辺、右辺の順に並ぶ.
+
+  CollisionHandlerType collisionHandlerTable[maxGroupId + 1][maxGroupId + 1]; ///< グループの組ごとの衝突解決ハンドラ. 小さいグループIDが先の添字.
+  uint32_t collisionGroupMask[maxGroupId + 1] = {}; ///< グループごとの、ハンドラが登録されている相手のグループのビットマスク.
+
+  Collision::AabbTree spatialTree; ///< 空間検索用の動的AABBツリー. カテゴリはグループIDのビット.
+  bool spatialQueryFlags[maxGroupId + 1] = {}; ///< グループごとの空間検索の可否.
+  mutable std::atomic<uint64_t> spatialQueryCount{ 0 }; ///< 空間検索の回数.
+  mutable std::atomic<uint64_t> spatialQueryNodeCount{ 0 }; ///< 空間検索で調べた木のノードの数.
+  mutable std::atomic<uint64_t> spatialQueryResultCount{ 0 }; ///< 空間検索で見つかったエンティティの数.
+  mutable std::atomic<int64_t> spatialQueryNanoseconds{ 0 }; ///< 空間検索にかかった時間の合計(ナノ秒).
+
+  SnapshotStatistics snapshotStats; ///< スナップショットの保存と復元の統計.
+
+  std::unique_ptr<BulletBuffer, BulletBufferDeleter> bulletBuffer; ///< 弾の管理クラス.
+
+  /**
+  * インスタンス描画の単位.
+  *
+  * 同じグループに属し、メッシュ・テクスチャ・シェーダが等しいエンティティをまとめたもの.
+  * 描画時に視錐台と交差するものだけが選ばれ、最大maxInstanceCount個ずつ描画される.
+  */
+  struct InstanceRun {
+    int groupId; ///< グループID.
+    const Mesh::Mesh* mesh; ///< 描画に使うメッシュ.
+    GLuint texture[2]; ///< 描画に使うテクスチャ.
+    Shader::Program* program; ///< 描画に使うインスタンス描画用シェーダ.
+    bool isPacked; ///< 詰めて格納したインスタンスデータを使うならtrue.
+    uint32_t firstItem; ///< instanceItemList内の先頭の位置.
+    uint32_t count; ///< エンティティの数.
+  };
+  /// インスタンス描画の単位を作るために並べ替える要素.
+  struct InstanceItem {
+    Shader::Program* program; ///< 描画に使うインスタンス描画用シェーダ.
+    const Mesh::Mesh* mesh; ///< 描画に使うメッシュ.
+    GLuint texture[2]; ///< 描画に使うテクスチャ.
+    bool isPacked; ///< 詰めて格納したインスタンスデータを使うならtrue.
+    uint32_t index; ///< グループデータ内の位置.
+  };
+  /// 個別に描画するエンティティ.
+  struct DrawItem {
+    int groupId; ///< グループID.
+    uint32_t index; ///< グループデータ内の位置.
+    Shader::Program* packedProgram; ///< 詰めて格納したインスタンスデータを使う場合のシェーダ. 使わなければnullptr.
+  };
+  /// 開始位置が決まる前の、詰めて格納したインスタンスデータを使う描画命令.
+  struct PackedPacket {
+    RenderQueue::Packet packet; ///< 描画命令. instanceBaseはpackedData内の位置.
+    bool isTransparent; ///< 半透明ならtrue.
+    float depth; ///< 深度.
+  };
+  bool isInstancedDraw = true; ///< trueならインスタンス描画を行う.
+  GLint ubAlignment = 1; ///< UBOのオフセットのアラインメント.
+  GLsizeiptr instanceStride = 0; ///< インスタンス描画用UBOにおける1エンティティ分のバイト数.
+  std::vector<std::pair<const Shader::Program*, Shader::ProgramPtr>> instancedProgramList; ///< 通常のシェーダとインスタンス描画用シェーダの対応表.
+  Shader::ProgramPtr depthProgram; ///< 影描画用のシェーダ.
+  Shader::ProgramPtr depthInstancedProgram; ///< インスタンス描画用の影描画シェーダ.
+  std::vector<std::pair<const Shader::Program*, Shader::ProgramPtr>> packedProgramList; ///< 通常のシェーダと、詰めて格納したインスタンスデータを使うシェーダの対応表.
+  Shader::ProgramPtr depthPackedProgram; ///< 詰めて格納したインスタンスデータを使う影描画シェーダ.
+  InstanceStoreType instanceStore = InstanceStoreType::UniformBuffer; ///< インスタンスデータの格納場所.
+  mutable std::vector<Uniform::InstanceData> packedData; ///< 詰めて格納するインスタンスデータの作業領域.
+  mutable std::vector<PackedPacket> packedPacketList; ///< 詰めて格納したインスタンスデータを使う描画命令の作業領域.
+  GLuint instanceTexture = 0; ///< インスタンスデータを参照するテクスチャバッファ.
+  mutable GLuint instanceTextureBuffer = 0; ///< instanceTextureに関連付けたバッファオブジェクト.
+  mutable GLsizeiptr instanceTextureSize = 0; ///< instanceTextureに関連付けたときのセグメントのバイト数.
+  mutable UniformBufferPtr instanceUbo; ///< インスタンス描画用のUBO.
+  mutable std::vector<uint8_t> instanceData; ///< instanceUboに転送するVertexDataの作業領域.
+  mutable std::vector<RenderQueue::Packet> instancePacketList; ///< インスタンス描画命令の作業領域.
+  std::vector<InstanceRun> instanceRunList; ///< インスタンス描画の単位のリスト.
+  std::vector<InstanceItem> instanceItemList; ///< インスタンス描画されるエンティティのリスト.
+  std::vector<DrawItem> nonInstancedList; ///< インスタンス描画できないエンティティのリスト.
+  mutable RenderQueue renderQueue; ///< 描画命令を並べ替えるキュー. 統計は毎回のUpdateでリセットされる.
+  mutable size_t submittedEntityCount = 0; ///< 視錐台との交差を調べたエンティティの数. 毎回のUpdateでリセットされる.
+  mutable size_t visibleEntityCount = 0; ///< 視錐台と交差したエンティティの数. 毎回のUpdateでリセットされる.
+  mutable size_t instanceDataBytes = 0; ///< GPUへ転送したエンティティごとのデータのバイト数. 毎回のUpdateでリセットされる.
+};
+
+inline Buffer::Iterator begin(Buffer& buffer) { return buffer.Begin(); }
+inline Buffer::Iterator end(Buffer& buffer) { return buffer.End(); }
+inline Buffer::ConstIterator begin(const Buffer& buffer) { return buffer.Begin(); }
+inline Buffer::ConstIterator end(const Buffer& buffer) { return buffer.End(); }
+
+} // namespace Entity
+
+#endif // OPENGLTUTORIAL_SRC_ENTITY_H_INCLUDED
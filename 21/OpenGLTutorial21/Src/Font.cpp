@@ -1,306 +1,309 @@
-/**
-* @file Font.cpp
-*/
-#include "Font.h"
-#include "GameEngine.h"
-#include <memory>
-#include <iostream>
-#include <stdio.h>
-
-/**
-* tHg`@\i[閼O.
-*/
-namespace Font {
-
-/**
-* tHgp_f[^^.
-*/
-struct Vertex
-{
-  glm::vec2 position;
-  glm::u16vec2 uv;
-  glm::u8vec4 color;
-  glm::u8vec4 subColor;
-  glm::u16vec2 thicknessAndOutline;
-};
-
-/**
-* tHg`IuWFNg.
-*
-* @param maxChar ő`敶.
-* @param screen  `XN[̑傫.
-*
-* @retval true  .
-* @retval false s.
-*/
-bool Renderer::Init(size_t maxChar, const glm::vec2& screen)
-{
-  if (maxChar > (USHRT_MAX + 1) / 4) {
-    std::cerr << "WARNING: " << maxChar << "͐ݒ\ȍő啶zĂ܂"<< std::endl;
-    maxChar = (USHRT_MAX + 1) / 4;
-  }
-  vboCapacity = static_cast<GLsizei>(4 * maxChar);
-  vbo.Init(GL_ARRAY_BUFFER, sizeof(Vertex) * vboCapacity, nullptr, GL_STREAM_DRAW);
-  {
-    std::vector<GLushort> tmp;
-    tmp.resize(maxChar * 6);
-    GLushort* p = tmp.data();
-    for (GLushort i = 0; i < maxChar * 4; i += 4) {
-      for (GLshort n : { 0, 1, 2, 2, 3, 0 }) {
-        *(p++) = i + n;
-      }
-    }
-    ibo.Init(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * 6 * maxChar, tmp.data(), GL_STATIC_DRAW);
-  }
-  vao.Init(vbo.Id(), ibo.Id());
-  vao.Bind();
-  vao.VertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), offsetof(Vertex, position));
-  vao.VertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(Vertex), offsetof(Vertex, uv));
-  vao.VertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), offsetof(Vertex, color));
-  vao.VertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), offsetof(Vertex, subColor));
-  vao.VertexAttribPointer(4, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(Vertex), offsetof(Vertex, thicknessAndOutline));
-  vao.Unbind();
-
-  progFont = Shader::Program::Create("Res/Font.vert", "Res/Font.frag");
-  if (!progFont) {
-    return false;
-  }
-
-  reciprocalScreenSize = 2.0f / screen;
-  return true;
-}
-
-/**
-* tHgt@Cǂݍ.
-*
-* @param filename tHgt@C.
-*
-* @retval true  ǂݍݐ.
-* @retval false ǂݍݎs.
-*/
-bool Renderer::LoadFromFile(const char* filename)
-{
-  const std::unique_ptr<FILE, decltype(&fclose)> fp(fopen(filename, "r"), fclose);
-  if (!fp) {
-    return false;
-  }
-
-  int line = 1;
-  float fontSize;
-  int ret = fscanf(fp.get(), "info face=%*s size=%f bold=%*d italic=%*d charset=%*s"
-    " unicode=%*d stretchH=%*d smooth=%*d aa=%*d padding=%*d,%*d,%*d,%*d spacing=%*d,%*d", &fontSize);
-  ++line;
-  const float reciprocalFontSize = 1.0f / fontSize;
-
-  glm::vec2 scale;
-  ret = fscanf(fp.get(), " common lineHeight=%*d base=%*d scaleW=%f scaleH=%f pages=%*d packed=%*d", &scale.x, &scale.y);
-  if (ret < 2) {
-    std::cerr << "ERROR: '" << filename << "'̓ǂݍ݂Ɏs(line=" << line << ")" << std::endl;
-    return false;
-  }
-  const glm::vec2 reciprocalScale = glm::vec2(1.0f / scale);
-  ++line;
-
-  char tex[128];
-  ret = fscanf(fp.get(), " page id=%*d file=%127s", tex);
-  if (ret < 1) {
-    std::cerr << "ERROR: '" << filename << "'̓ǂݍ݂Ɏs(line=" << line << ")" << std::endl;
-    return false;
-  }
-  texFilename = filename;
-  const size_t lastSlashIndex = texFilename.find_last_of('/', std::string::npos);
-  if (lastSlashIndex == std::string::npos) {
-    texFilename.clear();
-  } else {
-    texFilename.resize(lastSlashIndex + 1);
-  }
-  texFilename.append(tex + 1); // ŏ́u"v𔲂Ēǉ.
-  texFilename.pop_back(); // Ṓu"v.
-  ++line;
-
-  int charCount;
-  ret = fscanf(fp.get(), " chars count=%d", &charCount);
-  if (ret < 1) {
-    std::cerr << "ERROR: '" << filename << "'̓ǂݍ݂Ɏs(line=" << line << ")" << std::endl;
-    return false;
-  }
-  ++line;
-
-  fixedAdvance = 0;
-  fontList.resize(128);
-  for (int i = 0; i < charCount; ++i) {
-    FontInfo font;
-    glm::vec2 uv;
-    ret = fscanf(fp.get(), " char id=%d x=%f y=%f width=%f height=%f xoffset=%f yoffset=%f xadvance=%f page=%*d chnl=%*d", &font.id, &uv.x, &uv.y, &font.size.x, &font.size.y, &font.offset.x, &font.offset.y, &font.xadvance);
-    if (ret < 8) {
-      std::cerr << "ERROR: '" << filename << "'̓ǂݍ݂Ɏs(line=" << line << ")" << std::endl;
-      return false;
-    }
-    font.offset.y *= -1;
-    uv.y = scale.y - uv.y - font.size.y;
-    font.uv[0] = uv * reciprocalScale * 65535.0f;
-    font.uv[1] = (uv + font.size) * reciprocalScale * 65535.0f;
-    if (font.id < 128) {
-      fontList[font.id] = font;
-      if (font.xadvance > fixedAdvance) {
-        fixedAdvance = font.xadvance;
-      }
-    }
-    ++line;
-  }
-  GameEngine& game = GameEngine::Instance();
-  if (!game.LoadTextureFromFile(texFilename.c_str())) {
-    return false;
-  }
-  return true;
-}
-
-/**
-* ǉ.
-*
-* @param position \JnW.
-* @param str      ǉ镶.
-*
-* @retval true  ǉ.
-* @retval false ǉs.
-*/
-bool Renderer::AddString(const glm::vec2& position, const char* str)
-{
-  if (!pVBO) {
-    return false;
-  }
-
-  const glm::u16vec2 thicknessAndOutline = glm::vec2(0.625f - thickness * 0.375f, border) * 65535.0f;
-
-  Vertex* p = pVBO + vboSize;
-  glm::vec2 pos = position;
-  for (const char* itr = str; *itr; ++itr) {
-    if (vboSize + 4 > vboCapacity) {
-      break;
-    }
-    const FontInfo& font = fontList[*itr];
-    if (font.id >= 0 && font.size.x && font.size.y) {
-      const glm::vec2 size = font.size * reciprocalScreenSize * scale;
-      const glm::vec2 offsetedPos = propotional ? pos + (font.offset * reciprocalScreenSize) * scale : pos;
-      p[0].position = offsetedPos + glm::vec2(0, -size.y);
-      p[0].uv = font.uv[0];
-      p[0].color = color;
-      p[0].subColor = subColor;
-      p[0].thicknessAndOutline = thicknessAndOutline;
-
-      p[1].position = offsetedPos + glm::vec2(size.x, -size.y);
-      p[1].uv = glm::u16vec2(font.uv[1].x, font.uv[0].y);
-      p[1].color = color;
-      p[1].subColor = subColor;
-      p[1].thicknessAndOutline = thicknessAndOutline;
-
-      p[2].position = offsetedPos + glm::vec2(size.x, 0);
-      p[2].uv = font.uv[1];
-      p[2].color = color;
-      p[2].subColor = subColor;
-      p[2].thicknessAndOutline = thicknessAndOutline;
-
-      p[3].position = offsetedPos;
-      p[3].uv = glm::u16vec2(font.uv[0].x, font.uv[1].y);
-      p[3].color = color;
-      p[3].subColor = subColor;
-      p[3].thicknessAndOutline = thicknessAndOutline;
-
-      p += 4;
-      vboSize += 4;
-    }
-    pos.x += (propotional ? (font.xadvance * reciprocalScreenSize.x) : fixedAdvance) * scale.x;
-  }
-  return true;
-}
-
-/**
-* Fݒ肷.
-*
-* @param c F.
-*/
-void Renderer::Color(const glm::vec4& c)
-{
-  color = glm::clamp(c, 0.0f, 1.0f) * 255.0f;
-}
-
-/**
-* F擾.
-*
-* @return F.
-*/
-glm::vec4 Renderer::Color() const
-{
-  return glm::vec4(color) * (1.0f / 255.0f);
-}
-
-/**
-* TuFݒ肷.
-*
-* @param c F.
-*/
-void Renderer::SubColor(const glm::vec4& c)
-{
-  subColor = glm::clamp(c, 0.0f, 1.0f) * 255.0f;
-}
-
-/**
-* TuF擾.
-*
-* @return F.
-*/
-glm::vec4 Renderer::SubColor() const
-{
-  return glm::vec4(subColor) * (1.0f / 255.0f);
-}
-
-/**
-* VBOVXeɃ}bsO.
-*/
-void Renderer::MapBuffer()
-{
-  if (pVBO) {
-    return;
-  }
-  glBindBuffer(GL_ARRAY_BUFFER, vbo.Id());
-  pVBO = static_cast<Vertex*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, sizeof(Vertex) * vboCapacity, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
-  if (!pVBO) {
-    const GLenum err = glGetError();
-    std::cerr << "ERROR: MapBuffers(0x" << std::hex << err << ")" << std::endl;
-  }
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  vboSize = 0;
-}
-
-/**
-* VBÕ}bsO.
-*/
-void Renderer::UnmapBuffer()
-{
-  if (!pVBO || vboSize == 0) {
-    return;
-  }
-  glBindBuffer(GL_ARRAY_BUFFER, vbo.Id());
-  glUnmapBuffer(GL_ARRAY_BUFFER);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  pVBO = nullptr;
-}
-
-/**
-* tHg`悷.
-*/
-void Renderer::Draw() const
-{
-  if (vboSize > 0) {
-    vao.Bind();
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    progFont->UseProgram();
-    progFont->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, GameEngine::Instance().GetTexture(texFilename.c_str())->Id());
-    glDrawElements(GL_TRIANGLES, (vboSize / 4) * 6, GL_UNSIGNED_SHORT, 0);
-    vao.Unbind();
-  }
-}
-
+/**
+* @file Font.cpp
+*/
+#include "Font.h"
+#include "GameEngine.h"
+#include "GLState.h"
+#include <memory>
+#include <iostream>
+#include <stdio.h>
+
+/**
+* フォント描画機能を格納する名前空間.
+*/
+namespace Font {
+
+/**
+* フォント用頂点データ型.
+*/
+struct Vertex
+{
+  glm::vec2 position;
+  glm::u16vec2 uv;
+  glm::u8vec4 color;
+  glm::u8vec4 subColor;
+  glm::u16vec2 thicknessAndOutline;
+};
+
+/**
+* フォント描画オブジェクトを初期化する.
+*
+* @param maxChar 最大描画文字数.
+* @param screen  描画先スクリーンの大きさ.
+* @param stream  頂点データを書き込むストリーミングバッファ.
+*
+* @retval true  初期化成功.
+* @retval false 初期化失敗.
+*/
+bool Renderer::Init(size_t maxChar, const glm::vec2& screen, const StreamBufferPtr& stream)
+{
+  if (maxChar > (USHRT_MAX + 1) / 4) {
+    std::cerr << "WARNING: " << maxChar << "は設定可能な最大文字数を越えています"<< std::endl;
+    maxChar = (USHRT_MAX + 1) / 4;
+  }
+  if (!stream) {
+    return false;
+  }
+  streamBuffer = stream;
+  vboCapacity = static_cast<GLsizei>(4 * maxChar);
+  {
+    std::vector<GLushort> tmp;
+    tmp.resize(maxChar * 6);
+    GLushort* p = tmp.data();
+    for (GLushort i = 0; i < maxChar * 4; i += 4) {
+      for (GLshort n : { 0, 1, 2, 2, 3, 0 }) {
+        *(p++) = i + n;
+      }
+    }
+    ibo.Init(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * 6 * maxChar, tmp.data(), GL_STATIC_DRAW);
+  }
+  // 頂点アトリビュートは、描画のたびにストリーミングバッファ内の位置に合わせて設定する.
+  vao.Init(streamBuffer->Id(), ibo.Id());
+
+  progFont = Shader::Program::Create("Res/Font.vert", "Res/Font.frag");
+  if (!progFont) {
+    return false;
+  }
+
+  reciprocalScreenSize = 2.0f / screen;
+  return true;
+}
+
+/**
+* フォントファイルを読み込む.
+*
+* @param filename フォントファイル名.
+*
+* @retval true  読み込み成功.
+* @retval false 読み込み失敗.
+*/
+bool Renderer::LoadFromFile(const char* filename)
+{
+  const std::unique_ptr<FILE, decltype(&fclose)> fp(fopen(filename, "r"), fclose);
+  if (!fp) {
+    return false;
+  }
+
+  int line = 1;
+  float fontSize;
+  int ret = fscanf(fp.get(), "info face=%*s size=%f bold=%*d italic=%*d charset=%*s"
+    " unicode=%*d stretchH=%*d smooth=%*d aa=%*d padding=%*d,%*d,%*d,%*d spacing=%*d,%*d", &fontSize);
+  ++line;
+  const float reciprocalFontSize = 1.0f / fontSize;
+
+  glm::vec2 scale;
+  ret = fscanf(fp.get(), " common lineHeight=%*d base=%*d scaleW=%f scaleH=%f pages=%*d packed=%*d", &scale.x, &scale.y);
+  if (ret < 2) {
+    std::cerr << "ERROR: '" << filename << "'の読み込みに失敗(line=" << line << ")" << std::endl;
+    return false;
+  }
+  const glm::vec2 reciprocalScale = glm::vec2(1.0f / scale);
+  ++line;
+
+  char tex[128];
+  ret = fscanf(fp.get(), " page id=%*d file=%127s", tex);
+  if (ret < 1) {
+    std::cerr << "ERROR: '" << filename << "'の読み込みに失敗(line=" << line << ")" << std::endl;
+    return false;
+  }
+  texFilename = filename;
+  const size_t lastSlashIndex = texFilename.find_last_of('/', std::string::npos);
+  if (lastSlashIndex == std::string::npos) {
+    texFilename.clear();
+  } else {
+    texFilename.resize(lastSlashIndex + 1);
+  }
+  texFilename.append(tex + 1); // 最初の「"」を抜いて追加.
+  texFilename.pop_back(); // 最後の「"」を消す.
+  ++line;
+
+  int charCount;
+  ret = fscanf(fp.get(), " chars count=%d", &charCount);
+  if (ret < 1) {
+    std::cerr << "ERROR: '" << filename << "'の読み込みに失敗(line=" << line << ")" << std::endl;
+    return false;
+  }
+  ++line;
+
+  fixedAdvance = 0;
+  fontList.resize(128);
+  for (int i = 0; i < charCount; ++i) {
+    FontInfo font;
+    glm::vec2 uv;
+    ret = fscanf(fp.get(), " char id=%d x=%f y=%f width=%f height=%f xoffset=%f yoffset=%f xadvance=%f page=%*d chnl=%*d", &font.id, &uv.x, &uv.y, &font.size.x, &font.size.y, &font.offset.x, &font.offset.y, &font.xadvance);
+    if (ret < 8) {
+      std::cerr << "ERROR: '" << filename << "'の読み込みに失敗(line=" << line << ")" << std::endl;
+      return false;
+    }
+    font.offset.y *= -1;
+    uv.y = scale.y - uv.y - font.size.y;
+    font.uv[0] = uv * reciprocalScale * 65535.0f;
+    font.uv[1] = (uv + font.size) * reciprocalScale * 65535.0f;
+    if (font.id < 128) {
+      fontList[font.id] = font;
+      if (font.xadvance > fixedAdvance) {
+        fixedAdvance = font.xadvance;
+      }
+    }
+    ++line;
+  }
+  GameEngine& game = GameEngine::Instance();
+  if (!game.LoadTextureFromFile(texFilename.c_str())) {
+    return false;
+  }
+  return true;
+}
+
+/**
+* 文字列を追加する.
+*
+* @param position 表示開始座標.
+* @param str      追加する文字列.
+*
+* @retval true  追加成功.
+* @retval false 追加失敗.
+*/
+bool Renderer::AddString(const glm::vec2& position, const char* str)
+{
+  if (!pVBO) {
+    return false;
+  }
+
+  const glm::u16vec2 thicknessAndOutline = glm::vec2(0.625f - thickness * 0.375f, border) * 65535.0f;
+
+  Vertex* p = pVBO + vboSize;
+  glm::vec2 pos = position;
+  for (const char* itr = str; *itr; ++itr) {
+    if (vboSize + 4 > vboCapacity) {
+      break;
+    }
+    const FontInfo& font = fontList[*itr];
+    if (font.id >= 0 && font.size.x && font.size.y) {
+      const glm::vec2 size = font.size * reciprocalScreenSize * scale;
+      const glm::vec2 offsetedPos = propotional ? pos + (font.offset * reciprocalScreenSize) * scale : pos;
+      p[0].position = offsetedPos + glm::vec2(0, -size.y);
+      p[0].uv = font.uv[0];
+      p[0].color = color;
+      p[0].subColor = subColor;
+      p[0].thicknessAndOutline = thicknessAndOutline;
+
+      p[1].position = offsetedPos + glm::vec2(size.x, -size.y);
+      p[1].uv = glm::u16vec2(font.uv[1].x, font.uv[0].y);
+      p[1].color = color;
+      p[1].subColor = subColor;
+      p[1].thicknessAndOutline = thicknessAndOutline;
+
+      p[2].position = offsetedPos + glm::vec2(size.x, 0);
+      p[2].uv = font.uv[1];
+      p[2].color = color;
+      p[2].subColor = subColor;
+      p[2].thicknessAndOutline = thicknessAndOutline;
+
+      p[3].position = offsetedPos;
+      p[3].uv = glm::u16vec2(font.uv[0].x, font.uv[1].y);
+      p[3].color = color;
+      p[3].subColor = subColor;
+      p[3].thicknessAndOutline = thicknessAndOutline;
+
+      p += 4;
+      vboSize += 4;
+    }
+    pos.x += (propotional ? (font.xadvance * reciprocalScreenSize.x) : fixedAdvance) * scale.x;
+  }
+  return true;
+}
+
+/**
+* 文字色を設定する.
+*
+* @param c 文字色.
+*/
+void Renderer::Color(const glm::vec4& c)
+{
+  color = glm::clamp(c, 0.0f, 1.0f) * 255.0f;
+}
+
+/**
+* 文字色取得する.
+*
+* @return 文字色.
+*/
+glm::vec4 Renderer::Color() const
+{
+  return glm::vec4(color) * (1.0f / 255.0f);
+}
+
+/**
+* サブ文字色を設定する.
+*
+* @param c 文字色.
+*/
+void Renderer::SubColor(const glm::vec4& c)
+{
+  subColor = glm::clamp(c, 0.0f, 1.0f) * 255.0f;
+}
+
+/**
+* サブ文字色取得する.
+*
+* @return 文字色.
+*/
+glm::vec4 Renderer::SubColor() const
+{
+  return glm::vec4(subColor) * (1.0f / 255.0f);
+}
+
+/**
+* 頂点データの書き込み先をストリーミングバッファから確保する.
+*
+* 確保できなかった場合、このフレームの文字列は描画されない.
+*/
+void Renderer::MapBuffer()
+{
+  if (pVBO) {
+    return;
+  }
+  vboSize = 0;
+  const StreamBuffer::Allocation a = streamBuffer->Allocate(sizeof(Vertex) * vboCapacity, sizeof(Vertex));
+  if (!a) {
+    std::cerr << "WARNING: フォント用の頂点データを確保できません" << std::endl;
+    return;
+  }
+  pVBO = static_cast<Vertex*>(a.pointer);
+  vboOffset = a.offset;
+}
+
+/**
+* 頂点データの書き込みを終了する.
+*
+* 書き込んだデータは、ストリーミングバッファのCommit()でGPUに転送される.
+*/
+void Renderer::UnmapBuffer()
+{
+  pVBO = nullptr;
+}
+
+/**
+* フォントを描画する.
+*/
+void Renderer::Draw() const
+{
+  if (vboSize > 0) {
+    vao.Bind();
+    GLState::BindBuffer(GL_ARRAY_BUFFER, streamBuffer->Id());
+    vao.VertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), vboOffset + offsetof(Vertex, position));
+    vao.VertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(Vertex), vboOffset + offsetof(Vertex, uv));
+    vao.VertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), vboOffset + offsetof(Vertex, color));
+    vao.VertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), vboOffset + offsetof(Vertex, subColor));
+    vao.VertexAttribPointer(4, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(Vertex), vboOffset + offsetof(Vertex, thicknessAndOutline));
+    GLState::Disable(GL_DEPTH_TEST);
+    GLState::Enable(GL_BLEND);
+    GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    progFont->UseProgram();
+    progFont->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, GameEngine::Instance().GetTexture(texFilename.c_str())->Id());
+    glDrawElements(GL_TRIANGLES, (vboSize / 4) * 6, GL_UNSIGNED_SHORT, 0);
+    vao.Unbind();
+  }
+}
+
 } // namespace Font
\ No newline at end of file
@@ -0,0 +1,599 @@
+/**
+* @file GLState.cpp
+*/
+#include "GLState.h"
+
+namespace GLState {
+
+namespace /* unnamed */ {
+
+static const GLuint unknownId = ~0U; ///< 記録がないことを示すID.
+static const GLenum unknownEnum = ~0U; ///< 記録がないことを示す列挙値.
+static const int maxTextureUnitCount = 16; ///< 記録するテクスチャ・イメージ・ユニットの数.
+static const int maxUniformBindingCount = 16; ///< 記録するUniformバッファのバインディング・ポイントの数.
+
+/// 記録するバッファのターゲット.
+static const GLenum bufferTargetList[] = {
+  GL_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER,
+};
+static const int bufferTargetCount = sizeof(bufferTargetList) / sizeof(bufferTargetList[0]);
+
+/// 記録する機能.
+static const GLenum capList[] = { GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, GL_SCISSOR_TEST };
+static const int capCount = sizeof(capList) / sizeof(capList[0]);
+
+/// 矩形.
+struct Rect
+{
+  GLint x, y;
+  GLsizei width, height;
+  bool operator==(const Rect& rhs) const { return x == rhs.x && y == rhs.y && width == rhs.width && height == rhs.height; }
+};
+
+/// Uniformバッファのバインディング・ポイントの状態.
+struct UniformBinding
+{
+  GLuint buffer;
+  GLintptr offset;
+  GLsizeiptr size; ///< BindBufferBaseで割り当てた場合は-1.
+};
+
+/// 記録された状態.
+struct State
+{
+  GLuint program;
+  GLuint vao;
+  GLenum activeTexture;
+  GLuint texture2D[maxTextureUnitCount];
+  GLuint textureCube[maxTextureUnitCount];
+  GLuint buffer[bufferTargetCount];
+  UniformBinding uniformBinding[maxUniformBindingCount];
+  GLuint framebuffer;
+  Rect viewport;
+  bool hasViewport;
+  Rect scissor;
+  bool hasScissor;
+  int cap[capCount]; ///< 1=有効, 0=無効, -1=不明.
+  GLenum blendFunc[4];
+  GLenum depthFunc;
+  int depthMask; ///< 1=書き込む, 0=書き込まない, -1=不明.
+};
+
+State state; ///< 記録された状態.
+bool isInitialized = false; ///< stateが初期化済みならtrue.
+bool isCounting = false; ///< trueなら呼び出し回数を数える.
+Statistics currentStats; ///< 現在のフレームの呼び出し回数.
+Statistics lastFrameStats; ///< 直前のフレームの呼び出し回数.
+
+/// GL関数を呼び出したことを記録する.
+void Issued(size_t n = 1)
+{
+  if (isCounting) {
+    currentStats.issuedCount += n;
+  }
+}
+
+/// GL関数の呼び出しを省略したことを記録する.
+void Elided(size_t n = 1)
+{
+  if (isCounting) {
+    currentStats.elidedCount += n;
+  }
+}
+
+/// 必要なら状態を初期化する.
+State& GetState()
+{
+  if (!isInitialized) {
+    Invalidate();
+  }
+  return state;
+}
+
+/// バッファのターゲットの記録位置を取得する. 記録しないターゲットなら-1.
+int BufferTargetIndex(GLenum target)
+{
+  for (int i = 0; i < bufferTargetCount; ++i) {
+    if (bufferTargetList[i] == target) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/// 機能の記録位置を取得する. 記録しない機能なら-1.
+int CapIndex(GLenum cap)
+{
+  for (int i = 0; i < capCount; ++i) {
+    if (capList[i] == cap) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/// テクスチャ・イメージ・ユニットを選択する.
+void ActiveTexture(State& s, GLenum unit)
+{
+  if (s.activeTexture == unit) {
+    Elided();
+    return;
+  }
+  glActiveTexture(unit);
+  s.activeTexture = unit;
+  Issued();
+}
+
+/// 機能の有効・無効を設定する.
+void SetCap(GLenum cap, bool enable)
+{
+  State& s = GetState();
+  const int index = CapIndex(cap);
+  if (index >= 0 && s.cap[index] == static_cast<int>(enable)) {
+    Elided();
+    return;
+  }
+  if (enable) {
+    glEnable(cap);
+  } else {
+    glDisable(cap);
+  }
+  if (index >= 0) {
+    s.cap[index] = enable;
+  }
+  Issued();
+}
+
+} // unnamed namespace
+
+/**
+* 記録した状態を破棄する.
+*
+* 以後の各設定は、最初の1回は必ずGL関数を呼び出す.
+* コンテキストを作成したときや、GLStateを通さずに状態を変更したときに呼び出すこと.
+*/
+void Invalidate()
+{
+  state.program = unknownId;
+  state.vao = unknownId;
+  state.activeTexture = unknownEnum;
+  for (int i = 0; i < maxTextureUnitCount; ++i) {
+    state.texture2D[i] = unknownId;
+    state.textureCube[i] = unknownId;
+  }
+  for (auto& e : state.buffer) {
+    e = unknownId;
+  }
+  for (auto& e : state.uniformBinding) {
+    e.buffer = unknownId;
+  }
+  state.framebuffer = unknownId;
+  state.hasViewport = false;
+  state.hasScissor = false;
+  for (auto& e : state.cap) {
+    e = -1;
+  }
+  for (auto& e : state.blendFunc) {
+    e = unknownEnum;
+  }
+  state.depthFunc = unknownEnum;
+  state.depthMask = -1;
+  isInitialized = true;
+}
+
+/**
+* 描画に使うシェーダプログラムを設定する.
+*
+* @param program プログラムオブジェクト.
+*/
+void UseProgram(GLuint program)
+{
+  State& s = GetState();
+  if (s.program == program) {
+    Elided();
+    return;
+  }
+  glUseProgram(program);
+  s.program = program;
+  Issued();
+}
+
+/**
+* VAOをバインドする.
+*
+* @param vao VAO.
+*/
+void BindVertexArray(GLuint vao)
+{
+  State& s = GetState();
+  if (s.vao == vao) {
+    Elided();
+    return;
+  }
+  glBindVertexArray(vao);
+  s.vao = vao;
+  Issued();
+}
+
+/**
+* テクスチャをテクスチャ・イメージ・ユニットに割り当てる.
+*
+* @param unit    割り当て先のテクスチャ・イメージ・ユニット番号(GL_TEXTURE0～).
+* @param target  テクスチャの種類(GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAPなど).
+* @param texture 割り当てるテクスチャオブジェクト.
+*
+* 割り当てが変化しない場合はユニットの選択も省略されるため、テクスチャを操作するときはEditTexture()を使うこと.
+*/
+void BindTexture(GLenum unit, GLenum target, GLuint texture)
+{
+  State& s = GetState();
+  const int index = static_cast<int>(unit - GL_TEXTURE0);
+  GLuint* p = nullptr;
+  if (index >= 0 && index < maxTextureUnitCount) {
+    if (target == GL_TEXTURE_2D) {
+      p = &s.texture2D[index];
+    } else if (target == GL_TEXTURE_CUBE_MAP) {
+      p = &s.textureCube[index];
+    }
+  }
+  if (p && *p == texture) {
+    Elided(2);
+    return;
+  }
+  ActiveTexture(s, unit);
+  glBindTexture(target, texture);
+  if (p) {
+    *p = texture;
+  }
+  Issued();
+}
+
+/**
+* テクスチャを操作するためにバインドする.
+*
+* @param target  テクスチャの種類(GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAPなど).
+* @param texture 操作するテクスチャオブジェクト.
+*
+* GL_TEXTURE0を選択してからtextureを割り当てる. glTexImage2Dなどの前に使うこと.
+*/
+void EditTexture(GLenum target, GLuint texture)
+{
+  ActiveTexture(GetState(), GL_TEXTURE0);
+  BindTexture(GL_TEXTURE0, target, texture);
+}
+
+/**
+* バッファオブジェクトをバインドする.
+*
+* @param target バインド先のターゲット.
+* @param buffer バッファオブジェクト.
+*/
+void BindBuffer(GLenum target, GLuint buffer)
+{
+  State& s = GetState();
+  const int index = BufferTargetIndex(target);
+  if (index >= 0 && s.buffer[index] == buffer) {
+    Elided();
+    return;
+  }
+  glBindBuffer(target, buffer);
+  if (index >= 0) {
+    s.buffer[index] = buffer;
+  }
+  Issued();
+}
+
+/**
+* バッファオブジェクト全体をバインディング・ポイントに割り当てる.
+*
+* @param target バインド先のターゲット.
+* @param index  バインディング・ポイント.
+* @param buffer バッファオブジェクト.
+*
+* 汎用のバインド先(target)にもbufferがバインドされる.
+*/
+void BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+  State& s = GetState();
+  const bool isTracked = target == GL_UNIFORM_BUFFER && index < maxUniformBindingCount;
+  if (isTracked) {
+    const UniformBinding& e = s.uniformBinding[index];
+    if (e.buffer == buffer && e.size < 0) {
+      Elided();
+      return;
+    }
+  }
+  glBindBufferBase(target, index, buffer);
+  if (isTracked) {
+    s.uniformBinding[index] = { buffer, 0, -1 };
+  }
+  const int targetIndex = BufferTargetIndex(target);
+  if (targetIndex >= 0) {
+    s.buffer[targetIndex] = buffer;
+  }
+  Issued();
+}
+
+/**
+* バッファオブジェクトの一部をバインディング・ポイントに割り当てる.
+*
+* @param target バインド先のターゲット.
+* @param index  バインディング・ポイント.
+* @param buffer バッファオブジェクト.
+* @param offset 割り当てる範囲のバイトオフセット.
+* @param size   割り当てる範囲のバイト数.
+*
+* 汎用のバインド先(target)にもbufferがバインドされる.
+*/
+void BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+  State& s = GetState();
+  const bool isTracked = target == GL_UNIFORM_BUFFER && index < maxUniformBindingCount;
+  if (isTracked) {
+    const UniformBinding& e = s.uniformBinding[index];
+    if (e.buffer == buffer && e.offset == offset && e.size == size) {
+      Elided();
+      return;
+    }
+  }
+  glBindBufferRange(target, index, buffer, offset, size);
+  if (isTracked) {
+    s.uniformBinding[index] = { buffer, offset, size };
+  }
+  const int targetIndex = BufferTargetIndex(target);
+  if (targetIndex >= 0) {
+    s.buffer[targetIndex] = buffer;
+  }
+  Issued();
+}
+
+/**
+* フレームバッファをバインドする.
+*
+* @param framebuffer フレームバッファオブジェクト. 0ならデフォルトのフレームバッファ.
+*/
+void BindFramebuffer(GLuint framebuffer)
+{
+  State& s = GetState();
+  if (s.framebuffer == framebuffer) {
+    Elided();
+    return;
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  s.framebuffer = framebuffer;
+  Issued();
+}
+
+/**
+* ビューポートを設定する.
+*/
+void Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+  State& s = GetState();
+  const Rect rect = { x, y, width, height };
+  if (s.hasViewport && s.viewport == rect) {
+    Elided();
+    return;
+  }
+  glViewport(x, y, width, height);
+  s.viewport = rect;
+  s.hasViewport = true;
+  Issued();
+}
+
+/**
+* シザー矩形を設定する.
+*/
+void Scissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+  State& s = GetState();
+  const Rect rect = { x, y, width, height };
+  if (s.hasScissor && s.scissor == rect) {
+    Elided();
+    return;
+  }
+  glScissor(x, y, width, height);
+  s.scissor = rect;
+  s.hasScissor = true;
+  Issued();
+}
+
+/**
+* 機能を有効にする.
+*
+* @param cap 有効にする機能(GL_BLEND, GL_DEPTH_TESTなど).
+*/
+void Enable(GLenum cap)
+{
+  SetCap(cap, true);
+}
+
+/**
+* 機能を無効にする.
+*
+* @param cap 無効にする機能(GL_BLEND, GL_DEPTH_TESTなど).
+*/
+void Disable(GLenum cap)
+{
+  SetCap(cap, false);
+}
+
+/**
+* ブレンド関数を設定する.
+*/
+void BlendFunc(GLenum sfactor, GLenum dfactor)
+{
+  BlendFuncSeparate(sfactor, dfactor, sfactor, dfactor);
+}
+
+/**
+* RGBとアルファで別々のブレンド関数を設定する.
+*/
+void BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+  State& s = GetState();
+  if (s.blendFunc[0] == srcRGB && s.blendFunc[1] == dstRGB && s.blendFunc[2] == srcAlpha && s.blendFunc[3] == dstAlpha) {
+    Elided();
+    return;
+  }
+  glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+  s.blendFunc[0] = srcRGB;
+  s.blendFunc[1] = dstRGB;
+  s.blendFunc[2] = srcAlpha;
+  s.blendFunc[3] = dstAlpha;
+  Issued();
+}
+
+/**
+* 深度比較関数を設定する.
+*/
+void DepthFunc(GLenum func)
+{
+  State& s = GetState();
+  if (s.depthFunc == func) {
+    Elided();
+    return;
+  }
+  glDepthFunc(func);
+  s.depthFunc = func;
+  Issued();
+}
+
+/**
+* 深度バッファへの書き込みの有無を設定する.
+*/
+void DepthMask(GLboolean flag)
+{
+  State& s = GetState();
+  const int value = flag ? 1 : 0;
+  if (s.depthMask == value) {
+    Elided();
+    return;
+  }
+  glDepthMask(flag);
+  s.depthMask = value;
+  Issued();
+}
+
+/**
+* プログラムオブジェクトを削除する.
+*
+* 使用中のプログラムは削除が保留されるため、記録は不明な状態にしておく.
+*/
+void DeleteProgram(GLuint program)
+{
+  State& s = GetState();
+  glDeleteProgram(program);
+  if (s.program == program) {
+    s.program = unknownId;
+  }
+}
+
+/**
+* VAOを削除する.
+*
+* バインドされていた場合、バインドは0に戻る.
+*/
+void DeleteVertexArray(GLuint vao)
+{
+  State& s = GetState();
+  glDeleteVertexArrays(1, &vao);
+  if (s.vao == vao) {
+    s.vao = 0;
+  }
+}
+
+/**
+* テクスチャオブジェクトを削除する.
+*
+* 割り当てられていたユニットは0に戻る.
+*/
+void DeleteTexture(GLuint texture)
+{
+  State& s = GetState();
+  glDeleteTextures(1, &texture);
+  for (int i = 0; i < maxTextureUnitCount; ++i) {
+    if (s.texture2D[i] == texture) {
+      s.texture2D[i] = 0;
+    }
+    if (s.textureCube[i] == texture) {
+      s.textureCube[i] = 0;
+    }
+  }
+}
+
+/**
+* バッファオブジェクトを削除する.
+*
+* バインドされていたターゲットとバインディング・ポイントは0に戻る.
+*/
+void DeleteBuffer(GLuint buffer)
+{
+  State& s = GetState();
+  glDeleteBuffers(1, &buffer);
+  for (auto& e : s.buffer) {
+    if (e == buffer) {
+      e = 0;
+    }
+  }
+  for (auto& e : s.uniformBinding) {
+    if (e.buffer == buffer) {
+      e = { 0, 0, -1 };
+    }
+  }
+}
+
+/**
+* フレームバッファオブジェクトを削除する.
+*
+* バインドされていた場合、デフォルトのフレームバッファに戻る.
+*/
+void DeleteFramebuffer(GLuint framebuffer)
+{
+  State& s = GetState();
+  glDeleteFramebuffers(1, &framebuffer);
+  if (s.framebuffer == framebuffer) {
+    s.framebuffer = 0;
+  }
+}
+
+/**
+* 呼び出し回数を数えるかどうかを設定する.
+*
+* @param enable trueなら数える.
+*/
+void CounterMode(bool enable)
+{
+  isCounting = enable;
+  currentStats = Statistics();
+  lastFrameStats = Statistics();
+}
+
+/**
+* 呼び出し回数を数えているかどうか.
+*/
+bool CounterMode()
+{
+  return isCounting;
+}
+
+/**
+* フレームの終わりを通知する.
+*
+* 現在のフレームの呼び出し回数をLastFrameStats()で取得できるようにし、カウンタをリセットする.
+*/
+void EndFrame()
+{
+  lastFrameStats = currentStats;
+  currentStats = Statistics();
+}
+
+/**
+* 直前のフレームの呼び出し回数を取得する.
+*/
+const Statistics& LastFrameStats()
+{
+  return lastFrameStats;
+}
+
+} // namespace GLState
\ No newline at end of file
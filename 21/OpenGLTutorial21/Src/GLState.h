@@ -0,0 +1,65 @@
+/**
+* @file GLState.h
+*/
+#ifndef GLSTATE_H_INCLUDED
+#define GLSTATE_H_INCLUDED
+#include <GL/glew.h>
+#include <cstddef>
+
+/**
+* OpenGLの状態を記録し、変化しない設定を省略する関数群.
+*
+* 記録対象の状態は、必ずここの関数を通して変更すること.
+* 直接glXxxを呼んだ場合は、Invalidate()で記録を破棄しなければならない.
+*
+* 記録する状態:
+* - シェーダプログラム、VAO
+* - テクスチャ・イメージ・ユニットごとの2Dテクスチャとキューブマップ
+* - バッファのバインド(GL_ELEMENT_ARRAY_BUFFERはVAOの状態なので記録しない)、Uniformバッファのバインディング・ポイントごとの範囲
+* - フレームバッファ、ビューポート、シザー矩形
+* - GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, GL_SCISSOR_TESTの有効・無効、ブレンド関数、深度比較関数、深度バッファへの書き込み
+*/
+namespace GLState {
+
+/**
+* GL関数の呼び出し回数.
+*/
+struct Statistics
+{
+  size_t issuedCount = 0; ///< 実際に呼び出した回数.
+  size_t elidedCount = 0; ///< 状態が変化しないため省略した回数.
+};
+
+void Invalidate();
+
+void UseProgram(GLuint program);
+void BindVertexArray(GLuint vao);
+void BindTexture(GLenum unit, GLenum target, GLuint texture);
+void EditTexture(GLenum target, GLuint texture);
+void BindBuffer(GLenum target, GLuint buffer);
+void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+void BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+void BindFramebuffer(GLuint framebuffer);
+void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+void Scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+void Enable(GLenum cap);
+void Disable(GLenum cap);
+void BlendFunc(GLenum sfactor, GLenum dfactor);
+void BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+void DepthFunc(GLenum func);
+void DepthMask(GLboolean flag);
+
+void DeleteProgram(GLuint program);
+void DeleteVertexArray(GLuint vao);
+void DeleteTexture(GLuint texture);
+void DeleteBuffer(GLuint buffer);
+void DeleteFramebuffer(GLuint framebuffer);
+
+void CounterMode(bool enable);
+bool CounterMode();
+void EndFrame();
+const Statistics& LastFrameStats();
+
+} // namespace GLState
+
+#endif // GLSTATE_H_INCLUDED
\ No newline at end of file
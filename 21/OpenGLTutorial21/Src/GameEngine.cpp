@@ -1,964 +1,1588 @@
-/**
-* @file GameEngine.cpp
-*/
-#include "GameEngine.h"
-#include "GLFWEW.h"
-#include <glm/gtc/matrix_transform.hpp>
-#include <array>
-#include <iostream>
-#include <time.h>
-
-#include "Audio.h"
-
-/// _f[^^.
-struct Vertex
-{
-  glm::vec3 position; ///< W
-  glm::vec4 color; ///< F
-  glm::vec2 texCoord; ///< eNX`W.
-};
-
-/// _f[^.
-const Vertex vertices[] = {
-  { {-0.5f, -0.3f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 0.0f} },
-  { { 0.3f, -0.3f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f} },
-  { { 0.3f,  0.5f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 1.0f, 1.0f} },
-  { {-0.5f,  0.5f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 1.0f} },
-
-  { {-0.3f,  0.3f, 0.1f}, {0.0f, 0.0f, 1.0f, 1.0f}, { 0.0f, 1.0f} },
-  { {-0.3f, -0.5f, 0.1f}, {0.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 0.0f} },
-  { { 0.5f, -0.5f, 0.1f}, {0.0f, 0.0f, 1.0f, 1.0f}, { 1.0f, 0.0f} },
-  { { 0.5f, -0.5f, 0.1f}, {1.0f, 0.0f, 0.0f, 1.0f}, { 1.0f, 0.0f} },
-  { { 0.5f,  0.3f, 0.1f}, {1.0f, 1.0f, 0.0f, 1.0f}, { 1.0f, 1.0f} },
-  { {-0.3f,  0.3f, 0.1f}, {1.0f, 0.0f, 0.0f, 1.0f}, { 0.0f, 1.0f} },
-
-  { {-1.0f,-1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 0.0f} },
-  { { 1.0f,-1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f} },
-  { { 1.0f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 1.0f, 1.0f} },
-  { {-1.0f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 1.0f} },
-
-  { {-1.25f,-1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 0.0f} },
-  { { 0.75f,-1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f} },
-  { { 0.75f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 1.0f, 1.0f} },
-  { {-1.25f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 1.0f} },
-
-  { {-0.75f,-1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 0.0f} },
-  { { 1.25f,-1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f} },
-  { { 1.25f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 1.0f, 1.0f} },
-  { {-0.75f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 1.0f} },
-};
-
-/// CfbNXf[^.
-const GLuint indices[] = {
-  0, 1, 2, 2, 3, 0,
-  4, 5, 6, 7, 8, 9,
-  10, 11, 12, 12, 13, 10,
-  14, 15, 16, 16, 17, 14,
-  18, 19, 20, 20, 21, 18,
-};
-
-/**
-* CfbNX`͈.
-*/
-struct RenderingData
-{
-  GLsizei size; ///< `悷CfbNX.
-  GLvoid* offset; ///< `JnCfbNX̃oCgItZbg.
-};
-
-/**
-* RenderingData쐬.
-*
-* @param size `悷CfbNX.
-* @param offset `JnCfbNX̃ItZbg(CfbNXP).
-*
-* @return CfbNX`͈̓IuWFNg.
-*/
-constexpr RenderingData MakeRenderingData(GLsizei size, GLsizei offset) {
-  return { size, reinterpret_cast<GLvoid*>(offset * sizeof(GLuint)) };
-}
-
-/**
-* `͈̓Xg.
-*/
-static const RenderingData renderingData[] = {
-  MakeRenderingData( 3 * 4, 0),
-  MakeRenderingData( 3 * 2, 12),
-  MakeRenderingData( 3 * 2, 18),
-  MakeRenderingData( 3 * 2, 24),
-};
-
-/**
-* Uniform Buffer̃oCfBOE|Cg.
-*/
-enum BindingPoint {
-  BindingPoint_Vertex,
-  BindingPoint_Light,
-
-  countof_BindingPoint, ///< `oCfBOE|Cg̐.
-};
-
-/**
-* Vertex Buffer Object쐬.
-*
-* @param size _f[^̃TCY.
-* @param data _f[^ւ̃|C^.
-*
-* @return 쐬VBOID.
-*/
-GLuint CreateVBO(GLsizeiptr size, const GLvoid* data)
-{
-  GLuint vbo = 0;
-  glGenBuffers(1, &vbo);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  return vbo;
-}
-
-/**
-* Index Buffer Object쐬.
-*
-* @param size CfbNXf[^̃TCY.
-* @param data CfbNXf[^ւ̃|C^.
-*
-* @return 쐬IBO.
-*/
-GLuint CreateIBO(GLsizeiptr size, const GLvoid* data)
-{
-  GLuint ibo = 0;
-  glGenBuffers(1, &ibo);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STREAM_DRAW);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-  return ibo;
-}
-
-/**
-* _Agr[gݒ肷.
-*
-* @param index _Agr[g̃CfbNX.
-* @param cls   _f[^^.
-* @param mbr   _Agr[gɐݒ肷cls̃oϐ.
-*/
-#define SetVertexAttribPointer(index, cls, mbr) \
-  SetVertexAttribPointerI(index, sizeof(cls::mbr) / sizeof(float), sizeof(cls), reinterpret_cast<GLvoid*>(offsetof(cls, mbr)))
-void SetVertexAttribPointerI(GLuint index, GLint size, GLsizei stride, const GLvoid* pointer)
-{
-  glEnableVertexAttribArray(index);
-  glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, stride, pointer);
-}
-
-/**
-* Vertex Array Object쐬.
-*
-* @param vbo VAOɊ֘AtVBO.
-* @param ibo VAOɊ֘AtIBO.
-*
-* @return 쐬VAO.
-*/
-GLuint CreateVAO(GLuint vbo, GLuint ibo)
-{
-  GLuint vao = 0;
-  glGenVertexArrays(1, &vao);
-  glBindVertexArray(vao);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  SetVertexAttribPointer(0, Vertex, position);
-  SetVertexAttribPointer(1, Vertex, color);
-  SetVertexAttribPointer(2, Vertex, texCoord);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-  glBindVertexArray(0);
-  return vao;
-}
-
-/**
-* Q[GW̃CX^X擾.
-*
-* @return Q[GW̃CX^X.
-*/
-GameEngine& GameEngine::Instance() {
-  static GameEngine instance;
-  return instance;
-}
-
-/**
-* fXgN^.
-*/
-GameEngine::~GameEngine()
-{
-  updateFunc = nullptr;
-  Audio::Destroy();
-  if (vao) {
-    glDeleteVertexArrays(1, &vao);
-  }
-  if (ibo) {
-    glDeleteBuffers(1, &ibo);
-  }
-  if (vbo) {
-    glDeleteBuffers(1, &vbo);
-  }
-}
-
-/**
-* ԍXV֐ݒ肷.
-*
-* @param func ݒ肷XV֐.
-*/
-void GameEngine::UpdateFunc(const UpdateFuncType& func)
-{
-  updateFunc = func;
-}
-
-/**
-* ԍXV֐擾.
-*
-* @return ݒ肳ĂXV֐.
-*/
-const GameEngine::UpdateFuncType& GameEngine::UpdateFunc() const
-{
-  return updateFunc;
-}
-
-/**
-* Q[GW.
-*
-* @param w     EBhE̕`͈͂̕(sNZ).
-* @param h     EBhE̕`͈͂̍(sNZ).
-* @param title EBhE^Cg(UTF-80I[).
-*
-* @retval true  .
-* @retval false s.
-*
-* Update, Render֐ȂǂĂяoOɁAxĂяoĂKv.
-* xɐƁAȌ̌Ăяoł͂ȂɂtrueԂ.
-*/
-bool GameEngine::Init(int w, int h, const char* title)
-{
-  if (isInitialized) {
-    return true;
-  }
-  if (!GLFWEW::Window::Instance().Init(w, h, title)) {
-    return false;
-  }
-  vbo = CreateVBO(sizeof(vertices), vertices);
-  ibo = CreateIBO(sizeof(indices), indices);
-  vao = CreateVAO(vbo, ibo);
-
-  uboLight = UniformBuffer::Create(sizeof(Uniform::LightingData), BindingPoint_Light, "LightingData");
-  uboPostEffect = UniformBuffer::Create(sizeof(Uniform::PostEffectData), 2, "PostEffectData");
-  if (!vbo || !ibo || !vao || !uboLight || !uboPostEffect) {
-    return false;
-  }
-
-  static const char* const shaderNameList[][3] = {
-    { "Tutorial", "Res/Tutorial.vert", "Res/Tutorial.frag" },
-    { "PostEffect", "Res/PostEffect.vert", "Res/PostEffect.frag" },
-    { "Bloom", "Res/Bloom1st.vert", "Res/Bloom1st.frag" },
-    { "Composition", "Res/FinalComposition.vert", "Res/FinalComposition.frag" },
-    { "Simple", "Res/Simple.vert", "Res/Simple.frag" },
-    { "LensFlare", "Res/AnamorphicLensFlare.vert", "Res/AnamorphicLensFlare.frag" },
-    { "NonLighting", "Res/NonLighting.vert", "Res/NonLighting.frag" },
-    { "RenderDepth", "Res/RenderDepth.vert", "Res/RenderDepth.frag" },
-  };
-  shaderMap.reserve(sizeof(shaderNameList) / sizeof(shaderNameList[0]));
-  for (auto& e : shaderNameList) {
-    Shader::ProgramPtr program = Shader::Program::Create(e[1], e[2]);
-    if (!program) {
-      return false;
-    }
-    shaderMap.insert(std::make_pair(std::string(e[0]), program));
-  }
-  shaderMap["Tutorial"]->UniformBlockBinding("VertexData", BindingPoint_Vertex);
-  shaderMap["Tutorial"]->UniformBlockBinding("LightingData", BindingPoint_Light);
-  shaderMap["Composition"]->UniformBlockBinding("PostEffectData", 2);
-  shaderMap["Bloom"]->UniformBlockBinding("PostEffectData", 2);
-
-  meshBuffer = Mesh::Buffer::Create(60 * 1024, 60 * 1024);
-  if (!meshBuffer) {
-    return false;
-  }
-  textureMapStack.push_back(TextureMap());
-
-  entityBuffer = Entity::Buffer::Create(1024, sizeof(Uniform::VertexData), BindingPoint_Vertex, "VertexData");
-  if (!entityBuffer) {
-    return false;
-  }
-
-  static const uint32_t textureData[] = {
-    0xffffffff, 0xffcccccc, 0xffffffff, 0xffcccccc, 0xffffffff,
-    0xff888888, 0xffffffff, 0xff888888, 0xffffffff, 0xff888888,
-    0xffffffff, 0xff444444, 0xffffffff, 0xff444444, 0xffffffff,
-    0xff000000, 0xffffffff, 0xff000000, 0xffffffff, 0xff000000,
-    0xffffffff, 0xff000000, 0xffffffff, 0xff000000, 0xffffffff,
-  };
-  //  TexturePtr tex = Texture::Create(5, 5, GL_RGBA8, GL_RGBA, textureData);
-
-  rand.seed(std::random_device()());
-
-  offscreen = OffscreenBuffer::Create(800, 600,  GL_RGBA16F);
-  for (int i = 0, scale = 4; i < bloomBufferCount; ++i, scale *= 4) {
-    const int w = (800 + scale - 1) / scale;
-    const int h = (600 + scale - 1) / scale;
-    offBloom[i] = OffscreenBuffer::Create(w, h, GL_RGBA16F);
-    if (!offBloom) {
-      return false;
-    }
-  }
-  offAnamorphic[0] = OffscreenBuffer::Create(800 / 16, 600 / 2, GL_RGBA8);
-  offAnamorphic[1] = OffscreenBuffer::Create(800 / 64, 600 / 2, GL_RGBA8);
-  if (!offscreen || !offAnamorphic[0] || !offAnamorphic[1]) {
-    return false;
-  }
-
-  {
-    int width, height;
-    glBindTexture(GL_TEXTURE_2D, offBloom[bloomBufferCount - 1]->GetTexutre());
-    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
-    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    for (auto& e : pbo) {
-      e.Init(GL_PIXEL_PACK_BUFFER, width * height * sizeof(GLfloat) * 4, nullptr, GL_DYNAMIC_READ);
-    }
-  }
-
-  offDepth = OffscreenBuffer::Create(2048, 2048, GL_DEPTH_COMPONENT16);
-  if (!offDepth) {
-    return false;
-  }
-
-  fontRenderer.Init(1024, glm::vec2(800, 600));
-
-  camera[0].isActive = true;
-
-  isInitialized = true;
-  return true;
-}
-
-/**
-* Q[̏ԂXV.
-*
-* @param delta O̍XV̌oߎ(b).
-*/
-void GameEngine::Update(double delta)
-{
-  Audio::Update();
-  fontRenderer.MapBuffer();
-  if (updateFunc) {
-    updateFunc(delta);
-  }
-  const GLFWEW::Window& window = GLFWEW::Window::Instance();
-  const glm::mat4x4 matProj = glm::perspective(glm::radians(45.0f), static_cast<float>(window.Width()) / static_cast<float>(window.Height()), 1.0f, 1000.0f);
-  glm::mat4x4 matView[Uniform::maxViewCount];
-  for (int i = 0; i < Uniform::maxViewCount; ++i) {
-    if (!camera[i].isActive) {
-      continue;
-    }
-    const CameraData& cam = camera[i].camera;
-    matView[i] = glm::lookAt(cam.position, cam.target, cam.up);
-  }
-  const glm::vec2 range = shadowParameter.range * 0.5f;
-  glm::mat4 depthProjectionMatrix = glm::ortho<float>(-range.x, range.x, -range.y, range.y, shadowParameter.near, shadowParameter.far);
-  glm::mat4 depthViewMatrix = glm::lookAt(shadowParameter.lightPos, shadowParameter.lightPos + shadowParameter.lightDir, shadowParameter.lightUp);
-  glm::mat4 depthMVP = depthProjectionMatrix * depthViewMatrix;
-
-  entityBuffer->Update(delta, matView, matProj, depthMVP);
-  fontRenderer.UnmapBuffer();
-}
-
-struct GameEngine::RenderingContext
-{
-  std::array<int, Uniform::maxViewCount> cameraIndices;
-};
-
-/**
-* D揇Ń\[gꂽJCfbNXz쐬.
-*/
-void GameEngine::InitRenderingContext(RenderingContext& context) const
-{
-  for (int i = 0; i < Uniform::maxViewCount; ++i) {
-    context.cameraIndices[i] = i;
-  }
-  std::stable_sort(context.cameraIndices.begin(), context.cameraIndices.end(), [&](int lhs, int rhs) {
-    return camera[lhs].priority > camera[rhs].priority;
-  });
-}
-
-/**
-* e`悷.
-*/
-void GameEngine::RenderShadow(RenderingContext& context) const
-{
-  glBindFramebuffer(GL_FRAMEBUFFER, offDepth->GetFramebuffer());
-  glEnable(GL_DEPTH_TEST);
-  glDepthFunc(GL_LESS);
-  glEnable(GL_CULL_FACE);
-  glDisable(GL_BLEND);
-  glViewport(0, 0, offDepth->Width(), offDepth->Height());
-  glScissor(0, 0, offDepth->Width(), offDepth->Height());
-  glClearDepth(1);
-  glClear(GL_DEPTH_BUFFER_BIT);
-
-  const Shader::ProgramPtr& progDepth = shaderMap.find("RenderDepth")->second;
-  progDepth->UseProgram();
-
-  for (int index : context.cameraIndices) {
-    if (camera[index].isActive) {
-      entityBuffer->DrawDepth(index, meshBuffer);
-    }
-  }
-}
-
-/**
-* Q[̏Ԃ`悷.
-*/
-void GameEngine::Render() const
-{
-  RenderingContext context;
-  InitRenderingContext(context);
-
-  RenderShadow(context);
-
-  glBindFramebuffer(GL_FRAMEBUFFER, offscreen->GetFramebuffer());
-  glEnable(GL_DEPTH_TEST);
-  glDepthFunc(GL_LEQUAL);
-  glEnable(GL_CULL_FACE);
-  glViewport(0, 0, offscreen->Width(), offscreen->Height());
-  glScissor(0, 0, offscreen->Width(), offscreen->Height());
-  glClearColor(0.1f, 0.3f, 0.5f, 1.0f);
-  glClearDepth(1);
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-  glEnable(GL_BLEND);
-  glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ZERO);
-
-  shaderMap.find("Tutorial")->second->BindShadowTexture(GL_TEXTURE_2D, offDepth->GetTexutre());
-  uboLight->BufferSubData(&lightData);
-  for (int index : context.cameraIndices) {
-    if (camera[index].isActive) {
-      entityBuffer->Draw(index, meshBuffer);
-    }
-  }
-  glActiveTexture(GL_TEXTURE2);
-  glBindTexture(GL_TEXTURE_2D, 0);
-
-  glBindVertexArray(vao);
-
-#if 0
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
-  glClearColor(0.5f, 0.3f, 0.1f, 1.0f);
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-  progTutorial->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offscreen->GetTexutre());
-
-  VertexData transData;
-  uboTrans->BufferSubData(&transData);
-
-  LightingData lightData;
-  lightData.ambientColor = glm::vec4(1);
-  uboLight->BufferSubData(&lightData);
-#endif
-
-  glDisable(GL_DEPTH_TEST);
-  glDepthFunc(GL_LESS);
-  glDisable(GL_CULL_FACE);
-  glDisable(GL_BLEND);
-
-  Uniform::PostEffectData postEffect;
-#if 0
-  postEffect.matColor[0] = glm::vec4(0.393f, 0.349f, 0.272f, 0);
-  postEffect.matColor[1] = glm::vec4(0.769f, 0.686f, 0.534f, 0);
-  postEffect.matColor[2] = glm::vec4(0.189f, 0.168f, 0.131f, 0);
-  postEffect.matColor[3] = glm::vec4(0, 0, 0, 1);
-#elif 0
-  static float x = 1, xx = -0.01f;
-  postEffect.matColor[0] = glm::vec4(x, 0, 0, 0);
-  postEffect.matColor[1] = glm::vec4(0, x, 0, 0);
-  postEffect.matColor[2] = glm::vec4(0, 0, x, 0);
-  postEffect.matColor[3] = glm::vec4(0, 0, 0, 1);
-  x += xx;
-  if (x < -1.0f) {
-    xx = 0.01f;
-  } else if (x >= 1.0f) {
-    xx = -0.01f;
-  }
-#endif
-  postEffect.lumScale = luminanceScale;
-  postEffect.bloomThreshould = 1.0f / luminanceScale;
-  uboPostEffect->BufferSubData(&postEffect);
-
-  const Shader::ProgramPtr& progBloom = shaderMap.find("Bloom")->second;
-  progBloom->UseProgram();
-  glBindFramebuffer(GL_FRAMEBUFFER, offBloom[0]->GetFramebuffer());
-  glViewport(0, 0, offBloom[0]->Width(), offBloom[0]->Height());
-  progBloom->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offscreen->GetTexutre());
-  glDrawElements(GL_TRIANGLES, renderingData[1].size, GL_UNSIGNED_INT, renderingData[1].offset);
-
-  const Shader::ProgramPtr& progShrink = shaderMap.find("Simple")->second;
-  progShrink->UseProgram();
-  for (int i = 1; i < bloomBufferCount; ++i) {
-    glBindFramebuffer(GL_FRAMEBUFFER, offBloom[i]->GetFramebuffer());
-    glViewport(0, 0, offBloom[i]->Width(), offBloom[i]->Height());
-    progShrink->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offBloom[i - 1]->GetTexutre());
-    glDrawElements(GL_TRIANGLES, renderingData[1].size, GL_UNSIGNED_INT, renderingData[1].offset);
-  }
-
-  const Shader::ProgramPtr& progLensFlare = shaderMap.find("LensFlare")->second;
-  progLensFlare->UseProgram();
-  glBindFramebuffer(GL_FRAMEBUFFER, offAnamorphic[0]->GetFramebuffer());
-  glViewport(0, 0, offAnamorphic[0]->Width(), offAnamorphic[0]->Height());
-  progLensFlare->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offBloom[0]->GetTexutre());
-  glDrawElements(GL_TRIANGLES, renderingData[1].size, GL_UNSIGNED_INT, renderingData[1].offset);
-
-  glBindFramebuffer(GL_FRAMEBUFFER, offAnamorphic[1]->GetFramebuffer());
-  glViewport(0, 0, offAnamorphic[1]->Width(), offAnamorphic[1]->Height());
-  progLensFlare->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offAnamorphic[0]->GetTexutre());
-  glDrawElements(GL_TRIANGLES, renderingData[1].size, GL_UNSIGNED_INT, renderingData[1].offset);
-
-  glEnable(GL_BLEND);
-  glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ONE, GL_ZERO);
-
-  const Shader::ProgramPtr& progEnlarge = shaderMap.find("PostEffect")->second;
-  progEnlarge->UseProgram();
-  glBindFramebuffer(GL_FRAMEBUFFER, offAnamorphic[0]->GetFramebuffer());
-  glViewport(0, 0, offAnamorphic[0]->Width(), offAnamorphic[0]->Height());
-  progEnlarge->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offAnamorphic[1]->GetTexutre());
-  glDrawElements(GL_TRIANGLES, renderingData[1].size, GL_UNSIGNED_INT, renderingData[1].offset);
-  glDrawElements(GL_TRIANGLES, renderingData[2].size, GL_UNSIGNED_INT, renderingData[2].offset);
-  glDrawElements(GL_TRIANGLES, renderingData[3].size, GL_UNSIGNED_INT, renderingData[3].offset);
-
-  for (int i = bloomBufferCount - 1; i > 0; --i) {
-    glBindFramebuffer(GL_FRAMEBUFFER, offBloom[i - 1]->GetFramebuffer());
-    glViewport(0, 0, offBloom[i - 1]->Width(), offBloom[i - 1]->Height());
-    progEnlarge->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offBloom[i]->GetTexutre());
-    glDrawElements(GL_TRIANGLES, renderingData[1].size, GL_UNSIGNED_INT, renderingData[1].offset);
-  }
-
-  glDisable(GL_BLEND);
-
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
-  GLFWEW::Window& window = GLFWEW::Window::Instance();
-  const int windowWidth = window.Width();
-  const int windowHeight = window.Height();
-  glViewport(0, 0, windowWidth, windowHeight);
-  glScissor(0, 0, windowWidth, windowHeight);
-
-  const Shader::ProgramPtr& progComposition = shaderMap.find("Composition")->second;
-  progComposition->UseProgram();
-
-  progComposition->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offscreen->GetTexutre());
-  progComposition->BindTexture(GL_TEXTURE1, GL_TEXTURE_2D, offBloom[0]->GetTexutre());
-  progComposition->BindTexture(GL_TEXTURE2, GL_TEXTURE_2D, offAnamorphic[0]->GetTexutre());
-  glDrawElements(GL_TRIANGLES, renderingData[1].size, GL_UNSIGNED_INT, renderingData[1].offset);
-
-  fontRenderer.Draw();
-
-  {
-    int width, height;
-    glBindTexture(GL_TEXTURE_2D, offBloom[bloomBufferCount - 1]->GetTexutre());
-    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
-    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    if (pboIndexForWriting < 0) {
-      const GLuint pboWrite = pbo[1].Id();
-      glBindBuffer(GL_PIXEL_PACK_BUFFER, pboWrite);
-      glBindFramebuffer(GL_FRAMEBUFFER, offBloom[bloomBufferCount - 1]->GetFramebuffer());
-      glReadPixels(0, 0, width, height, GL_RGBA, GL_FLOAT, 0);
-      glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    } else {
-      const GLuint pboWrite = pbo[pboIndexForWriting].Id();
-      glBindBuffer(GL_PIXEL_PACK_BUFFER, pboWrite);
-      glBindFramebuffer(GL_FRAMEBUFFER, offBloom[bloomBufferCount - 1]->GetFramebuffer());
-      glReadPixels(0, 0, width, height, GL_RGBA, GL_FLOAT, 0);
-      glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-      const GLuint pboRead = pbo[pboIndexForWriting ^ 1].Id();
-      glBindBuffer(GL_PIXEL_PACK_BUFFER, pboRead);
-      const GLfloat* p = static_cast<GLfloat*>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
-      float lum = 0;
-      for (int i = 0; i < width * height; ++i) {
-        lum += p[i * 4 + 3];
-      }
-      luminanceScale = keyValue / std::exp(lum / static_cast<float>(width * height));
-      glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
-      glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-    }
-  }
-
-  glBindVertexArray(0);
-  glUseProgram(0);
-
-  glActiveTexture(GL_TEXTURE2);
-  glBindTexture(GL_TEXTURE_2D, 0);
-  glActiveTexture(GL_TEXTURE1);
-  glBindTexture(GL_TEXTURE_2D, 0);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, 0);
-}
-
-/**
-* Q[s.
-*/
-void GameEngine::Run()
-{
-  GLFWEW::Window& window = GLFWEW::Window::Instance();
-  double prevTime = glfwGetTime();
-  double frames = 0;
-  double fpsTimer = 0;
-  while (!window.ShouldClose()) {
-    const double curTime = glfwGetTime();
-    const double delta = curTime - prevTime;
-    prevTime = curTime;
-    frames += 1;
-    fpsTimer += delta;
-    if (fpsTimer >= 1) {
-      fpsTimer -= 1;
-      fps = frames;
-      frames = 0;
-    }
-    window.UpdateGamePad();
-    Update(delta <= 0.5 ? delta : 1.0 / 60.0);
-    Render();
-    window.SwapBuffers();
-    if (window.GetKey(GLFW_KEY_ESCAPE) == GLFWEW::Window::KeyState::Press) {
-      window.Close();
-    }
-    if (pboIndexForWriting < 0) {
-      pboIndexForWriting = 0;
-    } else {
-      pboIndexForWriting ^= 1;
-    }
-  }
-}
-
-/**
-* Q[pbh̏Ԃ擾.
-*/
-const GamePad& GameEngine::GetGamePad(int id) const
-{
-  return GLFWEW::Window::Instance().GetGamePad(id);
-}
-
-/**
-* eNX`ǂݍ.
-*
-* @param filename eNX`t@C.
-*
-* @retval true  ǂݍݐ.
-* @retval false ǂݍݎs.
-*/
-bool GameEngine::LoadTextureFromFile(const char* filename, GLenum wrapMode)
-{
-  if (GetTexture(filename)) {
-    return true;
-  }
-  TexturePtr texture = Texture::LoadFromFile(filename, wrapMode);
-  if (!texture) {
-    return false;
-  }
-  textureMapStack.back().insert(std::make_pair(std::string(filename), texture));
-  return true;
-}
-
-/*
-* eNX`擾.
-*
-* @param filename eNX`t@C.
-*
-*
-* @return filenameɑΉeNX`IuWFNg.
-*/
-const TexturePtr& GameEngine::GetTexture(const char* filename) const
-{
-  for (const auto& e : textureMapStack) {
-    const auto itr = e.find(filename);
-    if (itr != e.end()) {
-      return itr->second;
-    }
-  }
-  static const TexturePtr dummy;
-  return dummy;
-}
-
-/**
-* bVǂݍ.
-*
-* @param filename bVt@C.
-*
-* @retval true  ǂݍݐ.
-* @retval false ǂݍݎs.
-*/
-bool GameEngine::LoadMeshFromFile(const char* filename)
-{
-  return meshBuffer->LoadMeshFromFile(filename);
-}
-
-/**
-* bV擾.
-*
-* @param name bV.
-*
-* @return nameɑΉ郁bVIuWFNg.
-*/
-const Mesh::MeshPtr& GameEngine::GetMesh(const char* name)
-{
-  return meshBuffer->GetMesh(name);
-}
-
-/**
-* GeBeBǉ.
-*
-* @param groupId  GeBeB̃O[vID.
-* @param position GeBeB̍W.
-* @param meshName GeBeB̕\Ɏgp郁bV.
-* @param texName  GeBeB̕\ɎgeNX`t@C.
-* @param func     GeBeB̏ԂXV֐(܂͊֐IuWFNg).
-* @param shader   GeBeB̕\ɎgVF[_.
-*
-* @return ǉGeBeBւ̃|C^.
-*         ȏGeBeBǉłȂꍇnullptrԂ.
-*         ]g嗦͂̃|C^oRŐݒ肷.
-*         ȂÃ|C^AvP[VŕێKv͂Ȃ.
-*/
-Entity::Entity* GameEngine::AddEntity(int groupId, const glm::vec3& pos, const char* meshName, const char* texName, Entity::Entity::UpdateFuncType func, const char* shader)
-{
-  return AddEntity(groupId, pos, meshName, texName, nullptr, func, shader);
-}
-
-Entity::Entity* GameEngine::AddEntity(int groupId, const glm::vec3& pos, const char* meshName, const char* texName, const char* normalName, Entity::Entity::UpdateFuncType func, const char* shader)
-{
-  decltype(shaderMap)::const_iterator itr = shaderMap.end();
-  if (shader) {
-    itr = shaderMap.find(shader);
-  }
-  if (itr == shaderMap.end()) {
-    itr = shaderMap.find("Tutorial");
-    if (itr == shaderMap.end()) {
-      return nullptr;
-    }
-  }
-  const Mesh::MeshPtr& mesh = meshBuffer->GetMesh(meshName);
-  TexturePtr tex[2];
-  tex[0] = GetTexture(texName);
-  if (normalName) {
-    tex[1] = GetTexture(normalName);
-  } else {
-    tex[1] = GetTexture("Res/Model/Dummy.Normal.bmp");
-  }
-  return entityBuffer->AddEntity(groupId, pos, mesh, tex, itr->second, func);
-}
-
-/**
-*@GeBeB폜.
-*
-* @param 폜GeBeB̃|C^.
-*/
-void GameEngine::RemoveEntity(Entity::Entity* e)
-{
-  entityBuffer->RemoveEntity(e);
-}
-
-/**
-* SẴGeBeB폜.
-*/
-void GameEngine::RemoveAllEntity()
-{
-  entityBuffer->RemoveAllEntity();
-}
-
-/**
-* Cgݒ肷.
-*
-* @param indes  ݒ肷郉Cg̃CfbNX.
-* @param light  Cgp[^.
-*/
-void GameEngine::Light(int index, const Uniform::PointLight& light)
-{
-  if (index < 0 || index >= Uniform::maxLightCount) {
-    std::cerr << "WARNING: '" << index << "'͕sȃCgCfbNXł" << std::endl;
-    return;
-  }
-  lightData.light[index] = light;
-}
-
-/**
-* Cg擾.
-*
-* @param index 擾郉Cg̃CfbNX.
-*
-* @return Cgp[^.
-*/
-const Uniform::PointLight& GameEngine::Light(int index) const
-{
-  if (index < 0 || index >= Uniform::maxLightCount) {
-    std::cerr << "WARNING: '" << index << "'͕sȃCgCfbNXł" << std::endl;
-    static const Uniform::PointLight dummy;
-    return dummy;
-  }
-  return lightData.light[index];
-}
-
-/**
-* ݒ肷.
-*
-* @param color ̖邳.
-*/
-void GameEngine::AmbientLight(const glm::vec4& color)
-{
-  lightData.ambientColor = color;
-}
-
-/**
-* 擾.
-*
-* @return ̖邳.
-*/
-const glm::vec4& GameEngine::AmbientLight() const
-{
-  return lightData.ambientColor;
-}
-
-/**
-* _̈ʒuƎpݒ肷.
-*
-* @param index J̃CfbNX.
-* @param cam   ݒ肷Jf[^.
-*
-* w肳ꂽCfbNX̃JANeBuAԂݒ肷.
-*
-* @sa Camera, ActivateCamera, DeactivateCamera, IsCameraActive
-*/
-void GameEngine::Camera(size_t index, const CameraData& cam)
-{
-  camera[index].camera = cam;
-  camera[index].isActive = true;
-  lightData.eyePos[index] = glm::vec4(cam.position, 0);
-}
-
-/**
-* _̈ʒuƎp擾.
-*
-* @param index J̃CfbNX.
-* @return Jf[^.
-*/
-const GameEngine::CameraData& GameEngine::Camera(size_t index) const
-{
-  return camera[index].camera;
-}
-
-/**
-* SẴJ̏ԂԂɖ߂.
-*/
-void GameEngine::ResetAllCamera()
-{
-  for (auto& c : camera) {
-    c.camera = {};
-    c.isActive = false;
-    c.priority = 0;
-  }
-  camera[0].isActive = true;
-}
-
-/**
-* IuWFNg擾.
-*
-* @return IuWFNg.
-*/
-std::mt19937& GameEngine::Rand()
-{
-  return rand;
-}
-
-/**
-* Փˉnhݒ肷.
-*
-* @param gid0    ՓˑΏۂ̃O[vID.
-* @param gid1    ՓˑΏۂ̃O[vID.
-* @param handler Փˉnh.
-*
-* Փ˂ՓˉnhĂтƂA菬O[vIDGeBeBɓn.
-* Ŏw肵O[vID̏Ƃ͖֌Wł邱Ƃɒӂ邱.
-* ex)
-*   CollisionHandler(10, 1, Func)
-*   ƂR[hŃnho^Ƃ. Փ˂ƁA
-*   Func(O[vID=1̃GeBeBAO[vID=10̃GeBeB)
-*   ̂悤ɌĂяo.
-*/
-void GameEngine::CollisionHandler(int gid0, int gid1, Entity::CollisionHandlerType handler)
-{
-  entityBuffer->CollisionHandler(gid0, gid1, handler);
-}
-
-/**
-* Փˉnh擾.
-*
-* @param gid0 ՓˑΏۂ̃O[vID.
-* @param gid1 ՓˑΏۂ̃O[vID.
-*
-* @return Փˉnh.
-*/
-const Entity::CollisionHandlerType& GameEngine::CollisionHandler(int gid0, int gid1) const
-{
-  return entityBuffer->CollisionHandler(gid0, gid1);
-}
-
-/**
-* Փˉnh̃XgNA.
-*/
-void GameEngine::ClearCollisionHandlerList()
-{
-  entityBuffer->ClearCollisionHandlerList();
-}
-
-/**
-* I[fBI.
-*/
-bool GameEngine::InitAudio(const char* acfPath, const char* acbPath, const char* awbPath, const char* dspBusName)
-{
-  return Audio::Initialize(acfPath, acbPath, awbPath, dspBusName);
-}
-
-/**
-* Đ.
-*/
-void GameEngine::PlayAudio(int playerId, int cueId)
-{
-  Audio::Play(playerId, cueId);
-}
-
-/**
-* ~.
-*/
-void GameEngine::StopAudio(int playerId)
-{
-  Audio::Stop(playerId);
-}
-
-/**
-* \[XX^bNɐV\[Xx쐬.
-*/
-void GameEngine::PushLevel()
-{
-  meshBuffer->PushLevel();
-  textureMapStack.push_back(TextureMap());
-}
-
-/**
-* \[XX^bÑ̖\[Xx.
-*/
-void GameEngine::PopLevel()
-{
-  meshBuffer->PopLevel();
-  if (textureMapStack.size() > minimalStackSize) {
-    textureMapStack.pop_back();
-  }
-}
-
-/**
-* ̃\[Xx̏Ԃɂ.
-*/
-void GameEngine::ClearLevel()
-{
-  meshBuffer->ClearLevel();
-  textureMapStack.back().clear();
+/**
+* @file GameEngine.cpp
+*/
+#include "GameEngine.h"
+#include "GLFWEW.h"
+#include "GLState.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <array>
+#include <algorithm>
+#include <iostream>
+#include <time.h>
+
+#include "Audio.h"
+
+/// 通信対戦中の状態更新の間隔(秒).
+static const double netplayTimeStep = 1.0 / 60.0;
+
+/// 頂点データ型.
+struct Vertex
+{
+  glm::vec3 position; ///< 座標
+  glm::vec4 color; ///< 色
+  glm::vec2 texCoord; ///< テクスチャ座標.
+};
+
+/// 頂点データ.
+const Vertex vertices[] = {
+  { {-0.5f, -0.3f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 0.0f} },
+  { { 0.3f, -0.3f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f} },
+  { { 0.3f,  0.5f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 1.0f, 1.0f} },
+  { {-0.5f,  0.5f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 1.0f} },
+
+  { {-0.3f,  0.3f, 0.1f}, {0.0f, 0.0f, 1.0f, 1.0f}, { 0.0f, 1.0f} },
+  { {-0.3f, -0.5f, 0.1f}, {0.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 0.0f} },
+  { { 0.5f, -0.5f, 0.1f}, {0.0f, 0.0f, 1.0f, 1.0f}, { 1.0f, 0.0f} },
+  { { 0.5f, -0.5f, 0.1f}, {1.0f, 0.0f, 0.0f, 1.0f}, { 1.0f, 0.0f} },
+  { { 0.5f,  0.3f, 0.1f}, {1.0f, 1.0f, 0.0f, 1.0f}, { 1.0f, 1.0f} },
+  { {-0.3f,  0.3f, 0.1f}, {1.0f, 0.0f, 0.0f, 1.0f}, { 0.0f, 1.0f} },
+
+  { {-1.0f,-1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 0.0f} },
+  { { 1.0f,-1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f} },
+  { { 1.0f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 1.0f, 1.0f} },
+  { {-1.0f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 1.0f} },
+
+  { {-1.25f,-1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 0.0f} },
+  { { 0.75f,-1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f} },
+  { { 0.75f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 1.0f, 1.0f} },
+  { {-1.25f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 1.0f} },
+
+  { {-0.75f,-1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 0.0f} },
+  { { 1.25f,-1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f} },
+  { { 1.25f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 1.0f, 1.0f} },
+  { {-0.75f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, { 0.0f, 1.0f} },
+};
+
+/// インデックスデータ.
+const GLuint indices[] = {
+  0, 1, 2, 2, 3, 0,
+  4, 5, 6, 7, 8, 9,
+  10, 11, 12, 12, 13, 10,
+  14, 15, 16, 16, 17, 14,
+  18, 19, 20, 20, 21, 18,
+};
+
+/**
+* インデックス描画範囲.
+*/
+struct RenderingData
+{
+  GLsizei size; ///< 描画するインデックス数.
+  GLvoid* offset; ///< 描画開始インデックスのバイトオフセット.
+};
+
+/**
+* RenderingDataを作成する.
+*
+* @param size 描画するインデックス数.
+* @param offset 描画開始インデックスのオフセット(インデックス単位).
+*
+* @return インデックス描画範囲オブジェクト.
+*/
+constexpr RenderingData MakeRenderingData(GLsizei size, GLsizei offset) {
+  return { size, reinterpret_cast<GLvoid*>(offset * sizeof(GLuint)) };
+}
+
+/**
+* 描画範囲リスト.
+*/
+static const RenderingData renderingData[] = {
+  MakeRenderingData( 3 * 4, 0),
+  MakeRenderingData( 3 * 2, 12),
+  MakeRenderingData( 3 * 2, 18),
+  MakeRenderingData( 3 * 2, 24),
+};
+
+/**
+* Uniform Bufferのバインディング・ポイント.
+*/
+enum BindingPoint {
+  BindingPoint_Vertex,
+  BindingPoint_Light,
+  BindingPoint_PostEffect,
+  BindingPoint_View,
+
+  countof_BindingPoint, ///< 定義したバインディング・ポイントの数.
+};
+
+/**
+* Vertex Buffer Objectを作成する.
+*
+* @param size 頂点データのサイズ.
+* @param data 頂点データへのポインタ.
+*
+* @return 作成したVBOのID.
+*/
+GLuint CreateVBO(GLsizeiptr size, const GLvoid* data)
+{
+  GLuint vbo = 0;
+  glGenBuffers(1, &vbo);
+  GLState::BindBuffer(GL_ARRAY_BUFFER, vbo);
+  glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+  GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+  return vbo;
+}
+
+/**
+* Index Buffer Objectを作成する.
+*
+* @param size インデックスデータのサイズ.
+* @param data インデックスデータへのポインタ.
+*
+* @return 作成したIBO.
+*/
+GLuint CreateIBO(GLsizeiptr size, const GLvoid* data)
+{
+  GLuint ibo = 0;
+  glGenBuffers(1, &ibo);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STREAM_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  return ibo;
+}
+
+/**
+* 頂点アトリビュートを設定する.
+*
+* @param index 頂点アトリビュートのインデックス.
+* @param cls   頂点データ型名.
+* @param mbr   頂点アトリビュートに設定するclsのメンバ変数名.
+*/
+#define SetVertexAttribPointer(index, cls, mbr) \
+  SetVertexAttribPointerI(index, sizeof(cls::mbr) / sizeof(float), sizeof(cls), reinterpret_cast<GLvoid*>(offsetof(cls, mbr)))
+void SetVertexAttribPointerI(GLuint index, GLint size, GLsizei stride, const GLvoid* pointer)
+{
+  glEnableVertexAttribArray(index);
+  glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, stride, pointer);
+}
+
+/**
+* Vertex Array Objectを作成する.
+*
+* @param vbo VAOに関連付けられるVBO.
+* @param ibo VAOに関連付けられるIBO.
+*
+* @return 作成したVAO.
+*/
+GLuint CreateVAO(GLuint vbo, GLuint ibo)
+{
+  GLuint vao = 0;
+  glGenVertexArrays(1, &vao);
+  GLState::BindVertexArray(vao);
+  GLState::BindBuffer(GL_ARRAY_BUFFER, vbo);
+  SetVertexAttribPointer(0, Vertex, position);
+  SetVertexAttribPointer(1, Vertex, color);
+  SetVertexAttribPointer(2, Vertex, texCoord);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+  GLState::BindVertexArray(0);
+  return vao;
+}
+
+/**
+* ゲームエンジンのインスタンスを取得する.
+*
+* @return ゲームエンジンのインスタンス.
+*/
+GameEngine& GameEngine::Instance() {
+  static GameEngine instance;
+  return instance;
+}
+
+/**
+* デストラクタ.
+*/
+GameEngine::~GameEngine()
+{
+  updateFunc = nullptr;
+  if (entityBuffer) {
+    // 初期確保数を決める目安として、同時に存在したエンティティ数の最大値を出力する.
+    std::cout << "Entity: peak=" << entityBuffer->PeakEntityCount() << " capacity=" << entityBuffer->Capacity() << std::endl;
+  }
+  if (particleSystem) {
+    std::cout << "Particle: peak=" << particleSystem->PeakParticleCount() << std::endl;
+  }
+  if (entityBuffer) {
+    std::cout << "Bullet: peak=" << entityBuffer->Bullets().PeakCount() << std::endl;
+    // 更新の分割数を決める目安として、グループごとの処理時間を出力する.
+    for (int i = 0; i <= Entity::maxGroupId; ++i) {
+      const double t = entityBuffer->GroupUpdateTime(i);
+      if (t > 0) {
+        std::cout << "Group" << i << ": update=" << t * 1000.0 << "ms divisor=" << entityBuffer->GroupUpdateDivisor(i) << std::endl;
+      }
+    }
+    // 空間検索の1回あたりのコストを出力する.
+    const Entity::SpatialQueryStatistics stats = entityBuffer->SpatialQueryStats();
+    if (stats.queryCount) {
+      const double n = static_cast<double>(stats.queryCount);
+      std::cout << "SpatialQuery: count=" << stats.queryCount <<
+        " nodes/query=" << stats.visitedNodeCount / n <<
+        " results/query=" << stats.resultCount / n <<
+        " time/query=" << stats.seconds * 1e6 / n << "us" << std::endl;
+    }
+    // スナップショットの保存と復元の1回あたりの時間を出力する.
+    const Entity::SnapshotStatistics& snapshotStats = entityBuffer->SnapshotStats();
+    if (snapshotStats.saveCount) {
+      std::cout << "Snapshot: entities=" << snapshotStats.entityCount <<
+        " save=" << snapshotStats.saveSeconds * 1000.0 / snapshotStats.saveCount << "ms(max " << snapshotStats.maxSaveSeconds * 1000.0 << "ms)";
+      if (snapshotStats.restoreCount) {
+        std::cout << " restore=" << snapshotStats.restoreSeconds * 1000.0 / snapshotStats.restoreCount << "ms(max " << snapshotStats.maxRestoreSeconds * 1000.0 << "ms)";
+      }
+      std::cout << std::endl;
+    }
+  }
+  if (netplay.IsRunning()) {
+    // 再シミュレーションの1フレームあたりの費用を出力する. 相手の入力待ちが多ければ入力遅延を増やす目安にする.
+    const Netplay::Statistics& stats = netplay.Stats();
+    std::cout << "Netplay: frames=" << stats.frameCount << " stall=" << stats.stallCount <<
+      " rollback=" << stats.rollbackCount << " failed=" << stats.failedRollbackCount;
+    if (stats.rollbackCount) {
+      std::cout << " frames/rollback=" << static_cast<double>(stats.resimulatedFrameCount) / static_cast<double>(stats.rollbackCount) <<
+        "(max " << stats.maxRollbackFrames << ")" <<
+        " resimulate=" << stats.resimulateSeconds * 1000.0 / static_cast<double>(stats.rollbackCount) << "ms(max " << stats.maxResimulateSeconds * 1000.0 << "ms)";
+    }
+    std::cout << " sent=" << stats.sentPacketCount << " received=" << stats.receivedPacketCount << std::endl;
+    netplay.Stop();
+  }
+  if (streamBuffer) {
+    // フェンス待ちが多ければセグメント数を、拡張が起きていれば初期サイズを増やす目安にする.
+    const StreamBuffer::Statistics& stats = streamBuffer->Stats();
+    std::cout << "StreamBuffer: stall=" << stats.stallCount << " orphan=" << stats.orphanCount <<
+      " grow=" << stats.growCount << " peak=" << stats.peakUsage << "/" << streamBuffer->SegmentSize() << std::endl;
+  }
+  Audio::Destroy();
+  if (vao) {
+    GLState::DeleteVertexArray(vao);
+  }
+  if (ibo) {
+    GLState::DeleteBuffer(ibo);
+  }
+  if (vbo) {
+    GLState::DeleteBuffer(vbo);
+  }
+}
+
+/**
+* 状態更新関数を設定する.
+*
+* @param func 設定する更新関数.
+*/
+void GameEngine::UpdateFunc(const UpdateFuncType& func)
+{
+  updateFunc = func;
+}
+
+/**
+* 状態更新関数を取得する.
+*
+* @return 設定されている更新関数.
+*/
+const GameEngine::UpdateFuncType& GameEngine::UpdateFunc() const
+{
+  return updateFunc;
+}
+
+/**
+* ゲームエンジンを初期化する.
+*
+* @param w     ウィンドウの描画範囲の幅(ピクセル).
+* @param h     ウィンドウの描画範囲の高さ(ピクセル).
+* @param title ウィンドウタイトル(UTF-8の0終端文字列).
+*
+* @retval true  初期化成功.
+* @retval false 初期化失敗.
+*
+* Update, Render関数などを呼び出す前に、一度だけ呼び出しておく必要がある.
+* 一度初期化に成功すると、以後の呼び出しではなにもせずにtrueを返す.
+*/
+bool GameEngine::Init(int w, int h, const char* title)
+{
+  if (isInitialized) {
+    return true;
+  }
+  if (!GLFWEW::Window::Instance().Init(w, h, title)) {
+    return false;
+  }
+  GLState::Invalidate();
+  vbo = CreateVBO(sizeof(vertices), vertices);
+  ibo = CreateIBO(sizeof(indices), indices);
+  vao = CreateVAO(vbo, ibo);
+
+  uboLight = UniformBuffer::Create(sizeof(Uniform::LightingData), BindingPoint_Light, "LightingData");
+  uboPostEffect = UniformBuffer::Create(sizeof(Uniform::PostEffectData), BindingPoint_PostEffect, "PostEffectData");
+  uboView = UniformBuffer::Create(sizeof(Uniform::ViewData), BindingPoint_View, "ViewData");
+  streamBuffer = StreamBuffer::Create(4 * 1024 * 1024);
+  if (!vbo || !ibo || !vao || !uboLight || !uboPostEffect || !uboView || !streamBuffer) {
+    return false;
+  }
+
+  static const char* const shaderNameList[][3] = {
+    { "Tutorial", "Res/Tutorial.vert", "Res/Tutorial.frag" },
+    { "PostEffect", "Res/PostEffect.vert", "Res/PostEffect.frag" },
+    { "Bloom", "Res/Bloom1st.vert", "Res/Bloom1st.frag" },
+    { "Composition", "Res/FinalComposition.vert", "Res/FinalComposition.frag" },
+    { "Simple", "Res/Simple.vert", "Res/Simple.frag" },
+    { "LensFlare", "Res/AnamorphicLensFlare.vert", "Res/AnamorphicLensFlare.frag" },
+    { "NonLighting", "Res/NonLighting.vert", "Res/NonLighting.frag" },
+    { "RenderDepth", "Res/RenderDepth.vert", "Res/RenderDepth.frag" },
+    { "TutorialInstanced", "Res/TutorialInstanced.vert", "Res/Tutorial.frag" },
+    { "RenderDepthInstanced", "Res/RenderDepthInstanced.vert", "Res/RenderDepth.frag" },
+    { "Particle", "Res/Particle.vert", "Res/NonLighting.frag" },
+  };
+  shaderMap.reserve(sizeof(shaderNameList) / sizeof(shaderNameList[0]));
+  for (auto& e : shaderNameList) {
+    Shader::ProgramPtr program = Shader::Program::Create(e[1], e[2]);
+    if (!program) {
+      return false;
+    }
+    shaderMap.insert(std::make_pair(std::string(e[0]), program));
+  }
+
+  // エンティティごとのデータを詰めて格納するシェーダを読み込む.
+  // シェーダ・ストレージ・バッファが使えなければテクスチャバッファを使う.
+  const bool hasStorageBuffer = GLEW_VERSION_4_3 || GLEW_ARB_shader_storage_buffer_object;
+  static const char* const packedShaderNameList[2][2] = {
+    { "Res/TutorialPacked.vert", "Res/RenderDepthPacked.vert" },
+    { "Res/TutorialPackedSsbo.vert", "Res/RenderDepthPackedSsbo.vert" },
+  };
+  const char* const* packedShaderName = packedShaderNameList[hasStorageBuffer ? 1 : 0];
+  shaderMap["TutorialPacked"] = Shader::Program::Create(packedShaderName[0], "Res/Tutorial.frag");
+  shaderMap["RenderDepthPacked"] = Shader::Program::Create(packedShaderName[1], "Res/RenderDepth.frag");
+  if (!shaderMap["TutorialPacked"] || !shaderMap["RenderDepthPacked"]) {
+    return false;
+  }
+
+  shaderMap["Tutorial"]->UniformBlockBinding("VertexData", BindingPoint_Vertex);
+  shaderMap["Tutorial"]->UniformBlockBinding("LightingData", BindingPoint_Light);
+  shaderMap["TutorialInstanced"]->UniformBlockBinding("VertexData", BindingPoint_Vertex);
+  shaderMap["TutorialInstanced"]->UniformBlockBinding("LightingData", BindingPoint_Light);
+  shaderMap["RenderDepthInstanced"]->UniformBlockBinding("VertexData", BindingPoint_Vertex);
+  shaderMap["Tutorial"]->UniformBlockBinding("ViewData", BindingPoint_View);
+  shaderMap["TutorialInstanced"]->UniformBlockBinding("ViewData", BindingPoint_View);
+  shaderMap["NonLighting"]->UniformBlockBinding("ViewData", BindingPoint_View);
+  shaderMap["RenderDepth"]->UniformBlockBinding("ViewData", BindingPoint_View);
+  shaderMap["RenderDepthInstanced"]->UniformBlockBinding("ViewData", BindingPoint_View);
+  shaderMap["TutorialPacked"]->UniformBlockBinding("LightingData", BindingPoint_Light);
+  shaderMap["TutorialPacked"]->UniformBlockBinding("ViewData", BindingPoint_View);
+  shaderMap["RenderDepthPacked"]->UniformBlockBinding("ViewData", BindingPoint_View);
+  shaderMap["Particle"]->UniformBlockBinding("ViewData", BindingPoint_View);
+  shaderMap["Composition"]->UniformBlockBinding("PostEffectData", BindingPoint_PostEffect);
+  shaderMap["Bloom"]->UniformBlockBinding("PostEffectData", BindingPoint_PostEffect);
+
+  meshBuffer = Mesh::Buffer::Create(60 * 1024, 60 * 1024);
+  if (!meshBuffer) {
+    return false;
+  }
+  textureMapStack.push_back(TextureMap());
+
+  entityBuffer = Entity::Buffer::Create(1024, sizeof(Uniform::VertexData), BindingPoint_Vertex, "VertexData");
+  if (!entityBuffer) {
+    return false;
+  }
+  entityBuffer->InstancedProgram(shaderMap["Tutorial"], shaderMap["TutorialInstanced"]);
+  entityBuffer->PackedProgram(shaderMap["Tutorial"], shaderMap["TutorialPacked"]);
+  entityBuffer->DepthProgram(shaderMap["RenderDepth"], shaderMap["RenderDepthInstanced"], shaderMap["RenderDepthPacked"]);
+  entityBuffer->StreamingBuffer(streamBuffer);
+  entityBuffer->InstanceStore(hasStorageBuffer ? Entity::InstanceStoreType::StorageBuffer : Entity::InstanceStoreType::TextureBuffer);
+
+  particleSystem = Particle::System::Create(streamBuffer, shaderMap["Particle"]);
+  if (!particleSystem) {
+    return false;
+  }
+
+  static const uint32_t textureData[] = {
+    0xffffffff, 0xffcccccc, 0xffffffff, 0xffcccccc, 0xffffffff,
+    0xff888888, 0xffffffff, 0xff888888, 0xffffffff, 0xff888888,
+    0xffffffff, 0xff444444, 0xffffffff, 0xff444444, 0xffffffff,
+    0xff000000, 0xffffffff, 0xff000000, 0xffffffff, 0xff000000,
+    0xffffffff, 0xff000000, 0xffffffff, 0xff000000, 0xffffffff,
+  };
+  //  TexturePtr tex = Texture::Create(5, 5, GL_RGBA8, GL_RGBA, textureData);
+
+  rand.seed(std::random_device()());
+
+  offscreen = OffscreenBuffer::Create(800, 600,  GL_RGBA16F);
+  for (int i = 0, scale = 4; i < bloomBufferCount; ++i, scale *= 4) {
+    const int w = (800 + scale - 1) / scale;
+    const int h = (600 + scale - 1) / scale;
+    offBloom[i] = OffscreenBuffer::Create(w, h, GL_RGBA16F);
+    if (!offBloom) {
+      return false;
+    }
+  }
+  offAnamorphic[0] = OffscreenBuffer::Create(800 / 16, 600 / 2, GL_RGBA8);
+  offAnamorphic[1] = OffscreenBuffer::Create(800 / 64, 600 / 2, GL_RGBA8);
+  if (!offscreen || !offAnamorphic[0] || !offAnamorphic[1]) {
+    return false;
+  }
+
+  {
+    int width, height;
+    GLState::EditTexture(GL_TEXTURE_2D, offBloom[bloomBufferCount - 1]->GetTexutre());
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+    GLState::EditTexture(GL_TEXTURE_2D, 0);
+    for (auto& e : pbo) {
+      e.Init(GL_PIXEL_PACK_BUFFER, width * height * sizeof(GLfloat) * 4, nullptr, GL_DYNAMIC_READ);
+    }
+  }
+
+  offDepth = OffscreenBuffer::Create(2048, 2048, GL_DEPTH_COMPONENT16);
+  if (!offDepth) {
+    return false;
+  }
+
+  fontRenderer.Init(1024, glm::vec2(800, 600), streamBuffer);
+
+  camera[0].isActive = true;
+
+  isInitialized = true;
+  return true;
+}
+
+/**
+* ゲームの状態を更新し、描画の準備をする.
+*
+* @param delta 前回の更新からの経過時間(秒). 通信対戦中は使われず、固定時間で更新する.
+*/
+void GameEngine::Update(double delta)
+{
+  Audio::Update();
+  streamBuffer->BeginFrame();
+  fontRenderer.MapBuffer();
+  if (netplay.IsRunning()) {
+    delta = netplayTimeStep;
+    UpdateNetplay();
+  } else {
+    Simulate(delta);
+  }
+  fontRenderer.UnmapBuffer();
+  const GLFWEW::Window& window = GLFWEW::Window::Instance();
+  const glm::mat4x4 matProj = glm::perspective(glm::radians(45.0f), static_cast<float>(window.Width()) / static_cast<float>(window.Height()), 1.0f, 1000.0f);
+  glm::mat4x4 matView[Uniform::maxViewCount];
+  for (int i = 0; i < Uniform::maxViewCount; ++i) {
+    if (!camera[i].isActive) {
+      continue;
+    }
+    const CameraData& cam = camera[i].camera;
+    matView[i] = glm::lookAt(cam.position, cam.target, cam.up);
+    viewData.matVP[i] = matProj * matView[i];
+    // ビュー行列の回転部分は直交行列なので、行がワールド座標系でのカメラの軸になる.
+    viewData.cameraRight[i] = glm::vec4(matView[i][0][0], matView[i][1][0], matView[i][2][0], 0);
+    viewData.cameraUp[i] = glm::vec4(matView[i][0][1], matView[i][1][1], matView[i][2][1], 0);
+  }
+  const glm::vec2 range = shadowParameter.range * 0.5f;
+  glm::mat4 depthProjectionMatrix = glm::ortho<float>(-range.x, range.x, -range.y, range.y, shadowParameter.near, shadowParameter.far);
+  glm::mat4 depthViewMatrix = glm::lookAt(shadowParameter.lightPos, shadowParameter.lightPos + shadowParameter.lightDir, shadowParameter.lightUp);
+  glm::mat4 depthMVP = depthProjectionMatrix * depthViewMatrix;
+  viewData.matDepthVP = depthMVP;
+
+  entityBuffer->PrepareDraw(matView, matProj, depthMVP);
+  particleSystem->Update(delta);
+}
+
+/**
+* ゲームの状態を更新する. 描画の準備は行わない.
+*
+* @param delta 前回の更新からの経過時間(秒).
+*/
+void GameEngine::Simulate(double delta)
+{
+  if (updateFunc) {
+    updateFunc(delta);
+  }
+  entityBuffer->Update(delta);
+}
+
+struct GameEngine::RenderingContext
+{
+  std::array<int, Uniform::maxViewCount> cameraIndices;
+};
+
+/**
+* 優先順でソートされたカメラインデックス配列を作成する.
+*/
+void GameEngine::InitRenderingContext(RenderingContext& context) const
+{
+  for (int i = 0; i < Uniform::maxViewCount; ++i) {
+    context.cameraIndices[i] = i;
+  }
+  std::stable_sort(context.cameraIndices.begin(), context.cameraIndices.end(), [&](int lhs, int rhs) {
+    return camera[lhs].priority > camera[rhs].priority;
+  });
+}
+
+/**
+* 影を描画する.
+*/
+void GameEngine::RenderShadow(RenderingContext& context) const
+{
+  GLState::BindFramebuffer(offDepth->GetFramebuffer());
+  GLState::Enable(GL_DEPTH_TEST);
+  GLState::DepthFunc(GL_LESS);
+  GLState::Enable(GL_CULL_FACE);
+  GLState::Disable(GL_BLEND);
+  GLState::Viewport(0, 0, offDepth->Width(), offDepth->Height());
+  GLState::Scissor(0, 0, offDepth->Width(), offDepth->Height());
+  glClearDepth(1);
+  glClear(GL_DEPTH_BUFFER_BIT);
+
+  for (int index : context.cameraIndices) {
+    if (camera[index].isActive) {
+      entityBuffer->DrawDepth(index, meshBuffer);
+    }
+  }
+}
+
+/**
+* 毎フレーム変わるUniformデータを転送する.
+*
+* @param ubo  データを使うUBO. このUBOのバインディング・ポイントに割り当てる.
+* @param data 転送するデータへのポインタ.
+* @param size 転送するバイト数.
+*
+* ストリーミングバッファから確保した領域に書き込み、その範囲をバインディング・ポイントに割り当てる.
+* 空きが足りなければuboに転送して、ubo全体を割り当て直す.
+*/
+void GameEngine::UploadUniform(const UniformBufferPtr& ubo, const void* data, GLsizeiptr size) const
+{
+  const StreamBuffer::Allocation a = streamBuffer->AllocateUniform(size);
+  if (a) {
+    memcpy(a.pointer, data, size);
+    streamBuffer->Commit();
+    GLState::BindBufferRange(GL_UNIFORM_BUFFER, ubo->BindingPoint(), streamBuffer->Id(), a.offset, size);
+    return;
+  }
+  ubo->BufferSubData(data, 0, size);
+  ubo->BindBufferRange(0, ubo->Size());
+}
+
+/**
+* ゲームの状態を描画する.
+*/
+void GameEngine::Render() const
+{
+  RenderingContext context;
+  InitRenderingContext(context);
+
+  UploadUniform(uboView, &viewData, sizeof(viewData));
+  RenderShadow(context);
+
+  GLState::BindFramebuffer(offscreen->GetFramebuffer());
+  GLState::Enable(GL_DEPTH_TEST);
+  GLState::DepthFunc(GL_LEQUAL);
+  GLState::Enable(GL_CULL_FACE);
+  GLState::Viewport(0, 0, offscreen->Width(), offscreen->Height());
+  GLState::Scissor(0, 0, offscreen->Width(), offscreen->Height());
+  glClearColor(0.1f, 0.3f, 0.5f, 1.0f);
+  glClearDepth(1);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  GLState::Enable(GL_BLEND);
+  GLState::BlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ZERO);
+
+  shaderMap.find("Tutorial")->second->BindShadowTexture(GL_TEXTURE_2D, offDepth->GetTexutre());
+  UploadUniform(uboLight, &lightData, sizeof(lightData));
+  for (int index : context.cameraIndices) {
+    if (camera[index].isActive) {
+      entityBuffer->Draw(index, meshBuffer);
+    }
+  }
+  // パーティクルは半透明なので、全てのビューのエンティティを描画した後に描画する.
+  for (int index : context.cameraIndices) {
+    if (camera[index].isActive) {
+      particleSystem->Draw(index);
+    }
+  }
+  GLState::BindTexture(GL_TEXTURE2, GL_TEXTURE_2D, 0);
+
+  GLState::BindVertexArray(vao);
+
+#if 0
+  GLState::BindFramebuffer(0);
+  glClearColor(0.5f, 0.3f, 0.1f, 1.0f);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  progTutorial->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offscreen->GetTexutre());
+
+  VertexData transData;
+  uboTrans->BufferSubData(&transData);
+
+  LightingData lightData;
+  lightData.ambientColor = glm::vec4(1);
+  uboLight->BufferSubData(&lightData);
+#endif
+
+  GLState::Disable(GL_DEPTH_TEST);
+  GLState::DepthFunc(GL_LESS);
+  GLState::Disable(GL_CULL_FACE);
+  GLState::Disable(GL_BLEND);
+
+  Uniform::PostEffectData postEffect;
+#if 0
+  postEffect.matColor[0] = glm::vec4(0.393f, 0.349f, 0.272f, 0);
+  postEffect.matColor[1] = glm::vec4(0.769f, 0.686f, 0.534f, 0);
+  postEffect.matColor[2] = glm::vec4(0.189f, 0.168f, 0.131f, 0);
+  postEffect.matColor[3] = glm::vec4(0, 0, 0, 1);
+#elif 0
+  static float x = 1, xx = -0.01f;
+  postEffect.matColor[0] = glm::vec4(x, 0, 0, 0);
+  postEffect.matColor[1] = glm::vec4(0, x, 0, 0);
+  postEffect.matColor[2] = glm::vec4(0, 0, x, 0);
+  postEffect.matColor[3] = glm::vec4(0, 0, 0, 1);
+  x += xx;
+  if (x < -1.0f) {
+    xx = 0.01f;
+  } else if (x >= 1.0f) {
+    xx = -0.01f;
+  }
+#endif
+  postEffect.lumScale = luminanceScale;
+  postEffect.bloomThreshould = 1.0f / luminanceScale;
+  UploadUniform(uboPostEffect, &postEffect, sizeof(postEffect));
+
+  const Shader::ProgramPtr& progBloom = shaderMap.find("Bloom")->second;
+  progBloom->UseProgram();
+  GLState::BindFramebuffer(offBloom[0]->GetFramebuffer());
+  GLState::Viewport(0, 0, offBloom[0]->Width(), offBloom[0]->Height());
+  progBloom->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offscreen->GetTexutre());
+  glDrawElements(GL_TRIANGLES, renderingData[1].size, GL_UNSIGNED_INT, renderingData[1].offset);
+
+  const Shader::ProgramPtr& progShrink = shaderMap.find("Simple")->second;
+  progShrink->UseProgram();
+  for (int i = 1; i < bloomBufferCount; ++i) {
+    GLState::BindFramebuffer(offBloom[i]->GetFramebuffer());
+    GLState::Viewport(0, 0, offBloom[i]->Width(), offBloom[i]->Height());
+    progShrink->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offBloom[i - 1]->GetTexutre());
+    glDrawElements(GL_TRIANGLES, renderingData[1].size, GL_UNSIGNED_INT, renderingData[1].offset);
+  }
+
+  const Shader::ProgramPtr& progLensFlare = shaderMap.find("LensFlare")->second;
+  progLensFlare->UseProgram();
+  GLState::BindFramebuffer(offAnamorphic[0]->GetFramebuffer());
+  GLState::Viewport(0, 0, offAnamorphic[0]->Width(), offAnamorphic[0]->Height());
+  progLensFlare->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offBloom[0]->GetTexutre());
+  glDrawElements(GL_TRIANGLES, renderingData[1].size, GL_UNSIGNED_INT, renderingData[1].offset);
+
+  GLState::BindFramebuffer(offAnamorphic[1]->GetFramebuffer());
+  GLState::Viewport(0, 0, offAnamorphic[1]->Width(), offAnamorphic[1]->Height());
+  progLensFlare->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offAnamorphic[0]->GetTexutre());
+  glDrawElements(GL_TRIANGLES, renderingData[1].size, GL_UNSIGNED_INT, renderingData[1].offset);
+
+  GLState::Enable(GL_BLEND);
+  GLState::BlendFuncSeparate(GL_ONE, GL_ONE, GL_ONE, GL_ZERO);
+
+  const Shader::ProgramPtr& progEnlarge = shaderMap.find("PostEffect")->second;
+  progEnlarge->UseProgram();
+  GLState::BindFramebuffer(offAnamorphic[0]->GetFramebuffer());
+  GLState::Viewport(0, 0, offAnamorphic[0]->Width(), offAnamorphic[0]->Height());
+  progEnlarge->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offAnamorphic[1]->GetTexutre());
+  glDrawElements(GL_TRIANGLES, renderingData[1].size, GL_UNSIGNED_INT, renderingData[1].offset);
+  glDrawElements(GL_TRIANGLES, renderingData[2].size, GL_UNSIGNED_INT, renderingData[2].offset);
+  glDrawElements(GL_TRIANGLES, renderingData[3].size, GL_UNSIGNED_INT, renderingData[3].offset);
+
+  for (int i = bloomBufferCount - 1; i > 0; --i) {
+    GLState::BindFramebuffer(offBloom[i - 1]->GetFramebuffer());
+    GLState::Viewport(0, 0, offBloom[i - 1]->Width(), offBloom[i - 1]->Height());
+    progEnlarge->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offBloom[i]->GetTexutre());
+    glDrawElements(GL_TRIANGLES, renderingData[1].size, GL_UNSIGNED_INT, renderingData[1].offset);
+  }
+
+  GLState::Disable(GL_BLEND);
+
+  GLState::BindFramebuffer(0);
+  GLFWEW::Window& window = GLFWEW::Window::Instance();
+  const int windowWidth = window.Width();
+  const int windowHeight = window.Height();
+  GLState::Viewport(0, 0, windowWidth, windowHeight);
+  GLState::Scissor(0, 0, windowWidth, windowHeight);
+
+  const Shader::ProgramPtr& progComposition = shaderMap.find("Composition")->second;
+  progComposition->UseProgram();
+
+  progComposition->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offscreen->GetTexutre());
+  progComposition->BindTexture(GL_TEXTURE1, GL_TEXTURE_2D, offBloom[0]->GetTexutre());
+  progComposition->BindTexture(GL_TEXTURE2, GL_TEXTURE_2D, offAnamorphic[0]->GetTexutre());
+  glDrawElements(GL_TRIANGLES, renderingData[1].size, GL_UNSIGNED_INT, renderingData[1].offset);
+
+  fontRenderer.Draw();
+
+  {
+    int width, height;
+    GLState::EditTexture(GL_TEXTURE_2D, offBloom[bloomBufferCount - 1]->GetTexutre());
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+    GLState::EditTexture(GL_TEXTURE_2D, 0);
+
+    if (pboIndexForWriting < 0) {
+      const GLuint pboWrite = pbo[1].Id();
+      GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, pboWrite);
+      GLState::BindFramebuffer(offBloom[bloomBufferCount - 1]->GetFramebuffer());
+      glReadPixels(0, 0, width, height, GL_RGBA, GL_FLOAT, 0);
+      GLState::BindFramebuffer(0);
+    } else {
+      const GLuint pboWrite = pbo[pboIndexForWriting].Id();
+      GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, pboWrite);
+      GLState::BindFramebuffer(offBloom[bloomBufferCount - 1]->GetFramebuffer());
+      glReadPixels(0, 0, width, height, GL_RGBA, GL_FLOAT, 0);
+      GLState::BindFramebuffer(0);
+
+      const GLuint pboRead = pbo[pboIndexForWriting ^ 1].Id();
+      GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, pboRead);
+      const GLfloat* p = static_cast<GLfloat*>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+      float lum = 0;
+      for (int i = 0; i < width * height; ++i) {
+        lum += p[i * 4 + 3];
+      }
+      luminanceScale = keyValue / std::exp(lum / static_cast<float>(width * height));
+      glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+      GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+  }
+
+  // VAOをバインドしたままだと、メッシュの追加時にIBOのバインドがVAOに記録されてしまう.
+  // プログラムとテクスチャはGLStateが記録しているので、ここで解除する必要はない.
+  GLState::BindVertexArray(0);
+}
+
+/**
+* ゲームを実行する.
+*/
+void GameEngine::Run()
+{
+  GLFWEW::Window& window = GLFWEW::Window::Instance();
+  double prevTime = glfwGetTime();
+  double frames = 0;
+  double fpsTimer = 0;
+  while (!window.ShouldClose()) {
+    const double curTime = glfwGetTime();
+    const double delta = curTime - prevTime;
+    prevTime = curTime;
+    frames += 1;
+    fpsTimer += delta;
+    if (fpsTimer >= 1) {
+      fpsTimer -= 1;
+      fps = frames;
+      frames = 0;
+      if (isDrawStatsOutput) {
+        std::cout << "DrawStats: fps=" << fps << " entities=" << VisibleEntityCount() << "/" << SubmittedEntityCount() <<
+          " drawCalls=" << DrawCallCount() << " withoutInstancing=" << DrawCallCountWithoutInstancing() <<
+          " instancing=" << (InstancedDraw() ? "on" : "off") << std::endl;
+      }
+    }
+    window.UpdateGamePad();
+    Update(delta <= 0.5 ? delta : 1.0 / 60.0);
+    Render();
+    streamBuffer->EndFrame();
+    GLState::EndFrame();
+    window.SwapBuffers();
+    if (window.GetKey(GLFW_KEY_ESCAPE) == GLFWEW::Window::KeyState::Press) {
+      window.Close();
+    }
+    if (pboIndexForWriting < 0) {
+      pboIndexForWriting = 0;
+    } else {
+      pboIndexForWriting ^= 1;
+    }
+  }
+}
+
+/**
+* ゲームパッドの状態を取得する.
+*
+* 通信対戦中はプレイヤー番号idの、シミュレーション中のフレームの入力を返す.
+*/
+const GamePad& GameEngine::GetGamePad(int id) const
+{
+  if (netplay.IsRunning() && id >= 0 && id < Netplay::maxPlayerCount) {
+    return netplayGamePad[id];
+  }
+  return GLFWEW::Window::Instance().GetGamePad(id);
+}
+
+/**
+* 通信対戦を開始する.
+*
+* @param transport   相手との通信に使うTransport.
+* @param localPlayer ローカルのプレイヤーの番号. GetGamePad(localPlayer)でゲームパッド0の入力が得られる.
+* @param inputDelay  入力遅延のフレーム数.
+* @param seed        乱数の種. 全てのプレイヤーで同じ値を指定すること.
+*
+* @retval true  開始成功.
+* @retval false 開始失敗.
+*
+* 全てのプレイヤーが同じ状態から開始すること.
+* 通信対戦中は状態を1/60秒の固定時間で更新し、同じ入力からは同じ結果が得られるようにする.
+* 毎フレームの開始時にエンティティ・ユーザー変数・乱数・状態更新関数・カメラ・ライトを保存し、
+* 相手の入力の予測が外れたら、保存した状態に戻して再シミュレーションする.
+* グループの設定と読み込んだリソースは保存されないため、アーキタイプや弾の種類を登録し直したフレームより前には戻れない.
+*/
+bool GameEngine::StartNetplay(const Netplay::TransportPtr& transport, int localPlayer, int inputDelay, uint32_t seed)
+{
+  if (!netplay.Start(transport, localPlayer, inputDelay)) {
+    return false;
+  }
+  rand.seed(seed);
+  for (FrameState& e : frameStateList) {
+    e.frame = ~0U;
+  }
+  for (GamePad& e : netplayGamePad) {
+    e = GamePad();
+  }
+  return true;
+}
+
+/**
+* 通信対戦中のゲームの状態を1フレーム進める.
+*
+* 相手の入力の予測が外れていれば、保存した状態に戻して現在のフレームの直前まで再シミュレーションしてから進める.
+* 再シミュレーション中は音声の再生・パーティクルの放出・文字列の追加を行わない.
+* 相手の入力が遅れている場合はフレームを進めない.
+*/
+void GameEngine::UpdateNetplay()
+{
+  if (!netplay.BeginFrame(GLFWEW::Window::Instance().GetGamePad(0).buttons)) {
+    return;
+  }
+  const uint32_t frame = netplay.Frame();
+  int rollbackFrames = 0;
+  double rollbackSeconds = 0;
+  if (netplay.IsRollbackNeeded()) {
+    const double startTime = glfwGetTime();
+    const uint32_t firstFrame = netplay.RollbackFrame();
+    if (LoadFrameState(firstFrame)) {
+      isSilentUpdate = true;
+      for (uint32_t i = firstFrame; i < frame; ++i) {
+        SimulateNetplayFrame(i);
+        SaveFrameState(i + 1);
+      }
+      isSilentUpdate = false;
+      rollbackFrames = static_cast<int>(frame - firstFrame);
+    } else {
+      std::cerr << "WARNING in GameEngine::UpdateNetplay: フレーム" << firstFrame << "の状態を復元できません. 予測した入力のまま進めます." << std::endl;
+      netplay.RecordFailedRollback();
+    }
+    rollbackSeconds = glfwGetTime() - startTime;
+  }
+  netplay.RecordRollback(rollbackFrames, rollbackSeconds);
+  if (!rollbackFrames) {
+    SaveFrameState(frame);
+  }
+  SimulateNetplayFrame(frame);
+  netplay.EndFrame();
+}
+
+/**
+* 通信対戦中のゲームの状態を、指定したフレームの入力で1フレーム更新する.
+*
+* @param frame 更新するフレーム.
+*/
+void GameEngine::SimulateNetplayFrame(uint32_t frame)
+{
+  netplay.GamePads(frame, netplayGamePad);
+  Simulate(netplayTimeStep);
+}
+
+/**
+* フレーム開始時のゲームの状態を保存する.
+*
+* @param frame 保存するフレーム.
+*/
+void GameEngine::SaveFrameState(uint32_t frame)
+{
+  FrameState& state = frameStateList[frame % frameStateCount];
+  if (!state.entities.Save(*entityBuffer)) {
+    state.frame = ~0U;
+    return;
+  }
+  state.frame = frame;
+  state.userNumbers = userNumbers;
+  state.rand = rand;
+  state.updateFunc = updateFunc;
+  std::copy(std::begin(camera), std::end(camera), state.camera);
+  state.lightData = lightData;
+  state.keyValue = keyValue;
+  state.shadowParameter = shadowParameter;
+}
+
+/**
+* 保存したフレーム開始時のゲームの状態を復元する.
+*
+* @param frame 復元するフレーム.
+*
+* @retval true  復元成功.
+* @retval false 状態が保存されていないか、エンティティの状態を復元できない.
+*/
+bool GameEngine::LoadFrameState(uint32_t frame)
+{
+  const FrameState& state = frameStateList[frame % frameStateCount];
+  if (state.frame != frame || !state.entities.Restore(*entityBuffer)) {
+    return false;
+  }
+  userNumbers = state.userNumbers;
+  rand = state.rand;
+  updateFunc = state.updateFunc;
+  std::copy(std::begin(state.camera), std::end(state.camera), camera);
+  lightData = state.lightData;
+  keyValue = state.keyValue;
+  shadowParameter = state.shadowParameter;
+  return true;
+}
+
+/**
+* テクスチャを読み込む.
+*
+* @param filename テクスチャファイル名.
+*
+* @retval true  読み込み成功.
+* @retval false 読み込み失敗.
+*/
+bool GameEngine::LoadTextureFromFile(const char* filename, GLenum wrapMode)
+{
+  if (GetTexture(filename)) {
+    return true;
+  }
+  TexturePtr texture = Texture::LoadFromFile(filename, wrapMode);
+  if (!texture) {
+    return false;
+  }
+  textureMapStack.back().insert(std::make_pair(std::string(filename), texture));
+  return true;
+}
+
+/*
+* テクスチャを取得する.
+*
+* @param filename テクスチャファイル名.
+*
+*
+* @return filenameに対応するテクスチャオブジェクト.
+*/
+const TexturePtr& GameEngine::GetTexture(const char* filename) const
+{
+  for (const auto& e : textureMapStack) {
+    const auto itr = e.find(filename);
+    if (itr != e.end()) {
+      return itr->second;
+    }
+  }
+  static const TexturePtr dummy;
+  return dummy;
+}
+
+/**
+* メッシュを読み込む.
+*
+* @param filename メッシュファイル名.
+*
+* @retval true  読み込み成功.
+* @retval false 読み込み失敗.
+*/
+bool GameEngine::LoadMeshFromFile(const char* filename)
+{
+  return meshBuffer->LoadMeshFromFile(filename);
+}
+
+/**
+* メッシュを取得する.
+*
+* @param name メッシュ名.
+*
+* @return nameに対応するメッシュオブジェクト.
+*/
+const Mesh::MeshPtr& GameEngine::GetMesh(const char* name)
+{
+  return meshBuffer->GetMesh(name);
+}
+
+/**
+* エンティティを追加する.
+*
+* @param groupId  エンティティのグループID.
+* @param position エンティティの座標.
+* @param meshName エンティティの表示に使用するメッシュ名.
+* @param texName  エンティティの表示に使うテクスチャファイル名.
+* @param func     エンティティの状態を更新する関数(または関数オブジェクト).
+* @param shader   エンティティの表示に使うシェーダ名.
+*
+* @return 追加したエンティティへのポインタ.
+*         これ以上エンティティを追加できない場合はnullptrが返される.
+*         回転や拡大率はこのポインタ経由で設定する.
+*         なお、このポインタをアプリケーション側で保持する必要はない.
+*/
+Entity::Entity* GameEngine::AddEntity(int groupId, const glm::vec3& pos, const char* meshName, const char* texName, Entity::Entity::UpdateFuncType func, const char* shader)
+{
+  return AddEntity(groupId, pos, meshName, texName, nullptr, std::move(func), shader);
+}
+
+Entity::Entity* GameEngine::AddEntity(int groupId, const glm::vec3& pos, const char* meshName, const char* texName, const char* normalName, Entity::Entity::UpdateFuncType func, const char* shader)
+{
+  decltype(shaderMap)::const_iterator itr = shaderMap.end();
+  if (shader) {
+    itr = shaderMap.find(shader);
+  }
+  if (itr == shaderMap.end()) {
+    itr = shaderMap.find("Tutorial");
+    if (itr == shaderMap.end()) {
+      return nullptr;
+    }
+  }
+  const Mesh::MeshPtr& mesh = meshBuffer->GetMesh(meshName);
+  TexturePtr tex[2];
+  tex[0] = GetTexture(texName);
+  if (normalName) {
+    tex[1] = GetTexture(normalName);
+  } else {
+    tex[1] = GetTexture("Res/Model/Dummy.Normal.bmp");
+  }
+  return entityBuffer->AddEntity(groupId, pos, mesh, tex, itr->second, std::move(func));
+}
+
+/**
+* アーキタイプを登録する.
+*
+* @param groupId    エンティティのグループID.
+* @param meshName   エンティティの表示に使用するメッシュ名.
+* @param texName    エンティティの表示に使うテクスチャファイル名.
+* @param normalName エンティティの表示に使う法線テクスチャファイル名. nullptrの場合はダミーを使う.
+* @param func       エンティティの状態を更新する関数(または関数オブジェクト).
+* @param collision  エンティティの衝突形状.
+* @param shader     エンティティの表示に使うシェーダ名.
+*
+* @return 登録したアーキタイプのID. 登録に失敗した場合は-1.
+*
+* リソースの検索は登録時に一度だけ行われる.
+* 以後はAddEntity(ArchetypeId, const glm::vec3&)によって、検索なしでエンティティを追加できる.
+*/
+Entity::ArchetypeId GameEngine::RegisterArchetype(int groupId, const char* meshName, const char* texName, const char* normalName, Entity::Entity::UpdateFuncType func, const Entity::CollisionData& collision, const char* shader)
+{
+  Entity::Archetype archetype;
+  if (!SetupArchetype(archetype, groupId, meshName, texName, normalName, collision, shader)) {
+    return -1;
+  }
+  archetype.updateFunc = std::move(func);
+  return entityBuffer->RegisterArchetype(std::move(archetype));
+}
+
+/**
+* 振る舞いテーブルで更新されるアーキタイプを登録する.
+*
+* @param groupId    エンティティのグループID.
+* @param meshName   エンティティの表示に使用するメッシュ名.
+* @param texName    エンティティの表示に使うテクスチャファイル名.
+* @param normalName エンティティの表示に使う法線テクスチャファイル名. nullptrの場合はダミーを使う.
+* @param behavior   エンティティの状態を更新する振る舞いテーブル. Entity::CreateBehaviorTable()で作成する.
+* @param collision  エンティティの衝突形状.
+* @param shader     エンティティの表示に使うシェーダ名.
+*
+* @return 登録したアーキタイプのID. 登録に失敗した場合は-1.
+*
+* 生成されたエンティティは関数オブジェクトを個別に持たず、振る舞いテーブルの配列にまとめて格納される.
+*/
+Entity::ArchetypeId GameEngine::RegisterBehaviorArchetype(int groupId, const char* meshName, const char* texName, const char* normalName, const Entity::BehaviorTablePtr& behavior, const Entity::CollisionData& collision, const char* shader)
+{
+  Entity::Archetype archetype;
+  if (!SetupArchetype(archetype, groupId, meshName, texName, normalName, collision, shader)) {
+    return -1;
+  }
+  archetype.behaviorTable = behavior;
+  return entityBuffer->RegisterArchetype(std::move(archetype));
+}
+
+/**
+* 弾の種類を登録する.
+*
+* @param groupId   弾のグループID. 衝突解決ハンドラはこのグループIDで選ばれる.
+* @param meshName  弾の表示に使用するメッシュ名.
+* @param texName   弾の表示に使うテクスチャファイル名.
+* @param color     弾の色.
+* @param collision 弾の衝突形状.
+* @param capacity  この種類の弾が同時に存在できる数.
+* @param shader    弾の表示に使うシェーダ名.
+*
+* @return 登録した種類のID. 登録に失敗した場合は-1.
+*
+* 弾はエンティティの代わりに使う軽量なオブジェクトで、FireBullet()で発射する.
+*/
+Entity::BulletTypeId GameEngine::RegisterBulletType(int groupId, const char* meshName, const char* texName, const glm::vec4& color, const Entity::CollisionData& collision, size_t capacity, const char* shader)
+{
+  Entity::Archetype archetype;
+  if (!SetupArchetype(archetype, groupId, meshName, texName, nullptr, collision, shader)) {
+    return -1;
+  }
+  return entityBuffer->Bullets().RegisterType(archetype, color, capacity);
+}
+
+/**
+* アーキタイプのリソースを設定する.
+*
+* @param archetype  設定するアーキタイプ.
+* @param groupId    エンティティのグループID.
+* @param meshName   エンティティの表示に使用するメッシュ名.
+* @param texName    エンティティの表示に使うテクスチャファイル名.
+* @param normalName エンティティの表示に使う法線テクスチャファイル名. nullptrの場合はダミーを使う.
+* @param collision  エンティティの衝突形状.
+* @param shader     エンティティの表示に使うシェーダ名.
+*
+* @retval true  設定成功.
+* @retval false シェーダが見つからない.
+*/
+bool GameEngine::SetupArchetype(Entity::Archetype& archetype, int groupId, const char* meshName, const char* texName, const char* normalName, const Entity::CollisionData& collision, const char* shader)
+{
+  decltype(shaderMap)::const_iterator itr = shaderMap.end();
+  if (shader) {
+    itr = shaderMap.find(shader);
+  }
+  if (itr == shaderMap.end()) {
+    itr = shaderMap.find("Tutorial");
+    if (itr == shaderMap.end()) {
+      return false;
+    }
+  }
+  archetype.groupId = groupId;
+  archetype.mesh = meshBuffer->GetMesh(meshName);
+  archetype.texture[0] = GetTexture(texName);
+  archetype.texture[1] = GetTexture(normalName ? normalName : "Res/Model/Dummy.Normal.bmp");
+  archetype.program = itr->second;
+  archetype.collision = collision;
+  return true;
+}
+
+/**
+* アーキタイプからエンティティを追加する.
+*
+* @param id  アーキタイプID.
+* @param pos エンティティの座標.
+*
+* @return 追加したエンティティへのポインタ.
+*         これ以上エンティティを追加できない場合はnullptrが返される.
+*/
+Entity::Entity* GameEngine::AddEntity(Entity::ArchetypeId id, const glm::vec3& pos)
+{
+  return entityBuffer->AddEntity(id, pos);
+}
+
+/**
+* アーキタイプから複数のエンティティを追加する.
+*
+* @param id         アーキタイプID.
+* @param posList    エンティティの座標の配列.
+* @param count      追加するエンティティの数.
+* @param entityList 追加したエンティティへのポインタを格納する配列. 不要ならnullptr.
+*
+* @return 追加できたエンティティの数.
+*/
+size_t GameEngine::AddEntities(Entity::ArchetypeId id, const glm::vec3* posList, size_t count, Entity::Entity** entityList)
+{
+  return entityBuffer->AddEntities(id, posList, count, entityList);
+}
+
+/**
+*　エンティティを削除する.
+*
+* @param 削除するエンティティのポインタ.
+*/
+void GameEngine::RemoveEntity(Entity::Entity* e)
+{
+  entityBuffer->RemoveEntity(e);
+}
+
+/**
+* スナップショットの保存と復元にかかる時間を計測する.
+*
+* @param entityCount 計測に使うエンティティの数.
+* @param iterations  保存と復元を繰り返す回数.
+*
+* 現在のエンティティは全て削除される. 結果は標準出力に出力する.
+* 保存から復元までの間に、エンティティの1/8を削除して同じ数を追加し、全エンティティを移動させる.
+*/
+void GameEngine::BenchmarkSnapshot(size_t entityCount, int iterations)
+{
+  /// 計測用のエンティティの更新関数. 複製の費用を計るため、少しだけ状態を持たせる.
+  struct UpdateBenchmarkEntity {
+    void operator()(Entity::Entity&, double delta) { timer += static_cast<float>(delta); }
+    float timer = 0;
+  };
+
+  entityBuffer->RemoveAllEntity();
+  entityBuffer->ResetSnapshotStats();
+  const TexturePtr tex[2] = { GetTexture("Res/Model/Dummy.Normal.bmp"), GetTexture("Res/Model/Dummy.Normal.bmp") };
+  const auto itr = shaderMap.find("Tutorial");
+  const Shader::ProgramPtr program = itr != shaderMap.end() ? itr->second : Shader::ProgramPtr();
+  std::mt19937 random(0);
+  std::uniform_real_distribution<float> distPos(-50, 50);
+  const auto addEntity = [&](size_t i) {
+    const glm::vec3 pos(distPos(random), 0, distPos(random));
+    return entityBuffer->AddEntity(static_cast<int>(i % 4), pos, Mesh::MeshPtr(), tex, program, UpdateBenchmarkEntity());
+  };
+  std::vector<Entity::Entity*> entityList;
+  entityList.reserve(entityCount);
+  for (size_t i = 0; i < entityCount; ++i) {
+    if (Entity::Entity* e = addEntity(i)) {
+      entityList.push_back(e);
+    }
+  }
+
+  Entity::Snapshot snapshot;
+  std::vector<Entity::Entity*> savedList;
+  for (int n = 0; n < iterations; ++n) {
+    if (!SaveSnapshot(snapshot)) {
+      break;
+    }
+    savedList = entityList;
+    for (size_t i = 0; i < entityList.size(); i += 8) {
+      entityBuffer->RemoveEntity(entityList[i]);
+      entityList[i] = addEntity(i);
+    }
+    for (Entity::Entity& e : *entityBuffer) {
+      e.Position(e.Position() + glm::vec3(1, 0, 0));
+    }
+    if (!RestoreSnapshot(snapshot)) {
+      break;
+    }
+    entityList = savedList;
+  }
+
+  const Entity::SnapshotStatistics& stats = entityBuffer->SnapshotStats();
+  if (stats.saveCount && stats.restoreCount) {
+    std::cout << "BenchmarkSnapshot: entities=" << stats.entityCount << " bytes=" << snapshot.ByteSize() <<
+      " save=" << stats.saveSeconds * 1000.0 / stats.saveCount << "ms(max " << stats.maxSaveSeconds * 1000.0 << "ms)" <<
+      " restore=" << stats.restoreSeconds * 1000.0 / stats.restoreCount << "ms(max " << stats.maxRestoreSeconds * 1000.0 << "ms)" << std::endl;
+  }
+  entityBuffer->RemoveAllEntity();
+  entityBuffer->ResetSnapshotStats();
+}
+
+/**
+* InlineFunctionとstd::functionについて、エンティティの追加と更新にかかる時間を比べる.
+*
+* @param count      計測に使うエンティティの数.
+* @param iterations Entity::Buffer::Update()を呼び出す回数.
+*
+* 現在のエンティティは全て削除される. 結果はエンティティ1個あたりの時間として標準出力に出力する.
+* std::functionの場合は、以前の更新関数と同じくヒープに確保したstd::functionを経由して呼び出す.
+* InlineFunctionに収めるための間接参照が1段増えるので、以前の実装よりわずかに遅い値になる.
+*/
+void GameEngine::BenchmarkInlineFunction(size_t count, int iterations)
+{
+  static_assert(std::is_nothrow_move_constructible<Entity::Entity::UpdateFuncType>::value,
+    "vectorの再確保でムーブされるよう、更新関数の型は例外を投げずにムーブできなければなりません.");
+
+  /// 計測用のエンティティの更新関数. 実際の更新関数と同程度の状態を持たせる.
+  struct UpdateBenchmarkEntity {
+    void operator()(Entity::Entity& e, double delta) {
+      timer += delta;
+      e.Position(e.Position() + velocity * static_cast<float>(delta));
+    }
+    glm::vec3 velocity;
+    double timer;
+  };
+
+  /// std::functionを経由して更新関数を呼び出す関数オブジェクト.
+  struct StdFunctionUpdate {
+    typedef std::function<void(Entity::Entity&, double)> FuncType;
+    explicit StdFunctionUpdate(FuncType f) : func(new FuncType(std::move(f))) {}
+    StdFunctionUpdate(const StdFunctionUpdate& src) : func(new FuncType(*src.func)) {}
+    StdFunctionUpdate(StdFunctionUpdate&& src) noexcept = default;
+    void operator()(Entity::Entity& e, double delta) { (*func)(e, delta); }
+    std::unique_ptr<FuncType> func;
+  };
+
+  const TexturePtr tex[2] = { GetTexture("Res/Model/Dummy.Normal.bmp"), GetTexture("Res/Model/Dummy.Normal.bmp") };
+  const auto itr = shaderMap.find("Tutorial");
+  const Shader::ProgramPtr program = itr != shaderMap.end() ? itr->second : Shader::ProgramPtr();
+
+  // makeFuncで作った更新関数を持つエンティティをcount個追加し、追加と更新の時間を計測する.
+  const auto benchmark = [&](const char* name, auto makeFunc) {
+    entityBuffer->RemoveAllEntity();
+    std::mt19937 random(0);
+    std::uniform_real_distribution<float> distPos(-50, 50);
+    std::uniform_real_distribution<float> distVel(-1, 1);
+
+    double t = glfwGetTime();
+    size_t n = 0;
+    for (size_t i = 0; i < count; ++i) {
+      const glm::vec3 pos(distPos(random), 0, distPos(random));
+      const UpdateBenchmarkEntity f{ glm::vec3(distVel(random), 0, distVel(random)), 0.0 };
+      if (entityBuffer->AddEntity(static_cast<int>(i % 4), pos, Mesh::MeshPtr(), tex, program, makeFunc(f))) {
+        ++n;
+      }
+    }
+    const double addSeconds = glfwGetTime() - t;
+
+    t = glfwGetTime();
+    for (int i = 0; i < iterations; ++i) {
+      entityBuffer->Update(1.0 / 60.0);
+    }
+    const double updateSeconds = glfwGetTime() - t;
+
+    if (n && iterations > 0) {
+      std::cout << "BenchmarkInlineFunction: " << name << " entities=" << n <<
+        " add=" << addSeconds * 1e9 / n << "ns" <<
+        " update=" << updateSeconds * 1e9 / (static_cast<double>(n) * iterations) << "ns" << std::endl;
+    }
+  };
+  benchmark("std::function", [](const UpdateBenchmarkEntity& f) { return StdFunctionUpdate(f); });
+  benchmark("InlineFunction", [](const UpdateBenchmarkEntity& f) { return f; });
+  entityBuffer->RemoveAllEntity();
+}
+
+/**
+* 大量のパーティクルを放出し、Particle::System::Update()にかかる時間を計測する.
+*
+* @param count  放出するパーティクルの数.
+* @param frames 更新するフレーム数.
+*
+* 寿命は計測の間に尽きない長さにして、常にcount個を更新する.
+* 大きさと色のキーは実際の爆発と同程度の数にする.
+* Update()はインスタンスデータの書き込みまで含むので、ストリーミングバッファの統計も出力する.
+*/
+void GameEngine::BenchmarkParticles(size_t count, int frames)
+{
+  static const double delta = 1.0 / 60.0;
+
+  particleSystem->ClearTypes();
+  Particle::TypeDesc desc;
+  desc.lifetime = glm::vec2(static_cast<float>(frames * delta) + 1.0f);
+  desc.speed = glm::vec2(1, 5);
+  desc.acceleration = glm::vec3(0, -9.8f, 0);
+  desc.drag = 0.5f;
+  desc.sizeCurve = { 0.5f, 1.0f, 0.8f, 0.0f };
+  desc.colorCurve = { glm::vec4(1, 1, 0.8f, 1), glm::vec4(1, 0.6f, 0.2f, 1), glm::vec4(0.5f, 0.1f, 0, 0.5f), glm::vec4(0) };
+  desc.capacity = count;
+  const Particle::TypeId id = particleSystem->RegisterType(desc);
+
+  double t = glfwGetTime();
+  const size_t emitted = particleSystem->Emit(id, glm::vec3(0), count);
+  const double emitSeconds = glfwGetTime() - t;
+
+  double totalSeconds = 0;
+  double maxSeconds = 0;
+  for (int n = 0; n < frames; ++n) {
+    streamBuffer->BeginFrame();
+    t = glfwGetTime();
+    particleSystem->Update(delta);
+    const double seconds = glfwGetTime() - t;
+    streamBuffer->EndFrame();
+    totalSeconds += seconds;
+    maxSeconds = std::max(maxSeconds, seconds);
+  }
+
+  const StreamBuffer::Statistics& stats = streamBuffer->Stats();
+  std::cout << "BenchmarkParticles: particles=" << emitted << "/" << count <<
+    " emit=" << emitSeconds * 1000.0 << "ms" <<
+    " update=" << totalSeconds * 1000.0 / std::max(frames, 1) << "ms(max " << maxSeconds * 1000.0 << "ms)" <<
+    " alive=" << particleSystem->ParticleCount() <<
+    " streamPeak=" << stats.peakUsage << "bytes overflow=" << stats.overflowCount << std::endl;
+  particleSystem->ClearTypes();
+}
+
+/**
+* 全てのエンティティを削除する.
+*/
+void GameEngine::RemoveAllEntity()
+{
+  entityBuffer->RemoveAllEntity();
+}
+
+/**
+* ライトを設定する.
+*
+* @param indes  設定するライトのインデックス.
+* @param light  ライトパラメータ.
+*/
+void GameEngine::Light(int index, const Uniform::PointLight& light)
+{
+  if (index < 0 || index >= Uniform::maxLightCount) {
+    std::cerr << "WARNING: '" << index << "'は不正なライトインデックスです" << std::endl;
+    return;
+  }
+  lightData.light[index] = light;
+}
+
+/**
+* ライトを取得する.
+*
+* @param index 取得するライトのインデックス.
+*
+* @return ライトパラメータ.
+*/
+const Uniform::PointLight& GameEngine::Light(int index) const
+{
+  if (index < 0 || index >= Uniform::maxLightCount) {
+    std::cerr << "WARNING: '" << index << "'は不正なライトインデックスです" << std::endl;
+    static const Uniform::PointLight dummy;
+    return dummy;
+  }
+  return lightData.light[index];
+}
+
+/**
+* 環境光を設定する.
+*
+* @param color 環境光の明るさ.
+*/
+void GameEngine::AmbientLight(const glm::vec4& color)
+{
+  lightData.ambientColor = color;
+}
+
+/**
+* 環境光を取得する.
+*
+* @return 環境光の明るさ.
+*/
+const glm::vec4& GameEngine::AmbientLight() const
+{
+  return lightData.ambientColor;
+}
+
+/**
+* 視点の位置と姿勢を設定する.
+*
+* @param index カメラのインデックス.
+* @param cam   設定するカメラデータ.
+*
+* 指定されたインデックスのカメラをアクティブ化し、状態を設定する.
+*
+* @sa Camera, ActivateCamera, DeactivateCamera, IsCameraActive
+*/
+void GameEngine::Camera(size_t index, const CameraData& cam)
+{
+  camera[index].camera = cam;
+  camera[index].isActive = true;
+  lightData.eyePos[index] = glm::vec4(cam.position, 0);
+}
+
+/**
+* 視点の位置と姿勢を取得する.
+*
+* @param index カメラのインデックス.
+* @return カメラデータ.
+*/
+const GameEngine::CameraData& GameEngine::Camera(size_t index) const
+{
+  return camera[index].camera;
+}
+
+/**
+* 全てのカメラの状態を初期状態に戻す.
+*/
+void GameEngine::ResetAllCamera()
+{
+  for (auto& c : camera) {
+    c.camera = {};
+    c.isActive = false;
+    c.priority = 0;
+  }
+  camera[0].isActive = true;
+}
+
+/**
+* 乱数オブジェクトを取得する.
+*
+* @return 乱数オブジェクト.
+*/
+std::mt19937& GameEngine::Rand()
+{
+  return rand;
+}
+
+/**
+* 衝突解決ハンドラを設定する.
+*
+* @param gid0    衝突対象のグループID.
+* @param gid1    衝突対象のグループID.
+* @param handler 衝突解決ハンドラ.
+*
+* 衝突が発生し衝突解決ハンドラが呼びされるとき、より小さいグループIDを持つエンティティから先に渡される.
+* ここで指定したグループIDの順序とは無関係であることに注意すること.
+* ex)
+*   CollisionHandler(10, 1, Func)
+*   というコードでハンドラを登録したとする. 衝突が発生すると、
+*   Func(グループID=1のエンティティ、グループID=10のエンティティ)
+*   のように呼び出される.
+*/
+void GameEngine::CollisionHandler(int gid0, int gid1, Entity::CollisionHandlerType handler)
+{
+  entityBuffer->CollisionHandler(gid0, gid1, std::move(handler));
+}
+
+/**
+* 衝突解決ハンドラを取得する.
+*
+* @param gid0 衝突対象のグループID.
+* @param gid1 衝突対象のグループID.
+*
+* @return 衝突解決ハンドラ.
+*/
+const Entity::CollisionHandlerType& GameEngine::CollisionHandler(int gid0, int gid1) const
+{
+  return entityBuffer->CollisionHandler(gid0, gid1);
+}
+
+/**
+* 衝突解決ハンドラのリストをクリアする.
+*/
+void GameEngine::ClearCollisionHandlerList()
+{
+  entityBuffer->ClearCollisionHandlerList();
+}
+
+/**
+* オーディオを初期化する.
+*/
+bool GameEngine::InitAudio(const char* acfPath, const char* acbPath, const char* awbPath, const char* dspBusName)
+{
+  return Audio::Initialize(acfPath, acbPath, awbPath, dspBusName);
+}
+
+/**
+* 音を再生する.
+*/
+void GameEngine::PlayAudio(int playerId, int cueId)
+{
+  if (isSilentUpdate) {
+    return;
+  }
+  Audio::Play(playerId, cueId);
+}
+
+/**
+* 音を停止する.
+*/
+void GameEngine::StopAudio(int playerId)
+{
+  Audio::Stop(playerId);
+}
+
+/**
+* リソーススタックに新しいリソースレベルを作成する.
+*/
+void GameEngine::PushLevel()
+{
+  meshBuffer->PushLevel();
+  textureMapStack.push_back(TextureMap());
+}
+
+/**
+* リソーススタックの末尾のリソースレベルを除去する.
+*/
+void GameEngine::PopLevel()
+{
+  meshBuffer->PopLevel();
+  if (textureMapStack.size() > minimalStackSize) {
+    textureMapStack.pop_back();
+  }
+}
+
+/**
+* 末尾のリソースレベルを空の状態にする.
+*/
+void GameEngine::ClearLevel()
+{
+  entityBuffer->ClearArchetypeList();
+  entityBuffer->Bullets().ClearTypes();
+  particleSystem->ClearTypes();
+  meshBuffer->ClearLevel();
+  textureMapStack.back().clear();
 }
\ No newline at end of file
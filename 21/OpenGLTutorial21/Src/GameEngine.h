@@ -1,176 +1,278 @@
-/**
-* @file GameEngine.h
-*/
-#ifndef GAMEENGINE_H_INCLUDED
-#define GAMEENGINE_H_INCLUDED
-#include <GL/glew.h>
-#include "UniformBuffer.h"
-#include "OffscreenBuffer.h"
-#include "BufferObject.h"
-#include "Shader.h"
-#include "Texture.h"
-#include "Mesh.h"
-#include "Entity.h"
-#include "Uniform.h"
-#include "GamePad.h"
-#include "Font.h"
-#include <glm/glm.hpp>
-#include <unordered_map>
-#include <functional>
-#include <random>
-
-/**
-* Q[GWNX.
-*/
-class GameEngine
-{
-public:
-  /// Q[ԂXV֐̌^.
-  typedef std::function<void(double)> UpdateFuncType;
-  struct CameraData {
-    glm::vec3 position;
-    glm::vec3 target = { 0, 0, 1 };
-    glm::vec3 up = {0, 1, 0};
-  };
-
-  /// ep[^.
-  struct ShadowParameter {
-    glm::vec3 lightPos; ///< e𔭐郉Cg̈ʒu.
-    glm::vec3 lightDir; ///<e𔭐郉Cg̕.
-    glm::vec3 lightUp;  ///<e𔭐郉Cg̏.
-    glm::f32 near; ///< `͈͂̃jA.
-    glm::f32 far; ///< `͈͂̃t@[.
-    glm::vec2 range; ///< `͈͂̕ƍ.
-  };
-
-  static GameEngine& Instance();
-  bool Init(int w, int h, const char* title);
-  void Run();
-  void UpdateFunc(const UpdateFuncType& func);
-  const UpdateFuncType& UpdateFunc() const;
-
-  bool LoadMeshFromFile(const char* filename);
-  const Mesh::MeshPtr& GetMesh(const char* name);
-  bool LoadTextureFromFile(const char* filename, GLenum wrapMode = GL_CLAMP_TO_EDGE);
-  const TexturePtr& GetTexture(const char* filename) const;
-  Entity::Entity* AddEntity(int groupId, const glm::vec3& pos, const char* meshName, const char* texName, Entity::Entity::UpdateFuncType func = nullptr, const char* shader = nullptr);
-  Entity::Entity* AddEntity(int groupId, const glm::vec3& pos, const char* meshName, const char* texName, const char* normalName, Entity::Entity::UpdateFuncType func = nullptr, const char* shader = nullptr);
-  void RemoveEntity(Entity::Entity*);
-  void RemoveAllEntity();
-  void Light(int index, const Uniform::PointLight& light);
-  const Uniform::PointLight& Light(int index) const;
-  void AmbientLight(const glm::vec4& color);
-  const glm::vec4& AmbientLight() const;
-  float KeyValue() const { return keyValue; }
-  void KeyValue(float k) { keyValue = k; }
-
-  void Camera(size_t index, const CameraData& cam);
-  const CameraData& Camera(size_t index) const;
-  void CameraPriority(size_t index, int priority) { camera[index].priority = priority; }
-  int CameraPriority(size_t index) const { return camera[index].priority; }
-  void ActivateCamera(size_t index) { camera[index].isActive = true; }
-  void DeactivateCamera(size_t index) { camera[index].isActive = false; }
-  void ResetAllCamera();
-  bool IsCameraActive(size_t index) const { return camera[index].isActive; }
-  void GroupVisibility(int groupId, int index, bool isVisible) { entityBuffer->GroupVisibility(groupId, index, isVisible); }
-  bool GroupVisibility(int groupId, int index) const { return entityBuffer->GroupVisibility(groupId, index); }
-
-  std::mt19937& Rand();
-  const GamePad& GetGamePad(int id) const;
-
-  bool InitAudio(const char* acfPath, const char* acbPath, const char* awbPath, const char* dspBusName);
-  void PlayAudio(int playerId, int cueId);
-  void StopAudio(int playerId);
-
-  void PushLevel();
-  void PopLevel();
-  void ClearLevel();
-
-  void Shadow(const ShadowParameter& param) { shadowParameter = param; }
-  const ShadowParameter& Shadow() const { return shadowParameter; }
-
-  void CollisionHandler(int gid0, int gid1, Entity::CollisionHandlerType handler);
-  const Entity::CollisionHandlerType& CollisionHandler(int gid0, int gid1) const;
-  void ClearCollisionHandlerList();
-
-  bool LoadFontFromFile(const char* filename) { return fontRenderer.LoadFromFile(filename); }
-  bool AddString(const glm::vec2& pos, const char* str) {return fontRenderer.AddString(pos, str); }
-  void FontScale(const glm::vec2& scale) { fontRenderer.Scale(scale); }
-  void FontColor(const glm::vec4& color) { fontRenderer.Color(color); }
-  void FontSubColor(const glm::vec4& color) { fontRenderer.SubColor(color); }
-  void FontBorder(float border) { fontRenderer.Border(border); }
-  void FontThickness(float t) { fontRenderer.Thickness(t); }
-  void FontPropotional(bool b) { fontRenderer.Propotional(b); }
-  void FontXAdvance(float x) { fontRenderer.XAdvance(x); }
-
-  double& UserVariable(const char* name) { return userNumbers[name]; }
-  double UserVariable(const char* name) const {
-    auto itr = userNumbers.find(name);
-    return itr != userNumbers.end() ? itr->second : 0;
-  }
-
-  double Fps() const { return fps; }
-
-  Entity::Buffer::Iterator BeginEntity() { return entityBuffer->Begin(); }
-  Entity::Buffer::Iterator EndEntity() { return entityBuffer->End(); }
-
-  mutable float luminanceScale = 1.0f;
-
-private:
-  GameEngine() = default;
-  ~GameEngine();
-  GameEngine(const GameEngine&) = delete;
-  GameEngine& operator=(const GameEngine&) = delete;
-
-  struct RenderingContext;
-  void InitRenderingContext(RenderingContext& indices) const;
-
-  void Update(double delta);
-  void Render() const;
-  void RenderShadow(RenderingContext& indices) const;
-
-private:
-  bool isInitialized = false;
-  UpdateFuncType updateFunc;
-
-  GLuint vbo = 0;
-  GLuint ibo = 0;
-  GLuint vao = 0;
-  BufferObject pbo[2];
-  int pboIndexForWriting = -1;
-  float keyValue = 0.18f;
-
-  UniformBufferPtr uboLight;
-  UniformBufferPtr uboPostEffect;
-  std::unordered_map<std::string, Shader::ProgramPtr> shaderMap;
-  OffscreenBufferPtr offscreen;
-  static const int bloomBufferCount = 4;
-  OffscreenBufferPtr offBloom[bloomBufferCount];
-  OffscreenBufferPtr offAnamorphic[2];
-
-  Mesh::BufferPtr meshBuffer;
-
-  typedef std::unordered_map<std::string, TexturePtr> TextureMap;
-  static const size_t minimalStackSize = 1;
-  std::vector<TextureMap> textureMapStack;
-
-  Entity::BufferPtr entityBuffer;
-  Font::Renderer fontRenderer;
-  Uniform::LightingData lightData;
-
-  struct CameraStatus {
-    CameraData camera;
-    glm::u32 priority = 0;
-    bool isActive = false;
-  };
-  CameraStatus camera[Uniform::maxViewCount];
-  std::mt19937 rand;
-  double fps = 0;
-
-  std::unordered_map<std::string, double> userNumbers;
-
-  ShadowParameter shadowParameter;
-  OffscreenBufferPtr offDepth;
-};
-
+/**
+* @file GameEngine.h
+*/
+#ifndef GAMEENGINE_H_INCLUDED
+#define GAMEENGINE_H_INCLUDED
+#include <GL/glew.h>
+#include "UniformBuffer.h"
+#include "OffscreenBuffer.h"
+#include "BufferObject.h"
+#include "StreamBuffer.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "Mesh.h"
+#include "Entity.h"
+#include "Bullet.h"
+#include "Snapshot.h"
+#include "Netplay.h"
+#include "Uniform.h"
+#include "GamePad.h"
+#include "Font.h"
+#include "Particle.h"
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <functional>
+#include <random>
+
+/**
+* ゲームエンジンクラス.
+*/
+class GameEngine
+{
+public:
+  /// ゲーム状態を更新する関数の型.
+  typedef std::function<void(double)> UpdateFuncType;
+  struct CameraData {
+    glm::vec3 position;
+    glm::vec3 target = { 0, 0, 1 };
+    glm::vec3 up = {0, 1, 0};
+  };
+
+  /// 影生成パラメータ.
+  struct ShadowParameter {
+    glm::vec3 lightPos; ///< 影を発生させるライトの位置.
+    glm::vec3 lightDir; ///<影を発生させるライトの方向.
+    glm::vec3 lightUp;  ///<影を発生させるライトの上方向.
+    glm::f32 near; ///< 描画範囲のニア平面.
+    glm::f32 far; ///< 描画範囲のファー平面.
+    glm::vec2 range; ///< 描画範囲の幅と高さ.
+  };
+
+  static GameEngine& Instance();
+  bool Init(int w, int h, const char* title);
+  void Run();
+  void UpdateFunc(const UpdateFuncType& func);
+  const UpdateFuncType& UpdateFunc() const;
+
+  bool LoadMeshFromFile(const char* filename);
+  const Mesh::MeshPtr& GetMesh(const char* name);
+  bool LoadTextureFromFile(const char* filename, GLenum wrapMode = GL_CLAMP_TO_EDGE);
+  const TexturePtr& GetTexture(const char* filename) const;
+  Entity::Entity* AddEntity(int groupId, const glm::vec3& pos, const char* meshName, const char* texName, Entity::Entity::UpdateFuncType func = nullptr, const char* shader = nullptr);
+  Entity::Entity* AddEntity(int groupId, const glm::vec3& pos, const char* meshName, const char* texName, const char* normalName, Entity::Entity::UpdateFuncType func = nullptr, const char* shader = nullptr);
+  Entity::ArchetypeId RegisterArchetype(int groupId, const char* meshName, const char* texName, const char* normalName, Entity::Entity::UpdateFuncType func, const Entity::CollisionData& collision = {}, const char* shader = nullptr);
+  Entity::ArchetypeId RegisterBehaviorArchetype(int groupId, const char* meshName, const char* texName, const char* normalName, const Entity::BehaviorTablePtr& behavior, const Entity::CollisionData& collision = {}, const char* shader = nullptr);
+  Entity::Entity* AddEntity(Entity::ArchetypeId id, const glm::vec3& pos);
+  size_t AddEntities(Entity::ArchetypeId id, const glm::vec3* posList, size_t count, Entity::Entity** entityList = nullptr);
+  void RemoveEntity(Entity::Entity*);
+  void RemoveAllEntity();
+  void Light(int index, const Uniform::PointLight& light);
+  const Uniform::PointLight& Light(int index) const;
+  void AmbientLight(const glm::vec4& color);
+  const glm::vec4& AmbientLight() const;
+  float KeyValue() const { return keyValue; }
+  void KeyValue(float k) { keyValue = k; }
+
+  void Camera(size_t index, const CameraData& cam);
+  const CameraData& Camera(size_t index) const;
+  void CameraPriority(size_t index, int priority) { camera[index].priority = priority; }
+  int CameraPriority(size_t index) const { return camera[index].priority; }
+  void ActivateCamera(size_t index) { camera[index].isActive = true; }
+  void DeactivateCamera(size_t index) { camera[index].isActive = false; }
+  void ResetAllCamera();
+  bool IsCameraActive(size_t index) const { return camera[index].isActive; }
+  void GroupVisibility(int groupId, int index, bool isVisible) { entityBuffer->GroupVisibility(groupId, index, isVisible); }
+  bool GroupVisibility(int groupId, int index) const { return entityBuffer->GroupVisibility(groupId, index); }
+  void GroupOffset(int groupId, const glm::vec3& offset) { entityBuffer->GroupOffset(groupId, offset); }
+  const glm::vec3& GroupOffset(int groupId) const { return entityBuffer->GroupOffset(groupId); }
+  void GroupVelocity(int groupId, const glm::vec3& v) { entityBuffer->GroupVelocity(groupId, v); }
+  const glm::vec3& GroupVelocity(int groupId) const { return entityBuffer->GroupVelocity(groupId); }
+  void GroupParallelUpdate(int groupId, bool isParallel) { entityBuffer->GroupParallelUpdate(groupId, isParallel); }
+  bool GroupParallelUpdate(int groupId) const { return entityBuffer->GroupParallelUpdate(groupId); }
+  bool GroupUpdateDivisor(int groupId, int divisor) { return entityBuffer->GroupUpdateDivisor(groupId, divisor); }
+  int GroupUpdateDivisor(int groupId) const { return entityBuffer->GroupUpdateDivisor(groupId); }
+  double GroupUpdateTime(int groupId) const { return entityBuffer->GroupUpdateTime(groupId); }
+
+  std::mt19937& Rand();
+  void Seed(uint32_t seed) { rand.seed(seed); }
+  const GamePad& GetGamePad(int id) const;
+
+  bool StartNetplay(const Netplay::TransportPtr& transport, int localPlayer, int inputDelay, uint32_t seed);
+  void StopNetplay() { netplay.Stop(); }
+  bool IsNetplayRunning() const { return netplay.IsRunning(); }
+  const Netplay::Statistics& NetplayStats() const { return netplay.Stats(); }
+
+  bool InitAudio(const char* acfPath, const char* acbPath, const char* awbPath, const char* dspBusName);
+  void PlayAudio(int playerId, int cueId);
+  void StopAudio(int playerId);
+
+  void PushLevel();
+  void PopLevel();
+  void ClearLevel();
+
+  void Shadow(const ShadowParameter& param) { shadowParameter = param; }
+  const ShadowParameter& Shadow() const { return shadowParameter; }
+
+  void CollisionHandler(int gid0, int gid1, Entity::CollisionHandlerType handler);
+  const Entity::CollisionHandlerType& CollisionHandler(int gid0, int gid1) const;
+  void ClearCollisionHandlerList();
+
+  bool GroupSpatialQuery(int groupId, bool isEnabled) { return entityBuffer->GroupSpatialQuery(groupId, isEnabled); }
+  bool GroupSpatialQuery(int groupId) const { return entityBuffer->GroupSpatialQuery(groupId); }
+  size_t QueryBox(const glm::vec3& min, const glm::vec3& max, uint32_t groupMask, Entity::Entity** out, size_t capacity) const {
+    return entityBuffer->QueryBox(min, max, groupMask, out, capacity);
+  }
+  size_t QueryRadius(const glm::vec3& center, float radius, uint32_t groupMask, Entity::Entity** out, size_t capacity) const {
+    return entityBuffer->QueryRadius(center, radius, groupMask, out, capacity);
+  }
+  Entity::Entity* Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, uint32_t groupMask, float* distance = nullptr) const {
+    return entityBuffer->Raycast(origin, direction, maxDistance, groupMask, distance);
+  }
+  size_t Nearest(const glm::vec3& center, size_t k, uint32_t groupMask, Entity::SpatialQueryResult* out, float maxDistance = FLT_MAX) const {
+    return entityBuffer->Nearest(center, k, groupMask, out, maxDistance);
+  }
+
+  bool SaveSnapshot(Entity::Snapshot& snapshot) { return snapshot.Save(*entityBuffer); }
+  bool RestoreSnapshot(const Entity::Snapshot& snapshot) { return snapshot.Restore(*entityBuffer); }
+  void BenchmarkSnapshot(size_t entityCount, int iterations);
+  void BenchmarkInlineFunction(size_t count, int iterations);
+  void BenchmarkParticles(size_t count, int frames);
+
+  Particle::TypeId RegisterParticleType(const Particle::TypeDesc& desc) { return particleSystem->RegisterType(desc); }
+  size_t EmitParticles(Particle::TypeId id, const glm::vec3& pos, size_t count) { return isSilentUpdate ? count : particleSystem->Emit(id, pos, count); }
+  Particle::EmitterId AddParticleEmitter(Particle::TypeId id, const glm::vec3& pos, float rate, float duration = -1) { return particleSystem->AddEmitter(id, pos, rate, duration); }
+  void ParticleEmitterPosition(Particle::EmitterId id, const glm::vec3& pos) { particleSystem->EmitterPosition(id, pos); }
+  void RemoveParticleEmitter(Particle::EmitterId id) { particleSystem->RemoveEmitter(id); }
+  void ClearParticles() { particleSystem->Clear(); }
+  size_t ParticleCount() const { return particleSystem->ParticleCount(); }
+
+  Entity::BulletTypeId RegisterBulletType(int groupId, const char* meshName, const char* texName, const glm::vec4& color, const Entity::CollisionData& collision, size_t capacity, const char* shader = nullptr);
+  bool FireBullet(Entity::BulletTypeId id, const glm::vec3& pos, const Entity::BulletParam& param) { return entityBuffer->Bullets().Fire(id, pos, param); }
+  void BulletTarget(Entity::BulletTypeId id, const glm::vec3& pos) { entityBuffer->Bullets().Target(id, pos); }
+  void BulletBounds(const glm::vec3& min, const glm::vec3& max) { entityBuffer->Bullets().Bounds(min, max); }
+  void ClearBullets() { entityBuffer->Bullets().Clear(); }
+  size_t BulletCount() const { return entityBuffer->Bullets().Count(); }
+
+  bool LoadFontFromFile(const char* filename) { return fontRenderer.LoadFromFile(filename); }
+  bool AddString(const glm::vec2& pos, const char* str) { return isSilentUpdate || fontRenderer.AddString(pos, str); }
+  void FontScale(const glm::vec2& scale) { fontRenderer.Scale(scale); }
+  void FontColor(const glm::vec4& color) { fontRenderer.Color(color); }
+  void FontSubColor(const glm::vec4& color) { fontRenderer.SubColor(color); }
+  void FontBorder(float border) { fontRenderer.Border(border); }
+  void FontThickness(float t) { fontRenderer.Thickness(t); }
+  void FontPropotional(bool b) { fontRenderer.Propotional(b); }
+  void FontXAdvance(float x) { fontRenderer.XAdvance(x); }
+
+  double& UserVariable(const char* name) { return userNumbers[name]; }
+  double UserVariable(const char* name) const {
+    auto itr = userNumbers.find(name);
+    return itr != userNumbers.end() ? itr->second : 0;
+  }
+
+  double Fps() const { return fps; }
+  size_t PeakEntityCount() const { return entityBuffer->PeakEntityCount(); }
+  void InstancedDraw(bool enable) { entityBuffer->InstancedDraw(enable); }
+  bool InstancedDraw() const { return entityBuffer->InstancedDraw(); }
+  size_t DrawCallCount() const { return entityBuffer->DrawCallCount(); }
+  size_t DrawCallCountWithoutInstancing() const { return entityBuffer->DrawCallCountWithoutInstancing(); }
+  void DrawStatsOutput(bool enable) { isDrawStatsOutput = enable; }
+  const RenderQueue::Statistics& RenderStats() const { return entityBuffer->RenderStats(); }
+  size_t SubmittedEntityCount() const { return entityBuffer->SubmittedEntityCount(); }
+  size_t VisibleEntityCount() const { return entityBuffer->VisibleEntityCount(); }
+  size_t InstanceDataBytes() const { return entityBuffer->InstanceDataBytes(); }
+  const StreamBuffer::Statistics& StreamStats() const { return streamBuffer->Stats(); }
+
+  Entity::Buffer::Iterator BeginEntity() { return entityBuffer->Begin(); }
+  Entity::Buffer::Iterator EndEntity() { return entityBuffer->End(); }
+
+  mutable float luminanceScale = 1.0f;
+
+private:
+  GameEngine() = default;
+  ~GameEngine();
+  GameEngine(const GameEngine&) = delete;
+  GameEngine& operator=(const GameEngine&) = delete;
+
+  struct RenderingContext;
+  void InitRenderingContext(RenderingContext& indices) const;
+
+  void Update(double delta);
+  void Simulate(double delta);
+  void UpdateNetplay();
+  void SimulateNetplayFrame(uint32_t frame);
+  void SaveFrameState(uint32_t frame);
+  bool LoadFrameState(uint32_t frame);
+  void Render() const;
+  void RenderShadow(RenderingContext& indices) const;
+  void UploadUniform(const UniformBufferPtr& ubo, const void* data, GLsizeiptr size) const;
+  bool SetupArchetype(Entity::Archetype& archetype, int groupId, const char* meshName, const char* texName, const char* normalName, const Entity::CollisionData& collision, const char* shader);
+
+private:
+  bool isInitialized = false;
+  UpdateFuncType updateFunc;
+
+  GLuint vbo = 0;
+  GLuint ibo = 0;
+  GLuint vao = 0;
+  BufferObject pbo[2];
+  int pboIndexForWriting = -1;
+  float keyValue = 0.18f;
+
+  UniformBufferPtr uboLight;
+  UniformBufferPtr uboPostEffect;
+  UniformBufferPtr uboView;
+  StreamBufferPtr streamBuffer;
+  std::unordered_map<std::string, Shader::ProgramPtr> shaderMap;
+  OffscreenBufferPtr offscreen;
+  static const int bloomBufferCount = 4;
+  OffscreenBufferPtr offBloom[bloomBufferCount];
+  OffscreenBufferPtr offAnamorphic[2];
+
+  Mesh::BufferPtr meshBuffer;
+
+  typedef std::unordered_map<std::string, TexturePtr> TextureMap;
+  static const size_t minimalStackSize = 1;
+  std::vector<TextureMap> textureMapStack;
+
+  Entity::BufferPtr entityBuffer;
+  Particle::SystemPtr particleSystem;
+  Font::Renderer fontRenderer;
+  Uniform::LightingData lightData;
+  Uniform::ViewData viewData;
+
+  struct CameraStatus {
+    CameraData camera;
+    glm::u32 priority = 0;
+    bool isActive = false;
+  };
+  CameraStatus camera[Uniform::maxViewCount];
+  std::mt19937 rand;
+  double fps = 0;
+  bool isDrawStatsOutput = false; ///< trueなら描画の統計を1秒ごとに標準出力に出力する.
+
+  std::unordered_map<std::string, double> userNumbers;
+
+  ShadowParameter shadowParameter;
+  OffscreenBufferPtr offDepth;
+
+  /// ロールバックのために保存する、フレーム開始時のゲームの状態.
+  struct FrameState {
+    uint32_t frame = ~0U; ///< 保存したフレーム. 保存していなければ~0U.
+    Entity::Snapshot entities; ///< エンティティと弾.
+    std::unordered_map<std::string, double> userNumbers; ///< ユーザー変数.
+    std::mt19937 rand; ///< 乱数.
+    UpdateFuncType updateFunc; ///< 状態更新関数. 関数オブジェクトが持つ状態も複製される.
+    CameraStatus camera[Uniform::maxViewCount]; ///< カメラ.
+    Uniform::LightingData lightData; ///< ライト.
+    float keyValue; ///< 明るさの基準値.
+    ShadowParameter shadowParameter; ///< 影生成パラメータ.
+  };
+  static const size_t frameStateCount = Netplay::maxRollbackFrames + 1; ///< 保存しておくフレームの数.
+
+  Netplay::Session netplay; ///< 通信対戦のセッション.
+  FrameState frameStateList[frameStateCount]; ///< フレームごとの状態. フレーム番号をframeStateCountで割った余りの位置に保存する.
+  GamePad netplayGamePad[Netplay::maxPlayerCount]; ///< 通信対戦中にGetGamePad()が返す、シミュレーション中のフレームの入力.
+  bool isSilentUpdate = false; ///< 再シミュレーション中ならtrue. 音声の再生・パーティクルの放出・文字列の追加を行わない.
+};
+
 #endif // GAMEENGINE_H_INCLUDED
\ No newline at end of file
@@ -0,0 +1,145 @@
+/**
+* @file InlineFunction.h
+*/
+#ifndef INLINEFUNCTION_H_INCLUDED
+#define INLINEFUNCTION_H_INCLUDED
+#include <type_traits>
+#include <utility>
+#include <new>
+#include <cstddef>
+
+template<typename Signature, size_t Capacity = 32>
+class InlineFunction;
+
+/**
+* 関数オブジェクトを内部の固定長領域に格納する、ムーブ専用の呼び出し可能オブジェクト.
+*
+* std::functionと異なり、関数オブジェクトを格納するためにヒープを確保することはない.
+* 格納できる関数オブジェクトはCapacityバイト以下で、超える場合はコンパイルエラーになる.
+* コピーはできないが、関数オブジェクトがコピー可能であればClone()で複製を作ることができる.
+*/
+template<typename R, typename... Args, size_t Capacity>
+class InlineFunction<R(Args...), Capacity>
+{
+public:
+  InlineFunction() {}
+  InlineFunction(std::nullptr_t) {}
+  template<typename F,
+    typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, InlineFunction>::value>::type,
+    typename = decltype(std::declval<typename std::decay<F>::type&>()(std::declval<Args>()...))>
+  InlineFunction(F&& f) { Construct(std::forward<F>(f)); }
+  InlineFunction(InlineFunction&& rhs) noexcept { MoveFrom(rhs); }
+  ~InlineFunction() { Reset(); }
+  InlineFunction(const InlineFunction&) = delete;
+  InlineFunction& operator=(const InlineFunction&) = delete;
+
+  InlineFunction& operator=(InlineFunction&& rhs) noexcept {
+    if (this != &rhs) {
+      Reset();
+      MoveFrom(rhs);
+    }
+    return *this;
+  }
+  InlineFunction& operator=(std::nullptr_t) { Reset(); return *this; }
+
+  explicit operator bool() const { return ops != nullptr; }
+  R operator()(Args... args) const { return ops->invoke(Storage(), std::forward<Args>(args)...); }
+
+  /**
+  * 複製を作成する.
+  *
+  * @return 関数オブジェクトの複製. 関数オブジェクトがコピーできない場合は空のオブジェクト.
+  */
+  InlineFunction Clone() const {
+    InlineFunction tmp;
+    if (ops && ops->copy) {
+      ops->copy(tmp.Storage(), Storage());
+      tmp.ops = ops;
+    }
+    return tmp;
+  }
+
+  /// Clone()で複製できればtrue. 空の場合もtrue.
+  bool IsCopyable() const { return !ops || ops->copy; }
+
+  /**
+  * 格納している関数オブジェクトを取得する.
+  *
+  * @return 格納している関数オブジェクトの型がFならそのポインタ. そうでなければnullptr.
+  */
+  template<typename F>
+  F* Target() const { return ops == OpsOf<F>() ? static_cast<F*>(Storage()) : nullptr; }
+
+private:
+  typedef void(*CopyFuncType)(void*, const void*);
+
+  /// 関数オブジェクトの型ごとの操作.
+  struct Ops {
+    R(*invoke)(void*, Args&&...); ///< 呼び出し.
+    void(*move)(void*, void*); ///< ムーブ構築し、移動元を破棄する.
+    CopyFuncType copy; ///< コピー構築. コピーできない型ならnullptr.
+    void(*destroy)(void*); ///< 破棄.
+  };
+
+  template<typename F>
+  static R Invoke(void* p, Args&&... args) { return (*static_cast<F*>(p))(std::forward<Args>(args)...); }
+  template<typename F>
+  static void Move(void* dst, void* src) {
+    F* p = static_cast<F*>(src);
+    new(dst) F(std::move(*p));
+    p->~F();
+  }
+  template<typename F>
+  static void Destroy(void* p) { static_cast<F*>(p)->~F(); }
+  template<typename F>
+  static typename std::enable_if<std::is_copy_constructible<F>::value, CopyFuncType>::type CopyOf() {
+    return [](void* dst, const void* src) { new(dst) F(*static_cast<const F*>(src)); };
+  }
+  template<typename F>
+  static typename std::enable_if<!std::is_copy_constructible<F>::value, CopyFuncType>::type CopyOf() {
+    return nullptr;
+  }
+  template<typename F>
+  static const Ops* OpsOf() {
+    static const Ops ops = { &Invoke<F>, &Move<F>, CopyOf<F>(), &Destroy<F> };
+    return &ops;
+  }
+
+  template<typename F>
+  static bool IsNull(const F&) { return false; }
+  template<typename F>
+  static bool IsNull(F* p) { return !p; }
+
+  template<typename F>
+  void Construct(F&& f) {
+    typedef typename std::decay<F>::type Fn;
+    static_assert(sizeof(Fn) <= Capacity, "関数オブジェクトが大きすぎます. Capacityを増やすか、状態を減らしてください.");
+    static_assert(alignof(Fn) <= alignof(std::max_align_t), "関数オブジェクトのアラインメントが大きすぎます.");
+    static_assert(std::is_nothrow_move_constructible<Fn>::value, "関数オブジェクトは例外を投げずにムーブできなければなりません.");
+    if (IsNull(f)) {
+      return;
+    }
+    new(Storage()) Fn(std::forward<F>(f));
+    ops = OpsOf<Fn>();
+  }
+  void MoveFrom(InlineFunction& rhs) noexcept {
+    if (rhs.ops) {
+      rhs.ops->move(Storage(), rhs.Storage());
+      ops = rhs.ops;
+      rhs.ops = nullptr;
+    }
+  }
+  void Reset() noexcept {
+    if (ops) {
+      ops->destroy(Storage());
+      ops = nullptr;
+    }
+  }
+  void* Storage() const { return storage; }
+
+private:
+  const Ops* ops = nullptr; ///< 格納している関数オブジェクトの操作. 空ならnullptr.
+  alignas(std::max_align_t) mutable unsigned char storage[Capacity]; ///< 関数オブジェクトを格納する領域.
+};
+
+#endif // INLINEFUNCTION_H_INCLUDED
\ No newline at end of file
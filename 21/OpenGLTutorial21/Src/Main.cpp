@@ -1,27 +1,100 @@
-/**
-* @file main.cpp
-*/
-#include "GameEngine.h"
-#include "GameState.h"
-#include "../Res/Audio/SampleSound_acf.h"
-
-/// Gg[|Cg.
-int main()
-{
-  GameEngine& game = GameEngine::Instance();
-  if (!game.Init(800, 600, "OpenGL Tutorial")) {
-    return 1;
-  }
-  if (!game.InitAudio("Res/Audio/SampleSound.acf", "Res/Audio/SampleCueSheet.acb", "Res/Audio/SampleCueSheet.awb", CRI_SAMPLESOUND_ACF_DSPSETTING_DSPBUSSETTING_0)) {
-    return 1;
-  }
-
-  game.LoadFontFromFile("Res/Font.fnt");
-  game.LoadTextureFromFile("Res/Model/Dummy.Normal.bmp");
-
-  game.PushLevel();
-  game.UpdateFunc(GameState::Title());
-  game.Run();
-
-  return 0;
+/**
+* @file main.cpp
+*/
+#include "GameEngine.h"
+#include "GameState.h"
+#include "Collision.h"
+#include "../Res/Audio/SampleSound_acf.h"
+#include <cstring>
+#include <cstdlib>
+
+/// エントリーポイント.
+int main(int argc, char** argv)
+{
+  GameEngine& game = GameEngine::Instance();
+  if (!game.Init(800, 600, "OpenGL Tutorial")) {
+    return 1;
+  }
+  if (!game.InitAudio("Res/Audio/SampleSound.acf", "Res/Audio/SampleCueSheet.acb", "Res/Audio/SampleCueSheet.awb", CRI_SAMPLESOUND_ACF_DSPSETTING_DSPBUSSETTING_0)) {
+    return 1;
+  }
+
+  game.LoadFontFromFile("Res/Font.fnt");
+  game.LoadTextureFromFile("Res/Model/Dummy.Normal.bmp");
+
+  // 計測用のオプションを指定すると、計測結果を標準出力に出力して終了する.
+  if (argc > 1 && std::strcmp(argv[1], "-benchmark-snapshot") == 0) {
+    game.BenchmarkSnapshot(10000, 100);
+    return 0;
+  }
+  if (argc > 1 && std::strcmp(argv[1], "-benchmark-inline-function") == 0) {
+    game.BenchmarkInlineFunction(10000, 100);
+    return 0;
+  }
+  if (argc > 1 && std::strcmp(argv[1], "-benchmark-particles") == 0) {
+    game.BenchmarkParticles(100000, 300);
+    return 0;
+  }
+  if (argc > 1 && std::strcmp(argv[1], "-test-overlap") == 0) {
+    return Collision::TestOverlapKernels(1, 10000) ? 0 : 1;
+  }
+  if (argc > 1 && std::strcmp(argv[1], "-benchmark-overlap") == 0) {
+    Collision::BenchmarkOverlapKernels(100, 10000);
+    Collision::BenchmarkOverlapKernels(10000, 100);
+    return 0;
+  }
+  if (argc > 1 && std::strcmp(argv[1], "-benchmark-broadphase") == 0) {
+    Collision::BenchmarkBroadphase(100, 100000);
+    return 0;
+  }
+
+  // -draw-statsを指定すると、インスタンス描画の有無による描画コマンド数の違いを1秒ごとに標準出力に出力する.
+  // -no-instancingを指定すると、インスタンス描画を使わずに描画する.
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "-draw-stats") == 0) {
+      game.DrawStatsOutput(true);
+    } else if (std::strcmp(argv[i], "-no-instancing") == 0) {
+      game.InstancedDraw(false);
+    }
+  }
+
+  // -netplay-loopbackを指定すると、遅延と欠落のある仮想の通信路の先に模擬的な相手を置いて、ロールバックを試す.
+  // -netplay-udp <自分のポート> <相手のポート> <プレイヤー番号>を指定すると、同じマシンで起動したもう1つのプログラムと
+  // 127.0.0.1のUDPで対戦する. -netplay-udp-scriptedを指定すると、模擬的な相手とUDPで通信する.
+  static const int inputDelay = 2;
+  static const uint32_t seed = 12345;
+  Netplay::ScriptedPeer peer;
+  if (argc > 1 && std::strcmp(argv[1], "-netplay-loopback") == 0) {
+    Netplay::LoopbackParameter param;
+    param.latency = 0.05;
+    param.jitter = 0.02;
+    param.lossRate = 0.05f;
+    Netplay::TransportPtr local;
+    Netplay::TransportPtr remote;
+    Netplay::LoopbackTransport::CreatePair(param, local, remote);
+    if (!peer.Start(remote, 1, inputDelay, 1.0 / 60.0, seed) || !game.StartNetplay(local, 0, inputDelay, seed)) {
+      return 1;
+    }
+  } else if (argc > 4 && std::strcmp(argv[1], "-netplay-udp") == 0) {
+    const uint16_t localPort = static_cast<uint16_t>(std::atoi(argv[2]));
+    const uint16_t remotePort = static_cast<uint16_t>(std::atoi(argv[3]));
+    const Netplay::TransportPtr transport = Netplay::UdpTransport::Create(localPort, "127.0.0.1", remotePort);
+    if (!transport || !game.StartNetplay(transport, std::atoi(argv[4]), inputDelay, seed)) {
+      return 1;
+    }
+  } else if (argc > 1 && std::strcmp(argv[1], "-netplay-udp-scripted") == 0) {
+    static const uint16_t localPort = 27015;
+    static const uint16_t remotePort = 27016;
+    const Netplay::TransportPtr local = Netplay::UdpTransport::Create(localPort, "127.0.0.1", remotePort);
+    const Netplay::TransportPtr remote = Netplay::UdpTransport::Create(remotePort, "127.0.0.1", localPort);
+    if (!local || !remote || !peer.Start(remote, 1, inputDelay, 1.0 / 60.0, seed) || !game.StartNetplay(local, 0, inputDelay, seed)) {
+      return 1;
+    }
+  }
+
+  game.PushLevel();
+  game.UpdateFunc(GameState::Title());
+  game.Run();
+
+  return 0;
 }
\ No newline at end of file
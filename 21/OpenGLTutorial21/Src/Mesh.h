@@ -1,98 +1,116 @@
-/**
-* @file Mesh.h
-*/
-#ifndef OPENGLTUTORIAL_SRC_MESH_H_INCLUDED
-#define OPENGLTUTORIAL_SRC_MESH_H_INCLUDED
-#include <GL/glew.h>
-#include <glm/glm.hpp>
-#include <vector>
-#include <string>
-#include <unordered_map>
-#include <memory>
-
-namespace Mesh {
-
-class Mesh;
-class Buffer;
-typedef std::shared_ptr<Buffer> BufferPtr; ///< bVobt@|C^.
-typedef std::shared_ptr<Mesh> MeshPtr; ///< bVf[^|C^.
-
-/**
-* }eAf[^.
-*/
-struct Material
-{
-  GLenum type; ///< CfbNX̃f[^^.
-  GLsizei size; ///< `悷CfbNX.
-  GLvoid* offset; ///< `JnCfbNX̃oCgItZbg.
-  GLint baseVertex; ///< CfbNX0Ƃ݂Ȃ钸_z̈ʒu.
-  glm::vec4 color; ///< }eA̐F.
-};
-
-/**
-* bVf[^.
-*/
-class Mesh
-{
-  friend class Buffer;
-public:
-  const std::string& Name() const { return name; }
-  void Draw(const BufferPtr& buffer) const;
-
-private:
-  Mesh() = default;
-  Mesh(const std::string& n, size_t begin, size_t end);
-  Mesh(const Mesh&) = default;
-  ~Mesh() = default;
-  Mesh& operator=(const Mesh&) = default;
-
-private:
-  std::string name; ///< bVf[^.
-  std::vector<std::string> textureList; ///< eNX`̃Xg.
-  size_t beginMaterial = 0; ///< `悷}eA̐擪CfbNX.
-  size_t endMaterial = 0; ///< `悷}eȀI[CfbNX.
-};
-
-/**
-* bVf[^obt@.
-*/
-class Buffer
-{
-public:
-  static BufferPtr Create(int vboSize, int iboSize);
-  Buffer(const Buffer&) = delete;
-  Buffer& operator=(const Buffer&) = delete;
-
-  bool LoadMeshFromFile(const char* filename);
-  const MeshPtr& GetMesh(const char* name) const;
-  const Material& GetMaterial(size_t index) const;
-  void BindVAO() const;
-
-  void PushLevel();
-  void PopLevel();
-  void ClearLevel();
-
-private:
-  Buffer() = default;
-  ~Buffer();
-
-private:
-  GLuint vbo = 0; ///< f̒_f[^i[VBO.
-  GLuint ibo = 0; ///< f̃CfbNXf[^i[IBO.
-  GLuint vao = 0; ///< fpVAO.
-
-  std::vector<Material> materialList; ///< }eAXg.
-
-  struct Level {
-    GLintptr vboEnd = 0; ///< ǂݍݍςݒ_f[^̏I[.
-    GLintptr iboEnd = 0; ///< ǂݍݍς݃CfbNXf[^̏I[.
-    size_t materialBaseOffset = 0; ///< }eÅi[Jnʒu.
-    std::unordered_map<std::string, MeshPtr> meshList; ///< bVXg.
-  };
-  std::vector<Level> levelStack; ///< f[^X^bN.
-  static const size_t minimalStackSize = 1;
-};
-
-} // namespace Mesh
-
+/**
+* @file Mesh.h
+*/
+#ifndef OPENGLTUTORIAL_SRC_MESH_H_INCLUDED
+#define OPENGLTUTORIAL_SRC_MESH_H_INCLUDED
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <memory>
+
+namespace Mesh {
+
+class Mesh;
+class Buffer;
+typedef std::shared_ptr<Buffer> BufferPtr; ///< メッシュバッファポインタ.
+typedef std::shared_ptr<Mesh> MeshPtr; ///< メッシュデータポインタ.
+
+/**
+* 境界ボリューム.
+*
+* 視錐台カリングに使う. 座標はメッシュのローカル座標系.
+*/
+struct Bounds
+{
+  glm::vec3 min = glm::vec3(0); ///< AABBの最小座標.
+  glm::vec3 max = glm::vec3(0); ///< AABBの最大座標.
+  glm::vec3 center = glm::vec3(0); ///< 境界球の中心.
+  float radius = 0; ///< 境界球の半径.
+};
+
+/**
+* マテリアルデータ.
+*/
+struct Material
+{
+  GLenum type; ///< インデックスのデータ型.
+  GLsizei size; ///< 描画するインデックス数.
+  GLvoid* offset; ///< 描画開始インデックスのバイトオフセット.
+  GLint baseVertex; ///< インデックス0とみなされる頂点配列内の位置.
+  glm::vec4 color; ///< マテリアルの色.
+  Bounds bounds; ///< このマテリアルで描画される頂点の境界ボリューム.
+};
+
+/**
+* メッシュデータ.
+*/
+class Mesh
+{
+  friend class Buffer;
+public:
+  const std::string& Name() const { return name; }
+  void Draw(const BufferPtr& buffer) const;
+  void DrawInstanced(const BufferPtr& buffer, GLsizei instanceCount) const;
+  size_t MaterialCount() const { return endMaterial - beginMaterial; }
+  const Bounds& GetBounds() const { return bounds; }
+
+private:
+  Mesh() = default;
+  Mesh(const std::string& n, size_t begin, size_t end);
+  Mesh(const Mesh&) = default;
+  ~Mesh() = default;
+  Mesh& operator=(const Mesh&) = default;
+
+private:
+  std::string name; ///< メッシュデータ名.
+  std::vector<std::string> textureList; ///< テクスチャ名のリスト.
+  size_t beginMaterial = 0; ///< 描画するマテリアルの先頭インデックス.
+  size_t endMaterial = 0; ///< 描画するマテリアルの終端インデックス.
+  Bounds bounds; ///< 全マテリアルを含む境界ボリューム.
+};
+
+/**
+* メッシュデータバッファ.
+*/
+class Buffer
+{
+public:
+  static BufferPtr Create(int vboSize, int iboSize);
+  Buffer(const Buffer&) = delete;
+  Buffer& operator=(const Buffer&) = delete;
+
+  bool LoadMeshFromFile(const char* filename);
+  const MeshPtr& GetMesh(const char* name) const;
+  const Material& GetMaterial(size_t index) const;
+  void BindVAO() const;
+
+  void PushLevel();
+  void PopLevel();
+  void ClearLevel();
+
+private:
+  Buffer() = default;
+  ~Buffer();
+
+private:
+  GLuint vbo = 0; ///< モデルの頂点データを格納するVBO.
+  GLuint ibo = 0; ///< モデルのインデックスデータを格納するIBO.
+  GLuint vao = 0; ///< モデル用VAO.
+
+  std::vector<Material> materialList; ///< マテリアルリスト.
+
+  struct Level {
+    GLintptr vboEnd = 0; ///< 読み込み済み頂点データの終端.
+    GLintptr iboEnd = 0; ///< 読み込み済みインデックスデータの終端.
+    size_t materialBaseOffset = 0; ///< マテリアルの格納開始位置.
+    std::unordered_map<std::string, MeshPtr> meshList; ///< メッシュリスト.
+  };
+  std::vector<Level> levelStack; ///< データスタック.
+  static const size_t minimalStackSize = 1;
+};
+
+} // namespace Mesh
+
 #endif // OPENGLTUTORIAL_SRC_MESH_H_INCLUDED
\ No newline at end of file
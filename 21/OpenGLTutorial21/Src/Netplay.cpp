@@ -0,0 +1,598 @@
+/**
+* @file Netplay.cpp
+*/
+#include "Netplay.h"
+#include <algorithm>
+#include <iostream>
+#include <cstddef>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace Netplay {
+
+typedef std::chrono::steady_clock Clock;
+
+static const uint32_t packetMagic = 0x4e504c31; ///< 入力パケットであることを示す値.
+static const uint32_t maxPacketInputs = 32; ///< 1つのパケットで送る入力の最大数.
+
+/**
+* 入力を送るパケット.
+*
+* inputは先頭のcount個だけが送られる.
+*/
+struct InputPacket
+{
+  uint32_t magic; ///< packetMagic.
+  uint32_t ackCount; ///< 送信側が受信済みの、受信側の入力の数.
+  uint32_t firstFrame; ///< input[0]のフレーム.
+  uint32_t count; ///< 入力の数.
+  uint32_t input[maxPacketInputs]; ///< firstFrameから連続するフレームの入力.
+};
+static const size_t packetHeaderSize = offsetof(InputPacket, input);
+static_assert(sizeof(InputPacket) <= maxPacketSize, "InputPacketがmaxPacketSizeを超えています");
+
+/**
+* 対になったループバック通信路を作成する.
+*
+* @param param 通信路の設定. 両方向に同じ設定が使われる.
+* @param a     bと対になったTransportを受け取る変数.
+* @param b     aと対になったTransportを受け取る変数.
+*/
+void LoopbackTransport::CreatePair(const LoopbackParameter& param, TransportPtr& a, TransportPtr& b)
+{
+  const ChannelPtr ab = std::make_shared<Channel>();
+  ab->param = param;
+  ab->rand.seed(param.seed);
+  const ChannelPtr ba = std::make_shared<Channel>();
+  ba->param = param;
+  ba->rand.seed(param.seed + 1);
+  a.reset(new LoopbackTransport(ab, ba));
+  b.reset(new LoopbackTransport(ba, ab));
+}
+
+/**
+* パケットを送信する.
+*
+* @param data 送信するデータ.
+* @param size データのバイト数.
+*
+* @retval true  送信成功. 通信路で失われた場合もtrueを返す.
+* @retval false データが大きすぎて送信できない.
+*/
+bool LoopbackTransport::Send(const void* data, size_t size)
+{
+  if (size > maxPacketSize) {
+    std::cerr << "WARNING in Netplay::LoopbackTransport::Send: パケットが大きすぎます(" << size << "バイト)." << std::endl;
+    return false;
+  }
+  Channel& channel = *sendChannel;
+  std::lock_guard<std::mutex> lock(channel.mutex);
+  const LoopbackParameter& param = channel.param;
+  if (param.lossRate > 0 && std::uniform_real_distribution<float>(0, 1)(channel.rand) < param.lossRate) {
+    return true;
+  }
+  double delay = param.latency;
+  if (param.jitter > 0) {
+    delay += std::uniform_real_distribution<double>(0, param.jitter)(channel.rand);
+  }
+  channel.packetList.emplace_back();
+  Packet& packet = channel.packetList.back();
+  packet.deliveryTime = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(delay));
+  packet.size = size;
+  std::memcpy(packet.data, data, size);
+  return true;
+}
+
+/**
+* パケットを受信する.
+*
+* @param buffer   受信したデータを格納するバッファ.
+* @param capacity bufferのバイト数. これより大きいパケットは切り詰められる.
+*
+* @return bufferに格納したバイト数. 受信できるパケットがなければ0.
+*
+* 配達時刻を過ぎたパケットのうち、最も早いものを返す.
+* 遅延にばらつきがあれば、送信した順序と入れ替わることがある.
+*/
+size_t LoopbackTransport::Receive(void* buffer, size_t capacity)
+{
+  Channel& channel = *receiveChannel;
+  std::lock_guard<std::mutex> lock(channel.mutex);
+  std::vector<Packet>& list = channel.packetList;
+  const auto itr = std::min_element(list.begin(), list.end(),
+    [](const Packet& lhs, const Packet& rhs) { return lhs.deliveryTime < rhs.deliveryTime; });
+  if (itr == list.end() || itr->deliveryTime > Clock::now()) {
+    return 0;
+  }
+  const size_t size = std::min(itr->size, capacity);
+  std::memcpy(buffer, itr->data, size);
+  // 取り出す順序は配達時刻で決まるので、リストの順序は保たなくてよい.
+  *itr = list.back();
+  list.pop_back();
+  return size;
+}
+
+#ifdef _WIN32
+typedef SOCKET SocketType; ///< ソケットの型.
+/// ソケットを閉じる.
+static void CloseSocket(intptr_t s) { closesocket(static_cast<SOCKET>(s)); }
+/// ソケット関数の失敗が、送受信できるデータがないことを示すならtrue.
+static bool IsWouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+#else
+typedef int SocketType;
+static void CloseSocket(intptr_t s) { close(static_cast<int>(s)); }
+static bool IsWouldBlock() { return errno == EWOULDBLOCK || errno == EAGAIN; }
+#endif
+
+/**
+* UDPで通信するTransportを作成する.
+*
+* @param localPort     受信に使うポート番号.
+* @param remoteAddress 送信先のIPv4アドレスを表す文字列. 例えば"127.0.0.1".
+* @param remotePort    送信先のポート番号.
+*
+* @return 作成したTransport. 作成できなければnullptr.
+*/
+TransportPtr UdpTransport::Create(uint16_t localPort, const char* remoteAddress, uint16_t remotePort)
+{
+  struct Impl : UdpTransport { Impl() {} ~Impl() {} };
+  std::shared_ptr<Impl> p = std::make_shared<Impl>();
+  if (!p->Init(localPort, remoteAddress, remotePort)) {
+    return {};
+  }
+  return p;
+}
+
+/**
+* デストラクタ.
+*/
+UdpTransport::~UdpTransport()
+{
+  if (socketHandle != -1) {
+    CloseSocket(socketHandle);
+  }
+#ifdef _WIN32
+  if (isStarted) {
+    WSACleanup();
+  }
+#endif
+}
+
+/**
+* ソケットを作成し、受信するポートに割り当てる.
+*
+* @param localPort     受信に使うポート番号.
+* @param address       送信先のIPv4アドレスを表す文字列.
+* @param port          送信先のポート番号.
+*
+* @retval true  初期化成功.
+* @retval false 初期化失敗.
+*/
+bool UdpTransport::Init(uint16_t localPort, const char* address, uint16_t port)
+{
+#ifdef _WIN32
+  WSADATA wsaData;
+  if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+    std::cerr << "ERROR in Netplay::UdpTransport::Init: Winsockを初期化できません." << std::endl;
+    return false;
+  }
+  isStarted = true;
+#endif
+
+  in_addr remote;
+  if (inet_pton(AF_INET, address, &remote) != 1) {
+    std::cerr << "ERROR in Netplay::UdpTransport::Init: アドレスが正しくありません(" << address << ")." << std::endl;
+    return false;
+  }
+  remoteAddress = remote.s_addr;
+  remotePort = htons(port);
+
+  const SocketType s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  socketHandle = static_cast<intptr_t>(s);
+#ifdef _WIN32
+  if (s == INVALID_SOCKET) {
+    socketHandle = -1;
+#else
+  if (s < 0) {
+#endif
+    std::cerr << "ERROR in Netplay::UdpTransport::Init: ソケットを作成できません." << std::endl;
+    return false;
+  }
+
+  sockaddr_in local = {};
+  local.sin_family = AF_INET;
+  local.sin_addr.s_addr = htonl(INADDR_ANY);
+  local.sin_port = htons(localPort);
+  if (bind(s, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0) {
+    std::cerr << "ERROR in Netplay::UdpTransport::Init: ポート" << localPort << "を使用できません." << std::endl;
+    return false;
+  }
+
+#ifdef _WIN32
+  // 相手がまだ起動していないと、ICMPの到達不能通知によって以後のrecvfromが失敗するので無効にする.
+  BOOL reportConnReset = FALSE;
+  DWORD bytesReturned = 0;
+  WSAIoctl(s, _WSAIOW(IOC_VENDOR, 12), &reportConnReset, sizeof(reportConnReset), nullptr, 0, &bytesReturned, nullptr, nullptr);
+  u_long nonBlocking = 1;
+  const bool isNonBlocking = ioctlsocket(s, FIONBIO, &nonBlocking) == 0;
+#else
+  const int flags = fcntl(s, F_GETFL, 0);
+  const bool isNonBlocking = flags >= 0 && fcntl(s, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+  if (!isNonBlocking) {
+    std::cerr << "ERROR in Netplay::UdpTransport::Init: ソケットをノンブロッキングにできません." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/**
+* パケットを送信する.
+*
+* @param data 送信するデータ.
+* @param size データのバイト数.
+*
+* @retval true  送信成功. 送信バッファが一杯などで送れなかった場合も、失われたものとしてtrueを返す.
+* @retval false データが大きすぎて送信できない.
+*/
+bool UdpTransport::Send(const void* data, size_t size)
+{
+  if (size > maxPacketSize) {
+    std::cerr << "WARNING in Netplay::UdpTransport::Send: パケットが大きすぎます(" << size << "バイト)." << std::endl;
+    return false;
+  }
+  sockaddr_in remote = {};
+  remote.sin_family = AF_INET;
+  remote.sin_addr.s_addr = remoteAddress;
+  remote.sin_port = remotePort;
+  sendto(static_cast<SocketType>(socketHandle), static_cast<const char*>(data), static_cast<int>(size), 0,
+    reinterpret_cast<const sockaddr*>(&remote), sizeof(remote));
+  return true;
+}
+
+/**
+* パケットを受信する.
+*
+* @param buffer   受信したデータを格納するバッファ.
+* @param capacity bufferのバイト数. これより大きいパケットは切り詰められる.
+*
+* @return bufferに格納したバイト数. 受信できるパケットがなければ0.
+*
+* 送信先以外のアドレスから届いたパケットは読み捨てて、次のパケットを調べる.
+*/
+size_t UdpTransport::Receive(void* buffer, size_t capacity)
+{
+  for (;;) {
+    sockaddr_in from = {};
+    socklen_t fromSize = sizeof(from);
+    const auto size = recvfrom(static_cast<SocketType>(socketHandle), static_cast<char*>(buffer), static_cast<int>(capacity), 0,
+      reinterpret_cast<sockaddr*>(&from), &fromSize);
+    if (size < 0) {
+#ifdef _WIN32
+      // 切り詰められたパケットは、バッファに入った分を返す.
+      if (WSAGetLastError() == WSAEMSGSIZE) {
+        return capacity;
+      }
+#endif
+      if (!IsWouldBlock()) {
+        std::cerr << "WARNING in Netplay::UdpTransport::Receive: 受信に失敗しました." << std::endl;
+      }
+      return 0;
+    }
+    if (from.sin_addr.s_addr != remoteAddress || from.sin_port != remotePort) {
+      continue;
+    }
+    return static_cast<size_t>(size);
+  }
+}
+
+/**
+* セッションを開始する.
+*
+* @param transport   相手との通信に使うTransport.
+* @param localPlayer ローカルのプレイヤーの番号(0～maxPlayerCount-1).
+* @param inputDelay  入力遅延のフレーム数(0～maxInputDelay).
+*                    入力をこのフレーム数だけ後のフレームで使うことで、相手に届くまでの猶予を作り、ロールバックを減らす.
+*
+* @retval true  開始成功.
+* @retval false 引数が正しくない.
+*
+* 最初のinputDelayフレームの入力は、両方のプレイヤーとも何も押していないものとして扱う.
+*/
+bool Session::Start(const TransportPtr& transport, int localPlayer, int inputDelay)
+{
+  if (!transport) {
+    std::cerr << "WARNING in Netplay::Session::Start: Transportが指定されていません." << std::endl;
+    return false;
+  }
+  if (localPlayer < 0 || localPlayer >= maxPlayerCount) {
+    std::cerr << "WARNING in Netplay::Session::Start: " << localPlayer << "は無効なプレイヤー番号です." << std::endl;
+    return false;
+  }
+  if (inputDelay < 0 || inputDelay > maxInputDelay) {
+    std::cerr << "WARNING in Netplay::Session::Start: 入力遅延は0～" << maxInputDelay << "の範囲で指定してください." << std::endl;
+    return false;
+  }
+  this->transport = transport;
+  this->localPlayer = localPlayer;
+  frame = 0;
+  localCount = static_cast<uint32_t>(inputDelay);
+  remoteCount = 0;
+  ackCount = 0;
+  rollbackFrame = noRollback;
+  std::fill(std::begin(localInput), std::end(localInput), 0);
+  std::fill(std::begin(remoteInput), std::end(remoteInput), 0);
+  std::fill(std::begin(usedRemoteInput), std::end(usedRemoteInput), 0);
+  stats = Statistics();
+  return true;
+}
+
+/**
+* セッションを終了する.
+*/
+void Session::Stop()
+{
+  transport.reset();
+}
+
+/**
+* フレームを開始する.
+*
+* @param localButtons ローカルのプレイヤーの入力.
+*
+* @retval true  フレームを進められる.
+* @retval false 相手の入力が遅れているので、このフレームは進めない. localButtonsは使われない.
+*
+* 相手の入力を受信し、予測と違う入力があればロールバックが必要になる.
+* ローカルの入力は入力遅延の分だけ後のフレームに登録され、まだ相手に届いていない入力とまとめて送信される.
+*/
+bool Session::BeginFrame(uint32_t localButtons)
+{
+  Poll();
+  if (frame >= remoteCount + maxRollbackFrames) {
+    ++stats.stallCount;
+    SendInputs();
+    return false;
+  }
+  localInput[localCount % historySize] = localButtons;
+  ++localCount;
+  SendInputs();
+  return true;
+}
+
+/**
+* フレームのシミュレーションに使う入力を取得する.
+*
+* @param frame 入力を取得するフレーム.
+* @param pads  入力を格納する、maxPlayerCount要素の配列.
+*
+* 相手の入力が届いていなければ、最後に届いた入力が続くと予測する.
+* 使った入力は記録され、後から届いた入力と比べてロールバックが必要か判断するのに使われる.
+* buttonDownは前のフレームの入力と比べて作るので、再シミュレーションでも同じ値になる.
+*/
+void Session::GamePads(uint32_t frame, GamePad* pads)
+{
+  uint32_t remote = 0;
+  if (frame < remoteCount) {
+    remote = remoteInput[frame % historySize];
+  } else if (remoteCount) {
+    remote = remoteInput[(remoteCount - 1) % historySize];
+  }
+  usedRemoteInput[frame % historySize] = remote;
+  for (int i = 0; i < maxPlayerCount; ++i) {
+    const uint32_t buttons = Input(i, frame);
+    const uint32_t prevButtons = frame ? Input(i, frame - 1) : 0;
+    pads[i].buttons = buttons;
+    pads[i].buttonDown = buttons & ~prevButtons;
+  }
+}
+
+/**
+* フレームを終了する.
+*
+* 再シミュレーションは済んでいるものとして、ロールバックの要求を取り消す.
+*/
+void Session::EndFrame()
+{
+  ++frame;
+  ++stats.frameCount;
+  rollbackFrame = noRollback;
+}
+
+/**
+* ロールバックの結果を記録する.
+*
+* @param frameCount 再シミュレーションしたフレーム数. ロールバックしなかったフレームでは0.
+* @param seconds    状態の復元と再シミュレーションにかかった時間(秒).
+*
+* 直前のフレームの値として毎フレーム記録するため、ロールバックしなかったフレームでも呼び出すこと.
+*/
+void Session::RecordRollback(int frameCount, double seconds)
+{
+  stats.lastRollbackFrames = frameCount;
+  stats.lastResimulateSeconds = seconds;
+  if (frameCount <= 0) {
+    return;
+  }
+  ++stats.rollbackCount;
+  stats.resimulatedFrameCount += frameCount;
+  stats.maxRollbackFrames = std::max(stats.maxRollbackFrames, frameCount);
+  stats.resimulateSeconds += seconds;
+  stats.maxResimulateSeconds = std::max(stats.maxResimulateSeconds, seconds);
+}
+
+/**
+* 届いているパケットを全て受信する.
+*
+* 確定済みの入力の次のフレームから連続する入力だけを受け取る.
+* 途中が欠けている場合、欠けた入力は後のパケットにも含まれているので、それを待つ.
+*/
+void Session::Poll()
+{
+  InputPacket packet;
+  for (;;) {
+    const size_t size = transport->Receive(&packet, sizeof(packet));
+    if (!size) {
+      break;
+    }
+    ++stats.receivedPacketCount;
+    if (size < packetHeaderSize || packet.magic != packetMagic || packet.count > maxPacketInputs ||
+      size != packetHeaderSize + packet.count * sizeof(uint32_t)) {
+      ++stats.invalidPacketCount;
+      continue;
+    }
+    // 順序が入れ替わって古いパケットが後から届くことがあるので、減らす方向には更新しない.
+    if (packet.ackCount > ackCount && packet.ackCount <= localCount) {
+      ackCount = packet.ackCount;
+    }
+    for (uint32_t i = 0; i < packet.count; ++i) {
+      const uint32_t inputFrame = packet.firstFrame + i;
+      if (inputFrame < remoteCount) {
+        continue;
+      }
+      // 履歴に収まらない先の入力は、フレームが進んでから受け取り直す.
+      if (inputFrame > remoteCount || inputFrame + maxRollbackFrames + 1 >= frame + historySize) {
+        break;
+      }
+      const uint32_t buttons = packet.input[i];
+      remoteInput[inputFrame % historySize] = buttons;
+      if (inputFrame < frame && usedRemoteInput[inputFrame % historySize] != buttons && inputFrame < rollbackFrame) {
+        rollbackFrame = inputFrame;
+      }
+      ++remoteCount;
+    }
+  }
+}
+
+/**
+* 相手が受信していないローカルの入力を送信する.
+*
+* 入力が1つもなくても、受信済みの入力の数を知らせるために送信する.
+*/
+void Session::SendInputs()
+{
+  InputPacket packet;
+  uint32_t first = localCount > maxPacketInputs ? localCount - maxPacketInputs : 0;
+  first = std::max(first, ackCount);
+  packet.magic = packetMagic;
+  packet.ackCount = remoteCount;
+  packet.firstFrame = first;
+  packet.count = localCount - first;
+  for (uint32_t i = 0; i < packet.count; ++i) {
+    packet.input[i] = localInput[(first + i) % historySize];
+  }
+  if (transport->Send(&packet, packetHeaderSize + packet.count * sizeof(uint32_t))) {
+    ++stats.sentPacketCount;
+  }
+}
+
+/**
+* プレイヤーの入力を取得する.
+*
+* @param player プレイヤーの番号.
+* @param frame  入力を取得するフレーム.
+*
+* @return playerのframeにおける入力. 相手の入力はシミュレーションに使ったもの(予測を含む)を返す.
+*/
+uint32_t Session::Input(int player, uint32_t frame) const
+{
+  if (player == localPlayer) {
+    return localInput[frame % historySize];
+  }
+  return usedRemoteInput[frame % historySize];
+}
+
+/**
+* 模擬的な通信相手を開始する.
+*
+* @param transport    相手との通信に使うTransport.
+* @param player       このプレイヤーの番号.
+* @param inputDelay   入力遅延のフレーム数.
+* @param frameSeconds 1フレームの長さ(秒).
+* @param seed         押すボタンを決める乱数の種.
+*
+* @retval true  開始成功.
+* @retval false 開始失敗.
+*/
+bool ScriptedPeer::Start(const TransportPtr& transport, int player, int inputDelay, double frameSeconds, uint32_t seed)
+{
+  Stop();
+  if (!session.Start(transport, player, inputDelay)) {
+    return false;
+  }
+  isQuitting = false;
+  thread = std::thread(&ScriptedPeer::ThreadMain, this, frameSeconds, seed);
+  return true;
+}
+
+/**
+* 模擬的な通信相手を終了する.
+*/
+void ScriptedPeer::Stop()
+{
+  if (thread.joinable()) {
+    isQuitting = true;
+    thread.join();
+  }
+  session.Stop();
+}
+
+/**
+* フレームを進めるスレッドの処理.
+*
+* @param frameSeconds 1フレームの長さ(秒).
+* @param seed         押すボタンを決める乱数の種.
+*
+* ランダムに選んだボタンを一定フレーム押し続ける. 押し替えたフレームは相手の予測が外れるので、ロールバックが起きる.
+*/
+void ScriptedPeer::ThreadMain(double frameSeconds, uint32_t seed)
+{
+  static const uint32_t buttonList[] = {
+    0,
+    GamePad::DPAD_LEFT,
+    GamePad::DPAD_RIGHT,
+    GamePad::DPAD_UP,
+    GamePad::DPAD_DOWN,
+    GamePad::A,
+    GamePad::A | GamePad::DPAD_LEFT,
+    GamePad::A | GamePad::DPAD_RIGHT,
+  };
+  static const size_t buttonCount = sizeof(buttonList) / sizeof(buttonList[0]);
+
+  std::mt19937 rand(seed);
+  std::uniform_int_distribution<size_t> rndButton(0, buttonCount - 1);
+  std::uniform_int_distribution<int> rndHoldFrames(10, 60);
+  uint32_t buttons = 0;
+  int holdFrames = 0;
+  const Clock::duration interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(frameSeconds));
+  Clock::time_point nextTime = Clock::now();
+  while (!isQuitting) {
+    if (holdFrames <= 0) {
+      buttons = buttonList[rndButton(rand)];
+      holdFrames = rndHoldFrames(rand);
+    }
+    if (session.BeginFrame(buttons)) {
+      --holdFrames;
+      session.EndFrame();
+    }
+    nextTime += interval;
+    std::this_thread::sleep_until(nextTime);
+  }
+}
+
+} // namespace Netplay
\ No newline at end of file
@@ -0,0 +1,228 @@
+/**
+* @file Netplay.h
+*/
+#ifndef NETPLAY_H_INCLUDED
+#define NETPLAY_H_INCLUDED
+#include "GamePad.h"
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <cstdint>
+
+/**
+* ロールバック方式の通信対戦を扱う名前空間.
+*/
+namespace Netplay {
+
+static const int maxPlayerCount = 2; ///< 参加できるプレイヤーの数.
+static const int maxRollbackFrames = 8; ///< 予測で進められるフレーム数. 1回のロールバックで再シミュレーションする最大フレーム数でもある.
+static const int maxInputDelay = 8; ///< 入力遅延の最大フレーム数.
+static const size_t maxPacketSize = 256; ///< 送受信するパケットの最大バイト数.
+
+/**
+* パケットの送受信を行うインターフェイス.
+*
+* 信頼性のないデータグラム通信を想定する. パケットは失われたり、順序が入れ替わったりしてもよい.
+*/
+class Transport
+{
+public:
+  Transport() = default;
+  virtual ~Transport() = default;
+  Transport(const Transport&) = delete;
+  Transport& operator=(const Transport&) = delete;
+
+  virtual bool Send(const void* data, size_t size) = 0;
+  virtual size_t Receive(void* buffer, size_t capacity) = 0;
+};
+typedef std::shared_ptr<Transport> TransportPtr;
+
+/**
+* ループバック通信路の設定.
+*/
+struct LoopbackParameter
+{
+  double latency = 0; ///< 片道の遅延(秒).
+  double jitter = 0; ///< 遅延に加えるばらつきの最大値(秒).
+  float lossRate = 0; ///< パケットが失われる確率.
+  uint32_t seed = 1; ///< 遅延のばらつきと欠落を決める乱数の種.
+};
+
+/**
+* プロセス内で対になった相手にパケットを届けるTransport.
+*
+* 遅延・ばらつき・欠落を模擬できるので、ネットワークがなくても通信対戦の動作を確かめられる.
+* 送信と受信は別のスレッドから呼び出してもよい.
+*/
+class LoopbackTransport : public Transport
+{
+public:
+  static void CreatePair(const LoopbackParameter& param, TransportPtr& a, TransportPtr& b);
+
+  bool Send(const void* data, size_t size) override;
+  size_t Receive(void* buffer, size_t capacity) override;
+
+private:
+  /// 配達待ちのパケット.
+  struct Packet {
+    std::chrono::steady_clock::time_point deliveryTime; ///< 受信できるようになる時刻.
+    size_t size; ///< データのバイト数.
+    uint8_t data[maxPacketSize]; ///< データ.
+  };
+
+  /// 一方向の通信路.
+  struct Channel {
+    std::mutex mutex;
+    LoopbackParameter param; ///< 通信路の設定.
+    std::mt19937 rand; ///< 遅延のばらつきと欠落を決める乱数.
+    std::vector<Packet> packetList; ///< 配達待ちのパケットのリスト.
+  };
+  typedef std::shared_ptr<Channel> ChannelPtr;
+
+  LoopbackTransport(const ChannelPtr& send, const ChannelPtr& receive) : sendChannel(send), receiveChannel(receive) {}
+
+  ChannelPtr sendChannel; ///< 送信に使う通信路.
+  ChannelPtr receiveChannel; ///< 受信に使う通信路.
+};
+
+/**
+* UDPでパケットを送受信するTransport.
+*
+* ノンブロッキングのソケットを使うので、受信できるパケットがなければReceive()はすぐに0を返す.
+* 送信先は作成時に指定した1つのアドレスだけで、それ以外から届いたパケットは捨てる.
+* 同じマシンで2つのプログラムを起動し、127.0.0.1で互いのポートを指定すれば一人で試せる.
+*/
+class UdpTransport : public Transport
+{
+public:
+  static TransportPtr Create(uint16_t localPort, const char* remoteAddress, uint16_t remotePort);
+
+  bool Send(const void* data, size_t size) override;
+  size_t Receive(void* buffer, size_t capacity) override;
+
+private:
+  UdpTransport() = default;
+  ~UdpTransport();
+
+  bool Init(uint16_t localPort, const char* remoteAddress, uint16_t remotePort);
+
+  intptr_t socketHandle = -1; ///< ソケット. 作成していなければ-1.
+  uint32_t remoteAddress = 0; ///< 送信先のIPv4アドレス(ネットワークバイト順).
+  uint16_t remotePort = 0; ///< 送信先のポート番号(ネットワークバイト順).
+  bool isStarted = false; ///< ソケットライブラリを初期化していればtrue.
+};
+
+/**
+* 通信対戦の統計.
+*/
+struct Statistics
+{
+  uint64_t frameCount = 0; ///< 進めたフレーム数.
+  uint64_t stallCount = 0; ///< 相手の入力を待つためにフレームを進めなかった回数.
+  uint64_t rollbackCount = 0; ///< ロールバックした回数.
+  uint64_t failedRollbackCount = 0; ///< 状態を復元できずにロールバックを諦めた回数.
+  uint64_t resimulatedFrameCount = 0; ///< 再シミュレーションしたフレーム数の合計.
+  int maxRollbackFrames = 0; ///< 1回のロールバックで再シミュレーションしたフレーム数の最大値.
+  double resimulateSeconds = 0; ///< 状態の復元と再シミュレーションにかかった時間の合計(秒).
+  double maxResimulateSeconds = 0; ///< 1フレームの状態の復元と再シミュレーションにかかった時間の最大値(秒).
+  int lastRollbackFrames = 0; ///< 直前のフレームで再シミュレーションしたフレーム数.
+  double lastResimulateSeconds = 0; ///< 直前のフレームの状態の復元と再シミュレーションにかかった時間(秒).
+  uint64_t sentPacketCount = 0; ///< 送信したパケットの数.
+  uint64_t receivedPacketCount = 0; ///< 受信したパケットの数.
+  uint64_t invalidPacketCount = 0; ///< 形式が正しくないため捨てたパケットの数.
+};
+
+/**
+* ロールバック方式の通信対戦のセッション.
+*
+* 各プレイヤーの入力(ボタンのビット列)だけを交換し、シミュレーションはそれぞれのマシンで行う.
+* 相手の入力が届いていないフレームは、最後に届いた入力が続くと予測して進める.
+* 後から届いた入力が予測と違っていたら、そのフレームの状態に戻して現在まで再シミュレーションする.
+* 予測で進めるのはmaxRollbackFramesまでで、それ以上相手の入力が遅れたら届くまでフレームを進めない.
+*
+* 入力は届いていない可能性のあるものをまとめて毎回送るので、パケットが失われても次のパケットで補われる.
+* パケットは同じプログラム同士で交換する前提で、バイト順などの変換は行わない.
+*
+* 使い方(1フレームごと):
+* -# BeginFrame()でローカルの入力を渡す. falseが返ったらこのフレームは進めない.
+* -# IsRollbackNeeded()がtrueなら、RollbackFrame()の状態を復元し、Frame()の直前までを再シミュレーションする.
+* -# GamePads()で得た入力を使ってFrame()のシミュレーションを行う.
+* -# EndFrame()を呼ぶ.
+*/
+class Session
+{
+public:
+  Session() = default;
+  ~Session() = default;
+  Session(const Session&) = delete;
+  Session& operator=(const Session&) = delete;
+
+  bool Start(const TransportPtr& transport, int localPlayer, int inputDelay);
+  void Stop();
+  bool IsRunning() const { return transport != nullptr; }
+  int LocalPlayer() const { return localPlayer; }
+
+  bool BeginFrame(uint32_t localButtons);
+  bool IsRollbackNeeded() const { return rollbackFrame != noRollback; }
+  uint32_t RollbackFrame() const { return rollbackFrame; }
+  uint32_t Frame() const { return frame; }
+  void GamePads(uint32_t frame, GamePad* pads);
+  void EndFrame();
+
+  void RecordRollback(int frameCount, double seconds);
+  void RecordFailedRollback() { ++stats.failedRollbackCount; }
+  const Statistics& Stats() const { return stats; }
+
+private:
+  static const uint32_t historySize = 64; ///< 入力履歴の長さ. 2のべき乗.
+  static const uint32_t noRollback = ~0U; ///< ロールバックが不要なことを示すフレーム番号.
+
+  void Poll();
+  void SendInputs();
+  uint32_t Input(int player, uint32_t frame) const;
+
+  TransportPtr transport; ///< パケットの送受信に使うTransport.
+  int localPlayer = 0; ///< ローカルのプレイヤーの番号.
+  uint32_t frame = 0; ///< 次にシミュレーションするフレーム.
+  uint32_t localCount = 0; ///< 登録したローカルの入力の数.
+  uint32_t remoteCount = 0; ///< 確定した相手の入力の数.
+  uint32_t ackCount = 0; ///< 相手が受信済みのローカルの入力の数.
+  uint32_t rollbackFrame = noRollback; ///< 再シミュレーションを始めるフレーム.
+  uint32_t localInput[historySize]; ///< ローカルの入力の履歴.
+  uint32_t remoteInput[historySize]; ///< 確定した相手の入力の履歴.
+  uint32_t usedRemoteInput[historySize]; ///< シミュレーションに使った相手の入力(予測を含む)の履歴.
+  Statistics stats; ///< 統計.
+};
+
+/**
+* 決まった規則でボタンを押すだけの、模擬的な通信相手.
+*
+* 別スレッドで一定間隔ごとにフレームを進め、Sessionを通して入力を送る. シミュレーションは行わない.
+* ロールバックとTransportの動作を、一人で確かめるために使う.
+*/
+class ScriptedPeer
+{
+public:
+  ScriptedPeer() = default;
+  ~ScriptedPeer() { Stop(); }
+  ScriptedPeer(const ScriptedPeer&) = delete;
+  ScriptedPeer& operator=(const ScriptedPeer&) = delete;
+
+  bool Start(const TransportPtr& transport, int player, int inputDelay, double frameSeconds, uint32_t seed);
+  void Stop();
+
+private:
+  void ThreadMain(double frameSeconds, uint32_t seed);
+
+  Session session; ///< 入力を送受信するセッション.
+  std::thread thread; ///< フレームを進めるスレッド.
+  std::atomic<bool> isQuitting; ///< trueならスレッドを終了させる.
+};
+
+} // namespace Netplay
+
+#endif // NETPLAY_H_INCLUDED
\ No newline at end of file
@@ -0,0 +1,523 @@
+/**
+* @file Particle.cpp
+*/
+#include "Particle.h"
+#include "GLState.h"
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#include <xmmintrin.h>
+#define PARTICLE_USE_SSE
+#endif
+
+/**
+* パーティクル機能を格納する名前空間.
+*/
+namespace Particle {
+
+/**
+* 描画用のインスタンスデータ(パーティクルごと).
+*
+* Particle.vertの頂点アトリビュートと一致させること.
+*/
+struct InstanceData
+{
+  glm::vec4 positionAndSize; ///< xyz=座標, w=大きさ.
+  glm::vec4 color; ///< 色.
+};
+
+static const size_t simdWidth = 4; ///< 一度に処理するパーティクルの数.
+static const int defaultTextureSize = 32; ///< 既定のテクスチャの幅と高さ.
+
+/**
+* パーティクルの数をSIMD命令の処理単位に切り上げる.
+*
+* @param n パーティクルの数.
+*
+* @return nを4の倍数に切り上げた値.
+*/
+static size_t RoundUp(size_t n)
+{
+  return (n + simdWidth - 1) / simdWidth * simdWidth;
+}
+
+/**
+* 寿命を等分したキーの列を線形補間する.
+*
+* @param key   キーの配列.
+* @param count キーの数.
+* @param t     経過時間を寿命で割った値(0～1).
+*
+* @return tにおける値.
+*/
+template<typename T>
+T EvaluateCurve(const T* key, int count, float t)
+{
+  const float x = std::min(t, 1.0f) * static_cast<float>(count - 1);
+  const int i = std::min(static_cast<int>(x), count - 1);
+  const int next = std::min(i + 1, count - 1);
+  const float fract = x - static_cast<float>(i);
+  return key[i] * (1 - fract) + key[next] * fract;
+}
+
+/**
+* パーティクルシステムを作成する.
+*
+* @param stream  インスタンスデータを書き込むストリーミングバッファ.
+* @param program ビルボード描画用シェーダ.
+*
+* @return 作成したパーティクルシステムへのポインタ.
+*/
+SystemPtr System::Create(const StreamBufferPtr& stream, const Shader::ProgramPtr& program)
+{
+  struct Impl : System { Impl() {} ~Impl() {} };
+  SystemPtr p = std::make_shared<Impl>();
+  if (!p || !p->Init(stream, program)) {
+    std::cerr << "ERROR: パーティクルシステムの作成に失敗" << std::endl;
+    return {};
+  }
+  return p;
+}
+
+/**
+* パーティクルシステムを初期化する.
+*
+* @param stream  インスタンスデータを書き込むストリーミングバッファ.
+* @param program ビルボード描画用シェーダ.
+*
+* @retval true  初期化成功.
+* @retval false 初期化失敗.
+*/
+bool System::Init(const StreamBufferPtr& stream, const Shader::ProgramPtr& program)
+{
+  if (!stream || !program) {
+    return false;
+  }
+  streamBuffer = stream;
+  this->program = program;
+
+  // 頂点アトリビュートは、描画のたびにストリーミングバッファ内の位置に合わせて設定する.
+  // 1インスタンスごとに1要素を進めることは変わらないので、ここで設定しておく.
+  vao.Init(streamBuffer->Id(), 0);
+  vao.Bind();
+  glVertexAttribDivisor(0, 1);
+  glVertexAttribDivisor(1, 1);
+  vao.Unbind();
+
+  // 中心から外側へなめらかに透明になる円形のテクスチャを作成する.
+  std::vector<uint32_t> image(defaultTextureSize * defaultTextureSize);
+  for (int y = 0; y < defaultTextureSize; ++y) {
+    for (int x = 0; x < defaultTextureSize; ++x) {
+      const glm::vec2 v = (glm::vec2(static_cast<float>(x), static_cast<float>(y)) + 0.5f) / (defaultTextureSize * 0.5f) - 1.0f;
+      const float a = std::max(0.0f, 1.0f - glm::dot(v, v));
+      image[y * defaultTextureSize + x] = (static_cast<uint32_t>(a * a * 255.0f) << 24) | 0x00ffffff;
+    }
+  }
+  defaultTexture = Texture::Create(defaultTextureSize, defaultTextureSize, GL_RGBA8, GL_RGBA, image.data());
+  if (!defaultTexture) {
+    return false;
+  }
+
+  rand.seed(std::random_device()());
+  return true;
+}
+
+/**
+* パーティクルの種類を登録する.
+*
+* @param desc 種類の設定.
+*
+* @return 登録した種類のID.
+*/
+TypeId System::RegisterType(const TypeDesc& desc)
+{
+  Pool pool;
+  pool.desc = desc;
+  TypeDesc& d = pool.desc;
+  if (d.sizeCurve.empty()) {
+    d.sizeCurve.push_back(1);
+  }
+  if (d.colorCurve.empty()) {
+    d.colorCurve.push_back(glm::vec4(1));
+  }
+  if (d.sizeCurve.size() > maxCurveKeyCount || d.colorCurve.size() > maxCurveKeyCount) {
+    std::cerr << "WARNING in Particle::System::RegisterType: キーが" << maxCurveKeyCount << "個を超えています. 超えた分は無視されます." << std::endl;
+    d.sizeCurve.resize(std::min<size_t>(d.sizeCurve.size(), maxCurveKeyCount));
+    d.colorCurve.resize(std::min<size_t>(d.colorCurve.size(), maxCurveKeyCount));
+  }
+  if (!d.texture) {
+    d.texture = defaultTexture;
+  }
+  d.lifetime = glm::max(d.lifetime, glm::vec2(0.001f));
+  d.direction = glm::normalize(d.direction);
+  pool.tangent = glm::normalize(glm::cross(d.direction, std::abs(d.direction.y) < 0.99f ? glm::vec3(0, 1, 0) : glm::vec3(1, 0, 0)));
+  pool.bitangent = glm::cross(d.direction, pool.tangent);
+  pool.cosSpread = std::cos(glm::clamp(d.spread, 0.0f, glm::pi<float>()));
+
+  const size_t n = RoundUp(d.capacity);
+  for (std::vector<float>* e : { &pool.posX, &pool.posY, &pool.posZ, &pool.velX, &pool.velY, &pool.velZ, &pool.age, &pool.ageRate }) {
+    e->resize(n, 0.0f);
+  }
+  poolList.push_back(std::move(pool));
+  return static_cast<TypeId>(poolList.size() - 1);
+}
+
+/**
+* 全てのパーティクルの種類を削除する.
+*
+* 全てのパーティクルとエミッターも削除される.
+*/
+void System::ClearTypes()
+{
+  poolList.clear();
+  emitterList.clear();
+}
+
+/**
+* パーティクルをまとめて放出する.
+*
+* @param typeId   放出するパーティクルの種類.
+* @param position 放出する座標.
+* @param count    放出する数.
+*
+* @return 実際に放出した数. プールに空きがなければcountより少なくなる.
+*/
+size_t System::Emit(TypeId typeId, const glm::vec3& position, size_t count)
+{
+  if (typeId < 0 || typeId >= static_cast<TypeId>(poolList.size())) {
+    std::cerr << "WARNING in Particle::System::Emit: " << typeId << "は無効な種類IDです." << std::endl;
+    return 0;
+  }
+  Pool& pool = poolList[typeId];
+  const TypeDesc& d = pool.desc;
+  count = std::min(count, d.capacity - pool.count);
+  std::uniform_real_distribution<float> cosRange(pool.cosSpread, 1.0f);
+  std::uniform_real_distribution<float> angleRange(0.0f, glm::two_pi<float>());
+  std::uniform_real_distribution<float> speedRange(d.speed.x, d.speed.y);
+  std::uniform_real_distribution<float> lifetimeRange(d.lifetime.x, d.lifetime.y);
+  for (size_t i = pool.count; i < pool.count + count; ++i) {
+    const float c = cosRange(rand);
+    const float s = std::sqrt(std::max(0.0f, 1.0f - c * c));
+    const float angle = angleRange(rand);
+    const glm::vec3 dir = d.direction * c + (pool.tangent * std::cos(angle) + pool.bitangent * std::sin(angle)) * s;
+    const glm::vec3 vel = dir * speedRange(rand);
+    pool.posX[i] = position.x;
+    pool.posY[i] = position.y;
+    pool.posZ[i] = position.z;
+    pool.velX[i] = vel.x;
+    pool.velY[i] = vel.y;
+    pool.velZ[i] = vel.z;
+    pool.age[i] = 0;
+    pool.ageRate[i] = 1.0f / lifetimeRange(rand);
+  }
+  pool.count += count;
+  return count;
+}
+
+/**
+* 継続的にパーティクルを放出するエミッターを追加する.
+*
+* @param typeId   放出するパーティクルの種類.
+* @param position 放出する座標.
+* @param rate     1秒あたりに放出する数.
+* @param duration 放出を続ける時間(秒). 負数なら無期限.
+*
+* @return 追加したエミッターのID. 追加できなければ-1.
+*/
+EmitterId System::AddEmitter(TypeId typeId, const glm::vec3& position, float rate, float duration)
+{
+  if (typeId < 0 || typeId >= static_cast<TypeId>(poolList.size())) {
+    std::cerr << "WARNING in Particle::System::AddEmitter: " << typeId << "は無効な種類IDです." << std::endl;
+    return -1;
+  }
+  auto itr = std::find_if(emitterList.begin(), emitterList.end(), [](const Emitter& e) { return !e.isActive; });
+  if (itr == emitterList.end()) {
+    itr = emitterList.insert(emitterList.end(), Emitter());
+  }
+  itr->typeId = typeId;
+  itr->position = position;
+  itr->rate = rate;
+  itr->duration = duration;
+  itr->accumulator = 0;
+  itr->isActive = true;
+  return static_cast<EmitterId>(itr - emitterList.begin());
+}
+
+/**
+* エミッターの座標を設定する.
+*
+* @param id       エミッターのID.
+* @param position 放出する座標.
+*/
+void System::EmitterPosition(EmitterId id, const glm::vec3& position)
+{
+  if (id >= 0 && id < static_cast<EmitterId>(emitterList.size())) {
+    emitterList[id].position = position;
+  }
+}
+
+/**
+* エミッターを削除する.
+*
+* @param id エミッターのID.
+*
+* 放出済みのパーティクルは寿命が尽きるまで残る.
+*/
+void System::RemoveEmitter(EmitterId id)
+{
+  if (id >= 0 && id < static_cast<EmitterId>(emitterList.size())) {
+    emitterList[id].isActive = false;
+  }
+}
+
+/**
+* 全てのパーティクルとエミッターを削除する.
+*
+* 登録した種類は削除されない.
+*/
+void System::Clear()
+{
+  for (Pool& pool : poolList) {
+    pool.count = 0;
+    pool.drawCount = 0;
+  }
+  emitterList.clear();
+}
+
+/**
+* 存在するパーティクルの数を取得する.
+*
+* @return 全ての種類のパーティクル数の合計.
+*/
+size_t System::ParticleCount() const
+{
+  size_t n = 0;
+  for (const Pool& pool : poolList) {
+    n += pool.count;
+  }
+  return n;
+}
+
+/**
+* パーティクルの状態を更新する.
+*
+* @param delta 前回の更新からの経過時間(秒).
+*
+* エミッターからの放出、移動、寿命の尽きたパーティクルの削除を行い、描画用のインスタンスデータを書き込む.
+* ストリーミングバッファのBeginFrame()からEndFrame()の間に呼び出すこと.
+*/
+void System::Update(double delta)
+{
+  const float dt = static_cast<float>(delta);
+  for (Emitter& e : emitterList) {
+    if (!e.isActive) {
+      continue;
+    }
+    e.accumulator += e.rate * dt;
+    const size_t n = static_cast<size_t>(e.accumulator);
+    e.accumulator -= static_cast<float>(n);
+    Emit(e.typeId, e.position, n);
+    if (e.duration >= 0) {
+      e.duration -= dt;
+      if (e.duration <= 0) {
+        e.isActive = false;
+      }
+    }
+  }
+
+  size_t particleCount = 0;
+  for (Pool& pool : poolList) {
+    // 速度に空気抵抗と加速度を適用してから、座標と経過時間を進める.
+    const size_t n = RoundUp(pool.count);
+    float* const posX = pool.posX.data();
+    float* const posY = pool.posY.data();
+    float* const posZ = pool.posZ.data();
+    float* const velX = pool.velX.data();
+    float* const velY = pool.velY.data();
+    float* const velZ = pool.velZ.data();
+    float* const age = pool.age.data();
+    const float* const ageRate = pool.ageRate.data();
+    const float damping = std::max(0.0f, 1.0f - pool.desc.drag * dt);
+    const glm::vec3 accel = pool.desc.acceleration * dt;
+#ifdef PARTICLE_USE_SSE
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vdamping = _mm_set1_ps(damping);
+    const __m128 ax = _mm_set1_ps(accel.x);
+    const __m128 ay = _mm_set1_ps(accel.y);
+    const __m128 az = _mm_set1_ps(accel.z);
+    for (size_t i = 0; i < n; i += simdWidth) {
+      const __m128 vx = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(velX + i), vdamping), ax);
+      const __m128 vy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(velY + i), vdamping), ay);
+      const __m128 vz = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(velZ + i), vdamping), az);
+      _mm_storeu_ps(velX + i, vx);
+      _mm_storeu_ps(velY + i, vy);
+      _mm_storeu_ps(velZ + i, vz);
+      _mm_storeu_ps(posX + i, _mm_add_ps(_mm_loadu_ps(posX + i), _mm_mul_ps(vx, vdt)));
+      _mm_storeu_ps(posY + i, _mm_add_ps(_mm_loadu_ps(posY + i), _mm_mul_ps(vy, vdt)));
+      _mm_storeu_ps(posZ + i, _mm_add_ps(_mm_loadu_ps(posZ + i), _mm_mul_ps(vz, vdt)));
+      _mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), _mm_mul_ps(_mm_loadu_ps(ageRate + i), vdt)));
+    }
+#else
+    for (size_t i = 0; i < n; ++i) {
+      velX[i] = velX[i] * damping + accel.x;
+      velY[i] = velY[i] * damping + accel.y;
+      velZ[i] = velZ[i] * damping + accel.z;
+      posX[i] += velX[i] * dt;
+      posY[i] += velY[i] * dt;
+      posZ[i] += velZ[i] * dt;
+      age[i] += ageRate[i] * dt;
+    }
+#endif
+
+    // 寿命の尽きたパーティクルを末尾のパーティクルで置き換えて削除する.
+    for (size_t i = 0; i < pool.count;) {
+      if (age[i] < 1.0f) {
+        ++i;
+        continue;
+      }
+      const size_t last = --pool.count;
+      posX[i] = posX[last];
+      posY[i] = posY[last];
+      posZ[i] = posZ[last];
+      velX[i] = velX[last];
+      velY[i] = velY[last];
+      velZ[i] = velZ[last];
+      age[i] = age[last];
+      pool.ageRate[i] = ageRate[last];
+    }
+
+    WriteInstanceData(pool);
+    particleCount += pool.count;
+  }
+  peakParticleCount = std::max(peakParticleCount, particleCount);
+}
+
+/**
+* 描画用のインスタンスデータをストリーミングバッファに書き込む.
+*
+* @param pool 書き込むパーティクルのプール.
+*
+* 大きさと色のキーの補間は、各キーからの距離で決まる三角形の重みの和として計算する.
+* 分岐や表引きがないため、4個のパーティクルをまとめて計算できる.
+* ストリーミングバッファに空きがなければ、このフレームでは描画しない.
+*/
+void System::WriteInstanceData(Pool& pool)
+{
+  pool.drawCount = 0;
+  if (pool.count == 0) {
+    return;
+  }
+  const size_t n = RoundUp(pool.count);
+  const StreamBuffer::Allocation a = streamBuffer->Allocate(sizeof(InstanceData) * n, sizeof(InstanceData));
+  if (!a) {
+    return;
+  }
+  InstanceData* const out = static_cast<InstanceData*>(a.pointer);
+  const float* const posX = pool.posX.data();
+  const float* const posY = pool.posY.data();
+  const float* const posZ = pool.posZ.data();
+  const float* const age = pool.age.data();
+  const std::vector<float>& sizeCurve = pool.desc.sizeCurve;
+  const std::vector<glm::vec4>& colorCurve = pool.desc.colorCurve;
+  const int sizeKeyCount = static_cast<int>(sizeCurve.size());
+  const int colorKeyCount = static_cast<int>(colorCurve.size());
+#ifdef PARTICLE_USE_SSE
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+  const __m128 sizeScale = _mm_set1_ps(static_cast<float>(sizeKeyCount - 1));
+  const __m128 colorScale = _mm_set1_ps(static_cast<float>(colorKeyCount - 1));
+  for (size_t i = 0; i < n; i += simdWidth) {
+    const __m128 t = _mm_min_ps(_mm_loadu_ps(age + i), one);
+
+    const __m128 xs = _mm_mul_ps(t, sizeScale);
+    __m128 size = zero;
+    for (int k = 0; k < sizeKeyCount; ++k) {
+      const __m128 d = _mm_andnot_ps(signMask, _mm_sub_ps(xs, _mm_set1_ps(static_cast<float>(k))));
+      const __m128 w = _mm_max_ps(_mm_sub_ps(one, d), zero);
+      size = _mm_add_ps(size, _mm_mul_ps(w, _mm_set1_ps(sizeCurve[k])));
+    }
+
+    const __m128 xc = _mm_mul_ps(t, colorScale);
+    __m128 r = zero, g = zero, b = zero, alpha = zero;
+    for (int k = 0; k < colorKeyCount; ++k) {
+      const __m128 d = _mm_andnot_ps(signMask, _mm_sub_ps(xc, _mm_set1_ps(static_cast<float>(k))));
+      const __m128 w = _mm_max_ps(_mm_sub_ps(one, d), zero);
+      const glm::vec4& key = colorCurve[k];
+      r = _mm_add_ps(r, _mm_mul_ps(w, _mm_set1_ps(key.x)));
+      g = _mm_add_ps(g, _mm_mul_ps(w, _mm_set1_ps(key.y)));
+      b = _mm_add_ps(b, _mm_mul_ps(w, _mm_set1_ps(key.z)));
+      alpha = _mm_add_ps(alpha, _mm_mul_ps(w, _mm_set1_ps(key.w)));
+    }
+
+    // 要素ごとの並びから、パーティクルごとの並びに転置して書き込む.
+    __m128 x = _mm_loadu_ps(posX + i);
+    __m128 y = _mm_loadu_ps(posY + i);
+    __m128 z = _mm_loadu_ps(posZ + i);
+    _MM_TRANSPOSE4_PS(x, y, z, size);
+    _MM_TRANSPOSE4_PS(r, g, b, alpha);
+    InstanceData* p = out + i;
+    _mm_storeu_ps(&p[0].positionAndSize.x, x);
+    _mm_storeu_ps(&p[0].color.x, r);
+    _mm_storeu_ps(&p[1].positionAndSize.x, y);
+    _mm_storeu_ps(&p[1].color.x, g);
+    _mm_storeu_ps(&p[2].positionAndSize.x, z);
+    _mm_storeu_ps(&p[2].color.x, b);
+    _mm_storeu_ps(&p[3].positionAndSize.x, size);
+    _mm_storeu_ps(&p[3].color.x, alpha);
+  }
+#else
+  for (size_t i = 0; i < pool.count; ++i) {
+    const float size = EvaluateCurve(sizeCurve.data(), sizeKeyCount, age[i]);
+    out[i].positionAndSize = glm::vec4(posX[i], posY[i], posZ[i], size);
+    out[i].color = EvaluateCurve(colorCurve.data(), colorKeyCount, age[i]);
+  }
+#endif
+  pool.dataOffset = a.offset;
+  pool.drawCount = static_cast<GLsizei>(pool.count);
+}
+
+/**
+* パーティクルを描画する.
+*
+* @param viewIndex 表示するビューインデックス.
+*
+* 深度テストは行うが、深度バッファには書き込まない.
+* ブレンドの設定は変更したままになるため、必要なら呼び出し側で設定し直すこと.
+*/
+void System::Draw(int viewIndex) const
+{
+  const bool hasData = std::any_of(poolList.begin(), poolList.end(), [](const Pool& p) { return p.drawCount > 0; });
+  if (!hasData) {
+    return;
+  }
+  vao.Bind();
+  GLState::BindBuffer(GL_ARRAY_BUFFER, streamBuffer->Id());
+  GLState::Enable(GL_DEPTH_TEST);
+  GLState::Disable(GL_CULL_FACE);
+  GLState::Enable(GL_BLEND);
+  GLState::DepthMask(GL_FALSE);
+  program->UseProgram();
+  program->SetViewIndex(viewIndex);
+  for (const Pool& pool : poolList) {
+    if (pool.drawCount <= 0) {
+      continue;
+    }
+    vao.VertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), pool.dataOffset + offsetof(InstanceData, positionAndSize));
+    vao.VertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), pool.dataOffset + offsetof(InstanceData, color));
+    // 描画先のアルファ値は、不透明な物体が書き込んだ値のまま残す.
+    if (pool.desc.isAdditive) {
+      GLState::BlendFuncSeparate(GL_SRC_ALPHA, GL_ONE, GL_ZERO, GL_ONE);
+    } else {
+      GLState::BlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
+    }
+    program->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, pool.desc.texture->Id());
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, pool.drawCount);
+  }
+  GLState::DepthMask(GL_TRUE);
+  vao.Unbind();
+}
+
+} // namespace Particle
\ No newline at end of file
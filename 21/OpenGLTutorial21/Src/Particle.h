@@ -0,0 +1,129 @@
+/**
+* @file Particle.h
+*/
+#ifndef PARTICLE_H_INCLUDED
+#define PARTICLE_H_INCLUDED
+#include <GL/glew.h>
+#include "BufferObject.h"
+#include "StreamBuffer.h"
+#include "Shader.h"
+#include "Texture.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <vector>
+#include <memory>
+#include <random>
+
+namespace Particle {
+
+class System;
+typedef std::shared_ptr<System> SystemPtr; ///< パーティクルシステムポインタ型.
+typedef int TypeId; ///< パーティクルの種類のID.
+typedef int EmitterId; ///< エミッターのID.
+
+static const int maxCurveKeyCount = 8; ///< 大きさや色の変化を表すキーの最大数.
+
+/**
+* パーティクルの種類.
+*
+* 大きさと色は、寿命を等分した時点の値(キー)を並べて指定し、キーの間は線形補間する.
+* 例えばキーが3つなら、生成時・寿命の半分・消滅時の値になる.
+*/
+struct TypeDesc
+{
+  TexturePtr texture; ///< ビルボードに貼るテクスチャ. nullptrなら円形のぼかしテクスチャ.
+  glm::vec2 lifetime = glm::vec2(1); ///< 寿命の最小値と最大値(秒).
+  glm::vec3 direction = glm::vec3(0, 1, 0); ///< 放出する方向.
+  float spread = glm::pi<float>(); ///< 放出する方向からの最大の角度(ラジアン). πなら全方向に放出する.
+  glm::vec2 speed = glm::vec2(1); ///< 初速の最小値と最大値.
+  glm::vec3 acceleration = glm::vec3(0); ///< 加速度.
+  float drag = 0; ///< 空気抵抗. 1秒あたりに失われる速度の割合.
+  std::vector<float> sizeCurve = { 1 }; ///< 大きさの変化.
+  std::vector<glm::vec4> colorCurve = { glm::vec4(1) }; ///< 色の変化.
+  bool isAdditive = true; ///< trueなら加算合成、falseなら半透明合成で描画する.
+  size_t capacity = 4096; ///< 同時に存在できる数.
+};
+
+/**
+* パーティクルシステム.
+*
+* パーティクルは種類ごとのプールに、要素ごとの配列(SoA)として格納する.
+* 座標・速度・経過時間の更新と、大きさ・色の計算はSIMD命令で4個ずつまとめて行う.
+* 描画はカメラの方を向いたビルボードのインスタンス描画で、種類ごとに1回の描画命令になる.
+*
+* 使い方:
+* -# RegisterType()で種類を登録する.
+* -# Emit()でまとめて放出するか、AddEmitter()で継続的に放出するエミッターを追加する.
+* -# 毎フレームUpdate()で更新し、Draw()で描画する.
+*
+* Emit()などは並列更新中のエンティティの更新関数から呼び出してはならない.
+*/
+class System
+{
+public:
+  static SystemPtr Create(const StreamBufferPtr& stream, const Shader::ProgramPtr& program);
+
+  TypeId RegisterType(const TypeDesc& desc);
+  void ClearTypes();
+  size_t Emit(TypeId typeId, const glm::vec3& position, size_t count);
+  EmitterId AddEmitter(TypeId typeId, const glm::vec3& position, float rate, float duration = -1);
+  void EmitterPosition(EmitterId id, const glm::vec3& position);
+  void RemoveEmitter(EmitterId id);
+  void Clear();
+
+  void Update(double delta);
+  void Draw(int viewIndex) const;
+
+  size_t ParticleCount() const;
+  size_t PeakParticleCount() const { return peakParticleCount; }
+
+private:
+  System() = default;
+  ~System() = default;
+  System(const System&) = delete;
+  System& operator=(const System&) = delete;
+
+  /// 種類ごとのパーティクルのプール.
+  struct Pool {
+    TypeDesc desc; ///< 種類の設定.
+    glm::vec3 tangent; ///< 放出する方向に垂直な軸.
+    glm::vec3 bitangent; ///< 放出する方向とtangentに垂直な軸.
+    float cosSpread; ///< 放出する範囲の角度の余弦.
+    size_t count = 0; ///< 存在するパーティクルの数.
+
+    // 配列の長さは4の倍数に切り上げてあり、末尾の余った要素もまとめて処理する.
+    std::vector<float> posX, posY, posZ; ///< 座標.
+    std::vector<float> velX, velY, velZ; ///< 速度.
+    std::vector<float> age; ///< 生成からの経過時間を寿命で割った値. 1以上になると消滅する.
+    std::vector<float> ageRate; ///< 寿命の逆数.
+
+    GLintptr dataOffset = 0; ///< ストリーミングバッファ内のインスタンスデータのバイトオフセット.
+    GLsizei drawCount = 0; ///< 描画するインスタンスの数.
+  };
+
+  /// 継続的にパーティクルを放出するエミッター.
+  struct Emitter {
+    TypeId typeId = -1; ///< 放出するパーティクルの種類.
+    glm::vec3 position; ///< 放出する座標.
+    float rate = 0; ///< 1秒あたりに放出する数.
+    float duration = -1; ///< 残りの放出時間(秒). 負数なら無期限.
+    float accumulator = 0; ///< 放出しきれなかった端数.
+    bool isActive = false; ///< 使用中ならtrue.
+  };
+
+  bool Init(const StreamBufferPtr& stream, const Shader::ProgramPtr& program);
+  void WriteInstanceData(Pool& pool);
+
+  StreamBufferPtr streamBuffer; ///< インスタンスデータを書き込むストリーミングバッファ.
+  Shader::ProgramPtr program; ///< ビルボード描画用シェーダ.
+  VertexArrayObject vao; ///< インスタンスデータ用VAO.
+  TexturePtr defaultTexture; ///< テクスチャが指定されていない種類に使うテクスチャ.
+  std::vector<Pool> poolList; ///< 種類ごとのプール.
+  std::vector<Emitter> emitterList; ///< エミッターのリスト.
+  std::mt19937 rand; ///< 放出方向などを決める乱数.
+  size_t peakParticleCount = 0; ///< 同時に存在したパーティクル数の最大値.
+};
+
+} // namespace Particle
+
+#endif // PARTICLE_H_INCLUDED
\ No newline at end of file
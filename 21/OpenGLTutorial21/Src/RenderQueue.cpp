@@ -0,0 +1,202 @@
+/**
+* @file RenderQueue.cpp
+*/
+#include "RenderQueue.h"
+#include "GLState.h"
+#include <algorithm>
+#include <cstring>
+
+/// キーの各要素のビット数.
+static const int passBits = 4;
+static const int programBits = 12;
+static const int textureBits = 16;
+static const int meshBits = 15;
+static const int depthBits = 16;
+
+/**
+* 深度をソートキー用の整数に変換する.
+*
+* @param depth 視点からの距離.
+*
+* @return depthBitsビットの整数. 距離が大きいほど大きな値になる.
+*
+* 正の浮動小数点数はビット列を整数として比較しても大小関係が変わらないため、上位ビットをそのまま使う.
+*/
+static uint64_t QuantizeDepth(float depth)
+{
+  if (!(depth > 0)) {
+    return 0;
+  }
+  uint32_t bits;
+  memcpy(&bits, &depth, sizeof(bits));
+  return bits >> (32 - depthBits);
+}
+
+/**
+* キューを空にする.
+*
+* シェーダ・テクスチャ・メッシュの番号の割り当てもリセットされる.
+* 統計はリセットされないので、必要ならResetStats()を呼ぶこと.
+*/
+void RenderQueue::Clear()
+{
+  packetList.clear();
+  keyList.clear();
+  programIdMap.clear();
+  textureIdMap.clear();
+  meshIdMap.clear();
+}
+
+/**
+* キー用の番号を取得する.
+*
+* @param idMap 番号の対応表.
+* @param value 番号を取得する値.
+*
+* @return valueに対応する番号. 初めて現れた値には新しい番号を割り当てる.
+*/
+uint64_t RenderQueue::Id(std::unordered_map<uint64_t, uint64_t>& idMap, uint64_t value)
+{
+  return idMap.insert(std::make_pair(value, static_cast<uint64_t>(idMap.size()))).first->second;
+}
+
+/**
+* パケットを追加する.
+*
+* @param packet        追加するパケット.
+* @param pass          描画パス(0～15). 小さいパスから順に描画される. 視点インデックスとしてシェーダに渡される.
+* @param isTransparent 半透明ならtrue.
+* @param depth         視点からの距離.
+*/
+void RenderQueue::Push(const Packet& packet, int pass, bool isTransparent, float depth)
+{
+  const uint64_t programId = Id(programIdMap, reinterpret_cast<uintptr_t>(packet.program)) & ((1ULL << programBits) - 1);
+  const uint64_t textureId = Id(textureIdMap, (static_cast<uint64_t>(packet.texture[0]) << 32) | packet.texture[1]) & ((1ULL << textureBits) - 1);
+  const uint64_t meshId = Id(meshIdMap, reinterpret_cast<uintptr_t>(packet.mesh)) & ((1ULL << meshBits) - 1);
+  const uint64_t depthValue = QuantizeDepth(depth);
+
+  uint64_t key = static_cast<uint64_t>(pass & ((1 << passBits) - 1)) << (64 - passBits);
+  if (!isTransparent) {
+    key |= programId << (textureBits + meshBits + depthBits);
+    key |= textureId << (meshBits + depthBits);
+    key |= meshId << depthBits;
+    key |= depthValue;
+  } else {
+    key |= 1ULL << (63 - passBits);
+    key |= (((1ULL << depthBits) - 1) - depthValue) << (programBits + textureBits + meshBits);
+    key |= programId << (textureBits + meshBits);
+    key |= textureId << meshBits;
+    key |= meshId;
+  }
+  packetList.push_back(packet);
+  keyList.push_back(key);
+}
+
+/**
+* ソートキーを基数ソートする.
+*
+* 8ビットずつ下位から並べ替える. 全てのキーで値が等しい桁は並べ替えを省略する.
+* 結果はorderListとkeyListに格納される.
+*/
+void RenderQueue::Sort()
+{
+  const size_t count = keyList.size();
+  orderList.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    orderList[i] = static_cast<uint32_t>(i);
+  }
+  tmpKeyList.resize(count);
+  tmpOrderList.resize(count);
+  for (int shift = 0; shift < 64; shift += 8) {
+    size_t histogram[256] = {};
+    for (uint64_t key : keyList) {
+      ++histogram[(key >> shift) & 0xff];
+    }
+    if (histogram[(keyList[0] >> shift) & 0xff] == count) {
+      continue;
+    }
+    size_t offset = 0;
+    for (size_t& e : histogram) {
+      const size_t n = e;
+      e = offset;
+      offset += n;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      const size_t dest = histogram[(keyList[i] >> shift) & 0xff]++;
+      tmpKeyList[dest] = keyList[i];
+      tmpOrderList[dest] = orderList[i];
+    }
+    keyList.swap(tmpKeyList);
+    orderList.swap(tmpOrderList);
+  }
+}
+
+/**
+* パケットをソートして描画する.
+*
+* @param meshBuffer   描画に使用するメッシュバッファへのポインタ.
+* @param bindingPoint 頂点データを割り当てるUniformバッファのバインディング・ポイント.
+*
+* シェーダ・テクスチャ・UBOの範囲は、直前のパケットと異なる場合だけ設定する.
+* 実行後もパケットは残るので、次のフレームの前にClear()を呼ぶこと.
+*/
+void RenderQueue::Execute(const Mesh::BufferPtr& meshBuffer, GLuint bindingPoint)
+{
+  if (packetList.empty()) {
+    return;
+  }
+  Sort();
+
+  meshBuffer->BindVAO();
+  ++stats.bufferBindCount;
+
+  Shader::Program* program = nullptr;
+  int pass = -1;
+  GLuint texture[2] = { 0, 0 };
+  bool hasTexture[2] = { false, false };
+  GLuint ubo = 0;
+  GLintptr uboOffset = 0;
+  GLsizeiptr uboSize = 0;
+  for (size_t i = 0; i < orderList.size(); ++i) {
+    const Packet& p = packetList[orderList[i]];
+    const int packetPass = static_cast<int>(keyList[i] >> (64 - passBits));
+    if (p.program != program) {
+      program = p.program;
+      program->UseProgram();
+      ++stats.programBindCount;
+      pass = -1;
+    }
+    if (packetPass != pass) {
+      pass = packetPass;
+      program->SetViewIndex(pass);
+    }
+    const int unitCount = std::min(program->SamplerCount(), 2);
+    for (int unit = 0; unit < unitCount; ++unit) {
+      if (!hasTexture[unit] || p.texture[unit] != texture[unit]) {
+        program->BindTexture(GL_TEXTURE0 + unit, GL_TEXTURE_2D, p.texture[unit]);
+        texture[unit] = p.texture[unit];
+        hasTexture[unit] = true;
+        ++stats.textureBindCount;
+      }
+    }
+    program->SetGroupOffset(p.groupOffset);
+    if (!p.ubo) {
+      program->SetInstanceBase(p.instanceBase);
+    } else if (p.ubo != ubo || p.uboOffset != uboOffset || p.uboSize != uboSize) {
+      ubo = p.ubo;
+      uboOffset = p.uboOffset;
+      uboSize = p.uboSize;
+      GLState::BindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, ubo, uboOffset, uboSize);
+      ++stats.bufferBindCount;
+    }
+    const size_t materialCount = p.mesh->MaterialCount();
+    if (p.instanceCount > 0) {
+      p.mesh->DrawInstanced(meshBuffer, p.instanceCount);
+      stats.drawCallCountWithoutInstancing += materialCount * p.instanceCount;
+    } else {
+      p.mesh->Draw(meshBuffer);
+      stats.drawCallCountWithoutInstancing += materialCount;
+    }
+    stats.drawCallCount += materialCount;
+  }
+}
\ No newline at end of file
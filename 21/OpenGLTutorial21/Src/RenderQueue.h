@@ -0,0 +1,81 @@
+/**
+* @file RenderQueue.h
+*/
+#ifndef RENDERQUEUE_H_INCLUDED
+#define RENDERQUEUE_H_INCLUDED
+#include <GL/glew.h>
+#include "Mesh.h"
+#include "Shader.h"
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+/**
+* 描画命令を並べ替えて実行するキュー.
+*
+* 描画命令(パケット)には、パス・半透明かどうか・シェーダ・テクスチャ・メッシュ・深度から作った64ビットのソートキーを付ける.
+* Execute()はキーを基数ソートしてから、直前のパケットと異なる状態だけを設定して描画する.
+*
+* キーの構成(上位ビットから):
+* - 不透明:   パス(4) 半透明=0(1) シェーダ(12) テクスチャ(16) メッシュ(15) 深度(16)
+* - 半透明:   パス(4) 半透明=1(1) 反転した深度(16) シェーダ(12) テクスチャ(16) メッシュ(15)
+*
+* 不透明なパケットは状態ごとにまとめたうえで手前から奥へ、半透明なパケットは奥から手前へ描画される.
+* シェーダ・テクスチャ・メッシュの番号はClear()以降に現れた順に割り当てられる.
+* ビット数を超えた番号は切り詰められるが、並び順が変わるだけで描画結果には影響しない.
+*/
+class RenderQueue
+{
+public:
+  /// 描画命令.
+  struct Packet {
+    Shader::Program* program; ///< 描画に使うシェーダ.
+    GLuint texture[2]; ///< 描画に使うテクスチャ.
+    const Mesh::Mesh* mesh; ///< 描画するメッシュ.
+    GLuint ubo; ///< 頂点データを格納したバッファオブジェクト(UBOまたはストリーミングバッファ). 0ならinstanceBaseを使う.
+    GLintptr uboOffset; ///< バッファ内の頂点データのバイトオフセット.
+    GLsizeiptr uboSize; ///< 頂点データのバイト数.
+    GLsizei instanceCount; ///< インスタンスの数. 0ならインスタンス描画を使わない.
+    GLint instanceBase; ///< 詰めて格納したインスタンスデータの開始位置. uboが0の場合だけ使われる.
+    glm::vec3 groupOffset; ///< エンティティのグループに加える平行移動. シェーダのgroupOffsetに設定される.
+  };
+
+  /// 状態変更と描画の回数.
+  struct Statistics {
+    size_t programBindCount = 0; ///< シェーダを切り替えた回数.
+    size_t textureBindCount = 0; ///< テクスチャを割り当てた回数.
+    size_t bufferBindCount = 0; ///< VAOとUBOを割り当てた回数.
+    size_t drawCallCount = 0; ///< 描画コマンドの数.
+    size_t drawCallCountWithoutInstancing = 0; ///< インスタンス描画を使わなかった場合の描画コマンドの数.
+  };
+
+  RenderQueue() = default;
+  ~RenderQueue() = default;
+  RenderQueue(const RenderQueue&) = delete;
+  RenderQueue& operator=(const RenderQueue&) = delete;
+
+  void Clear();
+  void Push(const Packet& packet, int pass, bool isTransparent, float depth);
+  void Execute(const Mesh::BufferPtr& meshBuffer, GLuint bindingPoint);
+  size_t Size() const { return packetList.size(); }
+
+  const Statistics& Stats() const { return stats; }
+  void ResetStats() { stats = Statistics(); }
+
+private:
+  void Sort();
+  uint64_t Id(std::unordered_map<uint64_t, uint64_t>& idMap, uint64_t value);
+
+  std::vector<Packet> packetList; ///< パケットのリスト.
+  std::vector<uint64_t> keyList; ///< パケットのソートキーのリスト.
+  std::vector<uint32_t> orderList; ///< ソート済みのパケットの番号.
+  std::vector<uint64_t> tmpKeyList; ///< 基数ソート用の作業領域.
+  std::vector<uint32_t> tmpOrderList; ///< 基数ソート用の作業領域.
+  std::unordered_map<uint64_t, uint64_t> programIdMap; ///< シェーダからキー用の番号への対応表.
+  std::unordered_map<uint64_t, uint64_t> textureIdMap; ///< テクスチャの組からキー用の番号への対応表.
+  std::unordered_map<uint64_t, uint64_t> meshIdMap; ///< メッシュからキー用の番号への対応表.
+  Statistics stats; ///< ResetStats()以降の統計.
+};
+
+#endif // RENDERQUEUE_H_INCLUDED
\ No newline at end of file
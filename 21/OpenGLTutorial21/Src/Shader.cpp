@@ -1,273 +1,319 @@
-/**
-* @file Shader.cpp
-*/
-#include "Shader.h"
-#include <vector>
-#include <iostream>
-#include <cstdint>
-#include <stdio.h>
-#include <sys/stat.h>
-
-namespace Shader {
-
-/**
-* VF[_vO쐬.
-*
-* @param vsCode        _VF[_R[hւ̃|C^.
-* @param fsCode        tOgVF[_R[hւ̃|C^.
-*
-* @return 쐬vOIuWFNg.
-*/
-ProgramPtr Program::Create(const char* vsFilename, const char* fsFilename)
-{
-  struct Impl : Program { Impl() {} ~Impl() {} };
-  ProgramPtr p = std::make_shared<Impl>();
-  if (!p) {
-    std::cerr << "ERROR: vO'" << vsFilename << "'̍쐬Ɏs" << std::endl;
-    return {};
-  }
-  p->program = CreateProgramFromFile(vsFilename, fsFilename);
-  if (!p->program) {
-    return {};
-  }
-
-  GLint activeUniforms;
-  glGetProgramiv(p->program, GL_ACTIVE_UNIFORMS, &activeUniforms);
-  for (int i = 0; i < activeUniforms; ++i) {
-    GLint size;
-    GLenum type;
-    GLchar name[128];
-    glGetActiveUniform(p->program, i, sizeof(name), nullptr, &size, &type, name);
-    std::cout << "Uniform '" << name << "': size=" << size << " type=0x" << std::hex << type << std::endl;
-    if (type == GL_SAMPLER_2D) {
-      p->samplerLocation = glGetUniformLocation(p->program, name);
-      if (p->samplerLocation < 0) {
-        std::cerr << "ERROR: vO'" << vsFilename << "'̍쐬Ɏs" << std::endl;
-        return {};
-      }
-      p->samplerCount = size;
-      break;
-    }
-  }
-  p->viewIndexLocation = glGetUniformLocation(p->program, "viewIndex");
-  p->depthSamplerLocation = glGetUniformLocation(p->program, "depthSampler");
-
-  p->name = vsFilename;
-  p->name.resize(p->name.size() - 5);
-
-  return p;
-}
-
-/**
-* fXgN^.
-*/
-Program::~Program()
-{
-  if (program) {
-    glDeleteProgram(program);
-  }
-}
-
-/**
-* UniformubNoCfBOE|CgɊ蓖Ă.
-*
-* @param blockName    蓖ĂUniformubN̖O.
-* @param bindingPoint 蓖Đ̃oCfBOE|Cg.
-*
-* @retval true  蓖Đ.
-* @retval false 蓖Ďs.
-*/
-bool Program::UniformBlockBinding(const char* blockName, GLuint bindingPoint)
-{
-  const GLuint blockIndex = glGetUniformBlockIndex(program, blockName);
-  if (blockIndex == GL_INVALID_INDEX) {
-    std::cerr << "ERROR: UniformubN'" << blockName << "'܂" << std::endl;
-    return false;
-  }
-  glUniformBlockBinding(program, blockIndex, bindingPoint);
-  const GLenum result = glGetError();
-  if (result != GL_NO_ERROR) {
-    std::cerr << "ERROR: UniformubN'" << blockName << "'̃oChɎs" << std::endl;
-    return false;
-  }
-  return true;
-}
-
-/**
-* `pvOɐݒ肷.
-*/
-void Program::UseProgram()
-{
-  glUseProgram(program);
-  for (GLint i = 0; i < samplerCount; ++i) {
-    glUniform1i(samplerLocation + i, i);
-  }
-  if (depthSamplerLocation >= 0) {
-    glUniform1i(depthSamplerLocation, samplerCount);
-  }
-}
-
-/**
-* eNX`eNX`EC[WEjbgɊ蓖Ă.
-*
-* @param unit    蓖Đ̃eNX`EC[WEjbgԍ(GL_TEXTURE0`).
-* @param type    蓖ĂeNX`̎(GL_TEXTURE_1D, GL_TEXTURE_2D, etc).
-* @param texture 蓖ĂeNX`IuWFNg.
-*/
-void Program::BindTexture(GLenum unit, GLenum type, GLuint texture)
-{
-  if (unit >= GL_TEXTURE0 && unit < static_cast<GLenum>(GL_TEXTURE0 + samplerCount)) {
-    glActiveTexture(unit);
-    glBindTexture(type, texture);
-  }
-}
-
-/**
-* VhEeNX`eNX`EC[WEjbgɊ蓖Ă.
-*
-* @param type    蓖ĂeNX`̎(GL_TEXTURE_1D, GL_TEXTURE_2D, etc).
-* @param texture 蓖ĂeNX`IuWFNg.
-*/
-void Program::BindShadowTexture(GLenum type, GLuint texture)
-{
-  if (depthSamplerLocation >= 0) {
-    glActiveTexture(GL_TEXTURE0 + samplerCount);
-    glBindTexture(type, texture);
-  }
-}
-
-/**
-*
-*/
-void Program::SetViewIndex(int index)
-{
-  if (viewIndexLocation >= 0) {
-    glUniform1i(viewIndexLocation, index);
-  }
-}
-
-/**
-* VF[_R[hRpC.
-*
-* @param type VF[_̎.
-* @param string VF[_R[hւ̃|C^.
-*
-* @return 쐬VF[_IuWFNg.
-*/
-GLuint CompileShader(GLenum type, const GLchar* string)
-{
-	GLuint shader = glCreateShader(type);
-	glShaderSource(shader, 1, &string, nullptr);
-	glCompileShader(shader);
-	GLint compiled = 0;
-	glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
-	if (!compiled) {
-		GLint infoLen = 0;
-		glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLen);
-		if (infoLen) {
-			std::vector<char> buf;
-			buf.resize(infoLen);
-			if (static_cast<int>(buf.size()) >= infoLen) {
-				glGetShaderInfoLog(shader, infoLen, NULL, buf.data());
-				std::cerr << "ERROR: VF[_̃RpCɎs" << buf.data() << std::endl;
-			}
-			glDeleteShader(shader);
-		}
-		return 0;
-	}
-	return shader;
-}
-
-/**
-* VF[_vO쐬.
-*
-* @param vsCode _VF[_R[hւ̃|C^.
-* @param fsCode tOgVF[_R[hւ̃|C^.
-*
-* @return 쐬vOIuWFNg.
-*/
-GLuint CreateProgram(const GLchar* vsCode, const GLchar* fsCode)
-{
-	GLuint vs = CompileShader(GL_VERTEX_SHADER, vsCode);
-	GLuint fs = CompileShader(GL_FRAGMENT_SHADER, fsCode);
-	if (!vs || !fs) {
-		return 0;
-	}
-	GLuint program = glCreateProgram();
-	glAttachShader(program, fs);
-	glDeleteShader(fs);
-	glAttachShader(program, vs);
-	glDeleteShader(vs);
-	glLinkProgram(program);
-	GLint linkStatus = GL_FALSE;
-	glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
-	if (linkStatus != GL_TRUE) {
-		GLint infoLen = 0;
-		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLen);
-		if (infoLen) {
-			std::vector<char> buf;
-			buf.resize(infoLen);
-			if (static_cast<int>(buf.size()) >= infoLen) {
-				glGetProgramInfoLog(program, infoLen, NULL, buf.data());
-				std::cerr << "ERROR: VF[_̃NɎs" << buf.data() << std::endl;
-			}
-		}
-		glDeleteProgram(program);
-		return 0;
-	}
-	return program;
-}
-
-/**
-* t@Cǂݍ.
-*
-* @param filename ǂݍރt@C.
-* @param buf      ǂݍݐobt@.
-*
-* @retval true ǂݍݐ.
-* @retval false ǂݍݎs.
-*/
-bool ReadFile(const char* filename, std::vector<char>& buf)
-{
-	struct stat st;
-	if (stat(filename, &st)) {
-		return false;
-	}
-	FILE* fp = fopen(filename, "rb");
-	if (!fp) {
-		return false;
-	}
-	buf.resize(st.st_size + 1);
-	const size_t readSize = fread(buf.data(), 1, st.st_size, fp);
-	fclose(fp);
-	if (readSize != st.st_size) {
-		return false;
-	}
-	buf.back() = '\0';
-	return true;
-}
-
-/**
-* t@CVF[_vO쐬.
-*
-* @param vsCode _VF[_t@C.
-* @param fsCode tOgVF[_t@C.
-*
-* @return 쐬vOIuWFNg.
-*/
-GLuint CreateProgramFromFile(const char* vsFilename, const char* fsFilename)
-{
-	std::vector<char> vsBuf;
-	if (!ReadFile(vsFilename, vsBuf)) {
-		std::cerr << "ERROR in Shader::CreateProgramFromFile:\n" << vsFilename << "ǂݍ߂܂." << std::endl;
-		return 0;
-	}
-	std::vector<char> fsBuf;
-	if (!ReadFile(fsFilename, fsBuf)) {
-		std::cerr << "ERROR in Shader::CreateProgramFromFile:\n" << fsFilename << "ǂݍ߂܂." << std::endl;
-		return 0;
-	}
-	return CreateProgram(vsBuf.data(), fsBuf.data());
-}
-
+/**
+* @file Shader.cpp
+*/
+#include "Shader.h"
+#include "GLState.h"
+#include "Uniform.h"
+#include <vector>
+#include <iostream>
+#include <cstdint>
+#include <stdio.h>
+#include <sys/stat.h>
+
+namespace Shader {
+
+/**
+* シェーダプログラムを作成する.
+*
+* @param vsCode        頂点シェーダコードへのポインタ.
+* @param fsCode        フラグメントシェーダコードへのポインタ.
+*
+* @return 作成したプログラムオブジェクト.
+*/
+ProgramPtr Program::Create(const char* vsFilename, const char* fsFilename)
+{
+  struct Impl : Program { Impl() {} ~Impl() {} };
+  ProgramPtr p = std::make_shared<Impl>();
+  if (!p) {
+    std::cerr << "ERROR: プログラム'" << vsFilename << "'の作成に失敗" << std::endl;
+    return {};
+  }
+  p->program = CreateProgramFromFile(vsFilename, fsFilename);
+  if (!p->program) {
+    return {};
+  }
+
+  GLint activeUniforms;
+  glGetProgramiv(p->program, GL_ACTIVE_UNIFORMS, &activeUniforms);
+  for (int i = 0; i < activeUniforms; ++i) {
+    GLint size;
+    GLenum type;
+    GLchar name[128];
+    glGetActiveUniform(p->program, i, sizeof(name), nullptr, &size, &type, name);
+    std::cout << "Uniform '" << name << "': size=" << size << " type=0x" << std::hex << type << std::endl;
+    if (type == GL_SAMPLER_2D) {
+      p->samplerLocation = glGetUniformLocation(p->program, name);
+      if (p->samplerLocation < 0) {
+        std::cerr << "ERROR: プログラム'" << vsFilename << "'の作成に失敗" << std::endl;
+        return {};
+      }
+      p->samplerCount = size;
+      break;
+    }
+  }
+  p->viewIndexLocation = glGetUniformLocation(p->program, "viewIndex");
+  p->depthSamplerLocation = glGetUniformLocation(p->program, "depthSampler");
+  p->instanceBaseLocation = glGetUniformLocation(p->program, "instanceBase");
+  p->groupOffsetLocation = glGetUniformLocation(p->program, "groupOffset");
+  const GLint instanceDataLocation = glGetUniformLocation(p->program, "instanceData");
+
+  // サンプラーとユニットの対応は変わらないので、ここで一度だけ設定する.
+  GLState::UseProgram(p->program);
+  for (GLint i = 0; i < p->samplerCount; ++i) {
+    glUniform1i(p->samplerLocation + i, i);
+  }
+  if (p->depthSamplerLocation >= 0) {
+    glUniform1i(p->depthSamplerLocation, p->samplerCount);
+  }
+  if (instanceDataLocation >= 0) {
+    glUniform1i(instanceDataLocation, Uniform::instanceDataTextureUnit);
+  }
+
+  p->name = vsFilename;
+  p->name.resize(p->name.size() - 5);
+
+  return p;
+}
+
+/**
+* デストラクタ.
+*/
+Program::~Program()
+{
+  if (program) {
+    GLState::DeleteProgram(program);
+  }
+}
+
+/**
+* Uniformブロックをバインディング・ポイントに割り当てる.
+*
+* @param blockName    割り当てるUniformブロックの名前.
+* @param bindingPoint 割り当て先のバインディング・ポイント.
+*
+* @retval true  割り当て成功.
+* @retval false 割り当て失敗.
+*/
+bool Program::UniformBlockBinding(const char* blockName, GLuint bindingPoint)
+{
+  const GLuint blockIndex = glGetUniformBlockIndex(program, blockName);
+  if (blockIndex == GL_INVALID_INDEX) {
+    std::cerr << "ERROR: Uniformブロック'" << blockName << "'が見つかりません" << std::endl;
+    return false;
+  }
+  glUniformBlockBinding(program, blockIndex, bindingPoint);
+  const GLenum result = glGetError();
+  if (result != GL_NO_ERROR) {
+    std::cerr << "ERROR: Uniformブロック'" << blockName << "'のバインドに失敗" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/**
+* 描画用プログラムに設定する.
+*
+* サンプラーの設定はCreate()で済ませているので、ここではプログラムを切り替えるだけ.
+*/
+void Program::UseProgram()
+{
+  GLState::UseProgram(program);
+}
+
+/**
+* テクスチャをテクスチャ・イメージ・ユニットに割り当てる.
+*
+* @param unit    割り当て先のテクスチャ・イメージ・ユニット番号(GL_TEXTURE0～).
+* @param type    割り当てるテクスチャの種類(GL_TEXTURE_1D, GL_TEXTURE_2D, etc).
+* @param texture 割り当てるテクスチャオブジェクト.
+*/
+void Program::BindTexture(GLenum unit, GLenum type, GLuint texture)
+{
+  if (unit >= GL_TEXTURE0 && unit < static_cast<GLenum>(GL_TEXTURE0 + samplerCount)) {
+    GLState::BindTexture(unit, type, texture);
+  }
+}
+
+/**
+* シャドウテクスチャをテクスチャ・イメージ・ユニットに割り当てる.
+*
+* @param type    割り当てるテクスチャの種類(GL_TEXTURE_1D, GL_TEXTURE_2D, etc).
+* @param texture 割り当てるテクスチャオブジェクト.
+*/
+void Program::BindShadowTexture(GLenum type, GLuint texture)
+{
+  if (depthSamplerLocation >= 0) {
+    GLState::BindTexture(GL_TEXTURE0 + samplerCount, type, texture);
+  }
+}
+
+/**
+* 視点インデックスを設定する.
+*
+* @param index 視点インデックス.
+*
+* このプログラムが使用中であること. 値が変わらなければなにもしない.
+*/
+void Program::SetViewIndex(int index)
+{
+  if (viewIndexLocation >= 0 && viewIndex != index) {
+    glUniform1i(viewIndexLocation, index);
+    viewIndex = index;
+  }
+}
+
+/**
+* インスタンスデータの開始位置を設定する.
+*
+* @param base インスタンスデータ・バッファ内の、最初のインスタンスの要素番号.
+*
+* このプログラムが使用中であること. 値が変わらなければなにもしない.
+*/
+void Program::SetInstanceBase(GLint base)
+{
+  if (instanceBaseLocation >= 0 && instanceBase != base) {
+    glUniform1i(instanceBaseLocation, base);
+    instanceBase = base;
+  }
+}
+
+/**
+* グループの平行移動を設定する.
+*
+* @param offset エンティティのグループに加える平行移動.
+*
+* このプログラムが使用中であること. 値が変わらなければなにもしない.
+*/
+void Program::SetGroupOffset(const glm::vec3& offset)
+{
+  if (groupOffsetLocation >= 0 && groupOffset != offset) {
+    glUniform3fv(groupOffsetLocation, 1, &offset.x);
+    groupOffset = offset;
+  }
+}
+
+/**
+* シェーダコードをコンパイルする.
+*
+* @param type シェーダの種類.
+* @param string シェーダコードへのポインタ.
+*
+* @return 作成したシェーダオブジェクト.
+*/
+GLuint CompileShader(GLenum type, const GLchar* string)
+{
+	GLuint shader = glCreateShader(type);
+	glShaderSource(shader, 1, &string, nullptr);
+	glCompileShader(shader);
+	GLint compiled = 0;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+	if (!compiled) {
+		GLint infoLen = 0;
+		glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLen);
+		if (infoLen) {
+			std::vector<char> buf;
+			buf.resize(infoLen);
+			if (static_cast<int>(buf.size()) >= infoLen) {
+				glGetShaderInfoLog(shader, infoLen, NULL, buf.data());
+				std::cerr << "ERROR: シェーダのコンパイルに失敗" << buf.data() << std::endl;
+			}
+			glDeleteShader(shader);
+		}
+		return 0;
+	}
+	return shader;
+}
+
+/**
+* シェーダプログラムを作成する.
+*
+* @param vsCode 頂点シェーダコードへのポインタ.
+* @param fsCode フラグメントシェーダコードへのポインタ.
+*
+* @return 作成したプログラムオブジェクト.
+*/
+GLuint CreateProgram(const GLchar* vsCode, const GLchar* fsCode)
+{
+	GLuint vs = CompileShader(GL_VERTEX_SHADER, vsCode);
+	GLuint fs = CompileShader(GL_FRAGMENT_SHADER, fsCode);
+	if (!vs || !fs) {
+		return 0;
+	}
+	GLuint program = glCreateProgram();
+	glAttachShader(program, fs);
+	glDeleteShader(fs);
+	glAttachShader(program, vs);
+	glDeleteShader(vs);
+	glLinkProgram(program);
+	GLint linkStatus = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+	if (linkStatus != GL_TRUE) {
+		GLint infoLen = 0;
+		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLen);
+		if (infoLen) {
+			std::vector<char> buf;
+			buf.resize(infoLen);
+			if (static_cast<int>(buf.size()) >= infoLen) {
+				glGetProgramInfoLog(program, infoLen, NULL, buf.data());
+				std::cerr << "ERROR: シェーダのリンクに失敗" << buf.data() << std::endl;
+			}
+		}
+		glDeleteProgram(program);
+		return 0;
+	}
+	return program;
+}
+
+/**
+* ファイルを読み込む.
+*
+* @param filename 読み込むファイル名.
+* @param buf      読み込み先バッファ.
+*
+* @retval true 読み込み成功.
+* @retval false 読み込み失敗.
+*/
+bool ReadFile(const char* filename, std::vector<char>& buf)
+{
+	struct stat st;
+	if (stat(filename, &st)) {
+		return false;
+	}
+	FILE* fp = fopen(filename, "rb");
+	if (!fp) {
+		return false;
+	}
+	buf.resize(st.st_size + 1);
+	const size_t readSize = fread(buf.data(), 1, st.st_size, fp);
+	fclose(fp);
+	if (readSize != st.st_size) {
+		return false;
+	}
+	buf.back() = '\0';
+	return true;
+}
+
+/**
+* ファイルからシェーダプログラムを作成する.
+*
+* @param vsCode 頂点シェーダファイル名.
+* @param fsCode フラグメントシェーダファイル名.
+*
+* @return 作成したプログラムオブジェクト.
+*/
+GLuint CreateProgramFromFile(const char* vsFilename, const char* fsFilename)
+{
+	std::vector<char> vsBuf;
+	if (!ReadFile(vsFilename, vsBuf)) {
+		std::cerr << "ERROR in Shader::CreateProgramFromFile:\n" << vsFilename << "を読み込めません." << std::endl;
+		return 0;
+	}
+	std::vector<char> fsBuf;
+	if (!ReadFile(fsFilename, fsBuf)) {
+		std::cerr << "ERROR in Shader::CreateProgramFromFile:\n" << fsFilename << "を読み込めません." << std::endl;
+		return 0;
+	}
+	return CreateProgram(vsBuf.data(), fsBuf.data());
+}
+
 } // namespace Shader
\ No newline at end of file
@@ -1,49 +1,58 @@
-/**
-* @file Shader.h
-*/
-#ifndef SHADER_H_INCLUDED
-#define SHADER_H_INCLUDED
-#include <GL/glew.h>
-#include <string>
-#include <memory>
-
-namespace Shader {
-
-class Program;
-typedef std::shared_ptr<Program> ProgramPtr; ///< vOIuWFNg|C^^.
-
-/**
-* vOIuWFNg.
-*/
-class Program
-{
-public:
-  static ProgramPtr Create(const char* vsFilename, const char* fsFilename);
-
-  bool UniformBlockBinding(const char* blockName, GLuint bindingPoint);
-  void UseProgram();
-  void BindTexture(GLenum unit, GLenum type, GLuint texture);
-  void BindShadowTexture(GLenum type, GLuint texture);
-  void SetViewIndex(int index);
-
-private:
-  Program() = default;
-  ~Program();
-  Program(const Program&) = delete;
-  Program& operator=(const Program&) = delete;
-
-private:
-  GLuint program = 0; ///< vOIuWFNg.
-  GLint samplerLocation = -1; ///< Tv[̈ʒu.
-  int samplerCount = 0; ///< Tv[̐.
-  GLint viewIndexLocation = -1; ///< _CfbNẌʒu.
-  GLint depthSamplerLocation = -1; ///< [xTv[̈ʒu.
-  std::string name; ///< vO.
-};
-
-GLuint CreateProgram(const GLchar* vsCode, const GLchar* fsCode);
-GLuint CreateProgramFromFile(const char* vsFilename, const char* fsFilename);
-
-} // namespace Shader
-
+/**
+* @file Shader.h
+*/
+#ifndef SHADER_H_INCLUDED
+#define SHADER_H_INCLUDED
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <memory>
+
+namespace Shader {
+
+class Program;
+typedef std::shared_ptr<Program> ProgramPtr; ///< プログラムオブジェクトポインタ型.
+
+/**
+* プログラムオブジェクト.
+*/
+class Program
+{
+public:
+  static ProgramPtr Create(const char* vsFilename, const char* fsFilename);
+
+  bool UniformBlockBinding(const char* blockName, GLuint bindingPoint);
+  void UseProgram();
+  void BindTexture(GLenum unit, GLenum type, GLuint texture);
+  void BindShadowTexture(GLenum type, GLuint texture);
+  void SetViewIndex(int index);
+  void SetInstanceBase(GLint base);
+  void SetGroupOffset(const glm::vec3& offset);
+  int SamplerCount() const { return samplerCount; }
+
+private:
+  Program() = default;
+  ~Program();
+  Program(const Program&) = delete;
+  Program& operator=(const Program&) = delete;
+
+private:
+  GLuint program = 0; ///< プログラムオブジェクト.
+  GLint samplerLocation = -1; ///< サンプラーの位置.
+  int samplerCount = 0; ///< サンプラーの数.
+  GLint viewIndexLocation = -1; ///< 視点インデックスの位置.
+  int viewIndex = -1; ///< 設定済みの視点インデックス.
+  GLint depthSamplerLocation = -1; ///< 深度サンプラーの位置.
+  GLint instanceBaseLocation = -1; ///< インスタンスデータの開始位置の位置.
+  GLint instanceBase = -1; ///< 設定済みのインスタンスデータの開始位置.
+  GLint groupOffsetLocation = -1; ///< グループの平行移動の位置.
+  glm::vec3 groupOffset = glm::vec3(0); ///< 設定済みのグループの平行移動.
+  std::string name; ///< プログラム名.
+};
+
+GLuint CreateProgram(const GLchar* vsCode, const GLchar* fsCode);
+GLuint CreateProgramFromFile(const char* vsFilename, const char* fsFilename);
+
+} // namespace Shader
+
 #endif // SHADER_H_INCLUDED
\ No newline at end of file
@@ -0,0 +1,380 @@
+/**
+* @file Snapshot.cpp
+*/
+#include "Snapshot.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+
+namespace Entity {
+
+/// 保存と復元にかかった時間の計測に使う時計.
+typedef std::chrono::steady_clock Clock;
+
+/**
+* リソースの表から要素を検索し、なければ追加する.
+*
+* @param list 検索するリソースの表.
+* @param p    検索するリソース.
+*
+* @return listにおけるpの位置.
+*
+* 同じリソースを使うエンティティは続けて並ぶことが多いため、末尾から検索する.
+*/
+template<typename T>
+static size_t FindOrAdd(std::vector<std::shared_ptr<T>>& list, const std::shared_ptr<T>& p)
+{
+  for (size_t i = list.size(); i > 0; --i) {
+    if (list[i - 1] == p) {
+      return i - 1;
+    }
+  }
+  list.push_back(p);
+  return list.size() - 1;
+}
+
+/**
+* リソースの表の要素を設定する.
+*
+* @param dst   設定先.
+* @param list  リソースの表.
+* @param index listにおける設定するリソースの位置. 範囲外ならリソースを解除する.
+*
+* 参照カウントの操作を減らすため、同じリソースが設定されていれば何もしない.
+*/
+template<typename T>
+static void AssignResource(std::shared_ptr<T>& dst, const std::vector<std::shared_ptr<T>>& list, uint16_t index)
+{
+  if (index >= list.size()) {
+    if (dst) {
+      dst.reset();
+    }
+  } else if (dst != list[index]) {
+    dst = list[index];
+  }
+}
+
+/**
+* 配列の要素が占めるバイト数を計算する.
+*/
+template<typename T>
+static size_t Bytes(const std::vector<T>& v)
+{
+  return v.size() * sizeof(T);
+}
+
+/**
+* バッファの状態を保存する.
+*
+* @param buffer 保存するバッファ.
+*
+* @retval true  保存成功.
+* @retval false 更新中に呼び出されたか、リソースの種類が多すぎて保存できなかった.
+*/
+bool Snapshot::Save(Buffer& buffer)
+{
+  if (buffer.isUpdating) {
+    std::cerr << "WARNING in Entity::Snapshot::Save: 更新中は保存できません." << std::endl;
+    return false;
+  }
+  const Clock::time_point start = Clock::now();
+
+  // 保存したエンティティへのポインタが無効にならないよう、現在のページを解放しないようにする.
+  buffer.initialPageCount = std::max(buffer.initialPageCount, buffer.pageList.size());
+
+  if (source != &buffer) {
+    behaviorTableList.clear();
+    behaviorStateList.clear();
+  }
+  source = nullptr;
+
+  // グループデータは配列ごとにまとめてコピーする.
+  // エンティティごとの状態のうち、リソースと更新関数は表に集め、表の番号を記録する.
+  recordList.clear();
+  childList.clear();
+  funcList.clear();
+  meshList.clear();
+  textureList.clear();
+  programList.clear();
+  size_t uncopyableCount = 0;
+  for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
+    groups[groupId] = buffer.groups[groupId];
+    groupOffset[groupId] = buffer.groupOffset[groupId];
+    groupVelocity[groupId] = buffer.groupVelocity[groupId];
+    updateSlice[groupId] = buffer.updateSlice[groupId];
+    for (const Entity* e : groups[groupId].entity) {
+      EntityRecord r;
+      r.parent = e->parent;
+      r.archetype = e->archetype;
+      r.behaviorTable = e->behaviorTable;
+      r.behaviorIndex = e->behaviorIndex;
+      r.generation = e->generation;
+      r.firstChild = static_cast<uint32_t>(childList.size());
+      r.childCount = static_cast<uint32_t>(e->childList.size());
+      childList.insert(childList.end(), e->childList.begin(), e->childList.end());
+      r.updateFunc = noFunc;
+      if (e->updateFunc) {
+        if (e->updateFunc.IsCopyable()) {
+          r.updateFunc = static_cast<uint32_t>(funcList.size());
+          funcList.push_back(e->updateFunc.Clone());
+        } else {
+          ++uncopyableCount;
+        }
+      }
+      r.mesh = e->mesh ? static_cast<uint16_t>(FindOrAdd(meshList, e->mesh)) : noResource;
+      for (int i = 0; i < 2; ++i) {
+        r.texture[i] = e->texture[i] ? static_cast<uint16_t>(FindOrAdd(textureList, e->texture[i])) : noResource;
+      }
+      r.program = e->program ? static_cast<uint16_t>(FindOrAdd(programList, e->program)) : noResource;
+      recordList.push_back(r);
+    }
+  }
+  if (meshList.size() >= noResource || textureList.size() >= noResource || programList.size() >= noResource) {
+    std::cerr << "WARNING in Entity::Snapshot::Save: リソースの種類が多すぎるため保存できません." << std::endl;
+    return false;
+  }
+  if (uncopyableCount) {
+    std::cerr << "WARNING in Entity::Snapshot::Save: 複製できない更新関数を持つエンティティが" << uncopyableCount <<
+      "個あります. 復元すると更新関数は空になります." << std::endl;
+  }
+  transformStamp = buffer.transformStamp;
+
+  // 空きリストとページの使用状況.
+  freeList = buffer.freeList;
+  pageList.resize(buffer.pageList.size());
+  pageActiveCount.resize(buffer.pageList.size());
+  for (size_t n = 0; n < buffer.pageList.size(); ++n) {
+    const Buffer::Page* page = buffer.pageList[n].get();
+    pageList[n] = page;
+    pageActiveCount[n] = page ? page->activeCount : 0;
+  }
+  activeEntityCount = buffer.activeEntityCount;
+
+  // アーキタイプと振る舞いテーブル.
+  // 関数オブジェクトの配列の型はテーブルごとに異なるので、別のテーブルの状態を保存していた場所は作り直す.
+  archetypeList.clear();
+  for (const auto& e : buffer.archetypeList) {
+    archetypeList.push_back(e.get());
+  }
+  const size_t tableCount = buffer.behaviorTableList.size();
+  behaviorTableList.resize(tableCount, nullptr);
+  behaviorStateList.resize(tableCount);
+  for (size_t i = 0; i < tableCount; ++i) {
+    const BehaviorTable* table = buffer.behaviorTableList[i].get();
+    if (behaviorTableList[i] != table) {
+      behaviorTableList[i] = table;
+      behaviorStateList[i].stateList.reset();
+    }
+    table->SaveState(behaviorStateList[i]);
+  }
+
+  // 弾は運動パターンごとの配列をまとめてコピーする.
+  const BulletBuffer& bullets = *buffer.bulletBuffer;
+  bulletPoolList.resize(bullets.poolList.size());
+  for (size_t i = 0; i < bullets.poolList.size(); ++i) {
+    const BulletBuffer::Pool& pool = bullets.poolList[i];
+    BulletPoolState& state = bulletPoolList[i];
+    state.serial = pool.serial;
+    state.capacity = pool.capacity;
+    state.count = pool.count;
+    state.target = pool.target;
+    for (int lane = 0; lane < bulletPatternCount; ++lane) {
+      state.lane[lane] = pool.lane[lane];
+    }
+  }
+  source = &buffer;
+
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  SnapshotStatistics& stats = buffer.snapshotStats;
+  ++stats.saveCount;
+  stats.saveSeconds += seconds;
+  stats.maxSaveSeconds = std::max(stats.maxSaveSeconds, seconds);
+  stats.entityCount = recordList.size();
+  return true;
+}
+
+/**
+* 保存した状態をバッファに復元する.
+*
+* @param buffer 復元先のバッファ. Save()に渡したバッファであること.
+*
+* @retval true  復元成功.
+* @retval false 保存していないか、更新中に呼び出されたか、保存後にアーキタイプなどが登録し直された.
+*
+* 保存後に追加されたエンティティは削除され、世代番号が進む. 保存後に削除されたエンティティは保存時の状態に戻る.
+* 空間検索用の木は作り直され、全エンティティのUBOが転送し直される.
+*/
+bool Snapshot::Restore(Buffer& buffer) const
+{
+  if (source != &buffer) {
+    std::cerr << "WARNING in Entity::Snapshot::Restore: 保存元と異なるバッファには復元できません." << std::endl;
+    return false;
+  }
+  if (buffer.isUpdating) {
+    std::cerr << "WARNING in Entity::Snapshot::Restore: 更新中は復元できません." << std::endl;
+    return false;
+  }
+  bool isCompatible = buffer.archetypeList.size() == archetypeList.size() &&
+    buffer.behaviorTableList.size() == behaviorTableList.size() &&
+    buffer.bulletBuffer->poolList.size() == bulletPoolList.size();
+  for (size_t i = 0; isCompatible && i < archetypeList.size(); ++i) {
+    isCompatible = buffer.archetypeList[i].get() == archetypeList[i];
+  }
+  for (size_t i = 0; isCompatible && i < behaviorTableList.size(); ++i) {
+    isCompatible = buffer.behaviorTableList[i].get() == behaviorTableList[i];
+  }
+  for (size_t i = 0; isCompatible && i < bulletPoolList.size(); ++i) {
+    const BulletBuffer::Pool& pool = buffer.bulletBuffer->poolList[i];
+    isCompatible = pool.serial == bulletPoolList[i].serial && pool.capacity == bulletPoolList[i].capacity;
+  }
+  for (size_t n = 0; isCompatible && n < pageList.size(); ++n) {
+    isCompatible = !pageList[n] || (n < buffer.pageList.size() && buffer.pageList[n].get() == pageList[n]);
+  }
+  if (!isCompatible) {
+    std::cerr << "WARNING in Entity::Snapshot::Restore: 保存後にアーキタイプ、振る舞いテーブル、弾の種類のいずれかが変更されたため復元できません." << std::endl;
+    return false;
+  }
+  const Clock::time_point start = Clock::now();
+
+  // 現在のエンティティをいったん全て非アクティブにし、保存時に存在したものだけをアクティブに戻す.
+  // 戻らなかったもの(保存後に追加されたエンティティ)は、リソースを解放して未使用の状態にする.
+  buffer.spatialTree.Clear();
+  for (GroupStorage& s : buffer.groups) {
+    for (Entity* e : s.entity) {
+      e->isActive = false;
+      e->treeProxy = Collision::AabbTree::nullNode;
+    }
+  }
+  for (const GroupStorage& s : groups) {
+    for (Entity* e : s.entity) {
+      e->isActive = true;
+    }
+  }
+  for (GroupStorage& s : buffer.groups) {
+    for (Entity* e : s.entity) {
+      if (e->isActive) {
+        continue;
+      }
+      e->storage = nullptr;
+      e->index = 0;
+      e->mesh.reset();
+      for (auto& t : e->texture) {
+        t.reset();
+      }
+      e->program.reset();
+      e->archetype = nullptr;
+      e->updateFunc = nullptr;
+      e->behaviorTable = nullptr;
+      e->behaviorIndex = 0;
+      e->parent = nullptr;
+      e->childList.clear();
+      ++e->generation;
+    }
+  }
+
+  // グループデータを配列ごとにコピーし、エンティティごとの状態を戻す.
+  size_t recordIndex = 0;
+  for (int groupId = 0; groupId <= maxGroupId; ++groupId) {
+    GroupStorage& s = buffer.groups[groupId];
+    s = groups[groupId];
+    for (size_t i = 0; i < s.Size(); ++i) {
+      Entity* e = s.entity[i];
+      const EntityRecord& r = recordList[recordIndex++];
+      e->groupId = groupId;
+      e->storage = &s;
+      e->index = static_cast<uint32_t>(i);
+      e->parent = r.parent;
+      e->childList.assign(childList.begin() + r.firstChild, childList.begin() + r.firstChild + r.childCount);
+      AssignResource(e->mesh, meshList, r.mesh);
+      for (int n = 0; n < 2; ++n) {
+        AssignResource(e->texture[n], textureList, r.texture[n]);
+      }
+      AssignResource(e->program, programList, r.program);
+      e->archetype = r.archetype;
+      e->behaviorTable = r.behaviorTable;
+      e->behaviorIndex = r.behaviorIndex;
+      e->generation = r.generation;
+      if (r.updateFunc != noFunc) {
+        e->updateFunc = funcList[r.updateFunc].Clone();
+      } else {
+        e->updateFunc = nullptr;
+      }
+    }
+    buffer.groupOffset[groupId] = groupOffset[groupId];
+    buffer.groupVelocity[groupId] = groupVelocity[groupId];
+    buffer.updateSlice[groupId] = updateSlice[groupId];
+  }
+  buffer.transformStamp = transformStamp;
+
+  // 空きリストを戻す. 保存後に追加されたページのエンティティは全て未使用になる.
+  buffer.freeList = freeList;
+  for (size_t n = 0; n < buffer.pageList.size(); ++n) {
+    Buffer::Page* page = buffer.pageList[n].get();
+    if (!page) {
+      continue;
+    }
+    if (n < pageList.size() && pageList[n] == page) {
+      page->activeCount = pageActiveCount[n];
+      continue;
+    }
+    page->activeCount = 0;
+    for (size_t i = Buffer::entitiesPerPage; i > 0; --i) {
+      buffer.freeList.push_back(&page->entityList[i - 1]);
+    }
+  }
+  buffer.activeEntityCount = activeEntityCount;
+
+  for (size_t i = 0; i < behaviorStateList.size(); ++i) {
+    buffer.behaviorTableList[i]->RestoreState(behaviorStateList[i]);
+  }
+
+  BulletBuffer& bullets = *buffer.bulletBuffer;
+  for (size_t i = 0; i < bulletPoolList.size(); ++i) {
+    BulletBuffer::Pool& pool = bullets.poolList[i];
+    const BulletPoolState& state = bulletPoolList[i];
+    pool.count = state.count;
+    pool.target = state.target;
+    for (int lane = 0; lane < bulletPatternCount; ++lane) {
+      pool.lane[lane] = state.lane[lane];
+    }
+  }
+
+  // 親子関係の計算順、UBOの内容、空間検索用の木は保存時の状態と対応しないので作り直す.
+  buffer.isHierarchyDirty = true;
+  buffer.MarkAllDirty();
+  buffer.UpdateSpatialTree();
+
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  SnapshotStatistics& stats = buffer.snapshotStats;
+  ++stats.restoreCount;
+  stats.restoreSeconds += seconds;
+  stats.maxRestoreSeconds = std::max(stats.maxRestoreSeconds, seconds);
+  return true;
+}
+
+/**
+* 保存した状態のバイト数を計算する.
+*
+* @return 保存したデータのバイト数. リソースや関数オブジェクトが参照する先のデータは含まない.
+*/
+size_t Snapshot::ByteSize() const
+{
+  size_t n = 0;
+  for (const GroupStorage& s : groups) {
+    n += Bytes(s.entity) + Bytes(s.position) + Bytes(s.velocity) + Bytes(s.rotation) + Bytes(s.scale) +
+      Bytes(s.color) + Bytes(s.matModel) + Bytes(s.isDirty) + Bytes(s.colLocal) + Bytes(s.colWorld) +
+      Bytes(s.collisionMask) + Bytes(s.bounds) + Bytes(s.depth) + Bytes(s.transformStamp) +
+      Bytes(s.isStatic) + Bytes(s.elapsed) + Bytes(s.pageIndex) + Bytes(s.uboOffset);
+  }
+  n += Bytes(recordList) + Bytes(childList) + Bytes(funcList) + Bytes(freeList);
+  for (const BulletPoolState& pool : bulletPoolList) {
+    for (const BulletBuffer::Lane& lane : pool.lane) {
+      n += Bytes(lane.posX) + Bytes(lane.posY) + Bytes(lane.posZ) + Bytes(lane.velX) + Bytes(lane.velY) + Bytes(lane.velZ) +
+        Bytes(lane.orgX) + Bytes(lane.orgY) + Bytes(lane.orgZ) + Bytes(lane.age) + Bytes(lane.lifetime) +
+        Bytes(lane.paramX) + Bytes(lane.paramY) + Bytes(lane.paramZ);
+    }
+  }
+  return n;
+}
+
+} // namespace Entity
\ No newline at end of file
@@ -0,0 +1,101 @@
+/**
+* @file Snapshot.h
+*/
+#ifndef OPENGLTUTORIAL_SRC_SNAPSHOT_H_INCLUDED
+#define OPENGLTUTORIAL_SRC_SNAPSHOT_H_INCLUDED
+#include "Entity.h"
+#include "Bullet.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Entity {
+
+/**
+* エンティティバッファの状態の複製.
+*
+* Save()で保存した状態を、Restore()で同じバッファに復元する.
+* グループごとのSoA配列・空きリスト・弾の配列は、配列ごとにまとめてコピーするだけで保存される.
+* エンティティへのポインタはそのまま保存するため、一度でも保存したバッファはその時点のページを解放しなくなる.
+*
+* メッシュ・テクスチャ・シェーダはスナップショット内の表に重複なく保持し、エンティティには表の番号を記録する.
+* 更新関数はClone()で複製する. 複製できない更新関数を持つエンティティは、復元すると更新関数が空になる.
+* 振る舞いテーブルの状態は、テーブルごとに関数オブジェクトの配列を複製する.
+*
+* 保存と復元はUpdate()の外で行うこと. 同じSnapshotを繰り返し使えば、2回目以降はほとんどメモリを確保しない.
+*
+* 保存した状態はエンティティへのポインタ、リソースのshared_ptr、複製した更新関数を含むため、
+* 保存したプロセスの中でだけ有効で、ファイルに書き出したり別のプロセスで読み込んだりすることはできない.
+* ロールバックや、同じプロセス内で同じ状態から何度も計測を繰り返す用途に使う.
+* グループの設定(衝突ハンドラ、可視フラグ、更新の分割数など)は保存されない.
+* アーキタイプや振る舞いテーブルを登録し直した場合、それ以前に保存した状態は復元できない.
+*/
+class Snapshot
+{
+public:
+  Snapshot() = default;
+  ~Snapshot() = default;
+  Snapshot(const Snapshot&) = delete;
+  Snapshot& operator=(const Snapshot&) = delete;
+
+  bool Save(Buffer& buffer);
+  bool Restore(Buffer& buffer) const;
+  bool IsEmpty() const { return !source; }
+  size_t EntityCount() const { return recordList.size(); }
+  size_t ByteSize() const;
+
+private:
+  static const uint16_t noResource = 0xffff; ///< リソースが設定されていないことを示す番号.
+  static const uint32_t noFunc = ~0U; ///< 更新関数が設定されていないことを示す番号.
+
+  /// エンティティごとの、グループデータ以外の状態.
+  struct EntityRecord {
+    Entity* parent; ///< 親エンティティ.
+    const Archetype* archetype; ///< 生成に使われたアーキタイプ.
+    BehaviorTable* behaviorTable; ///< 所属する振る舞いテーブル.
+    uint32_t behaviorIndex; ///< 振る舞いテーブル内の位置.
+    uint32_t generation; ///< 世代番号.
+    uint32_t firstChild; ///< childList内の、子エンティティの先頭の位置.
+    uint32_t childCount; ///< 子エンティティの数.
+    uint32_t updateFunc; ///< funcList内の更新関数の位置.
+    uint16_t mesh; ///< meshList内のメッシュの位置.
+    uint16_t texture[2]; ///< textureList内のテクスチャの位置.
+    uint16_t program; ///< programList内のシェーダの位置.
+  };
+
+  /// 弾のプールの状態.
+  struct BulletPoolState {
+    uint32_t serial; ///< プールの登録番号. 復元時に同じ種類であることを確かめる.
+    size_t capacity; ///< 同時に存在できる数.
+    size_t count; ///< 存在する弾の数.
+    glm::vec3 target; ///< Aimedの目標座標.
+    BulletBuffer::Lane lane[bulletPatternCount]; ///< 運動パターンごとの弾.
+  };
+
+  const Buffer* source = nullptr; ///< 保存元のバッファ.
+  GroupStorage groups[maxGroupId + 1]; ///< グループごとのエンティティデータ.
+  glm::vec3 groupOffset[maxGroupId + 1]; ///< グループごとの平行移動.
+  glm::vec3 groupVelocity[maxGroupId + 1]; ///< グループごとの平行移動の速度.
+  int updateSlice[maxGroupId + 1]; ///< グループごとの、次に更新する分割の番号.
+  uint32_t transformStamp = 0; ///< モデル行列の計算に使う番号.
+
+  std::vector<EntityRecord> recordList; ///< groupsの順に並べた、エンティティごとの状態.
+  std::vector<Entity*> childList; ///< 全エンティティの子エンティティのリスト.
+  std::vector<Entity::UpdateFuncType> funcList; ///< 更新関数の複製.
+  std::vector<Mesh::MeshPtr> meshList; ///< エンティティが使うメッシュの表.
+  std::vector<TexturePtr> textureList; ///< エンティティが使うテクスチャの表.
+  std::vector<Shader::ProgramPtr> programList; ///< エンティティが使うシェーダの表.
+
+  std::vector<Entity*> freeList; ///< 未使用のエンティティのリスト.
+  std::vector<const void*> pageList; ///< 保存時のページ. 復元時に同じページが存在することを確かめる.
+  std::vector<size_t> pageActiveCount; ///< ページごとの使用中のエンティティの数.
+  size_t activeEntityCount = 0; ///< 使用中のエンティティの数.
+
+  std::vector<const Archetype*> archetypeList; ///< 保存時のアーキタイプ.
+  std::vector<const BehaviorTable*> behaviorTableList; ///< 保存時の振る舞いテーブル.
+  std::vector<BehaviorTable::State> behaviorStateList; ///< 振る舞いテーブルごとの状態.
+  std::vector<BulletPoolState> bulletPoolList; ///< 弾のプールごとの状態.
+};
+
+} // namespace Entity
+
+#endif // OPENGLTUTORIAL_SRC_SNAPSHOT_H_INCLUDED
\ No newline at end of file
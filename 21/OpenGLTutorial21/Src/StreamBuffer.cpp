@@ -0,0 +1,251 @@
+/**
+* @file StreamBuffer.cpp
+*/
+#include "StreamBuffer.h"
+#include "GLState.h"
+#include <algorithm>
+#include <iostream>
+
+/// マップや作り直しに使うバインド先. 描画用のバインド先の状態を変えないように、コピー用のものを使う.
+static const GLenum bufferTarget = GL_COPY_WRITE_BUFFER;
+
+static const GLuint64 fenceTimeout = 1000000; ///< フェンスを待つときの1回あたりの待ち時間(ナノ秒).
+
+/**
+* ストリーミングバッファを作成する.
+*
+* @param segmentSize  1フレームで使うバイト数.
+* @param segmentCount セグメントの数. GPUと並行して書き込めるフレーム数+1にする.
+*
+* @return 作成したストリーミングバッファへのポインタ.
+*/
+StreamBufferPtr StreamBuffer::Create(GLsizeiptr segmentSize, int segmentCount)
+{
+  struct Impl : StreamBuffer { Impl() {} ~Impl() {} };
+  StreamBufferPtr p = std::make_shared<Impl>();
+  if (!p || !p->Init(segmentSize, segmentCount)) {
+    std::cerr << "ERROR: ストリーミングバッファの作成に失敗" << std::endl;
+    return {};
+  }
+  return p;
+}
+
+/**
+* デストラクタ.
+*/
+StreamBuffer::~StreamBuffer()
+{
+  Destroy();
+}
+
+/**
+* バッファを作成する.
+*
+* @param size  セグメントのバイト数.
+* @param count セグメントの数.
+*
+* @retval true  作成成功.
+* @retval false 作成失敗.
+*/
+bool StreamBuffer::Init(GLsizeiptr size, int count)
+{
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &ubAlignment);
+  segmentSize = ((size + ubAlignment - 1) / ubAlignment) * ubAlignment;
+  segmentCount = std::max(count, 1);
+  const GLsizeiptr totalSize = segmentSize * segmentCount;
+
+  isPersistent = false;
+  if (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage) {
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    if (buffer.InitStorage(bufferTarget, totalSize, flags)) {
+      GLState::BindBuffer(bufferTarget, buffer.Id());
+      persistentPointer = static_cast<uint8_t*>(glMapBufferRange(bufferTarget, 0, totalSize, flags));
+      GLState::BindBuffer(bufferTarget, 0);
+      isPersistent = persistentPointer != nullptr;
+    }
+  }
+  if (!isPersistent) {
+    buffer.Init(bufferTarget, totalSize, nullptr, GL_STREAM_DRAW);
+  }
+  if (!buffer.Id()) {
+    return false;
+  }
+  fenceList.assign(segmentCount, nullptr);
+  segment = 0;
+  head = 0;
+  return true;
+}
+
+/**
+* バッファを破棄する.
+*
+* バッファを削除してもGPUが使い終わるまでは実際には解放されないため、フェンスは待たずに削除する.
+*/
+void StreamBuffer::Destroy()
+{
+  for (GLsync& e : fenceList) {
+    if (e) {
+      glDeleteSync(e);
+      e = nullptr;
+    }
+  }
+  if (persistentPointer || mappedPointer) {
+    GLState::BindBuffer(bufferTarget, buffer.Id());
+    glUnmapBuffer(bufferTarget);
+    GLState::BindBuffer(bufferTarget, 0);
+    persistentPointer = nullptr;
+    mappedPointer = nullptr;
+  }
+  buffer.Destroy();
+}
+
+/**
+* フレームの使用を開始する.
+*
+* 次のセグメントに切り替え、GPUがそのセグメントを読み終わるのを待つ.
+* 前のフレームで容量が足りなかった場合は、セグメントを2倍の大きさで作り直す.
+*/
+void StreamBuffer::BeginFrame()
+{
+  if (isFrameOpen) {
+    EndFrame();
+  }
+  if (isOverflowed) {
+    isOverflowed = false;
+    Destroy();
+    if (!Init(segmentSize * 2, segmentCount)) {
+      std::cerr << "ERROR: ストリーミングバッファの拡張に失敗" << std::endl;
+      return;
+    }
+    ++stats.growCount;
+  }
+  segment = (segment + 1) % segmentCount;
+  WaitSegment(segment);
+  head = 0;
+  isFrameOpen = true;
+}
+
+/**
+* GPUがセグメントを読み終わるのを待つ.
+*
+* @param index セグメントの番号.
+*
+* 永続的マップでない場合は、待つ代わりにバッファを作り直して古い領域をGPUに任せる.
+*/
+void StreamBuffer::WaitSegment(int index)
+{
+  GLsync& fence = fenceList[index];
+  if (!fence) {
+    return;
+  }
+  GLenum result = glClientWaitSync(fence, 0, 0);
+  if (result == GL_TIMEOUT_EXPIRED) {
+    if (!isPersistent) {
+      GLState::BindBuffer(bufferTarget, buffer.Id());
+      glBufferData(bufferTarget, segmentSize * segmentCount, nullptr, GL_STREAM_DRAW);
+      GLState::BindBuffer(bufferTarget, 0);
+      for (GLsync& e : fenceList) {
+        if (e) {
+          glDeleteSync(e);
+          e = nullptr;
+        }
+      }
+      ++stats.orphanCount;
+      return;
+    }
+    ++stats.stallCount;
+    do {
+      result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, fenceTimeout);
+    } while (result == GL_TIMEOUT_EXPIRED);
+  }
+  glDeleteSync(fence);
+  fence = nullptr;
+}
+
+/**
+* 現在のセグメントから領域を確保する.
+*
+* @param size      確保するバイト数.
+* @param alignment オフセットのアラインメント. 2のべき乗でなくてもよい.
+*
+* @return 確保した領域. 空きが足りない場合は空の領域を返す.
+*
+* 返されたポインタは書き込み専用で、次のCommit()まで有効.
+* 空きが足りなかった場合、次のBeginFrame()でセグメントが拡張される.
+*/
+StreamBuffer::Allocation StreamBuffer::Allocate(GLsizeiptr size, GLsizeiptr alignment)
+{
+  if (!isFrameOpen || !buffer.Id() || size <= 0) {
+    return {};
+  }
+  alignment = std::max<GLsizeiptr>(alignment, 1);
+  const GLintptr base = segment * segmentSize;
+  const GLintptr offset = ((base + head + alignment - 1) / alignment) * alignment;
+  if (offset + size > base + segmentSize) {
+    ++stats.overflowCount;
+    isOverflowed = true;
+    return {};
+  }
+
+  Allocation a;
+  a.offset = offset;
+  a.size = size;
+  if (isPersistent) {
+    a.pointer = persistentPointer + offset;
+  } else {
+    if (!mappedPointer || offset + size > mappedOffset + mappedSize) {
+      Commit();
+      // フェンスで使い終わったことを確認済みなので、同期せずにセグメントの残り全体をマップする.
+      mappedOffset = offset;
+      mappedSize = base + segmentSize - offset;
+      GLState::BindBuffer(bufferTarget, buffer.Id());
+      mappedPointer = static_cast<uint8_t*>(glMapBufferRange(bufferTarget, mappedOffset, mappedSize,
+        GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT));
+      GLState::BindBuffer(bufferTarget, 0);
+      if (!mappedPointer) {
+        return {};
+      }
+    }
+    a.pointer = mappedPointer + (offset - mappedOffset);
+  }
+  head = offset + size - base;
+  stats.peakUsage = std::max(stats.peakUsage, head);
+  return a;
+}
+
+/**
+* 確保した領域に書き込んだデータをGPUから見えるようにする.
+*
+* 永続的マップはコヒーレントなのでなにもしない.
+* そうでなければ、書き込んだ範囲をフラッシュしてマップを解除する.
+* 描画やコピーでバッファを使う前に呼び出すこと.
+*/
+void StreamBuffer::Commit()
+{
+  if (!mappedPointer) {
+    return;
+  }
+  const GLsizeiptr usedSize = segment * segmentSize + head - mappedOffset;
+  GLState::BindBuffer(bufferTarget, buffer.Id());
+  if (usedSize > 0) {
+    glFlushMappedBufferRange(bufferTarget, 0, usedSize);
+  }
+  glUnmapBuffer(bufferTarget);
+  GLState::BindBuffer(bufferTarget, 0);
+  mappedPointer = nullptr;
+}
+
+/**
+* フレームの使用を終了する.
+*
+* 現在のセグメントを使う全ての命令の後にフェンスを置く.
+*/
+void StreamBuffer::EndFrame()
+{
+  if (!isFrameOpen) {
+    return;
+  }
+  Commit();
+  fenceList[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  isFrameOpen = false;
+}
\ No newline at end of file
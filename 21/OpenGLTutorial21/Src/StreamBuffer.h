@@ -0,0 +1,96 @@
+/**
+* @file StreamBuffer.h
+*/
+#ifndef STREAMBUFFER_H_INCLUDED
+#define STREAMBUFFER_H_INCLUDED
+#include <GL/glew.h>
+#include "BufferObject.h"
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+class StreamBuffer;
+typedef std::shared_ptr<StreamBuffer> StreamBufferPtr; ///< ストリーミングバッファポインタ型.
+
+/**
+* 毎フレーム書き換えるデータを転送するためのリングバッファ.
+*
+* バッファをセグメントに分割し、1フレームに1セグメントずつ順番に使う.
+* フレームの終わりにフェンスを置き、再びそのセグメントを使うときはGPUが読み終わるのを待つ.
+*
+* glBufferStorageが使える場合は、永続的かつコヒーレントにマップしたまま使う.
+* 使えない場合(OpenGL 4.1)は、GL_MAP_UNSYNCHRONIZED_BITで必要な範囲だけをマップする.
+* このとき、GPUが読み終わっていなければ待たずにバッファを作り直す(オーファニング).
+*
+* 使い方:
+* -# BeginFrame()でセグメントを切り替える.
+* -# Allocate()で領域を確保し、返されたポインタにデータを書き込む.
+* -# Commit()で書き込んだデータをGPUから見えるようにしてから、描画やコピーに使う.
+* -# EndFrame()でフェンスを置く.
+*/
+class StreamBuffer
+{
+public:
+  /// 確保した領域.
+  struct Allocation {
+    void* pointer = nullptr; ///< 書き込み先. 次のCommit()まで有効.
+    GLintptr offset = 0; ///< バッファ先頭からのバイトオフセット.
+    GLsizeiptr size = 0; ///< バイト数.
+
+    explicit operator bool() const { return pointer != nullptr; }
+  };
+
+  /// 同期と容量の統計.
+  struct Statistics {
+    size_t stallCount = 0; ///< CPUがフェンスを待った回数.
+    size_t orphanCount = 0; ///< 待つ代わりにバッファを作り直した回数.
+    size_t overflowCount = 0; ///< セグメントの空きが足りず確保に失敗した回数.
+    size_t growCount = 0; ///< セグメントを拡張した回数.
+    GLsizeiptr peakUsage = 0; ///< 1フレームで使った最大のバイト数.
+  };
+
+  static StreamBufferPtr Create(GLsizeiptr segmentSize, int segmentCount = 3);
+
+  void BeginFrame();
+  Allocation Allocate(GLsizeiptr size, GLsizeiptr alignment);
+  Allocation AllocateUniform(GLsizeiptr size) { return Allocate(size, ubAlignment); }
+  void Commit();
+  void EndFrame();
+
+  GLuint Id() const { return buffer.Id(); }
+  bool IsPersistent() const { return isPersistent; }
+  GLsizeiptr SegmentSize() const { return segmentSize; }
+  const Statistics& Stats() const { return stats; }
+
+private:
+  StreamBuffer() = default;
+  ~StreamBuffer();
+  StreamBuffer(const StreamBuffer&) = delete;
+  StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+  bool Init(GLsizeiptr size, int count);
+  void Destroy();
+  void WaitSegment(int index);
+
+private:
+  BufferObject buffer; ///< バッファオブジェクト.
+  GLsizeiptr segmentSize = 0; ///< セグメントのバイト数.
+  int segmentCount = 0; ///< セグメントの数.
+  std::vector<GLsync> fenceList; ///< セグメントごとのフェンス.
+  GLint ubAlignment = 1; ///< UBOのオフセットのアラインメント.
+  bool isPersistent = false; ///< 永続的にマップしていればtrue.
+  uint8_t* persistentPointer = nullptr; ///< 永続的にマップしたバッファの先頭.
+
+  int segment = 0; ///< 使用中のセグメント.
+  GLsizeiptr head = 0; ///< セグメント内の次に確保する位置.
+  bool isFrameOpen = false; ///< BeginFrame()からEndFrame()までの間はtrue.
+  bool isOverflowed = false; ///< このフレームで確保に失敗していればtrue.
+
+  uint8_t* mappedPointer = nullptr; ///< 一時的にマップした範囲の先頭(永続的マップでない場合).
+  GLintptr mappedOffset = 0; ///< 一時的にマップした範囲のバイトオフセット.
+  GLsizeiptr mappedSize = 0; ///< 一時的にマップした範囲のバイト数.
+
+  Statistics stats; ///< 統計.
+};
+
+#endif // STREAMBUFFER_H_INCLUDED
\ No newline at end of file
@@ -0,0 +1,109 @@
+/**
+* @file ThreadPool.cpp
+*/
+#include "ThreadPool.h"
+
+/**
+* ワーカースレッドを起動する.
+*
+* @param workerCount 起動するワーカースレッドの数.
+*                    0の場合、全ての処理は呼び出し元のスレッドで実行される.
+*/
+void ThreadPool::Start(size_t workerCount)
+{
+  Stop();
+  isQuitting = false;
+  workerList.reserve(workerCount);
+  for (size_t i = 0; i < workerCount; ++i) {
+    workerList.emplace_back(&ThreadPool::WorkerMain, this, jobId);
+  }
+}
+
+/**
+* 全てのワーカースレッドを終了する.
+*/
+void ThreadPool::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    isQuitting = true;
+  }
+  cvStart.notify_all();
+  for (auto& e : workerList) {
+    e.join();
+  }
+  workerList.clear();
+}
+
+/**
+* 処理を分担して実行する.
+*
+* @param chunkCount 処理を分割したチャンクの数.
+* @param task       チャンク番号を受け取って処理を行う関数.
+*
+* 呼び出し元のスレッドもチャンクの処理に参加する.
+* 全てのチャンクの処理が終わるまで戻らない.
+* チャンクの実行順序とスレッドの割り当ては不定.
+*/
+void ThreadPool::ParallelFor(size_t chunkCount, const TaskType& task)
+{
+  if (workerList.empty() || chunkCount <= 1) {
+    for (size_t i = 0; i < chunkCount; ++i) {
+      task(i);
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->task = &task;
+    this->chunkCount = chunkCount;
+    nextChunk = 0;
+    runningWorkerCount = workerList.size();
+    ++jobId;
+  }
+  cvStart.notify_all();
+  RunChunks();
+  std::unique_lock<std::mutex> lock(mutex);
+  cvFinish.wait(lock, [this]() { return runningWorkerCount == 0; });
+  this->task = nullptr;
+}
+
+/**
+* 未処理のチャンクがなくなるまで処理する.
+*/
+void ThreadPool::RunChunks()
+{
+  for (;;) {
+    const size_t i = nextChunk++;
+    if (i >= chunkCount) {
+      break;
+    }
+    (*task)(i);
+  }
+}
+
+/**
+* ワーカースレッドの処理.
+*
+* @param lastJobId 起動時点の処理番号.
+*/
+void ThreadPool::WorkerMain(unsigned int lastJobId)
+{
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cvStart.wait(lock, [&]() { return isQuitting || jobId != lastJobId; });
+      if (isQuitting) {
+        return;
+      }
+      lastJobId = jobId;
+    }
+    RunChunks();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--runningWorkerCount == 0) {
+        cvFinish.notify_one();
+      }
+    }
+  }
+}
\ No newline at end of file
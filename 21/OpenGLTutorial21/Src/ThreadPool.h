@@ -0,0 +1,48 @@
+/**
+* @file ThreadPool.h
+*/
+#ifndef THREADPOOL_H_INCLUDED
+#define THREADPOOL_H_INCLUDED
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+/**
+* ワーカースレッドで処理を分担するためのスレッドプール.
+*/
+class ThreadPool
+{
+public:
+  /// 分担する処理の型. 引数は処理するチャンクの番号.
+  typedef std::function<void(size_t)> TaskType;
+
+  ThreadPool() = default;
+  ~ThreadPool() { Stop(); }
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  void Start(size_t workerCount);
+  void Stop();
+  size_t ThreadCount() const { return workerList.size() + 1; }
+  void ParallelFor(size_t chunkCount, const TaskType& task);
+
+private:
+  void WorkerMain(unsigned int lastJobId);
+  void RunChunks();
+
+  std::vector<std::thread> workerList; ///< ワーカースレッドのリスト.
+  std::mutex mutex;
+  std::condition_variable cvStart; ///< 処理の開始を通知する.
+  std::condition_variable cvFinish; ///< 全ワーカーの処理の終了を通知する.
+  const TaskType* task = nullptr; ///< 実行中の処理.
+  size_t chunkCount = 0; ///< 実行中の処理のチャンク数.
+  std::atomic<size_t> nextChunk; ///< 次に処理するチャンクの番号.
+  size_t runningWorkerCount = 0; ///< 処理中のワーカーの数.
+  unsigned int jobId = 0; ///< 処理を要求するたびに増加する番号.
+  bool isQuitting = false; ///< trueならワーカーを終了させる.
+};
+
+#endif // THREADPOOL_H_INCLUDED
\ No newline at end of file
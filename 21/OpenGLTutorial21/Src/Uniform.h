@@ -1,58 +1,93 @@
-/**
-* @file Uniform.h
-*/
-#ifndef UNIFORM_H_INCLUDED
-#define UNIFORM_H_INCLUDED
-#include <glm/glm.hpp>
-
-namespace Uniform {
-
-static const int maxViewCount = 4;
-
-/**
-* Wϊf[^.
-*/
-struct VertexData
-{
-  glm::mat4 matMVP[maxViewCount];
-  glm::mat4 matDepthMVP;
-  glm::mat4 matModel;
-  glm::mat3x4 matNormal;
-  glm::vec4 color;
-  glm::mat4 matTex;
-};
-
-/**
-* Cgf[^(_).
-*/
-struct PointLight
-{
-  glm::vec4 position; ///< W([hWn).
-  glm::vec4 color; ///< 邳.
-};
-
-static const int maxLightCount = 4; ///< Cg̐.
-
-/**
-* CeBOp[^.
-*/
-struct LightingData
-{
-  glm::vec4 eyePos[maxViewCount]; ///< _.
-  glm::vec4 ambientColor; ///< .
-  PointLight light[maxLightCount]; ///< Cg̃Xg.
-};
-
-/**
-* |XgGtFNgp[^.
-*/
-struct PostEffectData
-{
-  glm::mat4x4 matColor; ///< Fϊs.
-  float lumScale;
-  float bloomThreshould;
-};
-
-} // namespace Uniform
-
+/**
+* @file Uniform.h
+*/
+#ifndef UNIFORM_H_INCLUDED
+#define UNIFORM_H_INCLUDED
+#include <glm/glm.hpp>
+
+namespace Uniform {
+
+static const int maxViewCount = 4;
+
+/**
+* 座標変換データ(エンティティごと).
+*
+* ビュー・プロジェクション行列はViewDataで共有し、シェーダ内でモデル行列と掛け合わせる.
+*/
+struct VertexData
+{
+  glm::mat4 matModel;
+  glm::mat3x4 matNormal;
+  glm::vec4 color;
+  glm::mat4 matTex;
+};
+
+/**
+* 座標変換データ(全エンティティで共有).
+*
+* アクティブなビューの行列だけが設定される.
+*/
+struct ViewData
+{
+  glm::mat4 matVP[maxViewCount]; ///< ビュー・プロジェクション行列.
+  glm::mat4 matDepthVP; ///< 影用のビュー・プロジェクション行列.
+  glm::vec4 cameraRight[maxViewCount]; ///< ビルボードの右方向(ワールド座標系).
+  glm::vec4 cameraUp[maxViewCount]; ///< ビルボードの上方向(ワールド座標系).
+};
+
+/**
+* インスタンス描画で1回に描画できるインスタンスの最大数.
+*
+* 16KB(GL_MAX_UNIFORM_BLOCK_SIZEの最小保証値)に収まる数. シェーダの配列の長さと一致させること.
+*/
+static const int maxInstanceCount = 16 * 1024 / sizeof(VertexData);
+
+/**
+* 詰めて格納するインスタンスデータ(エンティティごと).
+*
+* テクスチャバッファまたはシェーダ・ストレージ・バッファに隙間なく並べ、シェーダはinstanceBase+gl_InstanceIDで参照する.
+* モデル行列の最後の行は常に(0, 0, 0, 1)なので格納しない. 法線の変換行列はシェーダでモデル行列から求める.
+*/
+struct InstanceData
+{
+  glm::vec4 matModel[3]; ///< モデル行列の上3行.
+  glm::vec4 color; ///< 色.
+};
+
+static const int instanceDataTextureUnit = 3; ///< インスタンスデータのテクスチャバッファを割り当てるユニット.
+static const int instanceDataStorageBinding = 0; ///< インスタンスデータのシェーダ・ストレージ・バッファのバインディング・ポイント.
+
+/**
+* ライトデータ(点光源).
+*/
+struct PointLight
+{
+  glm::vec4 position; ///< 座標(ワールド座標系).
+  glm::vec4 color; ///< 明るさ.
+};
+
+static const int maxLightCount = 4; ///< ライトの数.
+
+/**
+* ライティングパラメータ.
+*/
+struct LightingData
+{
+  glm::vec4 eyePos[maxViewCount]; ///< 視点.
+  glm::vec4 ambientColor; ///< 環境光.
+  PointLight light[maxLightCount]; ///< ライトのリスト.
+};
+
+/**
+* ポストエフェクトパラメータ.
+*/
+struct PostEffectData
+{
+  glm::mat4x4 matColor; ///< 色変換行列.
+  float lumScale;
+  float bloomThreshould;
+};
+
+} // namespace Uniform
+
 #endif // UNIFORM_H_INCLUDED
\ No newline at end of file
@@ -1,110 +1,139 @@
-/**
-* @file UniformBuffer.cpp
-*/
-#include "UniformBuffer.h"
-#include <iostream>
-
-/**
-* Uniformobt@쐬.
-*
-* @param size         obt@̃oCgTCY.
-* @param bindingPoint obt@蓖ĂoCfBOE|Cg.
-* @param name         obt@(fobOp).
-*
-* @return 쐬Uniformobt@ւ̃|C^.
-*/
-UniformBufferPtr UniformBuffer::Create(GLsizeiptr size, GLuint bindingPoint ,const char* name)
-{
-  struct Impl : UniformBuffer { Impl() {} ~Impl() {} };
-  UniformBufferPtr p = std::make_shared<Impl>();
-  if (!p) {
-    std::cerr << "ERROR: UBO '" << name << "'̍쐬Ɏs" << std::endl;
-    return {};
-  }
-
-  // TCYfoCX̃ACgɍ킹.
-  GLint ubAlignment;
-  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &ubAlignment);
-  size = ((size + ubAlignment - 1) / ubAlignment) * ubAlignment;
-
-  glGenBuffers(1, &p->ubo);
-  glBindBuffer(GL_UNIFORM_BUFFER, p->ubo);
-  glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
-  glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, p->ubo);
-  const GLenum result = glGetError();
-  if (result != GL_NO_ERROR) {
-    std::cerr << "ERROR: UBO '" << name << "'̍쐬Ɏs" << std::endl;
-    return {};
-  }
-  glBindBuffer(GL_UNIFORM_BUFFER, 0);
-
-  p->size = size;
-  p->bindingPoint = bindingPoint;
-  p->name = name;
-  return p;
-}
-
-/**
-* fXgN^.
-*/
-UniformBuffer::~UniformBuffer()
-{
-  if (ubo) {
-    glDeleteBuffers(1, &ubo);
-  }
-}
-
-/**
-* Uniformobt@Ƀf[^].
-*
-* @param data   ]f[^ւ̃|C^.
-* @param offset ]̃oCgItZbg.
-* @param size   ]oCg.
-*
-* @retval true  ].
-* @retval false ]s.
-*/
-bool UniformBuffer::BufferSubData(const GLvoid* data, GLintptr offset, GLsizeiptr size)
-{
-  if (offset + size > this->size) {
-    std::cerr << "ERROR(" << name << "): ]͈͂obt@TCYzĂ܂(buffer=" <<
-      this->size << " offset=" << offset << " size=" << size << ")" << std::endl;
-    return false;
-  }
-  if (offset == 0 && size == 0) {
-    size = this->size;
-  }
-  glBindBuffer(GL_UNIFORM_BUFFER, ubo);
-  glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
-  return true;
-}
-
-/**
-* w肳ꂽ͈͂oCfBOE|CgɊ蓖Ă.
-*
-* @param offset 蓖Ă͈͂̃oCgItZbg.
-* @param size   蓖Ă͈͂̃oCg.
-*/
-void UniformBuffer::BindBufferRange(GLintptr offset, GLsizeiptr size) const
-{
-  glBindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, ubo, offset, size);
-}
-
-/**
-* UBOVXeɃ}bv.
-*
-* @return }bvւ̃|C^.
-*/
-void* UniformBuffer::MapBuffer() const
-{
-  glBindBuffer(GL_UNIFORM_BUFFER, ubo);
-  return glMapBufferRange(GL_UNIFORM_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
-}
-
-/**
-* obt@̊蓖Ă.
-*/
-void UniformBuffer::UnmapBuffer() const
-{
-  glUnmapBuffer(GL_UNIFORM_BUFFER);
-}
+/**
+* @file UniformBuffer.cpp
+*/
+#include "UniformBuffer.h"
+#include "GLState.h"
+#include <iostream>
+
+/**
+* Uniformバッファを作成する.
+*
+* @param size         バッファのバイトサイズ.
+* @param bindingPoint バッファを割り当てるバインディング・ポイント.
+* @param name         バッファ名(デバッグ用).
+*
+* @return 作成したUniformバッファへのポインタ.
+*/
+UniformBufferPtr UniformBuffer::Create(GLsizeiptr size, GLuint bindingPoint ,const char* name)
+{
+  struct Impl : UniformBuffer { Impl() {} ~Impl() {} };
+  UniformBufferPtr p = std::make_shared<Impl>();
+  if (!p) {
+    std::cerr << "ERROR: UBO '" << name << "'の作成に失敗" << std::endl;
+    return {};
+  }
+
+  // サイズをデバイスのアラインメントに合わせる.
+  GLint ubAlignment;
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &ubAlignment);
+  size = ((size + ubAlignment - 1) / ubAlignment) * ubAlignment;
+
+  glGenBuffers(1, &p->ubo);
+  GLState::BindBuffer(GL_UNIFORM_BUFFER, p->ubo);
+  glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+  GLState::BindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, p->ubo);
+  const GLenum result = glGetError();
+  if (result != GL_NO_ERROR) {
+    std::cerr << "ERROR: UBO '" << name << "'の作成に失敗" << std::endl;
+    return {};
+  }
+  GLState::BindBuffer(GL_UNIFORM_BUFFER, 0);
+
+  p->size = size;
+  p->bindingPoint = bindingPoint;
+  p->name = name;
+  return p;
+}
+
+/**
+* デストラクタ.
+*/
+UniformBuffer::~UniformBuffer()
+{
+  if (ubo) {
+    GLState::DeleteBuffer(ubo);
+  }
+}
+
+/**
+* Uniformバッファにデータを転送する.
+*
+* @param data   転送するデータへのポインタ.
+* @param offset 転送先のバイトオフセット.
+* @param size   転送するバイト数.
+*
+* @retval true  転送成功.
+* @retval false 転送失敗.
+*/
+bool UniformBuffer::BufferSubData(const GLvoid* data, GLintptr offset, GLsizeiptr size)
+{
+  if (offset + size > this->size) {
+    std::cerr << "ERROR(" << name << "): 転送範囲がバッファサイズを越えています(buffer=" <<
+      this->size << " offset=" << offset << " size=" << size << ")" << std::endl;
+    return false;
+  }
+  if (offset == 0 && size == 0) {
+    size = this->size;
+  }
+  GLState::BindBuffer(GL_UNIFORM_BUFFER, ubo);
+  glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+  return true;
+}
+
+/**
+* 指定された範囲をバインディング・ポイントに割り当てる.
+*
+* @param offset 割り当てる範囲のバイトオフセット.
+* @param size   割り当てる範囲のバイト数.
+*/
+void UniformBuffer::BindBufferRange(GLintptr offset, GLsizeiptr size) const
+{
+  GLState::BindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, ubo, offset, size);
+}
+
+/**
+* UBOをシステムメモリにマップする.
+*
+* @return マップしたメモリへのポインタ.
+*/
+void* UniformBuffer::MapBuffer() const
+{
+  GLState::BindBuffer(GL_UNIFORM_BUFFER, ubo);
+  return glMapBufferRange(GL_UNIFORM_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+}
+
+/**
+* UBOの一部をシステムメモリにマップする.
+*
+* @param offset マップする範囲のバイトオフセット.
+* @param size   マップする範囲のバイト数.
+* @param access アクセス方法を示すフラグ(GL_MAP_WRITE_BITなど).
+*
+* @return マップしたメモリへのポインタ.
+*/
+void* UniformBuffer::MapBufferRange(GLintptr offset, GLsizeiptr size, GLbitfield access) const
+{
+  GLState::BindBuffer(GL_UNIFORM_BUFFER, ubo);
+  return glMapBufferRange(GL_UNIFORM_BUFFER, offset, size, access);
+}
+
+/**
+* マップした範囲のうち、書き換えた部分をGPUに通知する.
+*
+* @param offset 書き換えた範囲の、マップした範囲の先頭からのバイトオフセット.
+* @param size   書き換えた範囲のバイト数.
+*
+* GL_MAP_FLUSH_EXPLICIT_BITを指定してマップした場合に使う.
+*/
+void UniformBuffer::FlushMappedBufferRange(GLintptr offset, GLsizeiptr size) const
+{
+  glFlushMappedBufferRange(GL_UNIFORM_BUFFER, offset, size);
+}
+
+/**
+* バッファの割り当てを解除する.
+*/
+void UniformBuffer::UnmapBuffer() const
+{
+  glUnmapBuffer(GL_UNIFORM_BUFFER);
+}
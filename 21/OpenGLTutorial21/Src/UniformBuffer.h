@@ -1,37 +1,42 @@
-/**
-* @file UniformBuffer.h
-*/
-#ifndef UNIFORMBUFFER_H_INCLUDED
-#define UNIFORMBUFFER_H_INCLUDED
-#include <GL/glew.h>
-#include <string>
-#include <memory>
-
-class UniformBuffer;
-typedef std::shared_ptr<UniformBuffer> UniformBufferPtr; ///< UBO|C^^.
-
-/**
-* UBOǗp\.
-*/
-class UniformBuffer {
-public:
-  static UniformBufferPtr Create(GLsizeiptr size, GLuint bindingPoint, const char* name);
-  bool BufferSubData(const GLvoid* data, GLintptr offset = 0, GLsizeiptr size = 0);
-  void BindBufferRange(GLintptr offset, GLsizeiptr size) const;
-  void* MapBuffer() const;
-  void UnmapBuffer() const;
-
-private:
-  UniformBuffer() = default;
-  ~UniformBuffer();
-  UniformBuffer(const UniformBuffer&) = delete;
-  UniformBuffer& operator=(const UniformBuffer&) = delete;
-
-private:
-  GLuint ubo = 0; ///< Uniform Buffer Object.
-  GLsizeiptr size = 0; ///< UBÕoCgTCY.
-  GLuint bindingPoint; ///< UBO̊蓖ĂĐoCfBOE|Cg.
-  std::string name; ///< UBO.
-};
-
+/**
+* @file UniformBuffer.h
+*/
+#ifndef UNIFORMBUFFER_H_INCLUDED
+#define UNIFORMBUFFER_H_INCLUDED
+#include <GL/glew.h>
+#include <string>
+#include <memory>
+
+class UniformBuffer;
+typedef std::shared_ptr<UniformBuffer> UniformBufferPtr; ///< UBOポインタ型.
+
+/**
+* UBO管理用構造体.
+*/
+class UniformBuffer {
+public:
+  static UniformBufferPtr Create(GLsizeiptr size, GLuint bindingPoint, const char* name);
+  bool BufferSubData(const GLvoid* data, GLintptr offset = 0, GLsizeiptr size = 0);
+  void BindBufferRange(GLintptr offset, GLsizeiptr size) const;
+  void* MapBuffer() const;
+  void* MapBufferRange(GLintptr offset, GLsizeiptr size, GLbitfield access) const;
+  void FlushMappedBufferRange(GLintptr offset, GLsizeiptr size) const;
+  void UnmapBuffer() const;
+  GLsizeiptr Size() const { return size; }
+  GLuint Id() const { return ubo; }
+  GLuint BindingPoint() const { return bindingPoint; }
+
+private:
+  UniformBuffer() = default;
+  ~UniformBuffer();
+  UniformBuffer(const UniformBuffer&) = delete;
+  UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+private:
+  GLuint ubo = 0; ///< Uniform Buffer Object.
+  GLsizeiptr size = 0; ///< UBOのバイトサイズ.
+  GLuint bindingPoint; ///< UBOの割り当てて先バインディング・ポイント.
+  std::string name; ///< UBO名.
+};
+
 #endif // UNIFORMBUFFER_H_INCLUDED
\ No newline at end of file
@@ -1,14 +1,14 @@
-#version 410
-
-layout(location=0) in vec2 inTexCoord;
-
-out vec4 fragColor;
-
-uniform sampler2D colorSampler;
-
-void main()
-{
-  const float numShades = 3; // e̒i.
-  fragColor = texture(colorSampler, inTexCoord);
-  fragColor.rgb = ceil(fragColor.rgb * numShades) * (1 / numShades);
-}
+#version 410
+
+layout(location=0) in vec2 inTexCoord;
+
+out vec4 fragColor;
+
+uniform sampler2D colorSampler;
+
+void main()
+{
+  const float numShades = 3; // 影の段数.
+  fragColor = texture(colorSampler, inTexCoord);
+  fragColor.rgb = ceil(fragColor.rgb * numShades) * (1 / numShades);
+}
@@ -0,0 +1,242 @@
+/**
+* @file Collision.cpp
+*/
+#include "Collision.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <cmath>
+
+namespace Collision {
+
+static const int cellCoordBits = 21; ///< キーに格納するセル座標1軸あたりのビット数.
+static const int cellCoordBias = 1 << (cellCoordBits - 1); ///< セル座標を非負にするための補正値.
+static const int maxCellsPerElement = 64; ///< 1要素が記録されるセル数の上限. これを越える要素はlargeListに入れる.
+static const int maxCellsPerQuery = 512; ///< 1回の検索で調べるセル数の上限. これを越える場合は全要素を返す.
+
+/**
+* セル座標からキーを作成する.
+*
+* @param x セルのX座標.
+* @param y セルのY座標.
+* @param z セルのZ座標.
+*
+* @return セルを一意に識別するキー.
+*/
+uint64_t SpatialGrid::MakeKey(int x, int y, int z)
+{
+  const uint64_t mask = (1ULL << cellCoordBits) - 1;
+  return (static_cast<uint64_t>(x + cellCoordBias) & mask) |
+    ((static_cast<uint64_t>(y + cellCoordBias) & mask) << cellCoordBits) |
+    ((static_cast<uint64_t>(z + cellCoordBias) & mask) << (cellCoordBits * 2));
+}
+
+/**
+* 座標をセル座標に変換する.
+*
+* @param v 変換する座標.
+*
+* @return vを含むセルの座標.
+*/
+glm::ivec3 SpatialGrid::ToCell(const glm::vec3& v) const
+{
+  const float limit = static_cast<float>(cellCoordBias - 1);
+  glm::ivec3 cell;
+  for (int i = 0; i < 3; ++i) {
+    cell[i] = static_cast<int>(std::floor(glm::clamp(v[i] * reciprocalCellSize, -limit, limit)));
+  }
+  return cell;
+}
+
+/**
+* 全ての要素を削除し、セルの大きさを設定する.
+*
+* @param size セルの一辺の長さ.
+*/
+void SpatialGrid::Clear(float size)
+{
+  cellSize = size > 0 ? size : 1.0f;
+  reciprocalCellSize = 1.0f / cellSize;
+  cellList.clear();
+  largeList.clear();
+  idList.clear();
+}
+
+/**
+* 要素を登録する.
+*
+* @param id  要素ID. 検索結果としてこの値が返される.
+* @param min 要素を囲む直方体の最小座標.
+* @param max 要素を囲む直方体の最大座標.
+*
+* 全ての要素を登録したら、検索する前にBuild()を呼び出すこと.
+*/
+void SpatialGrid::Insert(uint32_t id, const glm::vec3& min, const glm::vec3& max)
+{
+  idList.push_back(id);
+  const glm::ivec3 cellMin = ToCell(min);
+  const glm::ivec3 cellMax = ToCell(max);
+  const glm::ivec3 cellCount = cellMax - cellMin + glm::ivec3(1);
+  if (static_cast<int64_t>(cellCount.x) * cellCount.y * cellCount.z > maxCellsPerElement) {
+    largeList.push_back(id);
+    return;
+  }
+  for (int z = cellMin.z; z <= cellMax.z; ++z) {
+    for (int y = cellMin.y; y <= cellMax.y; ++y) {
+      for (int x = cellMin.x; x <= cellMax.x; ++x) {
+        cellList.push_back({ MakeKey(x, y, z), id });
+      }
+    }
+  }
+}
+
+/**
+* 登録された要素を検索可能な状態にする.
+*/
+void SpatialGrid::Build()
+{
+  std::sort(cellList.begin(), cellList.end());
+}
+
+/**
+* 指定された範囲と重なる可能性のある要素を検索する.
+*
+* @param min    検索範囲の最小座標.
+* @param max    検索範囲の最大座標.
+* @param result 検索結果を格納する配列.
+*               要素IDが昇順かつ重複なしの状態で末尾に追加される.
+*
+* 結果には実際には重なっていない要素も含まれうるため、呼び出し側で詳細な判定を行うこと.
+*/
+void SpatialGrid::Query(const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& result) const
+{
+  const size_t first = result.size();
+  const glm::ivec3 cellMin = ToCell(min);
+  const glm::ivec3 cellMax = ToCell(max);
+  const glm::ivec3 cellCount = cellMax - cellMin + glm::ivec3(1);
+  if (static_cast<int64_t>(cellCount.x) * cellCount.y * cellCount.z > maxCellsPerQuery) {
+    result.insert(result.end(), idList.begin(), idList.end());
+  } else {
+    for (int z = cellMin.z; z <= cellMax.z; ++z) {
+      for (int y = cellMin.y; y <= cellMax.y; ++y) {
+        for (int x = cellMin.x; x <= cellMax.x; ++x) {
+          const uint64_t key = MakeKey(x, y, z);
+          auto itr = std::lower_bound(cellList.begin(), cellList.end(), Cell{ key, 0 });
+          for (; itr != cellList.end() && itr->key == key; ++itr) {
+            result.push_back(itr->id);
+          }
+        }
+      }
+    }
+    result.insert(result.end(), largeList.begin(), largeList.end());
+  }
+  std::sort(result.begin() + first, result.end());
+  result.erase(std::unique(result.begin() + first, result.end()), result.end());
+}
+
+/**
+* 総当たりと空間ハッシュで、2つのグループ間の衝突判定にかかる時間を計測する.
+*
+* @param minCount 最初に計測する要素数(2グループの合計).
+* @param maxCount 最後に計測する要素数(2グループの合計).
+*
+* 要素数を10倍ずつ増やしながら計測し、結果を標準出力に出力する.
+* 弾の撃ち合いを想定し、1辺1～2の直方体をXZ平面上にばらまく. 要素の密度が一定になるよう、
+* ばらまく範囲の面積は要素数に比例させる.
+* 両方の方法で見つかった衝突の数が一致しなければ、エラーとして標準エラーに出力する.
+*/
+void BenchmarkBroadphase(size_t minCount, size_t maxCount)
+{
+  typedef std::chrono::steady_clock Clock;
+  static const double minSeconds = 0.2; ///< 1つの計測にかける最小時間.
+
+  struct Box {
+    glm::vec3 min;
+    glm::vec3 max;
+  };
+  const auto hasCollision = [](const Box& lhs, const Box& rhs) {
+    return lhs.min.x <= rhs.max.x && lhs.max.x >= rhs.min.x &&
+      lhs.min.y <= rhs.max.y && lhs.max.y >= rhs.min.y &&
+      lhs.min.z <= rhs.max.z && lhs.max.z >= rhs.min.z;
+  };
+
+  // 時間がminSecondsを越えるまでfuncを繰り返し、1回あたりの時間を返す.
+  const auto measure = [](const auto& func) {
+    int count = 0;
+    const Clock::time_point start = Clock::now();
+    double seconds = 0;
+    do {
+      func();
+      ++count;
+      seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (seconds < minSeconds);
+    return seconds / count;
+  };
+
+  std::mt19937 rand(0);
+  std::vector<Box> listL;
+  std::vector<Box> listR;
+  SpatialGrid grid;
+  std::vector<uint32_t> candidateList;
+  for (size_t n = minCount; n <= maxCount; n *= 10) {
+    const float range = std::sqrt(static_cast<float>(n)) * 4.0f;
+    std::uniform_real_distribution<float> rndPos(-range * 0.5f, range * 0.5f);
+    std::uniform_real_distribution<float> rndSize(1.0f, 2.0f);
+    const auto randomBox = [&]() {
+      const glm::vec3 pos(rndPos(rand), 0, rndPos(rand));
+      const glm::vec3 size(rndSize(rand), rndSize(rand), rndSize(rand));
+      return Box{ pos - size * 0.5f, pos + size * 0.5f };
+    };
+    listL.clear();
+    listR.clear();
+    for (size_t i = 0; i < n / 2; ++i) {
+      listL.push_back(randomBox());
+      listR.push_back(randomBox());
+    }
+
+    size_t bruteForceHitCount = 0;
+    const double bruteForceSeconds = measure([&]() {
+      bruteForceHitCount = 0;
+      for (const Box& l : listL) {
+        for (const Box& r : listR) {
+          bruteForceHitCount += hasCollision(l, r);
+        }
+      }
+    });
+
+    // Entity::Buffer::Updateと同じく、両辺の衝突形状の平均的な大きさの2倍をセルの大きさにする.
+    size_t gridHitCount = 0;
+    const double gridSeconds = measure([&]() {
+      float totalSize = 0;
+      for (const std::vector<Box>* list : { &listL, &listR }) {
+        for (const Box& e : *list) {
+          const glm::vec3 size = e.max - e.min;
+          totalSize += std::max(size.x, std::max(size.y, size.z));
+        }
+      }
+      grid.Clear(totalSize / static_cast<float>(listL.size() + listR.size()) * 2.0f);
+      for (size_t i = 0; i < listR.size(); ++i) {
+        grid.Insert(static_cast<uint32_t>(i), listR[i].min, listR[i].max);
+      }
+      grid.Build();
+      gridHitCount = 0;
+      for (const Box& l : listL) {
+        candidateList.clear();
+        grid.Query(l.min, l.max, candidateList);
+        for (uint32_t id : candidateList) {
+          gridHitCount += hasCollision(l, listR[id]);
+        }
+      }
+    });
+
+    if (gridHitCount != bruteForceHitCount) {
+      std::cerr << "ERROR in Collision::BenchmarkBroadphase: 衝突の数が一致しません(総当たり=" <<
+        bruteForceHitCount << " 空間ハッシュ=" << gridHitCount << ")." << std::endl;
+    }
+    std::cout << "BenchmarkBroadphase: entities=" << n << " hits=" << gridHitCount <<
+      " bruteForce=" << bruteForceSeconds * 1000.0 << "ms grid=" << gridSeconds * 1000.0 << "ms" << std::endl;
+  }
+}
+
+} // namespace Collision
\ No newline at end of file
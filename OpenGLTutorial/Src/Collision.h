@@ -0,0 +1,52 @@
+/**
+* @file Collision.h
+*/
+#ifndef COLLISION_H_INCLUDED
+#define COLLISION_H_INCLUDED
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+/**
+* 衝突判定の補助機能を格納する名前空間.
+*/
+namespace Collision {
+
+/**
+* 一様グリッドによる空間ハッシュ.
+*
+* 登録された直方体を、それと重なる全てのセルに記録する.
+* 検索時は、指定範囲と重なるセルに記録された要素だけを列挙する.
+* 総当たりでO(N*M)かかる判定を、おおむねO(N+M)に減らすために使う.
+*/
+class SpatialGrid
+{
+public:
+  void Clear(float cellSize);
+  void Insert(uint32_t id, const glm::vec3& min, const glm::vec3& max);
+  void Build();
+  void Query(const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& result) const;
+  float CellSize() const { return cellSize; }
+
+private:
+  /// セルと要素の組.
+  struct Cell {
+    uint64_t key; ///< セル座標から作成したキー.
+    uint32_t id; ///< 要素ID.
+    bool operator<(const Cell& rhs) const { return key < rhs.key || (key == rhs.key && id < rhs.id); }
+  };
+  static uint64_t MakeKey(int x, int y, int z);
+  glm::ivec3 ToCell(const glm::vec3& v) const;
+
+  float cellSize = 1.0f; ///< セルの一辺の長さ.
+  float reciprocalCellSize = 1.0f; ///< セルの一辺の長さの逆数.
+  std::vector<Cell> cellList; ///< セルと要素の組のリスト. Build()によってキー順に整列される.
+  std::vector<uint32_t> largeList; ///< 多数のセルにまたがるため、常に検索結果に含める要素のリスト.
+  std::vector<uint32_t> idList; ///< 登録された全要素のリスト.
+};
+
+void BenchmarkBroadphase(size_t minCount, size_t maxCount);
+
+} // namespace Collision
+
+#endif // COLLISION_H_INCLUDED
\ No newline at end of file
@@ -1,70 +1,70 @@
-/**
-* @file Font.h
-*/
-#ifndef FONT_H_INCLUDED
-#define FONT_H_INCLUDED
-#include <GL/glew.h>
-#include "BufferObject.h"
-#include "Shader.h"
-#include <glm/glm.hpp>
-#include <vector>
-#include <string>
-
-namespace Font {
-
-struct Vertex;
-
-/// tHg.
-struct FontInfo {
-  int id = -1;        ///< R[h.
-  glm::u16vec2 uv[2]; ///< tHg摜̃eNX`W.
-  glm::vec2 size;     ///< tHg摜̕\TCY.
-  glm::vec2 offset;   ///< \ʒu炷.
-  float xadvance = 0; ///< J[\i߂鋗.
-};
-
-/**
-* rbg}bvtHg`NX.
-*/
-class Renderer
-{
-public:
-  Renderer() = default;
-  ~Renderer() = default;
-  Renderer(const Renderer&) = delete;
-  Renderer& operator=(const Renderer&) = delete;
-
-  bool Init(size_t maxChar, const glm::vec2& ss, glm::f32 fontSize);
-  bool LoadFromFile(const char* filename);
-
-  void Scale(const glm::vec2& s) { scale = s; }
-  const glm::vec2& Scale() const { return scale; }
-  void Color(const glm::vec4& c);
-  glm::vec4 Color() const;
-
-  void MapBuffer();
-  bool AddString(const glm::vec2& position, const char* str);
-  void UnmapBuffer();
-  void Draw() const;
-
-private:
-  BufferObject vbo;
-  BufferObject ibo;
-  VertexArrayObject vao;
-  GLsizei vboCapacity = 0;        ///< VBOɊi[\ȍő咸_.
-  std::vector<FontInfo> fontList; ///< tHgʒũXg.
-  std::string texFilename;        ///< tHgeNX`t@C.
-  Shader::ProgramPtr progFont;    ///< tHg`pVF[_vO.
-  glm::vec2 pixelSizeInClipCoord; ///< NbvWnɉ1sNZ̑傫.
-  glm::f32 normalFontSize;        ///< g嗦1.0̂Ƃɉʂɕ\TCY(sNZP).
-  glm::vec2 baseScale;            ///< normalFontSizeŕ\邽߂̔{.
-
-  glm::vec2 scale = glm::vec2(1, 1); ///< tHg`悷Ƃ̊g嗦.
-  glm::u8vec4 color = glm::u8vec4(255, 255, 255, 255); ///< tHg`悷Ƃ̐F.
-  GLsizei vboSize = 0;            ///< VBOɊi[Ă钸_.
-  Vertex* pVBO = nullptr;         ///< VBOւ̃|C^.
-};
-
-} // namespace Font
-
-#endif // FONT_H_INCLUDED
+/**
+* @file Font.h
+*/
+#ifndef FONT_H_INCLUDED
+#define FONT_H_INCLUDED
+#include <GL/glew.h>
+#include "BufferObject.h"
+#include "Shader.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+
+namespace Font {
+
+struct Vertex;
+
+/// フォント情報.
+struct FontInfo {
+  int id = -1;        ///< 文字コード.
+  glm::u16vec2 uv[2]; ///< フォント画像のテクスチャ座標.
+  glm::vec2 size;     ///< フォント画像の表示サイズ.
+  glm::vec2 offset;   ///< 表示位置をずらす距離.
+  float xadvance = 0; ///< カーソルを進める距離.
+};
+
+/**
+* ビットマップフォント描画クラス.
+*/
+class Renderer
+{
+public:
+  Renderer() = default;
+  ~Renderer() = default;
+  Renderer(const Renderer&) = delete;
+  Renderer& operator=(const Renderer&) = delete;
+
+  bool Init(size_t maxChar, const glm::vec2& ss, glm::f32 fontSize);
+  bool LoadFromFile(const char* filename);
+
+  void Scale(const glm::vec2& s) { scale = s; }
+  const glm::vec2& Scale() const { return scale; }
+  void Color(const glm::vec4& c);
+  glm::vec4 Color() const;
+
+  void MapBuffer();
+  bool AddString(const glm::vec2& position, const char* str);
+  void UnmapBuffer();
+  void Draw() const;
+
+private:
+  BufferObject vbo;
+  BufferObject ibo;
+  VertexArrayObject vao;
+  GLsizei vboCapacity = 0;        ///< VBOに格納可能な最大頂点数.
+  std::vector<FontInfo> fontList; ///< フォント位置情報のリスト.
+  std::string texFilename;        ///< フォントテクスチャファイル名.
+  Shader::ProgramPtr progFont;    ///< フォント描画用シェーダプログラム.
+  glm::vec2 pixelSizeInClipCoord; ///< クリップ座標系に於ける1ピクセルの大きさ.
+  glm::f32 normalFontSize;        ///< 拡大率1.0のときに画面に表示されるサイズ(ピクセル単位).
+  glm::vec2 baseScale;            ///< normalFontSizeで表示するための倍率.
+
+  glm::vec2 scale = glm::vec2(1, 1); ///< フォントを描画するときの拡大率.
+  glm::u8vec4 color = glm::u8vec4(255, 255, 255, 255); ///< フォントを描画するときの色.
+  GLsizei vboSize = 0;            ///< VBOに格納されている頂点数.
+  Vertex* pVBO = nullptr;         ///< VBOへのポインタ.
+};
+
+} // namespace Font
+
+#endif // FONT_H_INCLUDED
@@ -1,594 +1,594 @@
-/**
-* @file GameEngine.cpp
-*/
-#include "GameEngine.h"
-#include "GLFWEW.h"
-#include "Audio.h"
-#include <glm/gtc/matrix_transform.hpp>
-#include <iostream>
-
-/// _f[^^.
-struct Vertex
-{
-  glm::vec3 position; ///< W.
-  glm::vec4 color; ///< F.
-  glm::vec2 texCoord; ///< eNX`W.
-};
-
-/// _f[^.
-const Vertex vertices[] = {
-  { {-0.5f, -0.3f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, {0.0f, 0.0f} },
-  { { 0.3f, -0.3f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 0.0f} },
-  { { 0.3f,  0.5f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f} },
-  { {-0.5f,  0.5f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, {0.0f, 1.0f} },
-
-  { {-0.3f,  0.3f, 0.1f}, {0.0f, 0.0f, 1.0f, 1.0f}, {0.0f, 1.0f} },
-  { {-0.3f, -0.5f, 0.1f}, {0.0f, 1.0f, 1.0f, 1.0f}, {0.0f, 0.0f} },
-  { { 0.5f, -0.5f, 0.1f}, {0.0f, 0.0f, 1.0f, 1.0f}, {1.0f, 0.0f} },
-  { { 0.5f, -0.5f, 0.1f}, {1.0f, 0.0f, 0.0f, 1.0f}, {1.0f, 0.0f} },
-  { { 0.5f,  0.3f, 0.1f}, {1.0f, 1.0f, 0.0f, 1.0f}, {1.0f, 1.0f} },
-  { {-0.3f,  0.3f, 0.1f}, {1.0f, 0.0f, 0.0f, 1.0f}, {0.0f, 1.0f} },
-
-  { {-1.0f,-1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, {0.0f, 0.0f} },
-  { { 1.0f,-1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 0.0f} },
-  { { 1.0f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f} },
-  { {-1.0f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, {0.0f, 1.0f} },
-};
-
-/// CfbNXf[^.
-const GLuint indices[] = {
-  0, 1, 2, 2, 3, 0,
-  4, 5, 6, 7, 8, 9,
-  10, 11, 12, 12, 13, 10,
-};
-
-/**
-* `f[^.
-*/
-struct RenderingPart
-{
-  GLvoid* offset; ///< `JnCfbNX̃oCgItZbg.
-  GLsizei size; ///< `悷CfbNX.
-};
-
-/**
-* RenderingPart쐬.
-*
-* @param offset `JnCfbNX̃ItZbg(CfbNXP).
-* @param size `悷CfbNX.
-*
-* @return 쐬`IuWFNg.
-*/
-constexpr RenderingPart MakeRenderingPart(GLsizei offset, GLsizei size) {
-  return { reinterpret_cast<GLvoid*>(offset * sizeof(GLuint)), size };
-}
-
-/**
-* `f[^Xg.
-*/
-static const RenderingPart renderingParts[] = {
-  MakeRenderingPart(0, 12),
-  MakeRenderingPart(12, 6),
-};
-
-/**
-* Vertex Buffer Object쐬.
-*
-* @param size _f[^̃TCY.
-* @param data _f[^ւ̃|C^.
-*
-* @return 쐬VBO.
-*/
-GLuint CreateVBO(GLsizeiptr size, const GLvoid* data)
-{
-  GLuint vbo = 0;
-  glGenBuffers(1, &vbo);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  return vbo;
-}
-
-/**
-* Index Buffer Object쐬.
-*
-* @param size CfbNXf[^̃TCY.
-* @param data CfbNXf[^ւ̃|C^.
-*
-* @return 쐬IBO.
-*/
-GLuint CreateIBO(GLsizeiptr size, const GLvoid* data)
-{
-  GLuint ibo = 0;
-  glGenBuffers(1, &ibo);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-  return ibo;
-}
-
-/**
-* _Agr[gݒ肷.
-*
-* @param index _Agr[g̃CfbNX.
-* @param cls   _f[^^.
-* @param mbr   _Agr[gɐݒ肷cls̃oϐ.
-*/
-#define SetVertexAttribPointer(index, cls, mbr) SetVertexAttribPointerI( \
-  index, \
-  sizeof(cls::mbr) / sizeof(float), \
-  sizeof(cls), \
-  reinterpret_cast<GLvoid*>(offsetof(cls, mbr)))
-
-void SetVertexAttribPointerI(GLuint index, GLint size, GLsizei stride, const GLvoid* pointer)
-{
-  glEnableVertexAttribArray(index);
-  glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, stride, pointer);
-}
-
-/**
-* Vertex Array Object쐬.
-*
-* @param vbo VAOɊ֘AtVBO.
-* @param ibo VAOɊ֘AtIBO.
-*
-* @return 쐬VAO.
-*/
-GLuint CreateVAO(GLuint vbo, GLuint ibo)
-{
-  GLuint vao = 0;
-  glGenVertexArrays(1, &vao);
-  glBindVertexArray(vao);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-  SetVertexAttribPointer(0, Vertex, position);
-  SetVertexAttribPointer(1, Vertex, color);
-  SetVertexAttribPointer(2, Vertex, texCoord);
-  glBindVertexArray(0);
-  glDeleteBuffers(1, &vbo);
-  glDeleteBuffers(1, &ibo);
-  return vao;
-}
-
-/**
-* Q[GW̃CX^X擾.
-*
-* @return Q[GW̃CX^X.
-*/
-GameEngine& GameEngine::Instance()
-{
-  static GameEngine instance;
-  return instance;
-}
-
-/**
-* Q[GW.
-*
-* @param w     EBhE̕`͈͂̕(sNZ).
-* @param h     EBhE̕`͈͂̍(sNZ).
-* @param title EBhE^Cg(UTF-80I[).
-*
-* @retval true  .
-* @retval false s.
-*
-* Run֐ĂяoOɁAxĂяoĂKv.
-* xɐƁAȌ̌Ăяoł͂ȂɂtrueԂ.
-*/
-bool GameEngine::Init(int w, int h, const char* title)
-{
-  if (isInitialized) {
-    return true;
-  }
-  if (!GLFWEW::Window::Instance().Init(w, h, title)) {
-    return false;
-  }
-
-  width = w;
-  height = h;
-  vbo = CreateVBO(sizeof(vertices), vertices);
-  ibo = CreateIBO(sizeof(indices), indices);
-  vao = CreateVAO(vbo, ibo);
-  uboLight = UniformBuffer::Create(sizeof(InterfaceBlock::LightData), InterfaceBlock::BINDINGPOINT_LIGHTDATA, "LightData");
-  uboPostEffect = UniformBuffer::Create(sizeof(InterfaceBlock::PostEffectData), InterfaceBlock::BINDINGPOINT_POSTEFFECTDATA, "PostEffectData");
-  offscreen = OffscreenBuffer::Create(width, height);
-  if (!vbo || !ibo || !vao || !uboLight || !uboPostEffect || !offscreen) {
-    std::cerr << "ERROR: GameEnginȅɎs" << std::endl;
-    return false;
-  }
-
-  static const char* const shaderNameList[][3] = {
-    { "Tutorial", "Res/Tutorial.vert", "Res/Tutorial.frag" },
-    { "ColorFilter", "Res/ColorFilter.vert", "Res/ColorFilter.frag" },
-    { "NonLighting", "Res/NonLighting.vert", "Res/NonLighting.frag" },
-  };
-  shaderMap.reserve(sizeof(shaderNameList) / sizeof(shaderNameList[0]));
-  for (auto& e : shaderNameList) {
-    Shader::ProgramPtr program = Shader::Program::Create(e[1], e[2]);
-    if (!program) {
-      return false;
-    }
-    shaderMap.insert(std::make_pair(std::string(e[0]), program));
-  }
-
-  meshBuffer = Mesh::Buffer::Create(50000, 50000);
-  if (!meshBuffer) {
-    std::cerr << "ERROR: GameEnginȅɎs" << std::endl;
-    return false;
-  }
-  entityBuffer = Entity::Buffer::Create(1024, sizeof(InterfaceBlock::VertexData), 0, "VertexData");
-  if (!entityBuffer) {
-    std::cerr << "ERROR: GameEnginȅɎs" << std::endl;
-    return false;
-  }
-
-  shaderMap["Tutorial"]->UniformBlockBinding(*entityBuffer->UniformBuffer());
-  shaderMap["Tutorial"]->UniformBlockBinding(*uboLight);
-  shaderMap["ColorFilter"]->UniformBlockBinding(*uboPostEffect);
-
-  rand.seed(std::random_device()());
-  fontRenderer.Init(1024, glm::vec2(static_cast<float>(w), static_cast<float>(h)), 32);
-  isInitialized = true;
-  return true;
-}
-
-/**
-* Q[s.
-*/
-void GameEngine::Run()
-{
-  GLFWEW::Window& window = GLFWEW::Window::Instance();
-  double prevTime = glfwGetTime();
-  while (!window.ShouldClose()) {
-    // fobOȂǓȏ󋵂łȂ΂肦Ȃƍl邵l.
-    static const double thresholdToInvalidate = 0.25f;
-
-    const double curTime = glfwGetTime();
-    double delta = curTime - prevTime;
-    if (delta > thresholdToInvalidate) {
-      delta = 1.0 / 60.0;
-    }
-    prevTime = curTime;
-    Update(delta);
-    Render();
-    window.SwapBuffers();
-  }
-}
-
-/**
-* ԍXV֐ݒ肷.
-*
-* @param func ݒ肷XV֐.
-*/
-void GameEngine::UpdateFunc(const UpdateFuncType& func)
-{
-  updateFunc = func;
-}
-
-/**
-* ԍXV֐擾.
-*
-* @return ݒ肳ĂXV֐.
-*/
-const GameEngine::UpdateFuncType& GameEngine::UpdateFunc() const
-{
-  return updateFunc;
-}
-
-/**
-* eNX`ǂݍ.
-*
-* @param filename eNX`t@C.
-*
-* @retval true  ǂݍݐ.
-* @retval false ǂݍݎs.
-*/
-bool GameEngine::LoadTextureFromFile(const char* filename)
-{
-  const auto itr = textureBuffer.find(filename);
-  if (itr != textureBuffer.end()) {
-    return true;
-  }
-  TexturePtr texture = Texture::LoadFromFile(filename);
-  if (!texture) {
-    return false;
-  }
-  textureBuffer.insert(std::make_pair(std::string(filename), texture));
-  return true;
-}
-
-/**
-* eNX`擾.
-*
-* @param filename eNX`t@C.
-*
-* @return filenameɑΉeNX`ւ̃|C^.
-*         ΉeNX`ȂꍇnullptrԂ.
-*/
-const TexturePtr& GameEngine::GetTexture(const char* filename) const
-{
-  const auto itr = textureBuffer.find(filename);
-  if (itr != textureBuffer.end()) {
-    return itr->second;
-  }
-  static const TexturePtr dummy;
-  return dummy;
-}
-
-/**
-* bVǂݍ.
-*
-* @param filename bVt@C.
-*
-* @retval true  ǂݍݐ.
-* @retval false ǂݍݎs.
-*/
-bool GameEngine::LoadMeshFromFile(const char* filename)
-{
-  return meshBuffer->LoadMeshFromFile(filename);
-}
-
-/**
-* GeBeBǉ.
-*
-* @param groupId  GeBeB̃O[vID.
-* @param pos      GeBeB̍W.
-* @param meshName GeBeB̕\Ɏgp郁bV.
-* @param texName  GeBeB̕\ɎgeNX`t@C.
-* @param func     GeBeB̏ԂXV֐(܂͊֐IuWFNg).
-* @param shader   GeBeB̕\ɎgVF[_.
-*
-* @return ǉGeBeBւ̃|C^.
-*         ȏGeBeBǉłȂꍇnullptrԂ.
-*         ]g嗦͂̃|C^oRŐݒ肷.
-*         ȂÃ|C^AvP[VŕێKv͂Ȃ.
-*/
-Entity::Entity* GameEngine::AddEntity(int groupId, const glm::vec3& pos, const char* meshName, const char* texName, Entity::Entity::UpdateFuncType func, const char* shader)
-{
-  decltype(shaderMap)::const_iterator itr = shaderMap.end();
-  if (shader) {
-    itr = shaderMap.find(shader);
-  }
-  if (itr == shaderMap.end()) {
-    itr = shaderMap.find("Tutorial");
-    if (itr == shaderMap.end()) {
-      return nullptr;
-    }
-  }
-
-  const Mesh::MeshPtr& mesh = meshBuffer->GetMesh(meshName);
-  const TexturePtr& tex = textureBuffer.find(texName)->second;
-  return entityBuffer->AddEntity(groupId, pos, mesh, tex, itr->second, func);
-}
-
-/**
-*@GeBeB폜.
-*
-* @param 폜GeBeB̃|C^.
-*/
-void GameEngine::RemoveEntity(Entity::Entity* e)
-{
-  entityBuffer->RemoveEntity(e);
-}
-
-/**
-* Cgݒ肷.
-*
-* @param indes  ݒ肷郉Cg̃CfbNX.
-* @param light  Cgf[^.
-*/
-void GameEngine::Light(int index, const InterfaceBlock::PointLight& light)
-{
-  if (index < 0 || index >= InterfaceBlock::maxLightCount) {
-    std::cerr << "WARNING: '" << index << "'͕sȃCgCfbNXł" << std::endl;
-    return;
-  }
-  lightData.light[index] = light;
-}
-
-/**
-* Cg擾.
-*
-* @param index 擾郉Cg̃CfbNX.
-*
-* @return Cgf[^.
-*/
-const InterfaceBlock::PointLight& GameEngine::Light(int index) const
-{
-  if (index < 0 || index >= InterfaceBlock::maxLightCount) {
-    std::cerr << "WARNING: '" << index << "'͕sȃCgCfbNXł" << std::endl;
-    static const InterfaceBlock::PointLight dummy;
-    return dummy;
-  }
-  return lightData.light[index];
-}
-
-/**
-* ݒ肷.
-*
-* @param color ̖邳.
-*/
-void GameEngine::AmbientLight(const glm::vec4& color)
-{
-  lightData.ambientColor = color;
-}
-
-/**
-* 擾.
-*
-* @return ̖邳.
-*/
-const glm::vec4& GameEngine::AmbientLight() const
-{
-  return lightData.ambientColor;
-}
-
-/**
-* _̈ʒuƎpݒ肷.
-*
-* @param cam ݒ肷Jf[^.
-*/
-void GameEngine::Camera(const CameraData& cam)
-{
-  camera = cam;
-}
-
-/**
-* _̈ʒuƎp擾.
-*
-* @return Jf[^.
-*/
-const GameEngine::CameraData& GameEngine::Camera() const
-{
-  return camera;
-}
-
-/**
-* IuWFNg擾.
-*
-* @return IuWFNg.
-*/
-std::mt19937& GameEngine::Rand()
-{
-  return rand;
-}
-
-/**
-* Q[pbh̏Ԃ擾.
-*/
-const GamePad& GameEngine::GetGamePad() const
-{
-  return GLFWEW::Window::Instance().GetGamePad();
-}
-
-/**
-* Փˉnhݒ肷.
-*
-* @param gid0    ՓˑΏۂ̃O[vID.
-* @param gid1    ՓˑΏۂ̃O[vID.
-* @param handler Փˉnh.
-*
-* Փ˂ՓˉnhĂтƂA菬O[vIDGeBeBɓn.
-* Ŏw肵O[vID̏Ƃ͖֌Wł邱Ƃɒӂ邱.
-* ex)
-*   CollisionHandler(10, 1, Func)
-*   ƂR[hŃnho^Ƃ. Փ˂ƁA
-*   Func(O[vID=1̃GeBeBAO[vID=10̃GeBeB)
-*   ̂悤ɌĂяo.
-*/
-void GameEngine::CollisionHandler(int gid0, int gid1, Entity::CollisionHandlerType handler)
-{
-  entityBuffer->CollisionHandler(gid0, gid1, handler);
-}
-
-/**
-* Փˉnh擾.
-*
-* @param gid0 ՓˑΏۂ̃O[vID.
-* @param gid1 ՓˑΏۂ̃O[vID.
-*
-* @return Փˉnh.
-*/
-const Entity::CollisionHandlerType& GameEngine::CollisionHandler(int gid0, int gid1) const
-{
-  return entityBuffer->CollisionHandler(gid0, gid1);
-}
-
-/**
-* Փˉnh̃XgNA.
-*/
-void GameEngine::ClearCollisionHandlerList()
-{
-  entityBuffer->ClearCollisionHandlerList();
-}
-
-/**
-* @copydoc Audio::Initialize
-*/
-bool GameEngine::InitAudio(const char* acfPath, const char* acbPath,
-  const char* awbPath, const char* dspBusName, size_t playerCount)
-{
-  return Audio::Initialize(acfPath, acbPath, awbPath, dspBusName, playerCount);
-}
-
-/**
-* @copydoc Audio::Play
-*/
-void GameEngine::PlayAudio(int playerId, int cueId)
-{
-  Audio::Play(playerId, cueId);
-}
-
-/**
-* @copydoc Audio::Stop
-*/
-void GameEngine::StopAudio(int playerId)
-{
-  Audio::Stop(playerId);
-}
-
-/**
-* fXgN^.
-*/
-GameEngine::~GameEngine()
-{
-  Audio::Destroy();
-  if (vao) {
-    glDeleteVertexArrays(1, &vao);
-  }
-  if (ibo) {
-    glDeleteBuffers(1, &ibo);
-  }
-  if (vbo) {
-    glDeleteBuffers(1, &vbo);
-  }
-}
-
-/**
-* Q[̏ԂXV.
-*
-* @param delta O̍XV̌oߎ(b).
-*/
-void GameEngine::Update(double delta)
-{
-  GLFWEW::Window::Instance().UpdateGamePad();
-  fontRenderer.MapBuffer();
-  if (updateFunc) {
-    updateFunc(delta);
-  }
-  const glm::mat4x4 matProj = glm::perspective(glm::radians(45.0f), static_cast<float>(width) / static_cast<float>(height), 1.0f, 200.0f);
-  const glm::mat4x4 matView = glm::lookAt(camera.position, camera.target, camera.up);
-  entityBuffer->Update(delta, matView, matProj);
-  fontRenderer.UnmapBuffer();
-}
-
-/**
-* Q[̏Ԃ`悷.
-*/
-void GameEngine::Render() const
-{
-  glBindFramebuffer(GL_FRAMEBUFFER, offscreen->GetFramebuffer());
-  glEnable(GL_DEPTH_TEST);
-  glEnable(GL_CULL_FACE);
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-  glViewport(0, 0, width, height);
-  glScissor(0, 0, width, height);
-  glClearColor(0.1f, 0.3f, 0.5f, 1.0f);
-  glClearDepth(1);
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  uboLight->BufferSubData(&lightData);
-  entityBuffer->Draw(meshBuffer);
-
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
-  glDisable(GL_DEPTH_TEST);
-  glDisable(GL_CULL_FACE);
-  glDisable(GL_BLEND);
-  glBindVertexArray(vao);
-  const Shader::ProgramPtr& progColorFilter = shaderMap.find("ColorFilter")->second;
-  progColorFilter->UseProgram();
-  InterfaceBlock::PostEffectData postEffect;
-  uboPostEffect->BufferSubData(&postEffect);
-  progColorFilter->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offscreen->GetTexutre());
-  glDrawElements(GL_TRIANGLES, renderingParts[1].size, GL_UNSIGNED_INT, renderingParts[1].offset);
-  fontRenderer.Draw();
-}
+/**
+* @file GameEngine.cpp
+*/
+#include "GameEngine.h"
+#include "GLFWEW.h"
+#include "Audio.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+
+/// 頂点データ型.
+struct Vertex
+{
+  glm::vec3 position; ///< 座標.
+  glm::vec4 color; ///< 色.
+  glm::vec2 texCoord; ///< テクスチャ座標.
+};
+
+/// 頂点データ.
+const Vertex vertices[] = {
+  { {-0.5f, -0.3f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, {0.0f, 0.0f} },
+  { { 0.3f, -0.3f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 0.0f} },
+  { { 0.3f,  0.5f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f} },
+  { {-0.5f,  0.5f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, {0.0f, 1.0f} },
+
+  { {-0.3f,  0.3f, 0.1f}, {0.0f, 0.0f, 1.0f, 1.0f}, {0.0f, 1.0f} },
+  { {-0.3f, -0.5f, 0.1f}, {0.0f, 1.0f, 1.0f, 1.0f}, {0.0f, 0.0f} },
+  { { 0.5f, -0.5f, 0.1f}, {0.0f, 0.0f, 1.0f, 1.0f}, {1.0f, 0.0f} },
+  { { 0.5f, -0.5f, 0.1f}, {1.0f, 0.0f, 0.0f, 1.0f}, {1.0f, 0.0f} },
+  { { 0.5f,  0.3f, 0.1f}, {1.0f, 1.0f, 0.0f, 1.0f}, {1.0f, 1.0f} },
+  { {-0.3f,  0.3f, 0.1f}, {1.0f, 0.0f, 0.0f, 1.0f}, {0.0f, 1.0f} },
+
+  { {-1.0f,-1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, {0.0f, 0.0f} },
+  { { 1.0f,-1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 0.0f} },
+  { { 1.0f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f} },
+  { {-1.0f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f, 1.0f}, {0.0f, 1.0f} },
+};
+
+/// インデックスデータ.
+const GLuint indices[] = {
+  0, 1, 2, 2, 3, 0,
+  4, 5, 6, 7, 8, 9,
+  10, 11, 12, 12, 13, 10,
+};
+
+/**
+* 部分描画データ.
+*/
+struct RenderingPart
+{
+  GLvoid* offset; ///< 描画開始インデックスのバイトオフセット.
+  GLsizei size; ///< 描画するインデックス数.
+};
+
+/**
+* RenderingPartを作成する.
+*
+* @param offset 描画開始インデックスのオフセット(インデックス単位).
+* @param size 描画するインデックス数.
+*
+* @return 作成した部分描画オブジェクト.
+*/
+constexpr RenderingPart MakeRenderingPart(GLsizei offset, GLsizei size) {
+  return { reinterpret_cast<GLvoid*>(offset * sizeof(GLuint)), size };
+}
+
+/**
+* 部分描画データリスト.
+*/
+static const RenderingPart renderingParts[] = {
+  MakeRenderingPart(0, 12),
+  MakeRenderingPart(12, 6),
+};
+
+/**
+* Vertex Buffer Objectを作成する.
+*
+* @param size 頂点データのサイズ.
+* @param data 頂点データへのポインタ.
+*
+* @return 作成したVBO.
+*/
+GLuint CreateVBO(GLsizeiptr size, const GLvoid* data)
+{
+  GLuint vbo = 0;
+  glGenBuffers(1, &vbo);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+  glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  return vbo;
+}
+
+/**
+* Index Buffer Objectを作成する.
+*
+* @param size インデックスデータのサイズ.
+* @param data インデックスデータへのポインタ.
+*
+* @return 作成したIBO.
+*/
+GLuint CreateIBO(GLsizeiptr size, const GLvoid* data)
+{
+  GLuint ibo = 0;
+  glGenBuffers(1, &ibo);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  return ibo;
+}
+
+/**
+* 頂点アトリビュートを設定する.
+*
+* @param index 頂点アトリビュートのインデックス.
+* @param cls   頂点データ型名.
+* @param mbr   頂点アトリビュートに設定するclsのメンバ変数名.
+*/
+#define SetVertexAttribPointer(index, cls, mbr) SetVertexAttribPointerI( \
+  index, \
+  sizeof(cls::mbr) / sizeof(float), \
+  sizeof(cls), \
+  reinterpret_cast<GLvoid*>(offsetof(cls, mbr)))
+
+void SetVertexAttribPointerI(GLuint index, GLint size, GLsizei stride, const GLvoid* pointer)
+{
+  glEnableVertexAttribArray(index);
+  glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, stride, pointer);
+}
+
+/**
+* Vertex Array Objectを作成する.
+*
+* @param vbo VAOに関連付けられるVBO.
+* @param ibo VAOに関連付けられるIBO.
+*
+* @return 作成したVAO.
+*/
+GLuint CreateVAO(GLuint vbo, GLuint ibo)
+{
+  GLuint vao = 0;
+  glGenVertexArrays(1, &vao);
+  glBindVertexArray(vao);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+  SetVertexAttribPointer(0, Vertex, position);
+  SetVertexAttribPointer(1, Vertex, color);
+  SetVertexAttribPointer(2, Vertex, texCoord);
+  glBindVertexArray(0);
+  glDeleteBuffers(1, &vbo);
+  glDeleteBuffers(1, &ibo);
+  return vao;
+}
+
+/**
+* ゲームエンジンのインスタンスを取得する.
+*
+* @return ゲームエンジンのインスタンス.
+*/
+GameEngine& GameEngine::Instance()
+{
+  static GameEngine instance;
+  return instance;
+}
+
+/**
+* ゲームエンジンを初期化する.
+*
+* @param w     ウィンドウの描画範囲の幅(ピクセル).
+* @param h     ウィンドウの描画範囲の高さ(ピクセル).
+* @param title ウィンドウタイトル(UTF-8の0終端文字列).
+*
+* @retval true  初期化成功.
+* @retval false 初期化失敗.
+*
+* Run関数を呼び出す前に、一度だけ呼び出しておく必要がある.
+* 一度初期化に成功すると、以後の呼び出しではなにもせずにtrueを返す.
+*/
+bool GameEngine::Init(int w, int h, const char* title)
+{
+  if (isInitialized) {
+    return true;
+  }
+  if (!GLFWEW::Window::Instance().Init(w, h, title)) {
+    return false;
+  }
+
+  width = w;
+  height = h;
+  vbo = CreateVBO(sizeof(vertices), vertices);
+  ibo = CreateIBO(sizeof(indices), indices);
+  vao = CreateVAO(vbo, ibo);
+  uboLight = UniformBuffer::Create(sizeof(InterfaceBlock::LightData), InterfaceBlock::BINDINGPOINT_LIGHTDATA, "LightData");
+  uboPostEffect = UniformBuffer::Create(sizeof(InterfaceBlock::PostEffectData), InterfaceBlock::BINDINGPOINT_POSTEFFECTDATA, "PostEffectData");
+  offscreen = OffscreenBuffer::Create(width, height);
+  if (!vbo || !ibo || !vao || !uboLight || !uboPostEffect || !offscreen) {
+    std::cerr << "ERROR: GameEngineの初期化に失敗" << std::endl;
+    return false;
+  }
+
+  static const char* const shaderNameList[][3] = {
+    { "Tutorial", "Res/Tutorial.vert", "Res/Tutorial.frag" },
+    { "ColorFilter", "Res/ColorFilter.vert", "Res/ColorFilter.frag" },
+    { "NonLighting", "Res/NonLighting.vert", "Res/NonLighting.frag" },
+  };
+  shaderMap.reserve(sizeof(shaderNameList) / sizeof(shaderNameList[0]));
+  for (auto& e : shaderNameList) {
+    Shader::ProgramPtr program = Shader::Program::Create(e[1], e[2]);
+    if (!program) {
+      return false;
+    }
+    shaderMap.insert(std::make_pair(std::string(e[0]), program));
+  }
+
+  meshBuffer = Mesh::Buffer::Create(50000, 50000);
+  if (!meshBuffer) {
+    std::cerr << "ERROR: GameEngineの初期化に失敗" << std::endl;
+    return false;
+  }
+  entityBuffer = Entity::Buffer::Create(1024, sizeof(InterfaceBlock::VertexData), 0, "VertexData");
+  if (!entityBuffer) {
+    std::cerr << "ERROR: GameEngineの初期化に失敗" << std::endl;
+    return false;
+  }
+
+  shaderMap["Tutorial"]->UniformBlockBinding(*entityBuffer->UniformBuffer());
+  shaderMap["Tutorial"]->UniformBlockBinding(*uboLight);
+  shaderMap["ColorFilter"]->UniformBlockBinding(*uboPostEffect);
+
+  rand.seed(std::random_device()());
+  fontRenderer.Init(1024, glm::vec2(static_cast<float>(w), static_cast<float>(h)), 32);
+  isInitialized = true;
+  return true;
+}
+
+/**
+* ゲームを実行する.
+*/
+void GameEngine::Run()
+{
+  GLFWEW::Window& window = GLFWEW::Window::Instance();
+  double prevTime = glfwGetTime();
+  while (!window.ShouldClose()) {
+    // デバッグ中など特殊な状況でなければありえないと考えられるしきい値.
+    static const double thresholdToInvalidate = 0.25f;
+
+    const double curTime = glfwGetTime();
+    double delta = curTime - prevTime;
+    if (delta > thresholdToInvalidate) {
+      delta = 1.0 / 60.0;
+    }
+    prevTime = curTime;
+    Update(delta);
+    Render();
+    window.SwapBuffers();
+  }
+}
+
+/**
+* 状態更新関数を設定する.
+*
+* @param func 設定する更新関数.
+*/
+void GameEngine::UpdateFunc(const UpdateFuncType& func)
+{
+  updateFunc = func;
+}
+
+/**
+* 状態更新関数を取得する.
+*
+* @return 設定されている更新関数.
+*/
+const GameEngine::UpdateFuncType& GameEngine::UpdateFunc() const
+{
+  return updateFunc;
+}
+
+/**
+* テクスチャを読み込む.
+*
+* @param filename テクスチャファイル名.
+*
+* @retval true  読み込み成功.
+* @retval false 読み込み失敗.
+*/
+bool GameEngine::LoadTextureFromFile(const char* filename)
+{
+  const auto itr = textureBuffer.find(filename);
+  if (itr != textureBuffer.end()) {
+    return true;
+  }
+  TexturePtr texture = Texture::LoadFromFile(filename);
+  if (!texture) {
+    return false;
+  }
+  textureBuffer.insert(std::make_pair(std::string(filename), texture));
+  return true;
+}
+
+/**
+* テクスチャを取得する.
+*
+* @param filename テクスチャファイル名.
+*
+* @return filenameに対応するテクスチャへのポインタ.
+*         対応するテクスチャが見つからない場合はnullptrを返す.
+*/
+const TexturePtr& GameEngine::GetTexture(const char* filename) const
+{
+  const auto itr = textureBuffer.find(filename);
+  if (itr != textureBuffer.end()) {
+    return itr->second;
+  }
+  static const TexturePtr dummy;
+  return dummy;
+}
+
+/**
+* メッシュを読み込む.
+*
+* @param filename メッシュファイル名.
+*
+* @retval true  読み込み成功.
+* @retval false 読み込み失敗.
+*/
+bool GameEngine::LoadMeshFromFile(const char* filename)
+{
+  return meshBuffer->LoadMeshFromFile(filename);
+}
+
+/**
+* エンティティを追加する.
+*
+* @param groupId  エンティティのグループID.
+* @param pos      エンティティの座標.
+* @param meshName エンティティの表示に使用するメッシュ名.
+* @param texName  エンティティの表示に使うテクスチャファイル名.
+* @param func     エンティティの状態を更新する関数(または関数オブジェクト).
+* @param shader   エンティティの表示に使うシェーダ名.
+*
+* @return 追加したエンティティへのポインタ.
+*         これ以上エンティティを追加できない場合はnullptrが返される.
+*         回転や拡大率はこのポインタ経由で設定する.
+*         なお、このポインタをアプリケーション側で保持する必要はない.
+*/
+Entity::Entity* GameEngine::AddEntity(int groupId, const glm::vec3& pos, const char* meshName, const char* texName, Entity::Entity::UpdateFuncType func, const char* shader)
+{
+  decltype(shaderMap)::const_iterator itr = shaderMap.end();
+  if (shader) {
+    itr = shaderMap.find(shader);
+  }
+  if (itr == shaderMap.end()) {
+    itr = shaderMap.find("Tutorial");
+    if (itr == shaderMap.end()) {
+      return nullptr;
+    }
+  }
+
+  const Mesh::MeshPtr& mesh = meshBuffer->GetMesh(meshName);
+  const TexturePtr& tex = textureBuffer.find(texName)->second;
+  return entityBuffer->AddEntity(groupId, pos, mesh, tex, itr->second, func);
+}
+
+/**
+*　エンティティを削除する.
+*
+* @param 削除するエンティティのポインタ.
+*/
+void GameEngine::RemoveEntity(Entity::Entity* e)
+{
+  entityBuffer->RemoveEntity(e);
+}
+
+/**
+* ライトを設定する.
+*
+* @param indes  設定するライトのインデックス.
+* @param light  ライトデータ.
+*/
+void GameEngine::Light(int index, const InterfaceBlock::PointLight& light)
+{
+  if (index < 0 || index >= InterfaceBlock::maxLightCount) {
+    std::cerr << "WARNING: '" << index << "'は不正なライトインデックスです" << std::endl;
+    return;
+  }
+  lightData.light[index] = light;
+}
+
+/**
+* ライトを取得する.
+*
+* @param index 取得するライトのインデックス.
+*
+* @return ライトデータ.
+*/
+const InterfaceBlock::PointLight& GameEngine::Light(int index) const
+{
+  if (index < 0 || index >= InterfaceBlock::maxLightCount) {
+    std::cerr << "WARNING: '" << index << "'は不正なライトインデックスです" << std::endl;
+    static const InterfaceBlock::PointLight dummy;
+    return dummy;
+  }
+  return lightData.light[index];
+}
+
+/**
+* 環境光を設定する.
+*
+* @param color 環境光の明るさ.
+*/
+void GameEngine::AmbientLight(const glm::vec4& color)
+{
+  lightData.ambientColor = color;
+}
+
+/**
+* 環境光を取得する.
+*
+* @return 環境光の明るさ.
+*/
+const glm::vec4& GameEngine::AmbientLight() const
+{
+  return lightData.ambientColor;
+}
+
+/**
+* 視点の位置と姿勢を設定する.
+*
+* @param cam 設定するカメラデータ.
+*/
+void GameEngine::Camera(const CameraData& cam)
+{
+  camera = cam;
+}
+
+/**
+* 視点の位置と姿勢を取得する.
+*
+* @return カメラデータ.
+*/
+const GameEngine::CameraData& GameEngine::Camera() const
+{
+  return camera;
+}
+
+/**
+* 乱数オブジェクトを取得する.
+*
+* @return 乱数オブジェクト.
+*/
+std::mt19937& GameEngine::Rand()
+{
+  return rand;
+}
+
+/**
+* ゲームパッドの状態を取得する.
+*/
+const GamePad& GameEngine::GetGamePad() const
+{
+  return GLFWEW::Window::Instance().GetGamePad();
+}
+
+/**
+* 衝突解決ハンドラを設定する.
+*
+* @param gid0    衝突対象のグループID.
+* @param gid1    衝突対象のグループID.
+* @param handler 衝突解決ハンドラ.
+*
+* 衝突が発生し衝突解決ハンドラが呼びされるとき、より小さいグループIDを持つエンティティから先に渡される.
+* ここで指定したグループIDの順序とは無関係であることに注意すること.
+* ex)
+*   CollisionHandler(10, 1, Func)
+*   というコードでハンドラを登録したとする. 衝突が発生すると、
+*   Func(グループID=1のエンティティ、グループID=10のエンティティ)
+*   のように呼び出される.
+*/
+void GameEngine::CollisionHandler(int gid0, int gid1, Entity::CollisionHandlerType handler)
+{
+  entityBuffer->CollisionHandler(gid0, gid1, handler);
+}
+
+/**
+* 衝突解決ハンドラを取得する.
+*
+* @param gid0 衝突対象のグループID.
+* @param gid1 衝突対象のグループID.
+*
+* @return 衝突解決ハンドラ.
+*/
+const Entity::CollisionHandlerType& GameEngine::CollisionHandler(int gid0, int gid1) const
+{
+  return entityBuffer->CollisionHandler(gid0, gid1);
+}
+
+/**
+* 衝突解決ハンドラのリストをクリアする.
+*/
+void GameEngine::ClearCollisionHandlerList()
+{
+  entityBuffer->ClearCollisionHandlerList();
+}
+
+/**
+* @copydoc Audio::Initialize
+*/
+bool GameEngine::InitAudio(const char* acfPath, const char* acbPath,
+  const char* awbPath, const char* dspBusName, size_t playerCount)
+{
+  return Audio::Initialize(acfPath, acbPath, awbPath, dspBusName, playerCount);
+}
+
+/**
+* @copydoc Audio::Play
+*/
+void GameEngine::PlayAudio(int playerId, int cueId)
+{
+  Audio::Play(playerId, cueId);
+}
+
+/**
+* @copydoc Audio::Stop
+*/
+void GameEngine::StopAudio(int playerId)
+{
+  Audio::Stop(playerId);
+}
+
+/**
+* デストラクタ.
+*/
+GameEngine::~GameEngine()
+{
+  Audio::Destroy();
+  if (vao) {
+    glDeleteVertexArrays(1, &vao);
+  }
+  if (ibo) {
+    glDeleteBuffers(1, &ibo);
+  }
+  if (vbo) {
+    glDeleteBuffers(1, &vbo);
+  }
+}
+
+/**
+* ゲームの状態を更新する.
+*
+* @param delta 前回の更新からの経過時間(秒).
+*/
+void GameEngine::Update(double delta)
+{
+  GLFWEW::Window::Instance().UpdateGamePad();
+  fontRenderer.MapBuffer();
+  if (updateFunc) {
+    updateFunc(delta);
+  }
+  const glm::mat4x4 matProj = glm::perspective(glm::radians(45.0f), static_cast<float>(width) / static_cast<float>(height), 1.0f, 200.0f);
+  const glm::mat4x4 matView = glm::lookAt(camera.position, camera.target, camera.up);
+  entityBuffer->Update(delta, matView, matProj);
+  fontRenderer.UnmapBuffer();
+}
+
+/**
+* ゲームの状態を描画する.
+*/
+void GameEngine::Render() const
+{
+  glBindFramebuffer(GL_FRAMEBUFFER, offscreen->GetFramebuffer());
+  glEnable(GL_DEPTH_TEST);
+  glEnable(GL_CULL_FACE);
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glViewport(0, 0, width, height);
+  glScissor(0, 0, width, height);
+  glClearColor(0.1f, 0.3f, 0.5f, 1.0f);
+  glClearDepth(1);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  uboLight->BufferSubData(&lightData);
+  entityBuffer->Draw(meshBuffer);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glDisable(GL_DEPTH_TEST);
+  glDisable(GL_CULL_FACE);
+  glDisable(GL_BLEND);
+  glBindVertexArray(vao);
+  const Shader::ProgramPtr& progColorFilter = shaderMap.find("ColorFilter")->second;
+  progColorFilter->UseProgram();
+  InterfaceBlock::PostEffectData postEffect;
+  uboPostEffect->BufferSubData(&postEffect);
+  progColorFilter->BindTexture(GL_TEXTURE0, GL_TEXTURE_2D, offscreen->GetTexutre());
+  glDrawElements(GL_TRIANGLES, renderingParts[1].size, GL_UNSIGNED_INT, renderingParts[1].offset);
+  fontRenderer.Draw();
+}